@@ -36,6 +36,7 @@ static void mega_ext_instance_init(MEGAExt *mega_ext, G_GNUC_UNUSED gpointer g_c
     mega_ext->string_viewprevious = NULL;
     mega_ext->string_upload = NULL;
     mega_ext->syncs_received = FALSE;
+    mega_ext_client_init_entry_states(mega_ext);
 
     // ignore SIGPIPE as we most likely will write to a closed socket in mega_notify_client_read()
     signal(SIGPIPE, SIG_IGN);
@@ -69,6 +70,10 @@ static const gchar *file_state_to_str(FileState state)
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
 {
     GFile *f;
+
+    // a change of a sync folder itself (paused, resumed...) changes every state inside it
+    mega_ext_client_forget_entry_state(mega_ext, path, g_hash_table_contains(mega_ext->h_syncs, path));
+
     f = g_file_new_for_path(path);
     if (!f) {
         g_debug("No file found for %s!", path);
@@ -128,12 +133,14 @@ void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path)
         return;
     g_debug("New sync path: %s", path);
     g_hash_table_insert(mega_ext->h_syncs, g_strdup(path), GINT_TO_POINTER(1));
+    mega_ext_client_forget_entry_state(mega_ext, path, TRUE);
 }
 
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path)
 {
     g_debug("Deleted sync path: %s", path);
     g_hash_table_remove(mega_ext->h_syncs, path);
+    mega_ext_client_forget_entry_state(mega_ext, path, TRUE);
 }
 
 void expanselocalpath(const char *path, char *absolutepath)
@@ -528,12 +535,20 @@ static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *p
         g_object_unref(file_info);
     }
 
-    state = mega_ext_client_get_path_state(mega_ext, path, 0);
-    if (state == RESPONSE_DEFAULT)
+    // the states of the entries of synced folders are cached, as their changes are notified
+    if (mega_ext->syncs_received && mega_ext_path_in_sync(mega_ext, path))
     {
-        char canonical[PATH_MAX];
-        expanselocalpath(path,canonical);
-        state = mega_ext_client_get_path_state(mega_ext, canonical, 0);
+        state = mega_ext_client_get_entry_state(mega_ext, path);
+    }
+    else
+    {
+        state = mega_ext_client_get_path_state(mega_ext, path, 0);
+        if (state == RESPONSE_DEFAULT)
+        {
+            char canonical[PATH_MAX];
+            expanselocalpath(path,canonical);
+            state = mega_ext_client_get_path_state(mega_ext, canonical, 0);
+        }
     }
 
     g_debug("mega_ext_update_file_info. File: %s  State: %s", path, file_state_to_str(state));
@@ -27,6 +27,12 @@ struct _MEGAExt {
     gchar *string_viewonmega; // cached string
     gchar *string_viewprevious; // cached string
 
+    struct _MEGAStateCache *state_cache; // received states, until they are notified to change
+    gchar *states_folder; // folder of the entries last asked for
+    gchar *states_canonical_folder; // states_folder with its symlinks resolved
+    gint states_misses; // entries of states_folder not found in state_cache
+    gboolean states_fetched; // TRUE if the states of states_folder were already requested
+
 };
 
 struct _MEGAExtClass {
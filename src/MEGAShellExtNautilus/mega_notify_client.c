@@ -1,4 +1,5 @@
 #include "mega_notify_client.h"
+#include "mega_ext_client.h"
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -84,6 +85,8 @@ void mega_notify_client_destroy(MEGAExt *mega_ext)
         close(mega_ext->notify_sock);
     mega_ext->notify_sock = -1;
     mega_ext->syncs_received = FALSE;
+    // the cached states would not be updated anymore
+    mega_ext_client_clear_entry_states(mega_ext);
 }
 
 static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition condition, gpointer data)
@@ -0,0 +1,127 @@
+#include "mega_state_cache.h"
+#include <string.h>
+
+typedef struct {
+    gchar *path;
+    FileState state;
+} CachedState;
+
+struct _MEGAStateCache {
+    GHashTable *h_states; // path -> link of lru
+    GQueue lru; // CachedState, most recently used first
+    guint max_size;
+};
+
+static void cached_state_free(CachedState *cached)
+{
+    g_free(cached->path);
+    g_slice_free(CachedState, cached);
+}
+
+static void mega_state_cache_remove_link(MEGAStateCache *cache, GList *link)
+{
+    CachedState *cached = link->data;
+
+    g_hash_table_remove(cache->h_states, cached->path);
+    g_queue_delete_link(&cache->lru, link);
+    cached_state_free(cached);
+}
+
+MEGAStateCache *mega_state_cache_new(guint max_size)
+{
+    MEGAStateCache *cache = g_slice_new(MEGAStateCache);
+
+    // the keys are owned by the CachedState items
+    cache->h_states = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&cache->lru);
+    cache->max_size = max_size;
+
+    return cache;
+}
+
+void mega_state_cache_free(MEGAStateCache *cache)
+{
+    if (!cache)
+        return;
+
+    mega_state_cache_clear(cache);
+    g_hash_table_destroy(cache->h_states);
+    g_slice_free(MEGAStateCache, cache);
+}
+
+gboolean mega_state_cache_lookup(MEGAStateCache *cache, const gchar *path, FileState *state)
+{
+    GList *link = g_hash_table_lookup(cache->h_states, path);
+
+    if (!link)
+        return FALSE;
+
+    // move it to the front, it's the most recently used now
+    g_queue_unlink(&cache->lru, link);
+    g_queue_push_head_link(&cache->lru, link);
+
+    *state = ((CachedState *)link->data)->state;
+    return TRUE;
+}
+
+void mega_state_cache_insert(MEGAStateCache *cache, const gchar *path, FileState state)
+{
+    GList *link = g_hash_table_lookup(cache->h_states, path);
+    CachedState *cached;
+
+    if (link) {
+        ((CachedState *)link->data)->state = state;
+        g_queue_unlink(&cache->lru, link);
+        g_queue_push_head_link(&cache->lru, link);
+        return;
+    }
+
+    cached = g_slice_new(CachedState);
+    cached->path = g_strdup(path);
+    cached->state = state;
+    g_queue_push_head(&cache->lru, cached);
+    g_hash_table_insert(cache->h_states, cached->path, g_queue_peek_head_link(&cache->lru));
+
+    while (g_queue_get_length(&cache->lru) > cache->max_size)
+        mega_state_cache_remove_link(cache, g_queue_peek_tail_link(&cache->lru));
+}
+
+void mega_state_cache_remove(MEGAStateCache *cache, const gchar *path)
+{
+    GList *link = g_hash_table_lookup(cache->h_states, path);
+
+    if (link)
+        mega_state_cache_remove_link(cache, link);
+}
+
+void mega_state_cache_remove_tree(MEGAStateCache *cache, const gchar *path)
+{
+    GList *link, *next;
+    gsize len = strlen(path);
+
+    // trailing separators don't matter
+    while (len > 1 && path[len - 1] == '/')
+        len--;
+
+    for (link = cache->lru.head; link; link = next) {
+        const gchar *cached_path = ((CachedState *)link->data)->path;
+
+        next = link->next;
+        if (!strncmp(cached_path, path, len) && (cached_path[len] == '\0' || cached_path[len] == '/' || len == 1))
+            mega_state_cache_remove_link(cache, link);
+    }
+}
+
+void mega_state_cache_clear(MEGAStateCache *cache)
+{
+    CachedState *cached;
+
+    g_hash_table_remove_all(cache->h_states);
+    while ((cached = g_queue_pop_head(&cache->lru)) != NULL)
+        cached_state_free(cached);
+}
+
+guint mega_state_cache_size(MEGAStateCache *cache)
+{
+    return g_queue_get_length(&cache->lru);
+}
@@ -1,4 +1,5 @@
 #include "mega_ext_client.h"
+#include "mega_state_cache.h"
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -6,6 +7,7 @@
 #include <string.h>
 
 const gchar OP_PATH_STATE  = 'P'; //Path state
+const gchar OP_BATCH_PATH_STATE = 'B'; //Path states of several entries of a folder
 const gchar OP_INIT        = 'I'; //Init operation
 const gchar OP_END         = 'E'; //End operation
 const gchar OP_UPLOAD      = 'F'; //File-Folder upload
@@ -18,6 +20,10 @@ const gchar OP_PREVIOUS    = 'R'; //View previous versions
 
 const gchar *RESPONSE_DEFAULT_str = "9";
 
+const guint MAX_CACHED_STATES = 100000;
+// batched requests carry the names of a whole folder, only their beginning is logged
+const int MAX_LOGGED_REQUEST_SIZE = 256;
+
 static void mega_ext_client_disconnect(MEGAExt *mega_ext);
 
 // try to connect to the server
@@ -93,7 +99,7 @@ static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const
     GIOStatus status;
     gint num_retries;
 
-    g_debug("Sending request: %c:%s ", type, in);
+    g_debug("Sending request: %c:%.*s ", type, MAX_LOGGED_REQUEST_SIZE, in);
 
     // try to send request several times
     for (num_retries = 0; num_retries < mega_ext->num_retries; num_retries++) {
@@ -192,6 +198,174 @@ FileState mega_ext_client_get_path_state(MEGAExt *mega_ext, const gchar *path, i
     return st;
 }
 
+// get the states of several entries of the same folder with a single request
+// names must not contain newlines nor the 0x1C separator
+// return FALSE if the states could not be received
+gboolean mega_ext_client_get_path_states(MEGAExt *mega_ext, const gchar *folder, const gchar **names, guint count,
+                                         int forceGetState, FileState *states)
+{
+    GString *in;
+    gchar *out;
+    gchar **tokens;
+    guint i;
+    gboolean result = FALSE;
+
+    if (!count)
+        return TRUE;
+
+    char canonical[PATH_MAX];
+    expanselocalpath(folder,canonical);
+
+    in = g_string_sized_new(strlen(canonical) + count * 32);
+    g_string_append_printf(in, "%c%c%s", forceGetState?'1':'0', (char)0x1C, canonical);
+    for (i = 0; i < count; i++) {
+        g_string_append_c(in, (char)0x1C);
+        g_string_append(in, names[i]);
+    }
+    // unlike the rest, this request is newline terminated as it may need several reads in the server
+    g_string_append_c(in, '\n');
+
+    out = mega_ext_client_send_request(mega_ext, OP_BATCH_PATH_STATE, in->str);
+    g_string_free(in, TRUE);
+
+    if (!out)
+        return FALSE;
+
+    tokens = g_strsplit(out, ",", -1);
+    if (g_strv_length(tokens) == count) {
+        for (i = 0; i < count; i++)
+            states[i] = atoi(tokens[i]);
+        result = TRUE;
+    }
+    g_strfreev(tokens);
+    g_free(out);
+
+    return result;
+}
+
+void mega_ext_client_init_entry_states(MEGAExt *mega_ext)
+{
+    mega_ext->state_cache = mega_state_cache_new(MAX_CACHED_STATES);
+    mega_ext->states_folder = NULL;
+    mega_ext->states_canonical_folder = NULL;
+    mega_ext->states_misses = 0;
+    mega_ext->states_fetched = FALSE;
+}
+
+// request the states of all the entries of states_folder, to answer the next mega_ext_client_get_entry_state calls
+static void mega_ext_client_fetch_entry_states(MEGAExt *mega_ext)
+{
+    GDir *dir;
+    const gchar *name;
+    GPtrArray *names;
+    FileState *states;
+    gchar *key;
+    guint i;
+
+    mega_ext->states_fetched = TRUE;
+
+    dir = g_dir_open(mega_ext->states_folder, 0, NULL);
+    if (!dir)
+        return;
+
+    names = g_ptr_array_new_with_free_func(g_free);
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        // the entries which can't be sent in a batch are asked for one by one
+        if (!strchr(name, '\n') && !strchr(name, 0x1C) && g_utf8_validate(name, -1, NULL))
+            g_ptr_array_add(names, g_strdup(name));
+    }
+    g_dir_close(dir);
+
+    states = g_new(FileState, names->len);
+    if (mega_ext_client_get_path_states(mega_ext, mega_ext->states_folder, (const gchar **)names->pdata, names->len, 0, states)) {
+        for (i = 0; i < names->len; i++) {
+            // the entries not found are asked for again one by one, resolving their symlinks as usual
+            if (states[i] != RESPONSE_DEFAULT && states[i] != RESPONSE_ERROR) {
+                key = g_build_filename(mega_ext->states_canonical_folder, g_ptr_array_index(names, i), NULL);
+                mega_state_cache_insert(mega_ext->state_cache, key, states[i]);
+                g_free(key);
+            }
+        }
+    }
+    g_free(states);
+    g_ptr_array_free(names, TRUE);
+}
+
+// state of an entry shown by the file manager, to display its overlay icon.
+// The states are cached until the notify server tells they changed, so showing the same entries again doesn't
+// send any request. When a second entry of the same folder is missing, the states of the whole folder are
+// received with a single request, as the file manager is going to ask for all of them.
+FileState mega_ext_client_get_entry_state(MEGAExt *mega_ext, const gchar *path)
+{
+    gchar *folder;
+    gchar *name;
+    gchar *key;
+    FileState st;
+    char canonical[PATH_MAX] = "";
+
+    folder = g_path_get_dirname(path);
+    if (!mega_ext->states_folder || strcmp(mega_ext->states_folder, folder)) {
+        expanselocalpath(folder,canonical);
+        g_free(mega_ext->states_folder);
+        g_free(mega_ext->states_canonical_folder);
+        mega_ext->states_folder = folder;
+        mega_ext->states_canonical_folder = g_strdup(canonical);
+        mega_ext->states_misses = 0;
+        mega_ext->states_fetched = FALSE;
+    } else {
+        g_free(folder);
+    }
+
+    // the notified paths have the symlinks of their folders resolved
+    name = g_path_get_basename(path);
+    key = g_build_filename(mega_ext->states_canonical_folder, name, NULL);
+    g_free(name);
+
+    if (mega_state_cache_lookup(mega_ext->state_cache, key, &st)) {
+        g_free(key);
+        return st;
+    }
+
+    if (!mega_ext->states_fetched && ++mega_ext->states_misses > 1) {
+        mega_ext_client_fetch_entry_states(mega_ext);
+        if (mega_state_cache_lookup(mega_ext->state_cache, key, &st)) {
+            g_free(key);
+            return st;
+        }
+    }
+
+    st = mega_ext_client_get_path_state(mega_ext, path, 0);
+
+    // the state of a symlink is the one of its target, which is notified with its own path
+    expanselocalpath(path,canonical);
+    if (st != RESPONSE_ERROR && !strcmp(canonical, key))
+        mega_state_cache_insert(mega_ext->state_cache, key, st);
+    g_free(key);
+
+    return st;
+}
+
+// forget the cached states of path, after being notified that it changed
+void mega_ext_client_forget_entry_state(MEGAExt *mega_ext, const gchar *path, gboolean recursive)
+{
+    if (recursive)
+        mega_state_cache_remove_tree(mega_ext->state_cache, path);
+    else
+        mega_state_cache_remove(mega_ext->state_cache, path);
+}
+
+// forget every cached state, when the notifications can't be received
+void mega_ext_client_clear_entry_states(MEGAExt *mega_ext)
+{
+    mega_state_cache_clear(mega_ext->state_cache);
+    g_free(mega_ext->states_folder);
+    g_free(mega_ext->states_canonical_folder);
+    mega_ext->states_folder = NULL;
+    mega_ext->states_canonical_folder = NULL;
+    mega_ext->states_misses = 0;
+    mega_ext->states_fetched = FALSE;
+}
+
 gboolean mega_ext_client_paste_link(MEGAExt *mega_ext, const gchar *path)
 {
     gchar *out;
@@ -0,0 +1,25 @@
+#ifndef MEGA_STATE_CACHE_H
+#define MEGA_STATE_CACHE_H
+
+#include "MEGAShellExt.h"
+
+G_BEGIN_DECLS
+
+// States of paths received from the Extension server, kept until the notify server tells they changed.
+// The least recently used paths are discarded when there are more than max_size.
+typedef struct _MEGAStateCache MEGAStateCache;
+
+MEGAStateCache *mega_state_cache_new(guint max_size);
+void mega_state_cache_free(MEGAStateCache *cache);
+
+gboolean mega_state_cache_lookup(MEGAStateCache *cache, const gchar *path, FileState *state);
+void mega_state_cache_insert(MEGAStateCache *cache, const gchar *path, FileState state);
+void mega_state_cache_remove(MEGAStateCache *cache, const gchar *path);
+// remove path and every path inside it
+void mega_state_cache_remove_tree(MEGAStateCache *cache, const gchar *path);
+void mega_state_cache_clear(MEGAStateCache *cache);
+guint mega_state_cache_size(MEGAStateCache *cache);
+
+G_END_DECLS
+
+#endif
@@ -30,6 +30,7 @@
 #include "syncs/gui/SyncsMenu.h"
 #include "gui/UploadToMegaDialog.h"
 #include "EmailRequester.h"
+#include "DebrisCleaner.h"
 #include "StatsEventHandler.h"
 
 #include "qml/QmlManager.h"
@@ -373,6 +374,8 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
     // Don't execute the "onGlobalSyncStateChangedImpl" function too often or the dialog locks up,
     // eg. queueing a folder with 1k items for upload/download
     mIntervalExecutioner = std::make_unique<IntervalExecutioner>(Preferences::minSyncStateChangeProcessingIntervalMs);
+
+    mDebrisCleaner = std::make_unique<DebrisCleaner>();
 }
 
 MegaApplication::~MegaApplication()
@@ -544,6 +547,7 @@ void MegaApplication::initialize()
         gCrashableForTesting = settings.value(QString::fromUtf8("crashable"), false).toBool();
 
         Preferences::overridePreferences(settings);
+        Platform::getInstance()->updateShellNotificationLimits();
         Preferences::SDK_ID.append(QString::fromUtf8(" - STAGING"));
     }
     trayIcon->show();
@@ -1465,7 +1469,7 @@ if (!preferences->lastExecutionTime())
 
     megaApi->setDefaultFilePermissions(preferences->filePermissionsValue());
     megaApi->setDefaultFolderPermissions(preferences->folderPermissionsValue());
-    });
+    }, ThreadPool::Lane::INTERACTIVE);
 
     // Connect ScanStage signal
     connect(&scanStageController, &ScanStageController::enableTransferActions,
@@ -1932,6 +1936,7 @@ void MegaApplication::checkMemoryUsage()
     auto transferCount = getTransfersModel()->getTransfersCount();
     long long totalTransfers =  transferCount.pendingUploads + transferCount.pendingDownloads;
     long long procesUsage = 0;
+    ResourceUsageSample sample;
 
     if (!totalNodes)
     {
@@ -1960,15 +1965,32 @@ void MegaApplication::checkMemoryUsage()
         {
             return;
         }
+    #elif defined(Q_OS_LINUX)
+        if (!ResourceUsageSampler::readProcessUsage(sample))
+        {
+            return;
+        }
+        procesUsage = sample.residentBytes;
     #endif
 #endif
 
+    sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+    sample.memoryUsage = procesUsage;
+    sample.nodes = numNodes;
+    sample.localNodes = numLocalNodes;
+    sample.transfers = totalTransfers;
+    mResourceUsage.addSample(sample);
+
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG,
                  QString::fromUtf8("Memory usage: %1 MB / %2 Nodes / %3 LocalNodes / %4 B/N / %5 transfers")
                  .arg(procesUsage / (1024 * 1024))
                  .arg(numNodes).arg(numLocalNodes)
                  .arg(static_cast<float>(procesUsage) / static_cast<float>(totalNodes))
                  .arg(totalTransfers).toUtf8().constData());
+#ifdef Q_OS_LINUX
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG,
+                 QString::fromUtf8("Resource usage: %1").arg(sample.toString()).toUtf8().constData());
+#endif
 
     if (procesUsage > maxMemoryUsage)
     {
@@ -1993,6 +2015,20 @@ void MegaApplication::checkMemoryUsage()
     }
 }
 
+void MegaApplication::logResourceUsageHistory()
+{
+    const auto samples(mResourceUsage.getSamples());
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                 QString::fromUtf8("Resource usage history: %1 samples").arg(samples.size()).toUtf8().constData());
+    for (const auto& sample : samples)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                     QString::fromUtf8("%1: %2")
+                     .arg(QDateTime::fromMSecsSinceEpoch(sample.timestamp).toString(Qt::ISODate))
+                     .arg(sample.toString()).toUtf8().constData());
+    }
+}
+
 void MegaApplication::checkOverStorageStates()
 {
     if (!preferences->logged() || ((!infoDialog || !infoDialog->isVisible()) && !mStorageOverquotaDialog && !Platform::getInstance()->isUserActive()))
@@ -2171,7 +2207,7 @@ void MegaApplication::periodicTasks()
                     checkOverQuotaStates();
                 });//end of queued function
 
-            });// end of thread pool function
+            }, ThreadPool::Lane::INTERACTIVE);// end of thread pool function
         }
 
         onGlobalSyncStateChanged(megaApi);
@@ -2266,6 +2302,8 @@ void MegaApplication::cleanAll()
     mBackupsMenu->deleteLater();
 
     preferences->setLastExit(QDateTime::currentMSecsSinceEpoch());
+    // Write the settings still waiting for the flush timer
+    preferences->sync();
 
     // Ensure that there aren't objects deleted with deleteLater()
     // that may try to access megaApi after
@@ -3172,35 +3210,33 @@ void MegaApplication::cleanLocalCaches(bool all)
         return;
     }
 
-    if (all || preferences->cleanerDaysLimit())
+    int timeLimitDays = DebrisCleaner::NO_EXPIRATION;
+    if (all)
     {
-        int timeLimitDays = preferences->cleanerDaysLimitValue();
-        for (auto syncPath : model->getLocalFolders(SyncInfo::AllHandledSyncTypes))
-        {
-            if (!syncPath.isEmpty())
-            {
-                QDir cacheDir(syncPath + QDir::separator() + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
-                if (cacheDir.exists())
-                {
-                    QFileInfoList dailyCaches = cacheDir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
-                    for (int i = 0; i < dailyCaches.size(); i++)
-                    {
-                        QFileInfo cacheFolder = dailyCaches[i];
-                        if (!cacheFolder.fileName().compare(QString::fromUtf8("tmp"))) //DO NOT REMOVE tmp subfolder
-                        {
-                            continue;
-                        }
+        timeLimitDays = DebrisCleaner::ALL_FOLDERS;
+    }
+    else if (preferences->cleanerDaysLimit())
+    {
+        timeLimitDays = preferences->cleanerDaysLimitValue();
+    }
 
-                        QDateTime creationTime(cacheFolder.birthTime());
-                        if (all || (creationTime.isValid() && creationTime.daysTo(QDateTime::currentDateTime()) > timeLimitDays) )
-                        {
-                            Utilities::removeRecursively(cacheFolder.canonicalFilePath());
-                        }
-                    }
-                }
-            }
+    QStringList debrisFolders;
+    for (auto syncPath : model->getLocalFolders(SyncInfo::AllHandledSyncTypes))
+    {
+        if (!syncPath.isEmpty())
+        {
+            debrisFolders.append(syncPath + QDir::separator() + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
         }
     }
+
+    // The debris folders are read and removed in the thread pool. Without an expiration, only the removals
+    // interrupted by a restart are finished
+    mDebrisCleaner->clean(debrisFolders, timeLimitDays);
+}
+
+DebrisCleaner* MegaApplication::getDebrisCleaner() const
+{
+    return mDebrisCleaner.get();
 }
 
 void MegaApplication::showInfoMessage(QString message, QString title)
@@ -4013,6 +4049,9 @@ void MegaApplication::toggleLogging()
             MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Version string: %1   Version code: %2.%3   User-Agent: %4").arg(Preferences::VERSION_STRING)
                      .arg(Preferences::VERSION_CODE).arg(Preferences::BUILD_ID).arg(QString::fromUtf8(megaApi->getUserAgent())).toUtf8().constData());
         }
+
+        // The samples taken before the debug mode was enabled
+        logResourceUsageHistory();
     }
 }
 
@@ -32,6 +32,7 @@
 #include "UpdateTask.h"
 #include "MegaSyncLogger.h"
 #include "ThreadPool.h"
+#include "ResourceUsageSampler.h"
 #include "Utilities.h"
 #include "SetManager.h"
 #include "syncs/control/SyncInfo.h"
@@ -49,6 +50,7 @@
 #include "qml/QmlDialogManager.h"
 
 class IntervalExecutioner;
+class DebrisCleaner;
 class TransfersModel;
 class StalledIssuesModel;
 
@@ -185,6 +187,7 @@ public:
 
     TransfersModel* getTransfersModel(){return mTransfersModel;}
     StalledIssuesModel* getStalledIssuesModel(){return mStalledIssuesModel;}
+    DebrisCleaner* getDebrisCleaner() const;
 
     /**
      * @brief migrates sync configuration and fetches nodes
@@ -278,6 +281,7 @@ public slots:
     void pauseTransfers(bool pause);
     void checkNetworkInterfaces();
     void checkMemoryUsage();
+    void logResourceUsageHistory();
     void checkOverStorageStates();
     void checkOverQuotaStates();
     void periodicTasks();
@@ -439,6 +443,8 @@ protected:
     bool getUserDataRequestReady;
     long long receivedStorageSum;
     long long maxMemoryUsage;
+    // One sample per checkMemoryUsage call
+    ResourceUsageSampler mResourceUsage;
     int exportOps;
     std::shared_ptr<mega::MegaPricing> mPricing;
     std::shared_ptr<mega::MegaCurrency> mCurrency;
@@ -517,6 +523,7 @@ protected:
     QString mLinkToPublicSet;
     QList<mega::MegaHandle> mElementHandleList;
     std::unique_ptr<IntervalExecutioner> mIntervalExecutioner;
+    std::unique_ptr<DebrisCleaner> mDebrisCleaner;
 
 private:
     void loadSyncExclusionRules(QString email = QString());
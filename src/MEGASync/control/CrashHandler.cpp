@@ -437,6 +437,7 @@ void CrashHandler::tryReboot()
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Restarting app...");
         preferences->setLastReboot(QDateTime::currentMSecsSinceEpoch());
+        preferences->sync();
 
 #ifndef __APPLE__
         QString app = MegaApplication::applicationFilePath();
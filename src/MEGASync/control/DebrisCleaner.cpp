@@ -0,0 +1,283 @@
+#include "DebrisCleaner.h"
+
+#include "Utilities.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+const int DebrisCleaner::ALL_FOLDERS = -1;
+const int DebrisCleaner::NO_EXPIRATION = std::numeric_limits<int>::max();
+const int DebrisCleaner::DEFAULT_OPERATIONS_PER_SECOND = 2000;
+const QString DebrisCleaner::REMOVING_PREFIX = QString::fromUtf8(".removing-");
+const long long DebrisCleaner::PROGRESS_INTERVAL_ENTRIES = 1000;
+const std::chrono::milliseconds DebrisCleaner::MAX_BUDGET_WAIT = std::chrono::milliseconds(50);
+
+DebrisCleaner::DebrisCleaner(int operationsPerSecond, QObject* parent)
+    : QObject(parent)
+    , mOperationsPerSecond(operationsPerSecond)
+    , mWorkers(std::make_shared<Workers>())
+    , mBudget(0.0)
+    , mLastRefill(std::chrono::steady_clock::now())
+    , mRemovedEntries(0)
+{
+}
+
+DebrisCleaner::~DebrisCleaner()
+{
+    // The running workers see the cancellation in their next operation
+    mToken.cancel();
+    mWorkers->cancelAndWait();
+}
+
+void DebrisCleaner::clean(const QStringList& debrisFolders, int daysLimit)
+{
+    std::lock_guard<std::mutex> lock(mFoldersMutex);
+    for (const auto& debrisFolder : debrisFolders)
+    {
+        auto pendingFolder(mPendingFolders.find(debrisFolder));
+        if (pendingFolder != mPendingFolders.end())
+        {
+            pendingFolder.value() = mergeDaysLimits(pendingFolder.value(), daysLimit);
+        }
+        else
+        {
+            mPendingFolders.insert(debrisFolder, daysLimit);
+        }
+
+        // A folder being cleaned is cleaned again with the new days limit when it finishes
+        if (!mActiveFolders.contains(debrisFolder))
+        {
+            mActiveFolders.insert(debrisFolder);
+            ThreadPoolSingleton::getInstance()->push([this, workers = mWorkers, debrisFolder]()
+            {
+                if (workers->start())
+                {
+                    cleanDebrisFolder(debrisFolder);
+                    workers->finish();
+                }
+            }, ThreadPool::Lane::BULK_IO, mToken);
+        }
+    }
+}
+
+bool DebrisCleaner::isCleaning() const
+{
+    std::lock_guard<std::mutex> lock(mFoldersMutex);
+    return !mActiveFolders.isEmpty();
+}
+
+bool DebrisCleaner::Workers::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (destroying)
+    {
+        return false;
+    }
+    running++;
+    return true;
+}
+
+void DebrisCleaner::Workers::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+    }
+    condition.notify_all();
+}
+
+void DebrisCleaner::Workers::cancelAndWait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    destroying = true;
+    condition.wait(lock, [this]()
+    {
+        return running == 0;
+    });
+}
+
+void DebrisCleaner::cleanDebrisFolder(const QString& debrisFolder)
+{
+    bool isLastFolder(false);
+    while (true)
+    {
+        int daysLimit(NO_EXPIRATION);
+        {
+            std::lock_guard<std::mutex> lock(mFoldersMutex);
+            auto pendingFolder(mPendingFolders.find(debrisFolder));
+            if (pendingFolder == mPendingFolders.end() || ThreadPool::isThreadInterrupted())
+            {
+                mActiveFolders.remove(debrisFolder);
+                isLastFolder = mActiveFolders.isEmpty();
+                break;
+            }
+            daysLimit = pendingFolder.value();
+            mPendingFolders.erase(pendingFolder);
+        }
+
+        removeExpiredFolders(debrisFolder, daysLimit);
+    }
+
+    if (isLastFolder && !ThreadPool::isThreadInterrupted())
+    {
+        emit finished(mRemovedEntries.exchange(0));
+    }
+}
+
+void DebrisCleaner::removeExpiredFolders(const QString& debrisFolder, int daysLimit)
+{
+    QDir debrisDir(debrisFolder);
+    if (!debrisDir.exists())
+    {
+        return;
+    }
+
+    const auto entries(debrisDir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System));
+    for (const auto& entry : entries)
+    {
+        if (ThreadPool::isThreadInterrupted())
+        {
+            return;
+        }
+
+        auto name(entry.fileName());
+        if (!name.compare(QLatin1String("tmp"))) //DO NOT REMOVE tmp subfolder
+        {
+            continue;
+        }
+
+        auto path(entry.absoluteFilePath());
+        if (!name.startsWith(REMOVING_PREFIX))
+        {
+            QDateTime creationTime(entry.birthTime());
+            bool isExpired(daysLimit == ALL_FOLDERS
+                           || (daysLimit != NO_EXPIRATION && creationTime.isValid()
+                               && creationTime.daysTo(QDateTime::currentDateTime()) > daysLimit));
+            if (!isExpired)
+            {
+                continue;
+            }
+
+            // If it can not be renamed it is removed anyway, but an interrupted removal is not resumed
+            if (debrisDir.rename(name, REMOVING_PREFIX + name))
+            {
+                path = debrisDir.absoluteFilePath(REMOVING_PREFIX + name);
+            }
+        }
+
+        removeTree(path);
+    }
+}
+
+void DebrisCleaner::removeTree(const QString& path)
+{
+    QFileInfo root(path);
+    if (!root.isDir() || root.isSymLink())
+    {
+        if (waitForBudget())
+        {
+            removeEntry(path, false);
+        }
+        return;
+    }
+
+    // The folders are found before their contents, so they are removed in the reverse order
+    QStringList folders(path);
+    QDirIterator it(path, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        auto info(it.fileInfo());
+        if (info.isDir() && !info.isSymLink())
+        {
+            folders.append(info.filePath());
+        }
+        else
+        {
+            if (!waitForBudget())
+            {
+                return;
+            }
+            removeEntry(info.filePath(), false);
+        }
+    }
+
+    for (auto folder = folders.crbegin(); folder != folders.crend(); ++folder)
+    {
+        if (!waitForBudget())
+        {
+            return;
+        }
+        removeEntry(*folder, true);
+    }
+}
+
+void DebrisCleaner::removeEntry(const QString& path, bool isFolder)
+{
+    bool isRemoved(isFolder ? QDir().rmdir(path) : QFile::remove(path));
+    if (!isRemoved && !isFolder)
+    {
+        // The read only files can not be removed on Windows
+        QFile::setPermissions(path, QFile::permissions(path) | QFileDevice::WriteUser);
+        isRemoved = QFile::remove(path);
+    }
+
+    if (isRemoved)
+    {
+        auto removedEntries(++mRemovedEntries);
+        if (removedEntries % PROGRESS_INTERVAL_ENTRIES == 0)
+        {
+            emit progress(removedEntries);
+        }
+    }
+}
+
+bool DebrisCleaner::waitForBudget()
+{
+    if (mOperationsPerSecond <= 0)
+    {
+        return !ThreadPool::isThreadInterrupted();
+    }
+
+    // Token bucket shared by all the workers, holding up to one second of operations
+    std::unique_lock<std::mutex> lock(mBudgetMutex);
+    while (!ThreadPool::isThreadInterrupted())
+    {
+        auto now(std::chrono::steady_clock::now());
+        std::chrono::duration<double> elapsed(now - mLastRefill);
+        mBudget = std::min<double>(mOperationsPerSecond, mBudget + elapsed.count() * mOperationsPerSecond);
+        mLastRefill = now;
+
+        if (mBudget >= 1.0)
+        {
+            mBudget -= 1.0;
+            return true;
+        }
+
+        // Short waits, so the interruptions are seen soon
+        std::chrono::duration<double> missing((1.0 - mBudget) / mOperationsPerSecond);
+        auto wait(std::min(MAX_BUDGET_WAIT, std::chrono::duration_cast<std::chrono::milliseconds>(missing)
+                                            + std::chrono::milliseconds(1)));
+        lock.unlock();
+        std::this_thread::sleep_for(wait);
+        lock.lock();
+    }
+    return false;
+}
+
+int DebrisCleaner::mergeDaysLimits(int first, int second)
+{
+    if (first == ALL_FOLDERS || second == ALL_FOLDERS)
+    {
+        return ALL_FOLDERS;
+    }
+    return std::min(first, second);
+}
@@ -0,0 +1,92 @@
+#ifndef DEBRISCLEANER_H
+#define DEBRISCLEANER_H
+
+#include "ThreadPool.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+/// Responsability: remove the expired folders of the local debris of the syncs in the thread pool.
+/// Each debris folder is cleaned by its own functor, so the syncs are cleaned in parallel, and the removals of all
+/// of them share a budget of operations per second, so the disk is not saturated. The expired folders are renamed
+/// before being removed, so a removal interrupted by a restart is finished in the next clean.
+class DebrisCleaner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Days limit to remove every folder of the debris, not only the expired ones
+    static const int ALL_FOLDERS;
+    // Days limit to only finish the removals interrupted by a restart
+    static const int NO_EXPIRATION;
+    static const int DEFAULT_OPERATIONS_PER_SECOND;
+
+    // No limit when operationsPerSecond <= 0
+    explicit DebrisCleaner(int operationsPerSecond = DEFAULT_OPERATIONS_PER_SECOND, QObject* parent = nullptr);
+    ~DebrisCleaner();
+
+    // Only schedules the removals, the debris folders are read and cleaned in the thread pool
+    void clean(const QStringList& debrisFolders, int daysLimit);
+    bool isCleaning() const;
+
+signals:
+    // Entries removed since the clean started
+    void progress(long long removedEntries);
+    void finished(long long removedEntries);
+
+private:
+    // Shared with the functors, which can start after the cleaner is destroyed
+    struct Workers
+    {
+        // False when the cleaner is being destroyed, and the functor must not touch it
+        bool start();
+        void finish();
+        void cancelAndWait();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        int running = 0;
+        bool destroying = false;
+    };
+
+    void cleanDebrisFolder(const QString& debrisFolder);
+    void removeExpiredFolders(const QString& debrisFolder, int daysLimit);
+    void removeTree(const QString& path);
+    void removeEntry(const QString& path, bool isFolder);
+
+    // Waits until the budget allows one more operation. False when the thread is interrupted
+    bool waitForBudget();
+
+    static int mergeDaysLimits(int first, int second);
+
+    static const QString REMOVING_PREFIX;
+    static const long long PROGRESS_INTERVAL_ENTRIES;
+    static const std::chrono::milliseconds MAX_BUDGET_WAIT;
+
+    const int mOperationsPerSecond;
+    ThreadPool::CancellationToken mToken;
+
+    std::shared_ptr<Workers> mWorkers;
+
+    mutable std::mutex mFoldersMutex;
+    // Days limit of the cleans not started yet, by debris folder
+    QHash<QString, int> mPendingFolders;
+    QSet<QString> mActiveFolders;
+
+    std::mutex mBudgetMutex;
+    double mBudget;
+    std::chrono::steady_clock::time_point mLastRefill;
+
+    std::atomic<long long> mRemovedEntries;
+};
+
+#endif // DEBRISCLEANER_H
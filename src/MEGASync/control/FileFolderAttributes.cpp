@@ -2,6 +2,7 @@
 
 #include <MegaApplication.h>
 #include <UserAttributesRequests/FullName.h>
+#include <LocalAttributesScanner.h>
 
 #include <QEventLoop>
 
@@ -43,7 +44,7 @@ void FileFolderAttributes::requestSize(QObject* caller,std::function<void (qint6
             if(func)
             {
                 func(size);
-                if(size >= 0)
+                if(size >= 0 && isAttributeFinal(AttributeTypes::Size))
                 {
                     requestFinish(AttributeTypes::Size);
                 }
@@ -60,7 +61,7 @@ void FileFolderAttributes::requestModifiedTime(QObject* caller, std::function<vo
             if(func)
             {
                 func(time);
-                if(time.isValid())
+                if(time.isValid() && isAttributeFinal(AttributeTypes::ModifiedTime))
                 {
                     requestFinish(AttributeTypes::ModifiedTime);
                 }
@@ -100,6 +101,11 @@ void FileFolderAttributes::requestCRC(QObject *caller, std::function<void (const
     }
 }
 
+QString FileFolderAttributes::calculateCRC()
+{
+    return mFp;
+}
+
 void FileFolderAttributes::cancel()
 {
     mCancelled = true;
@@ -138,6 +144,11 @@ bool FileFolderAttributes::attributeNeedsUpdate(int type)
     return false;
 }
 
+bool FileFolderAttributes::isAttributeFinal(int) const
+{
+    return true;
+}
+
 void FileFolderAttributes::requestFinish(int type)
 {
     auto contextObject = mRequests.take(type);
@@ -164,16 +175,19 @@ QObject *FileFolderAttributes::requestReady(int type, QObject *caller)
 //LOCAL
 LocalFileFolderAttributes::LocalFileFolderAttributes(const QString &path, QObject *parent)
     : FileFolderAttributes(parent),
-      mPath(path)
+      mPath(path),
+      mIsEmpty(false),
+      mScanId(0),
+      mScanRunning(false),
+      mScanHasAnonymousRequest(false),
+      mCRCRunning(false)
 {
-    connect(&mModifiedTimeWatcher, &QFutureWatcher<QDateTime>::finished,
-            this, &LocalFileFolderAttributes::onModifiedTimeCalculated);
-
-    connect(&mFolderSizeFuture, &QFutureWatcher<qint64>::finished,
-            this, &LocalFileFolderAttributes::onSizeCalculated);
+}
 
-    QDirIterator filesIt(mPath, QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
-    mIsEmpty = !filesIt.hasNext();
+LocalFileFolderAttributes::~LocalFileFolderAttributes()
+{
+    mScanToken.cancel();
+    mCRCToken.cancel();
 }
 
 void LocalFileFolderAttributes::requestSize(QObject* caller,std::function<void(qint64)> func)
@@ -189,15 +203,13 @@ void LocalFileFolderAttributes::requestSize(QObject* caller,std::function<void(q
             {
                 mSize = fileInfo.size();
             }
-            else
+            else if(!fileInfo.isReadable())
             {
-                if(mSize <= Status::NOT_READY)
-                {
-                    auto future = QtConcurrent::run([this]() -> qint64{
-                        return calculateSize();
-                    });
-                    mFolderSizeFuture.setFuture(future);
-                }
+                mSize = Status::NOT_READABLE;
+            }
+            else if(mSize <= Status::NOT_READY)
+            {
+                startScan(caller);
             }
         }
         else
@@ -227,17 +239,7 @@ void LocalFileFolderAttributes::requestModifiedTime(QObject* caller,std::functio
             //Is local folder
             else
             {
-                if(mIsEmpty)
-                {
-                    requestCreatedTime(caller,func);
-                }
-                else
-                {
-                    auto future = QtConcurrent::run([this]() -> QDateTime{
-                        return calculateModifiedTime();
-                    });
-                    mModifiedTimeWatcher.setFuture(future);
-                }
+                startScan(caller);
             }
         }
     }
@@ -246,19 +248,103 @@ void LocalFileFolderAttributes::requestModifiedTime(QObject* caller,std::functio
     emit modifiedTimeReady(mModifiedTime);
 }
 
-void LocalFileFolderAttributes::onModifiedTimeCalculated()
+void LocalFileFolderAttributes::startScan(QObject* caller)
 {
-    mModifiedTime = mModifiedTimeWatcher.result();
-    if(mModifiedTime.isValid())
+    if(caller)
     {
-        emit modifiedTimeReady(mModifiedTime);
+        //The scan is stopped when every caller waiting for it is gone (i.e. the dialog is closed)
+        for(auto type : {AttributeTypes::Size, AttributeTypes::ModifiedTime})
+        {
+            auto context(mRequests.value(type));
+            if(context)
+            {
+                connect(context, &QObject::destroyed, this, &LocalFileFolderAttributes::onRequestContextDestroyed, Qt::UniqueConnection);
+            }
+        }
     }
+    else
+    {
+        mScanHasAnonymousRequest = true;
+    }
+
+    if(mScanRunning)
+    {
+        return;
+    }
+
+    mScanRunning = true;
+    auto scanId(++mScanId);
+    QPointer<LocalFileFolderAttributes> attributes(this);
+    mScanToken = LocalAttributesScanner::scan(mPath, [attributes, scanId](const LocalAttributesScanner::Result& result, bool finished)
+    {
+        Utilities::queueFunctionInAppThread([attributes, scanId, result, finished]()
+        {
+            if(attributes && attributes->mScanId == scanId)
+            {
+                attributes->onScanProgress(result.size, result.fileCount, result.lastModifiedTime, finished);
+            }
+        });
+    });
 }
 
-void LocalFileFolderAttributes::onSizeCalculated()
+void LocalFileFolderAttributes::onScanProgress(qint64 size, int fileCount, qint64 lastModifiedTime, bool finished)
 {
-    mSize = mFolderSizeFuture.result();
+    if(finished)
+    {
+        mScanRunning = false;
+        mScanHasAnonymousRequest = false;
+        mIsEmpty = (fileCount == 0);
+    }
+
+    mSize = size;
     emit sizeReady(mSize);
+
+    if(lastModifiedTime >= 0)
+    {
+        mModifiedTime = QDateTime::fromMSecsSinceEpoch(lastModifiedTime);
+        emit modifiedTimeReady(mModifiedTime);
+    }
+    else if(mIsEmpty)
+    {
+        updateCreatedTime();
+        mModifiedTime = mCreatedTime;
+        emit modifiedTimeReady(mModifiedTime);
+    }
+}
+
+void LocalFileFolderAttributes::onRequestContextDestroyed()
+{
+    if(!mScanRunning || mScanHasAnonymousRequest)
+    {
+        return;
+    }
+
+    for(auto type : {AttributeTypes::Size, AttributeTypes::ModifiedTime})
+    {
+        if(mRequests.value(type))
+        {
+            return;
+        }
+        //So new callers can request the attribute again
+        mRequests.remove(type);
+    }
+
+    stopScan();
+}
+
+void LocalFileFolderAttributes::stopScan()
+{
+    if(mScanRunning)
+    {
+        mScanToken.cancel();
+        mScanRunning = false;
+        mScanHasAnonymousRequest = false;
+        ++mScanId;
+
+        //So the next request starts a new scan
+        mRequestTimestamps.remove(AttributeTypes::Size);
+        mRequestTimestamps.remove(AttributeTypes::ModifiedTime);
+    }
 }
 
 void LocalFileFolderAttributes::requestCreatedTime(QObject* caller,std::function<void(const QDateTime&)> func)
@@ -271,24 +357,7 @@ void LocalFileFolderAttributes::requestCreatedTime(QObject* caller,std::function
         QFileInfo fileInfo(mPath);
         if(fileInfo.exists())
         {
-#ifdef Q_OS_WINDOWS
-            struct stat result;
-            const QString sourcePath = mPath;
-            QVarLengthArray<wchar_t, MAX_PATH + 1> file(sourcePath.length() + 2);
-            sourcePath.toWCharArray(file.data());
-            file[sourcePath.length()] = wchar_t{};
-            file[sourcePath.length() + 1] = wchar_t{};
-            if(_wstat(file.constData(), &result)==0)
-            {
-                mCreatedTime = QDateTime::fromSecsSinceEpoch(result.st_ctime);
-            }
-#elif defined(Q_OS_MACOS)
-            struct stat the_time;
-            stat(mPath.toUtf8(), &the_time);
-            mCreatedTime.setTime_t(the_time.st_birthtimespec.tv_sec);
-#elif defined(Q_OS_LINUX)
-            mCreatedTime = QDateTime::fromSecsSinceEpoch(0);
-#endif
+            updateCreatedTime();
             if(!fileInfo.isFile())
             {
                 if(mIsEmpty)
@@ -302,6 +371,28 @@ void LocalFileFolderAttributes::requestCreatedTime(QObject* caller,std::function
     }
 }
 
+void LocalFileFolderAttributes::updateCreatedTime()
+{
+#ifdef Q_OS_WINDOWS
+    struct stat result;
+    const QString sourcePath = mPath;
+    QVarLengthArray<wchar_t, MAX_PATH + 1> file(sourcePath.length() + 2);
+    sourcePath.toWCharArray(file.data());
+    file[sourcePath.length()] = wchar_t{};
+    file[sourcePath.length() + 1] = wchar_t{};
+    if(_wstat(file.constData(), &result)==0)
+    {
+        mCreatedTime = QDateTime::fromSecsSinceEpoch(result.st_ctime);
+    }
+#elif defined(Q_OS_MACOS)
+    struct stat the_time;
+    stat(mPath.toUtf8(), &the_time);
+    mCreatedTime.setTime_t(the_time.st_birthtimespec.tv_sec);
+#elif defined(Q_OS_LINUX)
+    mCreatedTime = QDateTime::fromSecsSinceEpoch(0);
+#endif
+}
+
 void LocalFileFolderAttributes::requestCRC(QObject *caller, std::function<void (const QString &)> func)
 {
     FileFolderAttributes::requestCRC(caller,func);
@@ -310,71 +401,80 @@ void LocalFileFolderAttributes::requestCRC(QObject *caller, std::function<void (
     {
         QFileInfo fileInfo(mPath);
 
-        if(fileInfo.exists())
+        //The file is read in a worker, CRCReady is emitted when it finishes
+        if(fileInfo.exists() && fileInfo.isFile())
         {
-            if(fileInfo.isFile())
+            if(!mCRCRunning)
             {
-                std::unique_ptr<char[]> crc(MegaSyncApp->getMegaApi()->getCRC(QDir::toNativeSeparators(fileInfo.filePath()).toUtf8().constData()));
-                mFp = QString::fromUtf8(crc.get());
+                mCRCRunning = true;
+                mCRCToken = ThreadPool::CancellationToken();
+                auto filePath(QDir::toNativeSeparators(fileInfo.filePath()));
+                QPointer<LocalFileFolderAttributes> attributes(this);
+                ThreadPoolSingleton::getInstance()->push([attributes, filePath]()
+                {
+                    std::unique_ptr<char[]> crc(MegaSyncApp->getMegaApi()->getCRC(filePath.toUtf8().constData()));
+                    auto fp(QString::fromUtf8(crc.get()));
+                    Utilities::queueFunctionInAppThread([attributes, fp]()
+                    {
+                        if(attributes && attributes->mCRCRunning)
+                        {
+                            attributes->mCRCRunning = false;
+                            attributes->mFp = fp;
+                            emit attributes->CRCReady(fp);
+                        }
+                    });
+                }, ThreadPool::Lane::BULK_IO, mCRCToken);
             }
-
         }
-
-        emit CRCReady(mFp);
+        else
+        {
+            emit CRCReady(mFp);
+        }
     }
 }
 
-QDateTime LocalFileFolderAttributes::calculateModifiedTime()
+QString LocalFileFolderAttributes::calculateCRC()
 {
-    QDateTime newDate;
-    QDirIterator filesIt(mPath, QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
-
-    while (filesIt.hasNext())
+    QFileInfo fileInfo(mPath);
+    if(!mPath.isEmpty() && fileInfo.exists() && fileInfo.isFile())
     {
-        if(mCancelled)
-        {
-            break;
-        }
-
-        filesIt.next();
-        if(filesIt.fileInfo().lastModified() > newDate)
-        {
-            newDate = filesIt.fileInfo().lastModified();
-        }
+        std::unique_ptr<char[]> crc(MegaSyncApp->getMegaApi()->getCRC(QDir::toNativeSeparators(fileInfo.filePath()).toUtf8().constData()));
+        mFp = QString::fromUtf8(crc.get());
     }
 
-    return newDate;
+    return mFp;
 }
 
-qint64 LocalFileFolderAttributes::calculateSize()
+void LocalFileFolderAttributes::cancel()
 {
-    qint64 newSize(0);
+    FileFolderAttributes::cancel();
 
-    QFileInfo fileInfo(mPath);
-    if(!fileInfo.isReadable())
+    stopScan();
+    if(mCRCRunning)
     {
-        newSize = NOT_READABLE;
+        mCRCToken.cancel();
+        mCRCRunning = false;
     }
-    if(!mPath.isEmpty() && fileInfo.exists())
-    {
-        QDirIterator filesIt(mPath, QDir::Files| QDir::NoDotAndDotDot | QDir::NoSymLinks | QDir::Hidden, QDirIterator::Subdirectories);
+}
 
-        while (filesIt.hasNext())
-        {
-            filesIt.next();
-            newSize += filesIt.fileInfo().size();
-        }
+bool LocalFileFolderAttributes::isAttributeFinal(int type) const
+{
+    if(type == AttributeTypes::Size || type == AttributeTypes::ModifiedTime)
+    {
+        return !mScanRunning;
     }
 
-    return newSize;
+    return true;
 }
 
 void LocalFileFolderAttributes::setPath(const QString &newPath)
 {
     if(mPath != newPath)
     {
+        stopScan();
         mPath = newPath;
         mSize = NOT_READY;
+        mIsEmpty = false;
         //initAllAttributes();
         mRequestTimestamps.clear();
         mRequests.clear();
@@ -552,6 +652,11 @@ void RemoteFileFolderAttributes::requestCRC(QObject *caller, std::function<void
 {
     FileFolderAttributes::requestCRC(caller, func);
 
+    emit CRCReady(calculateCRC());
+}
+
+QString RemoteFileFolderAttributes::calculateCRC()
+{
     std::unique_ptr<mega::MegaNode> node = getNode();
     if(node)
     {
@@ -566,7 +671,7 @@ void RemoteFileFolderAttributes::requestCRC(QObject *caller, std::function<void
         }
     }
 
-    emit CRCReady(mFp);
+    return mFp;
 }
 
 void RemoteFileFolderAttributes::requestUser(QObject *caller, std::function<void (QString, bool)> func)
@@ -2,6 +2,7 @@
 #define FILEFOLDERATTRIBUTES_H
 
 #include <QTMegaRequestListener.h>
+#include <ThreadPool.h>
 
 #include <QDateTime>
 #include <QFutureWatcher>
@@ -52,7 +53,10 @@ public:
     virtual void requestCreatedTime(QObject *caller, std::function<void(const QDateTime&)> func);
     virtual void requestCRC(QObject* caller,std::function<void(const QString&)> func);
 
-    void cancel();
+    //Calculated in the caller thread
+    virtual QString calculateCRC();
+
+    virtual void cancel();
 
     template <class Type>
     static std::shared_ptr<Type> convert(std::shared_ptr<FileFolderAttributes> attributes)
@@ -104,6 +108,8 @@ protected:
     }
 
     bool attributeNeedsUpdate(int type);
+    //The requests are finished with the final values only, not the partial ones
+    virtual bool isAttributeFinal(int type) const;
     QObject* requestReady(int type, QObject* caller);
     void requestFinish(int type);
     QMap<int, QPointer<QObject>> mRequests;
@@ -116,27 +122,41 @@ class LocalFileFolderAttributes : public FileFolderAttributes
 
 public:
     LocalFileFolderAttributes(const QString& path, QObject* parent);
-    ~LocalFileFolderAttributes() override = default;
+    ~LocalFileFolderAttributes() override;
 
     void requestSize(QObject* caller,std::function<void(qint64)> func) override;
     void requestModifiedTime(QObject* caller,std::function<void(const QDateTime&)> func) override;
     void requestCreatedTime(QObject* caller,std::function<void(const QDateTime&)> func) override;
     void requestCRC(QObject* caller,std::function<void(const QString&)> func) override;
 
+    QString calculateCRC() override;
+
+    //Stops the folder scan and the CRC calculation
+    void cancel() override;
+
     void setPath(const QString &newPath);
 
-private slots:
-    void onModifiedTimeCalculated();
-    void onSizeCalculated();
-    
+protected:
+    bool isAttributeFinal(int type) const override;
+
 private:
-    QDateTime calculateModifiedTime();
-    qint64 calculateSize();
+    //The size and modified time of a folder are read in one scan
+    void startScan(QObject* caller);
+    void onScanProgress(qint64 size, int fileCount, qint64 lastModifiedTime, bool finished);
+    void onRequestContextDestroyed();
+    void stopScan();
+    void updateCreatedTime();
 
-    QFutureWatcher<qint64> mFolderSizeFuture;
-    QFutureWatcher<QDateTime> mModifiedTimeWatcher;
     QString mPath;
     bool mIsEmpty;
+    ThreadPool::CancellationToken mScanToken;
+    //Identifies the results of the current scan
+    int mScanId;
+    bool mScanRunning;
+    //A request without caller waits for the scan, so it is not stopped when the callers are gone
+    bool mScanHasAnonymousRequest;
+    ThreadPool::CancellationToken mCRCToken;
+    bool mCRCRunning;
 };
 
 class RemoteFileFolderAttributes : public FileFolderAttributes
@@ -156,6 +176,9 @@ public:
     void requestModifiedTime(QObject* caller,std::function<void(const QDateTime&)> func) override;
     void requestCreatedTime(QObject* caller,std::function<void(const QDateTime&)> func) override;
     void requestCRC(QObject* caller,std::function<void(const QString&)> func) override;
+
+    QString calculateCRC() override;
+
     void requestUser(QObject* caller, std::function<void(QString, bool)> func);
     void requestUser(QObject* caller, mega::MegaHandle currentUser, std::function<void(QString, bool)> func);
     void requestVersions(QObject*, std::function<void(int)> func);
@@ -0,0 +1,352 @@
+#include "FolderSizeScanner.h"
+
+#include "Utilities.h"
+
+#include <QDir>
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFileInfo>
+#endif
+
+#include <chrono>
+
+const long long FolderSizeScanner::PROGRESS_INTERVAL_MS = 250;
+
+namespace
+{
+#ifdef Q_OS_LINUX
+constexpr std::size_t DIRENTS_BUFFER_SIZE = 32 * 1024;
+// In nanoseconds, as the modification times
+constexpr long long RECENT_CHANGE_INTERVAL = 2000000000LL;
+
+long long toNanoseconds(const struct timespec& time)
+{
+    return static_cast<long long>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+long long getCurrentTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return toNanoseconds(now);
+}
+
+bool isDotOrDotDot(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+#else
+// Entries read between two checks of the cancellation
+constexpr int ENTRIES_PER_INTERRUPTION_CHECK = 1000;
+// In milliseconds, as the modification times
+constexpr long long RECENT_CHANGE_INTERVAL = 2000;
+
+long long getCurrentTime()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+#endif
+
+long long getSteadyMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+FolderSizeScanner* FolderSizeScanner::instance()
+{
+    static FolderSizeScanner scanner;
+    return &scanner;
+}
+
+ThreadPool::CancellationToken FolderSizeScanner::scan(const QStringList& folderPaths, ProgressCallback progress)
+{
+    auto scan(std::make_shared<Scan>());
+    scan->progress = std::move(progress);
+    scan->pendingFolders = folderPaths.size();
+
+    auto threadPool(ThreadPoolSingleton::getInstance());
+    if (folderPaths.isEmpty())
+    {
+        threadPool->push([this, scan]()
+        {
+            reportProgress(scan, true);
+        }, ThreadPool::Lane::BULK_IO, scan->token);
+        return scan->token;
+    }
+
+    for (const auto& folderPath : folderPaths)
+    {
+        auto path(QDir::cleanPath(folderPath));
+        std::shared_ptr<CachedFolder> cachedRoot;
+        {
+            std::lock_guard<std::mutex> lock(mCacheMutex);
+            auto& root(mCachedRoots[path]);
+            if (!root)
+            {
+                root = std::make_shared<CachedFolder>();
+            }
+            cachedRoot = root;
+        }
+
+        threadPool->push([this, scan, path, cachedRoot]()
+        {
+            scanFolder(scan, path, cachedRoot);
+        }, ThreadPool::Lane::BULK_IO, scan->token);
+    }
+
+    return scan->token;
+}
+
+void FolderSizeScanner::clearCache()
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    mCachedRoots.clear();
+}
+
+void FolderSizeScanner::scanFolder(const std::shared_ptr<Scan>& scan, const QString& folderPath,
+                                   const std::shared_ptr<CachedFolder>& cachedFolder)
+{
+    if (ThreadPool::isThreadInterrupted())
+    {
+        return;
+    }
+
+    long long filesSize(0);
+    QList<QPair<QString, std::shared_ptr<CachedFolder>>> subfolders;
+
+    auto modificationTime(getModificationTime(folderPath));
+    bool isCached(false);
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        if (modificationTime >= 0 && cachedFolder->modificationTime == modificationTime)
+        {
+            filesSize = cachedFolder->filesSize;
+            for (auto it = cachedFolder->subfolders.cbegin(); it != cachedFolder->subfolders.cend(); ++it)
+            {
+                subfolders.append(qMakePair(it.key(), it.value()));
+            }
+            isCached = true;
+        }
+    }
+
+    if (!isCached)
+    {
+        FolderContents contents;
+        auto isRead(readFolder(folderPath, contents));
+        if (ThreadPool::isThreadInterrupted())
+        {
+            return;
+        }
+
+        // The cached subfolders are kept, so their contents are not read again if they did not change
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        QHash<QString, std::shared_ptr<CachedFolder>> cachedSubfolders;
+        if (isRead)
+        {
+            for (const auto& name : contents.subfolders)
+            {
+                auto cachedSubfolder(cachedFolder->subfolders.value(name));
+                if (!cachedSubfolder)
+                {
+                    cachedSubfolder = std::make_shared<CachedFolder>();
+                }
+                cachedSubfolders.insert(name, cachedSubfolder);
+                subfolders.append(qMakePair(name, cachedSubfolder));
+            }
+            filesSize = contents.filesSize;
+        }
+        // The modification times are not precise enough to tell a recent change from a change made while the
+        // folder was read, so a folder changed recently is read again in the next scan
+        auto isCacheable(isRead && contents.modificationTime < getCurrentTime() - RECENT_CHANGE_INTERVAL);
+        cachedFolder->modificationTime = isCacheable ? contents.modificationTime : -1;
+        cachedFolder->filesSize = filesSize;
+        cachedFolder->subfolders.swap(cachedSubfolders);
+    }
+
+    scan->size += filesSize;
+    scan->pendingFolders += subfolders.size();
+
+    auto threadPool(ThreadPoolSingleton::getInstance());
+    for (const auto& subfolder : subfolders)
+    {
+        auto subfolderPath(folderPath + QLatin1Char('/') + subfolder.first);
+        auto cachedSubfolder(subfolder.second);
+        threadPool->push([this, scan, subfolderPath, cachedSubfolder]()
+        {
+            scanFolder(scan, subfolderPath, cachedSubfolder);
+        }, ThreadPool::Lane::BULK_IO, scan->token);
+    }
+
+    reportProgress(scan, --scan->pendingFolders == 0);
+}
+
+void FolderSizeScanner::reportProgress(const std::shared_ptr<Scan>& scan, bool finished)
+{
+    if (ThreadPool::isThreadInterrupted())
+    {
+        return;
+    }
+
+    if (!finished)
+    {
+        auto now(getSteadyMs());
+        auto nextProgressMs(scan->nextProgressMs.load());
+        if (now < nextProgressMs
+            || !scan->nextProgressMs.compare_exchange_strong(nextProgressMs, now + PROGRESS_INTERVAL_MS))
+        {
+            return;
+        }
+    }
+
+    // A partial size is never reported after the final one
+    std::lock_guard<std::mutex> lock(scan->progressMutex);
+    if (!scan->finished)
+    {
+        scan->finished = finished;
+        scan->progress(scan->size, finished);
+    }
+}
+
+#ifdef Q_OS_LINUX
+bool FolderSizeScanner::readFolder(const QString& folderPath, FolderContents& contents)
+{
+    auto fd(open(QFile::encodeName(folderPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Taken before reading the entries, so a change while reading them is seen in the next scan
+    struct stat folderStat;
+    if (fstat(fd, &folderStat) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    contents.modificationTime = toNanoseconds(folderStat.st_mtim);
+
+    // getdents64 fills the buffer with many entries per call. The files are stat'ed relative to the folder
+    // descriptor, and the symbolic links are not followed
+    alignas(struct dirent64) char buffer[DIRENTS_BUFFER_SIZE];
+    bool isCompleted(true);
+    while (true)
+    {
+        auto bytes(syscall(SYS_getdents64, fd, buffer, sizeof(buffer)));
+        if (bytes <= 0)
+        {
+            isCompleted = (bytes == 0);
+            break;
+        }
+
+        for (long offset = 0; offset < bytes;)
+        {
+            auto entry(reinterpret_cast<const struct dirent64*>(buffer + offset));
+            offset += entry->d_reclen;
+
+            const char* name(entry->d_name);
+            if (isDotOrDotDot(name))
+            {
+                continue;
+            }
+
+            if (entry->d_type == DT_DIR)
+            {
+                contents.subfolders.append(QFile::decodeName(name));
+            }
+            else if (entry->d_type == DT_REG || entry->d_type == DT_UNKNOWN)
+            {
+                struct stat entryStat;
+                if (fstatat(fd, name, &entryStat, AT_SYMLINK_NOFOLLOW) == 0)
+                {
+                    if (S_ISREG(entryStat.st_mode))
+                    {
+                        contents.filesSize += entryStat.st_size;
+                    }
+                    else if (S_ISDIR(entryStat.st_mode))
+                    {
+                        contents.subfolders.append(QFile::decodeName(name));
+                    }
+                }
+            }
+        }
+
+        if (ThreadPool::isThreadInterrupted())
+        {
+            isCompleted = false;
+            break;
+        }
+    }
+
+    close(fd);
+    return isCompleted;
+}
+
+long long FolderSizeScanner::getModificationTime(const QString& folderPath)
+{
+    struct stat folderStat;
+    if (stat(QFile::encodeName(folderPath).constData(), &folderStat) != 0 || !S_ISDIR(folderStat.st_mode))
+    {
+        return -1;
+    }
+    return toNanoseconds(folderStat.st_mtim);
+}
+#else
+bool FolderSizeScanner::readFolder(const QString& folderPath, FolderContents& contents)
+{
+    contents.modificationTime = getModificationTime(folderPath);
+    if (contents.modificationTime < 0)
+    {
+        return false;
+    }
+
+    // QDirIterator does not build the whole list of entries
+    QDirIterator it(folderPath, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
+    int entries(0);
+    while (it.hasNext())
+    {
+        it.next();
+        auto info(it.fileInfo());
+        if (info.isDir())
+        {
+            // Linked folders are not followed, to avoid loops
+            if (!info.isSymLink())
+            {
+                contents.subfolders.append(info.fileName());
+            }
+        }
+        else if (info.isFile())
+        {
+            contents.filesSize += info.size();
+        }
+
+        if (++entries % ENTRIES_PER_INTERRUPTION_CHECK == 0 && ThreadPool::isThreadInterrupted())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+long long FolderSizeScanner::getModificationTime(const QString& folderPath)
+{
+    QFileInfo info(folderPath);
+    if (!info.isDir())
+    {
+        return -1;
+    }
+    return info.lastModified().toMSecsSinceEpoch();
+}
+#endif
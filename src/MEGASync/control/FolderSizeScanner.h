@@ -0,0 +1,77 @@
+#ifndef FOLDERSIZESCANNER_H
+#define FOLDERSIZESCANNER_H
+
+#include "ThreadPool.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/// Responsability: calculate the size of local folder trees in the thread pool.
+/// Every folder is read by its own functor, so the subfolders are scanned in parallel, and the scan stops when
+/// its token is cancelled. The size of the files of each folder is cached with the folder modification time, so
+/// a folder that did not change is not read again (the subfolders are still checked). That time only changes when
+/// an entry is added, removed or renamed, so a file rewritten in place keeps its cached size until its folder
+/// changes. The debris folders get their files moved in, which is what the cache is for.
+class FolderSizeScanner
+{
+public:
+    // Called from the worker threads with the size found so far, at most every PROGRESS_INTERVAL_MS.
+    // The last call has finished == true, unless the scan is cancelled
+    using ProgressCallback = std::function<void(long long size, bool finished)>;
+
+    static FolderSizeScanner* instance();
+
+    ThreadPool::CancellationToken scan(const QStringList& folderPaths, ProgressCallback progress);
+    void clearCache();
+
+private:
+    struct CachedFolder
+    {
+        // -1 when the folder was not read yet
+        long long modificationTime = -1;
+        long long filesSize = 0;
+        QHash<QString, std::shared_ptr<CachedFolder>> subfolders;
+    };
+
+    // The contents of a folder, not recursive
+    struct FolderContents
+    {
+        long long modificationTime = -1;
+        long long filesSize = 0;
+        QStringList subfolders;
+    };
+
+    struct Scan
+    {
+        ProgressCallback progress;
+        ThreadPool::CancellationToken token;
+        std::atomic<long long> size{0};
+        std::atomic<int> pendingFolders{0};
+        std::atomic<long long> nextProgressMs{0};
+        std::mutex progressMutex;
+        bool finished = false;
+    };
+
+    FolderSizeScanner() = default;
+
+    void scanFolder(const std::shared_ptr<Scan>& scan, const QString& folderPath,
+                    const std::shared_ptr<CachedFolder>& cachedFolder);
+    void reportProgress(const std::shared_ptr<Scan>& scan, bool finished);
+
+    // False when the folder can not be read or the scan is interrupted
+    static bool readFolder(const QString& folderPath, FolderContents& contents);
+    static long long getModificationTime(const QString& folderPath);
+
+    static const long long PROGRESS_INTERVAL_MS;
+
+    std::mutex mCacheMutex;
+    QHash<QString, std::shared_ptr<CachedFolder>> mCachedRoots;
+};
+
+#endif // FOLDERSIZESCANNER_H
@@ -0,0 +1,179 @@
+#include "HTTPRequestParser.h"
+
+#include <algorithm>
+
+namespace
+{
+const char HEADERS_END[] = "\r\n\r\n";
+const int HEADERS_END_SIZE = 4;
+}
+
+const int HTTPRequestParser::MAX_HEADERS_SIZE = 64 * 1024;
+const qint64 HTTPRequestParser::MAX_BODY_SIZE = 128 * 1024 * 1024;
+
+QList<QByteArray> HTTPRequestParser::Request::headerValues(const QByteArray& lowerCaseName) const
+{
+    QList<QByteArray> values;
+    for (const auto& header : headers)
+    {
+        if (header.first == lowerCaseName)
+        {
+            values.append(header.second);
+        }
+    }
+    return values;
+}
+
+QByteArray HTTPRequestParser::Request::headerValue(const QByteArray& lowerCaseName) const
+{
+    for (const auto& header : headers)
+    {
+        if (header.first == lowerCaseName)
+        {
+            return header.second;
+        }
+    }
+    return QByteArray();
+}
+
+bool HTTPRequestParser::Request::keepAlive() const
+{
+    auto connection = headerValue("connection").toLower();
+    if (version == "HTTP/1.0")
+    {
+        return connection.contains("keep-alive");
+    }
+    return !connection.contains("close");
+}
+
+HTTPRequestParser::HTTPRequestParser()
+    : mScannedBytes(0),
+      mHeadersSize(-1),
+      mContentLength(0)
+{
+}
+
+void HTTPRequestParser::append(const QByteArray& data)
+{
+    mBuffer.append(data);
+}
+
+HTTPRequestParser::Result HTTPRequestParser::next(Request& request)
+{
+    if (mHeadersSize < 0)
+    {
+        // Empty lines before a request are allowed
+        while (mBuffer.startsWith("\r\n"))
+        {
+            mBuffer.remove(0, 2);
+            mScannedBytes = std::max(0, mScannedBytes - 2);
+        }
+
+        // The end of the headers may have started in the last scanned bytes
+        auto headersEnd = mBuffer.indexOf(HEADERS_END, std::max(0, mScannedBytes - (HEADERS_END_SIZE - 1)));
+        if (headersEnd < 0)
+        {
+            mScannedBytes = mBuffer.size();
+            return mBuffer.size() > MAX_HEADERS_SIZE ? Result::REQUEST_TOO_LARGE : Result::NEED_MORE_DATA;
+        }
+        else if (headersEnd > MAX_HEADERS_SIZE)
+        {
+            return Result::REQUEST_TOO_LARGE;
+        }
+
+        auto result = parseHeaders(headersEnd);
+        if (result != Result::NEED_MORE_DATA)
+        {
+            return result;
+        }
+        mHeadersSize = headersEnd + HEADERS_END_SIZE;
+    }
+
+    if (mBuffer.size() - mHeadersSize < mContentLength)
+    {
+        return Result::NEED_MORE_DATA;
+    }
+
+    mRequest.body = mBuffer.mid(mHeadersSize, static_cast<int>(mContentLength));
+    mBuffer.remove(0, mHeadersSize + static_cast<int>(mContentLength));
+    request = std::move(mRequest);
+
+    mRequest = Request();
+    mScannedBytes = 0;
+    mHeadersSize = -1;
+    mContentLength = 0;
+    return Result::REQUEST_READY;
+}
+
+void HTTPRequestParser::clear()
+{
+    mBuffer.clear();
+    mRequest = Request();
+    mScannedBytes = 0;
+    mHeadersSize = -1;
+    mContentLength = 0;
+}
+
+bool HTTPRequestParser::hasPendingData() const
+{
+    return !mBuffer.isEmpty();
+}
+
+// Returns NEED_MORE_DATA when the headers are valid, as the body may still be incomplete
+HTTPRequestParser::Result HTTPRequestParser::parseHeaders(int headersSize)
+{
+    auto lines = mBuffer.left(headersSize).split('\n');
+
+    auto requestLine = lines.takeFirst();
+    if (requestLine.endsWith('\r'))
+    {
+        requestLine.chop(1);
+    }
+    auto requestLineTokens = requestLine.split(' ');
+    if (requestLineTokens.size() != 3 || !requestLineTokens[2].startsWith("HTTP/1."))
+    {
+        return Result::BAD_REQUEST;
+    }
+    mRequest.method = requestLineTokens[0];
+    mRequest.target = requestLineTokens[1];
+    mRequest.version = requestLineTokens[2];
+
+    for (const auto& line : qAsConst(lines))
+    {
+        auto separator = line.indexOf(':');
+        if (separator <= 0)
+        {
+            return Result::BAD_REQUEST;
+        }
+        mRequest.headers.append(qMakePair(line.left(separator).trimmed().toLower(),
+                                          line.mid(separator + 1).trimmed()));
+    }
+
+    // Chunked bodies are not used by the webclient
+    if (!mRequest.headerValue("transfer-encoding").isEmpty())
+    {
+        return Result::BAD_REQUEST;
+    }
+
+    auto contentLengths = mRequest.headerValues("content-length");
+    mRequest.hasContentLength = !contentLengths.isEmpty();
+    mContentLength = 0;
+    if (mRequest.hasContentLength)
+    {
+        bool ok(false);
+        mContentLength = contentLengths.first().toLongLong(&ok);
+        if (!ok || mContentLength < 0
+            || std::any_of(contentLengths.cbegin(), contentLengths.cend(), [&contentLengths](const QByteArray& value){
+                   return value != contentLengths.first();
+               }))
+        {
+            return Result::BAD_REQUEST;
+        }
+        else if (mContentLength > MAX_BODY_SIZE)
+        {
+            return Result::REQUEST_TOO_LARGE;
+        }
+    }
+
+    return Result::NEED_MORE_DATA;
+}
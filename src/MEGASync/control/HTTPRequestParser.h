@@ -0,0 +1,61 @@
+#ifndef HTTPREQUESTPARSER_H
+#define HTTPREQUESTPARSER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+
+/// Responsability: incremental HTTP/1.x request parser for the local webclient server. The bytes are appended as they
+/// are read from the socket and the end of the headers is only searched in the bytes that were not scanned yet, so a
+/// request received in several reads is not scanned again. Several requests in the same connection (keep-alive and
+/// pipelining) are returned one after another, in order.
+class HTTPRequestParser
+{
+public:
+    enum class Result
+    {
+        NEED_MORE_DATA,
+        REQUEST_READY,
+        BAD_REQUEST,
+        REQUEST_TOO_LARGE
+    };
+
+    struct Request
+    {
+        QByteArray method;
+        QByteArray target;
+        QByteArray version;
+        // Field names in lower case, in the order they were received
+        QList<QPair<QByteArray, QByteArray>> headers;
+        QByteArray body;
+        bool hasContentLength = false;
+
+        QList<QByteArray> headerValues(const QByteArray& lowerCaseName) const;
+        // Empty if the field is missing
+        QByteArray headerValue(const QByteArray& lowerCaseName) const;
+        bool keepAlive() const;
+    };
+
+    static const int MAX_HEADERS_SIZE;
+    static const qint64 MAX_BODY_SIZE;
+
+    HTTPRequestParser();
+
+    void append(const QByteArray& data);
+    // Returns REQUEST_READY and fills request when a whole request has been received
+    Result next(Request& request);
+    void clear();
+
+    bool hasPendingData() const;
+
+private:
+    Result parseHeaders(int headersSize);
+
+    QByteArray mBuffer;
+    int mScannedBytes;
+    int mHeadersSize;
+    qint64 mContentLength;
+    Request mRequest;
+};
+
+#endif // HTTPREQUESTPARSER_H
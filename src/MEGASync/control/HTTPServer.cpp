@@ -14,6 +14,10 @@
 using namespace mega;
 
 const unsigned int HTTPServer::MAX_REQUEST_TIME_SECS = 1800;
+const int HTTPServer::KEEP_ALIVE_TIMEOUT_MS = 60000;
+const int HTTPServer::PROGRESS_PUSH_INTERVAL_MS = 500;
+const qint64 HTTPServer::MAX_PROGRESS_STREAM_BUFFERED_BYTES = 1024 * 1024;
+const QByteArray TRANSFER_PROGRESS_STREAM_PATH("/progress");
 const QString PUBLIC_LINK_START = QString::fromUtf8("https://mega.nz/collection/");
 
 bool ts_comparator(RequestData* i, RequestData *j)
@@ -30,20 +34,9 @@ RequestData::RequestData()
     status = STATE_OPEN;
 }
 
-RequestTransferData::RequestTransferData()
-{
-    state = MegaTransfer::STATE_NONE;
-    progress = 0;
-    size = 0;
-    speed = 0;
-    tsStart = QDateTime::currentMSecsSinceEpoch() / 1000;
-    tsEnd = -1;
-    tPath = QString();
-}
-
 bool HTTPServer::isFirstWebDownloadDone = false;
 QMultiMap<QString, RequestData*> HTTPServer::webDataRequests;
-QMap<mega::MegaHandle, RequestTransferData*> HTTPServer::webTransferStateRequests;
+WebTransferProgressTable HTTPServer::webTransferStateRequests;
 
 HTTPServer::HTTPServer(MegaApi *megaApi, quint16 port)
     : QTcpServer(), disabled(false)
@@ -51,13 +44,13 @@ HTTPServer::HTTPServer(MegaApi *megaApi, quint16 port)
     this->megaApi = megaApi;
     listen(QHostAddress::LocalHost, port);
 
-    connect(&mVersionCommandWatcher, &QFutureWatcher<VersionCommandAnswer>::finished,
-            this, &HTTPServer::onVersionCommandFinished);
+    progressPushTimer.setInterval(PROGRESS_PUSH_INTERVAL_MS);
+    connect(&progressPushTimer, &QTimer::timeout, this, &HTTPServer::pushTransferProgress);
 }
 
 HTTPServer::~HTTPServer()
 {
-
+    qDeleteAll(connections);
 }
 
 void HTTPServer::incomingConnection(qintptr socket)
@@ -75,7 +68,14 @@ void HTTPServer::incomingConnection(qintptr socket)
     connect(s, SIGNAL(disconnected()), this, SLOT(discardClient()));
 
     s->setSocketDescriptor(socket);
-    requests.insert(s, new HTTPRequest());
+
+    // Persistent connections are closed when they are idle for a while
+    HTTPConnection* connection = new HTTPConnection();
+    connection->idleTimer.setSingleShot(true);
+    connection->idleTimer.setInterval(KEEP_ALIVE_TIMEOUT_MS);
+    connect(&connection->idleTimer, &QTimer::timeout, s, &QAbstractSocket::disconnectFromHost);
+    connection->idleTimer.start();
+    connections.insert(s, connection);
 }
 
 void HTTPServer::pause()
@@ -105,22 +105,7 @@ void HTTPServer::checkAndPurgeRequests()
         }
     }
 
-    for (QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.begin() ; it != webTransferStateRequests.end();)
-    {
-        RequestTransferData *transferData = it.value();
-        if ((transferData->state == MegaTransfer::STATE_CANCELLED
-             || transferData->state == MegaTransfer::STATE_COMPLETED
-             || transferData->state == MegaTransfer::STATE_FAILED)
-                && (((QDateTime::currentMSecsSinceEpoch() / 1000) - transferData->tsEnd) > MAX_REQUEST_TIME_SECS))
-        {
-            webTransferStateRequests.erase(it++);
-            delete transferData;
-        }
-        else
-        {
-            it++;
-        }
-    }
+    webTransferStateRequests.purgeExpired(QDateTime::currentMSecsSinceEpoch() / 1000, MAX_REQUEST_TIME_SECS);
 }
 
 void HTTPServer::onUploadSelectionAccepted(int files, int folders)
@@ -151,8 +136,7 @@ void HTTPServer::onUploadSelectionDiscarded()
 
 void HTTPServer::onTransferDataUpdate(MegaHandle handle, int state, long long progress, long long size, long long speed, QString localPath)
 {
-    QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(handle);
-    if (it == webTransferStateRequests.end())
+    if (!webTransferStateRequests.contains(handle))
     {
         return;
     }
@@ -164,47 +148,63 @@ void HTTPServer::onTransferDataUpdate(MegaHandle handle, int state, long long pr
     }
     #endif
 
-    RequestTransferData* tData = it.value();
-    tData->state = state;
-    tData->progress = progress;
-    tData->size = size;
-    tData->speed = speed;
-
-    if (!localPath.isEmpty() && tData->tPath != localPath)
-    {
-        tData->tPath = localPath;
-    }
-
-    if (state == MegaTransfer::STATE_CANCELLED
-            || state == MegaTransfer::STATE_COMPLETED
-            || state == MegaTransfer::STATE_FAILED)
-    {
-        tData->tsEnd = QDateTime::currentMSecsSinceEpoch() / 1000;
-    }
+    webTransferStateRequests.update(handle, state, progress, size, speed, localPath,
+                                    QDateTime::currentMSecsSinceEpoch() / 1000);
 }
 
 void HTTPServer::readClient()
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Processing webclient request via HTTP").toUtf8().constData());
     QAbstractSocket *socket = (QAbstractSocket*)sender();
-    HTTPRequest *request = requests.value(socket);
-    if (disabled || !request)
+    HTTPConnection *connection = connections.value(socket);
+    if (disabled || !connection)
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Webclient request not found");
         discardClient();
         return;
     }
 
-    QByteArray socketData = socket->readAll();
-    request->data.append(QString::fromUtf8(socketData.data()));
-    if (request->data.contains(QString::fromUtf8("\r\n\r\n")))
+    connection->parser.append(socket->readAll());
+    processPendingRequests(socket);
+}
+
+void HTTPServer::processPendingRequests(QAbstractSocket* socket)
+{
+    QPointer<QAbstractSocket> safeSocket = socket;
+    QPointer<HTTPServer> safeServer = this;
+
+    HTTPConnection *connection = connections.value(socket);
+    while (connection && !connection->busy && !disabled)
     {
-        QStringList tokens = request->data.split(QString::fromUtf8("\r\n\r\n"));
-        QStringList headers = tokens[0].split(QString::fromUtf8("\r\n"));
-        bool requestIsPost = isRequestOfType(headers, "POST");
-        bool requestIsOption = isRequestOfType(headers, "OPTION");
+        HTTPRequestParser::Request parsedRequest;
+        auto result = connection->parser.next(parsedRequest);
+        if (result == HTTPRequestParser::Result::NEED_MORE_DATA)
+        {
+            return;
+        }
+        else if (result == HTTPRequestParser::Result::BAD_REQUEST)
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Malformed webclient request");
+            rejectRequest(socket, QString::fromUtf8("400 Bad Request"));
+            return;
+        }
+        else if (result == HTTPRequestParser::Result::REQUEST_TOO_LARGE)
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Webclient request too large");
+            rejectRequest(socket, QString::fromUtf8("413 Payload Too Large"));
+            return;
+        }
+
+        connection->busy = true;
+        connection->idleTimer.stop();
 
-        if (!headers.size() || (!requestIsPost && !requestIsOption))
+        HTTPRequest request;
+        request.keepAlive = parsedRequest.keepAlive();
+        bool requestIsPost = parsedRequest.method == "POST";
+        bool requestIsOption = parsedRequest.method == "OPTIONS";
+        bool requestIsProgressStream = parsedRequest.method == "GET" && parsedRequest.target == TRANSFER_PROGRESS_STREAM_PATH;
+
+        if (!requestIsPost && !requestIsOption && !requestIsProgressStream)
         {
             MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Method not allowed for webclient request");
             rejectRequest(socket, QString::fromUtf8("405 Method Not Allowed"));
@@ -213,10 +213,10 @@ void HTTPServer::readClient()
 
         if (Preferences::HTTPS_ORIGIN_CHECK_ENABLED && !Preferences::HTTPS_ALLOWED_ORIGINS.isEmpty())
         {
-            QString foundOrigin = findCorrespondingAllowedOrigin(headers);
+            QString foundOrigin = findCorrespondingAllowedOrigin(parsedRequest);
             if (!foundOrigin.isEmpty())
             {
-                request->origin = foundOrigin;
+                request.origin = foundOrigin;
             }
             else
             {
@@ -226,42 +226,86 @@ void HTTPServer::readClient()
             }
         }
 
-        if (requestIsPost)
+        if (requestIsProgressStream)
+        {
+            // The connection is only used for the stream from now on
+            subscribeToTransferProgress(socket, request);
+            return;
+        }
+        else if (requestIsPost)
         {
-            processPostRequest(socket, request, headers, tokens[1]);
+            processPostRequest(socket, request, parsedRequest);
         }
         else // requestIsOption
         {
-            processOptionRequest(socket, request, headers);
+            processOptionRequest(socket, request, parsedRequest);
+        }
+
+        if (!safeServer || !safeSocket)
+        {
+            return;
         }
+
+        // Synchronous requests are already answered, so the next pipelined request can be processed now
+        connection = connections.value(socket);
     }
 }
+
 void HTTPServer::discardClient()
 {
     QAbstractSocket* socket = (QSslSocket*)sender();
     socket->deleteLater();
-
-    HTTPRequest *request = requests.value(socket);
-    if (request)
-    {
-        requests.remove(socket);
-        delete request;
-    }
+    removeConnection(socket);
 }
 
 void HTTPServer::rejectRequest(QAbstractSocket *socket, QString response)
 {
-    socket->write(QString::fromUtf8("HTTP/1.0 %1\r\n"
+    // Same protocol version as the other responses, but the connection is not kept
+    socket->write(QString::fromUtf8("HTTP/1.1 %1\r\n"
+                  "Content-Length: 0\r\n"
+                  "Connection: close\r\n"
                   "\r\n").arg(response).toUtf8());
     socket->flush();
     socket->disconnectFromHost();
     socket->deleteLater();
+    removeConnection(socket);
+}
 
-    HTTPRequest *request = requests.value(socket);
-    if (request)
+void HTTPServer::removeConnection(QAbstractSocket* socket)
+{
+    HTTPConnection *connection = connections.take(socket);
+    if (connection)
     {
-        requests.remove(socket);
-        delete request;
+        delete connection;
+    }
+}
+
+void HTTPServer::finishResponse(QAbstractSocket* socket, bool keepAlive)
+{
+    socket->flush();
+
+    HTTPConnection *connection = connections.value(socket);
+    if (!keepAlive || !connection || disabled)
+    {
+        socket->disconnectFromHost();
+        socket->deleteLater();
+        return;
+    }
+
+    connection->busy = false;
+    connection->idleTimer.start();
+
+    // Requests received while this one was processed asynchronously
+    if (connection->parser.hasPendingData())
+    {
+        QPointer<QAbstractSocket> safeSocket = socket;
+        QTimer::singleShot(0, this, [this, safeSocket]()
+        {
+            if (safeSocket)
+            {
+                processPendingRequests(safeSocket);
+            }
+        });
     }
 }
 
@@ -341,18 +385,18 @@ void HTTPServer::endProcessRequest(QPointer<QAbstractSocket> socket,const HTTPRe
             MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Response to HTTP request: %1").arg(response).toUtf8().constData());
         }
 
-        QString fullResponse = QString::fromUtf8("HTTP/1.0 200 Ok\r\n"
+        QByteArray content = response.toUtf8();
+        QString fullResponse = QString::fromUtf8("HTTP/1.1 200 OK\r\n"
                                                  "Access-Control-Allow-Origin: %1\r\n"
                                                  "Content-Type: text/html; charset=\"utf-8\"\r\n"
                                                  "Content-Length: %2\r\n"
-                                                 "\r\n"
-                                                 "%3").arg(request.origin).arg(response.size()).arg(response);
+                                                 "Connection: %3\r\n"
+                                                 "\r\n").arg(request.origin).arg(content.size())
+                                                          .arg(QString::fromUtf8(request.keepAlive ? "keep-alive" : "close"));
         if (safeServer && socket)
         {
-            socket->write(fullResponse.toUtf8());
-            socket->flush();
-            socket->disconnectFromHost();
-            socket->deleteLater();
+            socket->write(fullResponse.toUtf8() + content);
+            finishResponse(socket, request.keepAlive);
         }
     }
 }
@@ -383,14 +427,16 @@ void HTTPServer::versionCommand(const HTTPRequest& request, QPointer<QAbstractSo
         return answer;
     });
 
-    mVersionCommandWatcher.setFuture(future);
-}
-
-void HTTPServer::onVersionCommandFinished()
-{
-    auto answer = mVersionCommandWatcher.result();
+    // One watcher per request, as several keep-alive connections can ask for the version at the same time
+    auto watcher = new QFutureWatcher<VersionCommandAnswer>(this);
+    connect(watcher, &QFutureWatcher<VersionCommandAnswer>::finished, this, [this, watcher]()
+    {
+        auto answer = watcher->result();
+        watcher->deleteLater();
 
-    endProcessRequest(answer.socket, answer.request, answer.response);
+        endProcessRequest(answer.socket, answer.request, answer.response);
+    });
+    watcher->setFuture(future);
 }
 
 void HTTPServer::openLinkRequest(QString &response, const HTTPRequest& request)
@@ -414,12 +460,7 @@ void HTTPServer::openLinkRequest(QString &response, const HTTPRequest& request)
         auto preferences = Preferences::instance();
         QString defaultPath = preferences->downloadFolder();
         MegaHandle megaHandle = megaApi->base64ToHandle(handle.toUtf8().constData());
-        QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(megaHandle);
-        if (it != webTransferStateRequests.end())
-        {
-            delete it.value();
-        }
-        webTransferStateRequests.insert(megaHandle, new RequestTransferData());
+        webTransferStateRequests.track(megaHandle);
 
         if (preferences->hasDefaultDownloadFolder() && QFile(defaultPath).exists())
         {
@@ -565,12 +606,7 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                                                          publicAuthArray.constData(),
                                                          chatAuth.isEmpty() ? nullptr :  chatAuthArray.constData());
                         downloadQueue.append(new WrappedNode(WrappedNode::TransferOrigin::FROM_WEBSERVER, node, undelete));
-                        QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(h);
-                        if (it != webTransferStateRequests.end())
-                        {
-                            delete it.value();
-                        }
-                        webTransferStateRequests.insert(h, new RequestTransferData());
+                        webTransferStateRequests.track(h);
                     }
                     else
                     {
@@ -824,26 +860,119 @@ void HTTPServer::externalTransferQueryProgress(QString &response, const HTTPRequ
     }
     else
     {
-        if (!webTransferStateRequests.contains(handle))
+        const RequestTransferData* tData = webTransferStateRequests.value(handle);
+        if (!tData)
         {
             response = QString::number(MegaError::API_ENOENT);
         }
         else
         {
-            RequestTransferData* tData = webTransferStateRequests.value(handle);
-            if (tData->state == MegaTransfer::STATE_NONE)
-            {
-                response = QString::fromUtf8("{\"s\":%1}").arg(tData->state);
-            }
-            else
-            {
-                response = QString::fromUtf8("{\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4}")
-                        .arg(tData->state)
-                        .arg(tData->progress)
-                        .arg(tData->size)
-                        .arg(tData->speed);
-            }
+            response = QString::fromUtf8("{%1}").arg(transferProgressJson(tData));
+        }
+    }
+}
+
+QString HTTPServer::transferProgressJson(const RequestTransferData* tData)
+{
+    if (tData->state == MegaTransfer::STATE_NONE)
+    {
+        return QString::fromUtf8("\"s\":%1").arg(tData->state);
+    }
+
+    return QString::fromUtf8("\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4")
+            .arg(tData->state)
+            .arg(tData->progress)
+            .arg(tData->size)
+            .arg(tData->speed);
+}
+
+void HTTPServer::subscribeToTransferProgress(QAbstractSocket* socket, const HTTPRequest& request)
+{
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Transfer progress stream requested by the webclient");
+
+    QString headers = QString::fromUtf8("HTTP/1.1 200 OK\r\n"
+                                        "Access-Control-Allow-Origin: %1\r\n"
+                                        "Content-Type: text/event-stream\r\n"
+                                        "Cache-Control: no-cache\r\n"
+                                        "Connection: keep-alive\r\n"
+                                        "\r\n").arg(request.origin);
+    socket->write(headers.toUtf8());
+
+    // The first event has every tracked transfer, the next ones only the changes
+    bool firstSubscriber = progressSubscribers.isEmpty();
+    progressSubscribers.append(socket);
+    if (firstSubscriber)
+    {
+        webTransferStateRequests.clearChangedHandles();
+        progressPushTimer.start();
+    }
+
+    QList<MegaHandle> handles = webTransferStateRequests.handles();
+    if (!handles.isEmpty())
+    {
+        socket->write(transferProgressEvent(handles));
+    }
+    socket->flush();
+}
+
+QByteArray HTTPServer::transferProgressEvent(const QList<MegaHandle>& handles)
+{
+    QStringList transfers;
+    for (auto handle : handles)
+    {
+        const RequestTransferData* tData = webTransferStateRequests.value(handle);
+        if (tData)
+        {
+            std::unique_ptr<char[]> base64Handle(MegaApi::handleToBase64(handle));
+            transfers.append(QString::fromUtf8("{\"h\":\"%1\",%2}")
+                             .arg(QString::fromUtf8(base64Handle.get()), transferProgressJson(tData)));
+        }
+    }
+
+    if (transfers.isEmpty())
+    {
+        return QByteArray();
+    }
+    return QString::fromUtf8("event: progress\ndata: [%1]\n\n").arg(transfers.join(QLatin1Char(','))).toUtf8();
+}
+
+void HTTPServer::pushTransferProgress()
+{
+    progressSubscribers.erase(std::remove_if(progressSubscribers.begin(), progressSubscribers.end(),
+                                             [](const QPointer<QAbstractSocket>& socket){
+        return !socket || socket->state() != QAbstractSocket::ConnectedState;
+    }), progressSubscribers.end());
+
+    if (progressSubscribers.isEmpty())
+    {
+        progressPushTimer.stop();
+        return;
+    }
+
+    // Coalesced: one event with the last state of the transfers updated since the previous push
+    QByteArray event = transferProgressEvent(webTransferStateRequests.takeChangedHandles());
+    if (event.isEmpty())
+    {
+        return;
+    }
+
+    // Copied, as closing a subscriber changes the list
+    const auto subscribers = progressSubscribers;
+    for (const auto& socket : subscribers)
+    {
+        // The events only carry the changes, so a subscriber that does not keep up is closed instead of
+        // skipping some of them. The webclient gets every transfer again when it subscribes again
+        if (socket->bytesToWrite() > MAX_PROGRESS_STREAM_BUFFERED_BYTES)
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Transfer progress stream closed: %1 bytes not sent")
+                         .arg(socket->bytesToWrite()).toUtf8().constData());
+            progressSubscribers.removeAll(socket);
+            socket->abort();
+            continue;
         }
+
+        socket->write(event);
+        socket->flush();
     }
 }
 
@@ -863,13 +992,13 @@ void HTTPServer::externalShowInFolder(QString &response, const HTTPRequest& requ
     }
     else
     {
-        if (!webTransferStateRequests.contains(handle))
+        const RequestTransferData* tData = webTransferStateRequests.value(handle);
+        if (!tData)
         {
             response = QString::number(MegaError::API_ENOENT);
         }
         else
         {
-            RequestTransferData* tData = webTransferStateRequests.value(handle);
             if (!tData->tPath.isNull())
             {
                 if (QFile(tData->tPath).exists())
@@ -1000,71 +1129,40 @@ HTTPServer::RequestType HTTPServer::GetRequestType(const HTTPRequest &request)
     return UNKNOWN_REQUEST;
 }
 
-QString HTTPServer::findCorrespondingAllowedOrigin(const QStringList& headers)
+QString HTTPServer::findCorrespondingAllowedOrigin(const HTTPRequestParser::Request& parsedRequest)
 {
+    const auto origins = parsedRequest.headerValues("origin");
     for (const QString& allowedOrigin : qAsConst(Preferences::HTTPS_ALLOWED_ORIGINS))
     {
-        QRegExp check = QRegExp(QString::fromUtf8("Origin: %1").arg(allowedOrigin),
-                                Qt::CaseSensitive, QRegExp::Wildcard);
-        for (const QString& header : headers)
+        QRegExp check = QRegExp(allowedOrigin, Qt::CaseSensitive, QRegExp::Wildcard);
+        for (const QByteArray& origin : origins)
         {
-            if (check.exactMatch(header))
+            QString originString = QString::fromUtf8(origin);
+            if (check.exactMatch(originString))
             {
-               return header.mid(8);
+               return originString;
             }
         }
     }
     return QString();
 }
 
-void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* request,
-                                    const QStringList& headers, const QString& content)
+void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest& request, const HTTPRequestParser::Request& parsedRequest)
 {
-    QString contentLengthId = QString::fromUtf8("Content-length: ");
-    QStringList contentLengthHeader = headers.filter(QRegExp(contentLengthId, Qt::CaseInsensitive));
-    if (!contentLengthHeader.size())
+    if (!parsedRequest.hasContentLength)
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Missing Content-length header");
         rejectRequest(socket);
         return;
     }
 
-    bool ok;
-    request->contentLength = contentLengthHeader[0].mid(contentLengthId.size(), contentLengthHeader[0].size() - contentLengthId.size()).toInt(&ok);
-    if (!ok || request->contentLength < content.size())
-    {
-        if (!ok)
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Unable to parse Content-length header: %1")
-                         .arg(contentLengthHeader[0]).toUtf8().constData());
-        }
-        else
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Invalid Content-length header. Header: %1 - Data: %2")
-                         .arg(request->contentLength).arg(content.size()).toUtf8().constData());
-        }
-        rejectRequest(socket);
-        return;
-    }
-
-    if (request->contentLength > content.size())
-    {
-        return;
-    }
-
-    request->data = content;
+    request.contentLength = parsedRequest.body.size();
+    request.data = QString::fromUtf8(parsedRequest.body);
 
-
-    QPointer<QAbstractSocket> safeSocket = socket;
-    QPointer<HTTPServer> safeServer = this;
-    processRequest(socket, *request);
-    if (!safeServer || !safeSocket)
-    {
-        return;
-    }
+    processRequest(socket, request);
 }
 
-void HTTPServer::sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* request, bool sendPrivateNetworkField)
+void HTTPServer::sendPreFlightResponse(QAbstractSocket* socket, const HTTPRequest& request, bool sendPrivateNetworkField)
 {
     QPointer<QAbstractSocket> safeSocket = socket;
     QPointer<HTTPServer> safeServer = this;
@@ -1072,69 +1170,62 @@ void HTTPServer::sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* req
     QString fullResponse = QString::fromUtf8("HTTP/1.1 204 No Content\r\n"
                                              "Server: MegaSync HTTP Server\r\n"
                                              "Access-Control-Allow-Origin: %1\r\n"
-                                             "Access-Control-Allow-Methods: POST\r\n"
-                                             ).arg(request->origin);
+                                             "Access-Control-Allow-Methods: GET, POST\r\n"
+                                             ).arg(request.origin);
     if (sendPrivateNetworkField)
         fullResponse += QString::fromUtf8("Access-Control-Allow-Private-Network: true\r\n");
 
-    fullResponse += QString::fromUtf8(   "Access-Control-Max-Age: 86400\r\n"
-                                         "\r\n");
+    fullResponse += QString::fromUtf8("Access-Control-Max-Age: 86400\r\n"
+                                      "Connection: %1\r\n"
+                                      "\r\n").arg(QString::fromUtf8(request.keepAlive ? "keep-alive" : "close"));
 
     if (safeServer && safeSocket)
     {
         safeSocket->write(fullResponse.toUtf8());
-        safeSocket->flush();
-        safeSocket->disconnectFromHost();
-        safeSocket->deleteLater();
+        finishResponse(safeSocket, request.keepAlive);
     }
 }
 
-void HTTPServer::processOptionRequest(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers)
+void HTTPServer::processOptionRequest(QAbstractSocket* socket, HTTPRequest& request, const HTTPRequestParser::Request& parsedRequest)
 {
-    bool isCors = isPreFlightCorsRequest(headers);
+    bool isCors = isPreFlightCorsRequest(parsedRequest);
     if (!isCors)
+    {
+        // Answer anyway, the next requests of the connection wait for this one
+        rejectRequest(socket);
         return;
+    }
 
-    bool hasPrivateNetworkField = hasFieldWithValue(headers, "Access-Control-Request-Private-Network", "true");
-
-    QPointer<QAbstractSocket> safeSocket = socket;
-    QPointer<HTTPServer> safeServer = this;
+    bool hasPrivateNetworkField = hasFieldWithValue(parsedRequest, "Access-Control-Request-Private-Network", "true");
 
     sendPreFlightResponse(socket, request, hasPrivateNetworkField);
-
-    if (!safeServer || !safeSocket)
-    {
-        return;
-    }
 }
 
-bool HTTPServer::hasFieldWithValue(const QStringList& headers, const char* fieldName, const char* value)
+bool HTTPServer::getFieldValue(const HTTPRequestParser::Request& parsedRequest, const char* fieldName, QByteArray& value)
 {
-    bool isFieldAsExpected = false;
-    QString fieldNameStr = QString::fromUtf8(fieldName);
-    QString keyString = QString::fromUtf8("%1: ").arg(fieldNameStr);
-    QStringList foundValues = headers.filter(QRegExp(keyString, Qt::CaseInsensitive));
+    QList<QByteArray> foundValues = parsedRequest.headerValues(QByteArray(fieldName).toLower());
     if (foundValues.size() == 1)
     {
-        QString foundValue = foundValues.front().mid(keyString.length());
-        isFieldAsExpected = (foundValue == QString::fromUtf8(value));
-    }
-    else
-    {
-        const char* logString = (foundValues.size() > 1) ? "Several instances of field %1 in header"
-                                                         : "field %1 not found in header";
-        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8(logString).arg(fieldNameStr).toUtf8().constData());
+        value = foundValues.front();
+        return true;
     }
 
-    return isFieldAsExpected;
+    const char* logString = (foundValues.size() > 1) ? "Several instances of field %1 in header"
+                                                     : "field %1 not found in header";
+    MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8(logString).arg(QString::fromUtf8(fieldName)).toUtf8().constData());
+    return false;
 }
 
-bool HTTPServer::isPreFlightCorsRequest(const QStringList& headers)
+bool HTTPServer::hasFieldWithValue(const HTTPRequestParser::Request& parsedRequest, const char* fieldName, const char* value)
 {
-    return hasFieldWithValue(headers, "Access-Control-Request-Method", "POST");
+    QByteArray foundValue;
+    return getFieldValue(parsedRequest, fieldName, foundValue) && foundValue == value;
 }
 
-bool HTTPServer::isRequestOfType(const QStringList& headers, const char* typeName)
+bool HTTPServer::isPreFlightCorsRequest(const HTTPRequestParser::Request& parsedRequest)
 {
-    return headers[0].startsWith(QString::fromLatin1(typeName));
+    // Read once, so a missing field is only reported once
+    QByteArray method;
+    return getFieldValue(parsedRequest, "Access-Control-Request-Method", method)
+           && (method == "POST" || method == "GET");
 }
@@ -10,11 +10,14 @@
 #include <QQueue>
 #include <QFutureWatcher>
 #include <QPointer>
+#include <QTimer>
 
 #include <megaapi.h>
 
 #include "Utilities.h"
 #include "SetManager.h"
+#include "HTTPRequestParser.h"
+#include "WebTransferProgressTable.h"
 
 class RequestData
 {
@@ -34,26 +37,24 @@ public:
     int status;
 };
 
-class RequestTransferData
-{
-public:
-    RequestTransferData();
-    int state;
-    long long progress;
-    long long size;
-    long long speed;
-    long long tsStart;
-    long long tsEnd;
-    QString tPath;
-};
-
 class HTTPRequest
 {
 public:
-    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")) {}
+    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")), keepAlive(false) {}
     QString data;
     int contentLength;
     QString origin;
+    bool keepAlive;
+};
+
+class HTTPConnection
+{
+public:
+    HTTPConnection() : busy(false) {}
+    HTTPRequestParser parser;
+    // A request is being processed. The next ones wait in the parser, so the responses keep the order of the requests
+    bool busy;
+    QTimer idleTimer;
 };
 
 class HTTPServer: public QTcpServer
@@ -81,6 +82,10 @@ class HTTPServer: public QTcpServer
 
     public:
         static const unsigned int MAX_REQUEST_TIME_SECS;
+        static const int KEEP_ALIVE_TIMEOUT_MS;
+        static const int PROGRESS_PUSH_INTERVAL_MS;
+        // Bytes of progress events waiting to be sent to a subscriber before it is closed
+        static const qint64 MAX_PROGRESS_STREAM_BUFFERED_BYTES;
 
         HTTPServer(mega::MegaApi *megaApi, quint16 port);
         ~HTTPServer();
@@ -109,7 +114,7 @@ class HTTPServer: public QTcpServer
                                             const QList<mega::MegaHandle>& elementHandleList);
 
     private slots:
-        void onVersionCommandFinished();
+        void pushTransferProgress();
 
     public slots:
         void readClient();
@@ -118,15 +123,18 @@ class HTTPServer: public QTcpServer
         void processRequest(QPointer<QAbstractSocket> socket, HTTPRequest request);
 
     private:
-        QString findCorrespondingAllowedOrigin(const QStringList& headers);
-
-        void processPostRequest(QAbstractSocket* socket, HTTPRequest* request,
-                                const QStringList& headers, const QString& content);
-        void processOptionRequest(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers);
-        void sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* request, bool sendPrivateNetworkField);
-        bool hasFieldWithValue(const QStringList& headers, const char* fieldName, const char* value);
-        bool isPreFlightCorsRequest(const QStringList& headers);
-        bool isRequestOfType(const QStringList& headers, const char* typeName);
+        QString findCorrespondingAllowedOrigin(const HTTPRequestParser::Request& parsedRequest);
+
+        void processPendingRequests(QAbstractSocket* socket);
+        void processPostRequest(QAbstractSocket* socket, HTTPRequest& request, const HTTPRequestParser::Request& parsedRequest);
+        void processOptionRequest(QAbstractSocket* socket, HTTPRequest& request, const HTTPRequestParser::Request& parsedRequest);
+        void sendPreFlightResponse(QAbstractSocket* socket, const HTTPRequest& request, bool sendPrivateNetworkField);
+        void finishResponse(QAbstractSocket* socket, bool keepAlive);
+        void removeConnection(QAbstractSocket* socket);
+        // False, with a warning, when the field is missing or repeated
+        bool getFieldValue(const HTTPRequestParser::Request& parsedRequest, const char* fieldName, QByteArray& value);
+        bool hasFieldWithValue(const HTTPRequestParser::Request& parsedRequest, const char* fieldName, const char* value);
+        bool isPreFlightCorsRequest(const HTTPRequestParser::Request& parsedRequest);
 
         struct VersionCommandAnswer
         {
@@ -148,17 +156,22 @@ class HTTPServer: public QTcpServer
         void externalTransferQueryProgress(QString& response, const HTTPRequest& request);
         void externalShowInFolder(QString& response, const HTTPRequest& request);
         void externalAddBackup(QString& response, const HTTPRequest& request);
+        void subscribeToTransferProgress(QAbstractSocket* socket, const HTTPRequest& request);
+        static QString transferProgressJson(const RequestTransferData* tData);
+        static QByteArray transferProgressEvent(const QList<mega::MegaHandle>& handles);
 
         void endProcessRequest(QPointer<QAbstractSocket> socket, const HTTPRequest &request, QString response);
 
         RequestType GetRequestType(const HTTPRequest& request);
         bool disabled;
         mega::MegaApi *megaApi;
-        QMap<QAbstractSocket*, HTTPRequest*> requests;
+        QMap<QAbstractSocket*, HTTPConnection*> connections;
         static bool isFirstWebDownloadDone;
         static QMultiMap<QString, RequestData*> webDataRequests;
-        static QMap<mega::MegaHandle, RequestTransferData*> webTransferStateRequests;
-        QFutureWatcher<VersionCommandAnswer> mVersionCommandWatcher;
+        static WebTransferProgressTable webTransferStateRequests;
+        // Connections receiving the transfer progress as server-sent events
+        QList<QPointer<QAbstractSocket>> progressSubscribers;
+        QTimer progressPushTimer;
 };
 
 #endif // HTTPSERVER_H
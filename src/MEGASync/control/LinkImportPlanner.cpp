@@ -0,0 +1,50 @@
+#include "LinkImportPlanner.h"
+
+#include <memory>
+
+LinkImportPlanner::LinkImportPlanner(mega::MegaApi* megaApi)
+    : mMegaApi(megaApi)
+{
+}
+
+bool LinkImportPlanner::planImport(mega::MegaNode* node, mega::MegaNode* importParentNode)
+{
+    if(!node || !importParentNode)
+    {
+        return false;
+    }
+
+    addNodeChildren(importParentNode);
+    return planImport(importParentNode->getHandle(), QString::fromUtf8(node->getName()), node->getSize());
+}
+
+bool LinkImportPlanner::planImport(mega::MegaHandle importParentHandle, const QString& name, long long size)
+{
+    auto& folder(mFolders[importParentHandle]);
+    auto nameAndSize(qMakePair(name, size));
+    if(folder.contains(nameAndSize))
+    {
+        return false;
+    }
+
+    folder.insert(nameAndSize);
+    return true;
+}
+
+void LinkImportPlanner::addNodeChildren(mega::MegaNode* importParentNode)
+{
+    if(mLoadedFolders.contains(importParentNode->getHandle()))
+    {
+        return;
+    }
+    mLoadedFolders.insert(importParentNode->getHandle());
+
+    auto& folder(mFolders[importParentNode->getHandle()]);
+    std::unique_ptr<mega::MegaNodeList> children(mMegaApi->getChildren(importParentNode));
+    folder.reserve(folder.size() + children->size());
+    for(int index = 0; index < children->size(); ++index)
+    {
+        auto child(children->get(index));
+        folder.insert(qMakePair(QString::fromUtf8(child->getName()), child->getSize()));
+    }
+}
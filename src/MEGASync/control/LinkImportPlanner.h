@@ -0,0 +1,32 @@
+#ifndef LINKIMPORTPLANNER_H
+#define LINKIMPORTPLANNER_H
+
+#include <megaapi.h>
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+/// Responsability: decide which links are imported to a cloud folder, skipping the nodes with the same name and size
+/// as a child of the folder or as a node already planned. Every import folder is only read once.
+class LinkImportPlanner
+{
+public:
+    explicit LinkImportPlanner(mega::MegaApi* megaApi);
+
+    // Returns true when the node has to be imported. Then it is added to the folder, so its duplicates are skipped
+    bool planImport(mega::MegaNode* node, mega::MegaNode* importParentNode);
+    bool planImport(mega::MegaHandle importParentHandle, const QString& name, long long size);
+
+private:
+    void addNodeChildren(mega::MegaNode* importParentNode);
+
+    using NameAndSize = QPair<QString, long long>;
+
+    mega::MegaApi* mMegaApi;
+    QHash<mega::MegaHandle, QSet<NameAndSize>> mFolders;
+    QSet<mega::MegaHandle> mLoadedFolders;
+};
+
+#endif // LINKIMPORTPLANNER_H
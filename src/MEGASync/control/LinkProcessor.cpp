@@ -4,9 +4,15 @@
 #include "CommonMessages.h"
 #include <QDir>
 
+#include <algorithm>
+#include <utility>
+
 using namespace mega;
 
-LinkProcessor::LinkProcessor(const QStringList& linkList, MegaApi* megaApi, MegaApi* megaApiFolders)
+const int LinkProcessor::DEFAULT_MAX_LINK_INFO_REQUESTS = 16;
+
+LinkProcessor::LinkProcessor(const QStringList& linkList, MegaApi* megaApi, MegaApi* megaApiFolders,
+                             int maxLinkInfoRequests)
     : mMegaApi(megaApi)
     , mMegaApiFolders(megaApiFolders)
     , mLinkList(linkList)
@@ -15,7 +21,14 @@ LinkProcessor::LinkProcessor(const QStringList& linkList, MegaApi* megaApi, Mega
     , mDelegateTransferListener(std::make_shared<QTMegaTransferListener>(megaApi, this))
     , mParentHandler(nullptr)
     , mRequestCounter(0)
-    , mCurrentIndex(0)
+    , mMaxLinkInfoRequests(std::max(1, maxLinkInfoRequests))
+    , mLinkInfoRequested(false)
+    , mPublicLinkRequests(0)
+    , mFolderLinkIndex(-1)
+    , mSetLinkIndex(-1)
+    , mLinkInfoResolved(linkList.size(), false)
+    , mResolvedLinks(0)
+    , mImportPlanner(megaApi)
 {
     for (int i = 0; i < linkList.size(); i++)
     {
@@ -66,15 +79,27 @@ void LinkProcessor::sendLinkInfoAvailableSignal(int index)
                              linkObject->showFolderIcon());
 }
 
-void LinkProcessor::continueOrFinishLinkInfoReq()
+//!
+//! \brief LinkProcessor::onLinkInfoResolved
+//! \param index: the index of the link whose LinkObject is ready
+//! \Sends the link info as soon as it is available, whatever the order of the links,
+//! \and starts the next requests
+//!
+void LinkProcessor::onLinkInfoResolved(int index)
 {
-    if (mCurrentIndex == mLinkList.size())
+    if (!isValidIndex(mLinkInfoResolved, index) || mLinkInfoResolved[index]) { return; }
+
+    mLinkInfoResolved[index] = true;
+    mResolvedLinks++;
+    sendLinkInfoAvailableSignal(index);
+
+    if (mResolvedLinks == mLinkList.size())
     {
         emit onLinkInfoRequestFinish();
     }
     else
     {
-        requestLinkInfo();
+        issueLinkInfoRequests();
     }
 }
 
@@ -99,38 +124,6 @@ void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e
 
     switch (request->getType())
     {
-    case MegaRequest::TYPE_GET_PUBLIC_NODE:
-    {
-        if (!isValidIndex(mLinkObjects, mCurrentIndex)) { return; }
-
-        if (error != MegaError::API_OK)
-        {
-            // Invalid Link
-            createInvalidLinkObject(mCurrentIndex, error);
-        }
-        else    // API_OK
-        {
-            MegaNode* node = request->getPublicMegaNode();
-
-            if (!node)
-            {
-                // Invalid Link
-                createInvalidLinkObject(mCurrentIndex, error);
-            }
-            else    // Valid Link
-            {
-                mLinkObjects[mCurrentIndex] = std::make_shared<LinkNode>(mMegaApi,
-                                                                         MegaNodeSPtr(node),
-                                                                         mLinkList[mCurrentIndex]);
-            }
-        }
-
-        mCurrentIndex++;
-        sendLinkInfoAvailableSignal(mCurrentIndex - 1);
-        continueOrFinishLinkInfoReq();
-        break;
-    }
-
     // Response to MegaApi::createFolder() request
     case MegaRequest::TYPE_CREATE_FOLDER:
     {
@@ -152,31 +145,29 @@ void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e
 
     case MegaRequest::TYPE_LOGIN:
     {
-        if (!isValidIndex(mLinkObjects, mCurrentIndex)) { return; }
+        if (!isValidIndex(mLinkObjects, mFolderLinkIndex)) { break; }
 
         if (error == MegaError::API_OK)
         {
             mRequestCounter++;
-            mMegaApiFolders->fetchNodes(this);
+            mMegaApiFolders->fetchNodes(mDelegateListener.get());
         }
         else
         {
-            createInvalidLinkObject(mCurrentIndex, error);
-            mCurrentIndex++;
-            sendLinkInfoAvailableSignal(mCurrentIndex - 1);
-            continueOrFinishLinkInfoReq();
+            createInvalidLinkObject(mFolderLinkIndex, error);
+            onLinkInfoResolved(std::exchange(mFolderLinkIndex, -1));
         }
         break;
     }
 
     case MegaRequest::TYPE_FETCH_NODES:
     {
-        if (!isValidIndex(mLinkObjects, mCurrentIndex)) { return; }
+        if (!isValidIndex(mLinkObjects, mFolderLinkIndex)) { break; }
 
         if (error == MegaError::API_OK)
         {
             std::unique_ptr<MegaNode> rootNode(nullptr);
-            QString currentStr = mLinkList[mCurrentIndex];
+            QString currentStr = mLinkList[mFolderLinkIndex];
             QString splitSeparator;
 
             if (currentStr.count(QChar::fromLatin1('!')) == 3)
@@ -211,20 +202,17 @@ void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e
 
             Preferences::instance()->setLastPublicHandle(request->getNodeHandle(), MegaApi::AFFILIATE_TYPE_FILE_FOLDER);
             mega::MegaNode* node = mMegaApiFolders->authorizeNode(rootNode.get());
-            mLinkObjects[mCurrentIndex] = std::make_shared<LinkNode>(mMegaApi,
-                                                                     MegaNodeSPtr(node),
-                                                                     mLinkList[mCurrentIndex]);
+            mLinkObjects[mFolderLinkIndex] = std::make_shared<LinkNode>(mMegaApi,
+                                                                        MegaNodeSPtr(node),
+                                                                        mLinkList[mFolderLinkIndex]);
         }
         else
         {
             // Invalid Link
-            createInvalidLinkObject(mCurrentIndex, error);
+            createInvalidLinkObject(mFolderLinkIndex, error);
         }
 
-        mCurrentIndex++;
-        sendLinkInfoAvailableSignal(mCurrentIndex - 1);
-        continueOrFinishLinkInfoReq();
-
+        onLinkInfoResolved(std::exchange(mFolderLinkIndex, -1));
         break;
     }
 
@@ -265,35 +253,114 @@ void LinkProcessor::markForDeletionIfNoMoreRequests()
     }
 }
 
+//!
+//! \brief LinkProcessor::requestLinkInfo
+//! \Sorts the links by the kind of request that resolves them and starts the first requests.
+//! \onLinkInfoAvailable is emitted for every link as soon as it is resolved, and
+//! \onLinkInfoRequestFinish once all of them are
+//!
 void LinkProcessor::requestLinkInfo()
 {
-    if (!isValidIndex(mLinkList, mCurrentIndex)) { return; }
+    if (mLinkInfoRequested) { return; }
+    mLinkInfoRequested = true;
 
-    const QString link = mLinkList[mCurrentIndex];
-    if (link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/#F!")) ||
-        link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/folder/")))
+    for (int index = 0; index < mLinkList.size(); index++)
     {
-        std::unique_ptr<char []> authToken(mMegaApi->getAccountAuth());
-        if (authToken)
+        const QString& link = mLinkList[index];
+        if (link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/#F!")) ||
+            link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/folder/")))
+        {
+            mPendingFolderLinks.enqueue(index);
+        }
+        else if (link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/collection/")))
         {
-            mMegaApiFolders->setAccountAuth(authToken.get());
+            mPendingSetLinks.enqueue(index);
         }
+        else
+        {
+            mPendingPublicLinks.enqueue(index);
+        }
+    }
 
-        mRequestCounter++;
-        mMegaApiFolders->loginToFolder(link.toUtf8().constData(), mDelegateListener.get());
+    issueLinkInfoRequests();
+}
+
+void LinkProcessor::issueLinkInfoRequests()
+{
+    while (mPublicLinkRequests < mMaxLinkInfoRequests && !mPendingPublicLinks.isEmpty())
+    {
+        requestPublicNode(mPendingPublicLinks.dequeue());
     }
-    else if (link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/collection/")))
+
+    if (mFolderLinkIndex < 0 && !mPendingFolderLinks.isEmpty())
     {
-        mRequestCounter++;
-        emit requestFetchSetFromLink(link);
+        requestFolderLink(mPendingFolderLinks.dequeue());
     }
-    else
+
+    if (mSetLinkIndex < 0 && !mPendingSetLinks.isEmpty())
     {
-        mRequestCounter++;
-        mMegaApi->getPublicNode(link.toUtf8().constData(), mDelegateListener.get());
+        requestSetLink(mPendingSetLinks.dequeue());
     }
 }
 
+void LinkProcessor::requestPublicNode(int index)
+{
+    mRequestCounter++;
+    mPublicLinkRequests++;
+    mMegaApi->getPublicNode(mLinkList[index].toUtf8().constData(), new OnFinishOneShot(mMegaApi, this, [this, index]
+        (bool isContextValid, const MegaRequest& request, const MegaError& e)
+        {
+            if (isContextValid)
+            {
+                mRequestCounter--;
+                mPublicLinkRequests--;
+                onPublicNodeRequestFinish(index, request, e);
+                markForDeletionIfNoMoreRequests();
+            }
+        }));
+}
+
+void LinkProcessor::onPublicNodeRequestFinish(int index, const MegaRequest& request, const MegaError& e)
+{
+    if (!isValidIndex(mLinkObjects, index)) { return; }
+
+    const int error = e.getErrorCode();
+    MegaNode* node = (error == MegaError::API_OK) ? request.getPublicMegaNode() : nullptr;
+    if (!node)
+    {
+        // Invalid Link
+        createInvalidLinkObject(index, error);
+    }
+    else    // Valid Link
+    {
+        mLinkObjects[index] = std::make_shared<LinkNode>(mMegaApi,
+                                                         MegaNodeSPtr(node),
+                                                         mLinkList[index]);
+    }
+
+    onLinkInfoResolved(index);
+}
+
+void LinkProcessor::requestFolderLink(int index)
+{
+    std::unique_ptr<char []> authToken(mMegaApi->getAccountAuth());
+    if (authToken)
+    {
+        mMegaApiFolders->setAccountAuth(authToken.get());
+    }
+
+    mFolderLinkIndex = index;
+    mRequestCounter++;
+    mMegaApiFolders->loginToFolder(mLinkList[index].toUtf8().constData(), mDelegateListener.get());
+}
+
+void LinkProcessor::requestSetLink(int index)
+{
+    mSetLinkIndex = index;
+    mRequestCounter++;
+    emit requestFetchSetFromLink(mLinkList[index]);
+}
+
 // ----------------------------------------------------------------------------
 //
 // Callbacks from Sets & Elements
@@ -304,13 +371,12 @@ void LinkProcessor::onFetchSetFromLink(const AlbumCollection& collection)
     // We received a response to a request
     mRequestCounter--;
 
-    if (mCurrentIndex >= mLinkObjects.size()) { return; }
-
-    mLinkObjects[mCurrentIndex] = std::make_shared<LinkSet>(mMegaApi, collection);
-    mCurrentIndex++;
+    if (isValidIndex(mLinkObjects, mSetLinkIndex))
+    {
+        mLinkObjects[mSetLinkIndex] = std::make_shared<LinkSet>(mMegaApi, collection);
+        onLinkInfoResolved(std::exchange(mSetLinkIndex, -1));
+    }
 
-    sendLinkInfoAvailableSignal(mCurrentIndex - 1);
-    continueOrFinishLinkInfoReq();
     markForDeletionIfNoMoreRequests();
 }
 
@@ -420,34 +486,15 @@ void LinkProcessor::setImportParentNode(MegaNodeSPtr importParentNode)
 //! \param linkNode: the source node to copy
 //! \param importParentNode: import parent destination folder on Cloud Drive
 //! \Copies @linkNode to @importParentNode, if a node with the same name and
-//! \size doesn't already exist at the destination.
+//! \size doesn't already exist at the destination, nor was imported before.
 //! \Returns true if a copy/import request was made to SDK, false otherwise
 //!
 bool LinkProcessor::copyNode(MegaNodeSPtr linkNode, MegaNodeSPtr importParentNode)
 {
     if (!linkNode || !importParentNode) { return false; }
 
-    // Returns true if a similar node to @node, with the same name and size,
-    // already exists in import folder @importNode. Returns false otherwise.
-    auto alreadyExists = [&](MegaNodeSPtr node, MegaNodeSPtr importNode) -> bool {
-        std::unique_ptr<MegaNodeList> children(mMegaApi->getChildren(importNode.get()));
-        const char* srcName = node->getName();
-        const long long srcSize = node->getSize();
-        const int nrChildren = children->size();
-
-        for (int i = 0; i < nrChildren; i++)
-        {
-            MegaNode* child = children->get(i);
-            if (!strcmp(srcName, child->getName()) && (srcSize == child->getSize()))
-            {
-                return true;
-            }
-        }
-
-        return false;
-    };
-
-    if (!alreadyExists(linkNode, importParentNode))
+    // The import folder is read once for all the links
+    if (mImportPlanner.planImport(linkNode.get(), importParentNode.get()))
     {
         mRequestCounter++;
         mMegaApi->copyNode(linkNode.get(), importParentNode.get(), mDelegateListener.get());
@@ -660,9 +707,12 @@ void LinkProcessor::setParentHandler(QObject *parent)
 //!
 void LinkProcessor::refreshLinkInfo()
 {
-    for (int i = 0; i < mCurrentIndex; i++)
+    for (int i = 0; i < mLinkInfoResolved.size(); i++)
     {
-        sendLinkInfoAvailableSignal(i);
+        if (mLinkInfoResolved[i])
+        {
+            sendLinkInfoAvailableSignal(i);
+        }
     }
 }
 
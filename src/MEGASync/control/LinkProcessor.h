@@ -11,7 +11,9 @@
 #include <QSharedPointer>
 #include <QQueue>
 #include <QList>
+#include <QVector>
 #include "LinkObject.h"
+#include "LinkImportPlanner.h"
 #include "SetTypes.h"
 
 enum class LinkTransferType { UNKNOWN, DOWNLOAD, IMPORT };
@@ -32,7 +34,12 @@ class LinkProcessor: public QObject, public mega::MegaRequestListener, public me
     Q_OBJECT
 
 public:
-    LinkProcessor(const QStringList& linkList, mega::MegaApi* megaApi, mega::MegaApi* megaApiFolders);
+    static const int DEFAULT_MAX_LINK_INFO_REQUESTS;
+
+    // The file links are resolved in parallel, up to maxLinkInfoRequests at a time.
+    // The folder links and the set links are resolved one at a time, as they use a shared session
+    LinkProcessor(const QStringList& linkList, mega::MegaApi* megaApi, mega::MegaApi* megaApiFolders,
+                  int maxLinkInfoRequests = DEFAULT_MAX_LINK_INFO_REQUESTS);
     virtual ~LinkProcessor();
 
     QString getLink(int index) const;
@@ -94,7 +101,12 @@ private:
 
     inline bool isLinkObjectValid(int index) const;
     void sendLinkInfoAvailableSignal(int index);
-    void continueOrFinishLinkInfoReq();
+    void issueLinkInfoRequests();
+    void requestPublicNode(int index);
+    void requestFolderLink(int index);
+    void requestSetLink(int index);
+    void onPublicNodeRequestFinish(int index, const mega::MegaRequest& request, const mega::MegaError& e);
+    void onLinkInfoResolved(int index);
     void createInvalidLinkObject(int index, int error);
     void markForDeletionIfNoMoreRequests();
 
@@ -111,8 +123,19 @@ private:
     std::shared_ptr<mega::QTMegaTransferListener> mDelegateTransferListener;
     QPointer<QObject> mParentHandler;
     uint32_t mRequestCounter;
-    int mCurrentIndex;
+    const int mMaxLinkInfoRequests;
+    bool mLinkInfoRequested;
+    QQueue<int> mPendingPublicLinks;
+    QQueue<int> mPendingFolderLinks;
+    QQueue<int> mPendingSetLinks;
+    int mPublicLinkRequests;
+    // Links being resolved, -1 if none
+    int mFolderLinkIndex;
+    int mSetLinkIndex;
+    QVector<bool> mLinkInfoResolved;
+    int mResolvedLinks;
     QQueue<LinkTransfer> mTransferQueue;
+    LinkImportPlanner mImportPlanner;
 };
 
 #endif // LINKPROCESSOR_H
@@ -0,0 +1,133 @@
+#include "LocalAttributesScanner.h"
+
+#include "Utilities.h"
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+
+const long long LocalAttributesScanner::PROGRESS_INTERVAL_MS = 250;
+const int LocalAttributesScanner::ENTRIES_PER_INTERRUPTION_CHECK = 1000;
+
+namespace
+{
+long long getSteadyMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+ThreadPool::CancellationToken LocalAttributesScanner::scan(const QString& folderPath, ProgressCallback progress)
+{
+    auto scan(std::make_shared<Scan>());
+    scan->progress = std::move(progress);
+
+    auto path(QDir::cleanPath(folderPath));
+    ThreadPoolSingleton::getInstance()->push([scan, path]()
+    {
+        scanFolder(scan, path, false);
+    }, ThreadPool::Lane::BULK_IO, scan->token);
+
+    return scan->token;
+}
+
+void LocalAttributesScanner::scanFolder(const std::shared_ptr<Scan>& scan, const QString& folderPath, bool isHidden)
+{
+    if (ThreadPool::isThreadInterrupted())
+    {
+        return;
+    }
+
+    long long size(0);
+    int fileCount(0);
+    long long lastModifiedTime(-1);
+    QList<QPair<QString, bool>> subfolders;
+
+    // QDirIterator does not build the whole list of entries
+    QDirIterator it(folderPath, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    int entries(0);
+    while (it.hasNext())
+    {
+        it.next();
+        auto info(it.fileInfo());
+        auto isEntryHidden(isHidden || info.isHidden());
+        if (info.isDir())
+        {
+            subfolders.append(qMakePair(info.fileName(), isEntryHidden));
+        }
+        else if (info.isFile())
+        {
+            size += info.size();
+            if (!isEntryHidden)
+            {
+                ++fileCount;
+                lastModifiedTime = std::max(lastModifiedTime, info.lastModified().toMSecsSinceEpoch());
+            }
+        }
+
+        if (++entries % ENTRIES_PER_INTERRUPTION_CHECK == 0 && ThreadPool::isThreadInterrupted())
+        {
+            return;
+        }
+    }
+
+    scan->size += size;
+    scan->fileCount += fileCount;
+    auto scanLastModifiedTime(scan->lastModifiedTime.load());
+    while (lastModifiedTime > scanLastModifiedTime
+           && !scan->lastModifiedTime.compare_exchange_weak(scanLastModifiedTime, lastModifiedTime))
+    {
+    }
+    scan->pendingFolders += subfolders.size();
+
+    auto threadPool(ThreadPoolSingleton::getInstance());
+    for (const auto& subfolder : qAsConst(subfolders))
+    {
+        auto subfolderPath(folderPath + QLatin1Char('/') + subfolder.first);
+        auto isSubfolderHidden(subfolder.second);
+        threadPool->push([scan, subfolderPath, isSubfolderHidden]()
+        {
+            scanFolder(scan, subfolderPath, isSubfolderHidden);
+        }, ThreadPool::Lane::BULK_IO, scan->token);
+    }
+
+    reportProgress(scan, --scan->pendingFolders == 0);
+}
+
+void LocalAttributesScanner::reportProgress(const std::shared_ptr<Scan>& scan, bool finished)
+{
+    if (ThreadPool::isThreadInterrupted())
+    {
+        return;
+    }
+
+    if (!finished)
+    {
+        auto now(getSteadyMs());
+        auto nextProgressMs(scan->nextProgressMs.load());
+        if (now < nextProgressMs
+            || !scan->nextProgressMs.compare_exchange_strong(nextProgressMs, now + PROGRESS_INTERVAL_MS))
+        {
+            return;
+        }
+    }
+
+    // A partial result is never reported after the final one, and nothing is reported after a cancellation,
+    // even one made by the callback while this thread was waiting for the lock
+    std::lock_guard<std::mutex> lock(scan->progressMutex);
+    if (!scan->finished && !ThreadPool::isThreadInterrupted())
+    {
+        scan->finished = finished;
+
+        Result result;
+        result.size = scan->size;
+        result.fileCount = scan->fileCount;
+        result.lastModifiedTime = scan->lastModifiedTime;
+        scan->progress(result, finished);
+    }
+}
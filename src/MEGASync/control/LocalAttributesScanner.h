@@ -0,0 +1,55 @@
+#ifndef LOCALATTRIBUTESSCANNER_H
+#define LOCALATTRIBUTESSCANNER_H
+
+#include "ThreadPool.h"
+
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/// Responsability: read a local folder tree once in the thread pool to get its size, file count and last modification time.
+/// Every folder is read by its own functor, so the subfolders are scanned in parallel, and the scan stops when
+/// its token is cancelled. The hidden files count for the size only.
+class LocalAttributesScanner
+{
+public:
+    struct Result
+    {
+        long long size = 0;
+        int fileCount = 0;
+        // Milliseconds since the epoch, -1 when no file was found
+        long long lastModifiedTime = -1;
+    };
+
+    // Called from the worker threads with the result found so far, at most every PROGRESS_INTERVAL_MS.
+    // The last call has finished == true, unless the scan is cancelled
+    using ProgressCallback = std::function<void(const Result& result, bool finished)>;
+
+    static ThreadPool::CancellationToken scan(const QString& folderPath, ProgressCallback progress);
+
+private:
+    struct Scan
+    {
+        ProgressCallback progress;
+        ThreadPool::CancellationToken token;
+        std::atomic<long long> size{0};
+        std::atomic<int> fileCount{0};
+        std::atomic<long long> lastModifiedTime{-1};
+        std::atomic<int> pendingFolders{1};
+        std::atomic<long long> nextProgressMs{0};
+        std::mutex progressMutex;
+        bool finished = false;
+    };
+
+    static void scanFolder(const std::shared_ptr<Scan>& scan, const QString& folderPath, bool isHidden);
+    static void reportProgress(const std::shared_ptr<Scan>& scan, bool finished);
+
+    static const long long PROGRESS_INTERVAL_MS;
+    // Entries read between two checks of the cancellation
+    static const int ENTRIES_PER_INTERRUPTION_CHECK;
+};
+
+#endif // LOCALATTRIBUTESSCANNER_H
@@ -0,0 +1,118 @@
+#ifndef LOCK_FREE_QUEUE
+#define LOCK_FREE_QUEUE
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Bounded multi-producer/single-consumer queue (D. Vyukov's bounded queue).
+// Producers never take a lock: tryPush fails when the queue is full and the caller decides what to do with the item.
+// Only one thread may call tryPop at a time.
+template <typename T>
+class LockFreeQueue
+{
+public:
+    // Capacity is rounded up to the next power of two
+    explicit LockFreeQueue(size_t capacity)
+        : mMask(roundUpToPowerOfTwo(capacity) - 1),
+          mCells(new Cell[mMask + 1]),
+          mEnqueuePos(0),
+          mDequeuePos(0)
+    {
+        for (size_t index = 0; index <= mMask; ++index)
+        {
+            mCells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    bool tryPush(T&& item)
+    {
+        Cell* cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Full
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item)
+    {
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &mCells[pos & mMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0)
+        {
+            // Empty (or the producer has not finished writing the cell yet)
+            return false;
+        }
+
+        mDequeuePos.store(pos + 1, std::memory_order_relaxed);
+        item = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+    // Approximated, only for statistics
+    size_t sizeApprox() const
+    {
+        auto enqueued = mEnqueuePos.load(std::memory_order_relaxed);
+        auto dequeued = mDequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result(2);
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    // Keep producers and consumer positions in different cache lines
+    alignas(64) std::atomic<size_t> mEnqueuePos;
+    alignas(64) std::atomic<size_t> mDequeuePos;
+};
+
+#endif // LOCK_FREE_QUEUE
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <sstream>
 #include <ctime>
+#include <cstring>
+#include <climits>
 #include <assert.h>
 
 #include <QFileInfo>
@@ -22,6 +24,8 @@
 
 #include <megaapi.h>
 #include <future>
+#include <algorithm>
+#include <vector>
 
 #ifdef WIN32
 #include <windows.h>
@@ -38,6 +42,11 @@
 #define MAX_ROTATE_LOGS_DEFAULT 50   // So we expect to keep 42MB or so in compressed logs
 #define MAX_ROTATE_LOGS_TODELETE 50   // If ever reducing the number of logs, we should remove the older ones anyway. This number should be the historical maximum of that value
 
+#define THREAD_LOG_BLOCK_SIZE 32768
+#define MAX_THREAD_LOG_PENDING_BYTES (64 * 1024 * 1024)   // Lines not written yet by a single thread. Beyond this, lines are counted as lost
+#define COMPRESSED_LOG_BUFFER_SIZE 65536
+#define NO_LOG_LINE_SEQUENCE ULLONG_MAX
+
 
 #ifdef _WIN32
     #define CERRQSTRING(filename) std::wcerr << filename.toStdWString()
@@ -46,73 +55,88 @@
 #endif
 
 
-void gzipCompressOnRotate(const QString filename, const QString destinationFilename)
+gzFile_s* openCompressedLog(const QString& filename, const char* mode = "wb")
 {
-#ifdef WIN32
-    std::ifstream file(filename.toStdWString().data(), std::ofstream::out);
+#ifdef _WIN32
+    gzFile_s* gzfile = gzopen_w(filename.toStdWString().data(), mode);
 #else
-    std::ifstream file(filename.toUtf8().data(), std::ofstream::out);
+    gzFile_s* gzfile = gzopen(filename.toUtf8().data(), mode);
 #endif
-    if (!file.is_open())
+    if (!gzfile)
     {
-        std::cerr << "Unable to open log file for reading: "; CERRQSTRING(filename) << std::endl;
-        return;
+        std::cerr << "Unable to open gzfile: "; CERRQSTRING(filename) << std::endl;
+        return nullptr;
     }
 
-    auto gzdeleter = [](gzFile_s* f) { if (f) gzclose(f); };
+    gzbuffer(gzfile, COMPRESSED_LOG_BUFFER_SIZE);
+    return gzfile;
+}
 
-#ifdef _WIN32
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen_w(destinationFilename.toStdWString().data(), "wb"), gzdeleter};
-#else
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen(destinationFilename.toUtf8().data(), "wb"), gzdeleter };
-#endif
+// Reads a log written by a previous execution. Returns false if it is not a complete compressed log:
+// the execution was killed before closing it (no gzip trailer, gzjoin rejects it), or it is an uncompressed log of an older version
+bool readPreviousLog(const QString& filename, gzFile_s* destination)
+{
+    gzFile_s* gzfile = openCompressedLog(filename, "rb");
     if (!gzfile)
     {
-        std::cerr << "Unable to open gzfile for writing: "; CERRQSTRING(filename) << std::endl;
-        return;
+        return false;
     }
 
-    std::string line;
-    while (std::getline(file, line))
+    std::vector<char> buffer(COMPRESSED_LOG_BUFFER_SIZE);
+    int size = 0;
+    while ((size = gzread(gzfile, buffer.data(), static_cast<unsigned>(buffer.size()))) > 0)
     {
-        line.push_back('\n');
-        if (gzputs(gzfile.get(), line.c_str()) == -1)
+        if (destination && gzwrite(destination, buffer.data(), static_cast<unsigned>(size)) != size)
         {
             std::cerr << "Unable to compress log file: "; CERRQSTRING(filename) << std::endl;
-            return;
+            break;
         }
     }
 
-    gzfile.reset();
-    file.close();
+    // A truncated gzip member is reported as an error, not as the end of the file
+    int error = Z_OK;
+    gzerror(gzfile, &error);
+    bool complete = !size && error == Z_OK && !gzdirect(gzfile);
+    gzclose(gzfile);
+    return complete;
+}
+
+// Moves the log left by the previous execution to destination. Usually this is just a rename, only an
+// incomplete or uncompressed log is compressed again (what can be read of it)
+void rotatePreviousLog(const QString& filename, const QString& destination)
+{
+    if (readPreviousLog(filename, nullptr))
+    {
+        if (!QFile(filename).rename(destination))
+        {
+            std::cerr << "Error renaming previous log file" << std::endl;
+        }
+        return;
+    }
+
+    if (gzFile_s* gzfile = openCompressedLog(destination))
+    {
+        readPreviousLog(filename, gzfile);
+        gzclose(gzfile);
+    }
     QFile::remove(filename);
 }
 
 using DirectLogFunction = std::function <void (std::ostream *)>;
 
+// Direct messages (ENABLE_LOG_PERFORMANCE): the logging thread writes them with the caller's function and notifies it
 struct LogLinkedList
 {
     LogLinkedList* next = nullptr;
-    unsigned allocated = 0;
-    unsigned used = 0;
-    int lastmessage = -1;
-    int lastmessageRepeats = 0;
-    bool oomGap = false;
     DirectLogFunction *mDirectLoggingFunction = nullptr; // we cannot use a non pointer due to the malloc allocation of new entries
     std::promise<void>* mCompletionPromise = nullptr; // we cannot use a unique_ptr due to the malloc allocation of new entries
-    char message[1];
 
-    static LogLinkedList* create(LogLinkedList* prev, size_t size)
+    static LogLinkedList* create(LogLinkedList* prev)
     {
-        LogLinkedList* entry = (LogLinkedList*)malloc(size);
+        LogLinkedList* entry = (LogLinkedList*)malloc(sizeof(LogLinkedList));
         if (entry)
         {
             entry->next = nullptr;
-            entry->allocated = unsigned(size - sizeof(LogLinkedList));
-            entry->used = 0;
-            entry->lastmessage = -1;
-            entry->lastmessageRepeats = 0;
-            entry->oomGap = false;
             entry->mDirectLoggingFunction = nullptr;
             entry->mCompletionPromise = nullptr;
             prev->next = entry;
@@ -120,24 +144,11 @@ struct LogLinkedList
         return entry;
     }
 
-    bool messageFits(size_t size)
-    {
-        return used + size + 2 < allocated;
-    }
-
     bool needsDirectOutput()
     {
         return mDirectLoggingFunction != nullptr;
     }
 
-    void append(const char* s, unsigned int n = 0)
-    {
-        n = n ? n : unsigned(strlen(s));
-        assert(used + n + 1 < allocated);
-        strcpy(message + used, s);
-        used += n;
-    }
-
     void notifyWaiter()
     {
         if (mCompletionPromise)
@@ -148,6 +159,72 @@ struct LogLinkedList
 
 };
 
+// Each line in a LogBlock starts with this header (copied with memcpy, the lines are not aligned).
+// The sequence is global, so the logging thread writes the lines of all threads in the order they were logged
+struct LogLineHeader
+{
+    unsigned long long sequence;
+    unsigned size;
+};
+
+// Block of log lines written by a single thread and read by the logging thread, without locking.
+// The writer publishes the lines with "committed" and links the next block when this one is full;
+// once "next" is set, nothing else is written in this block.
+struct LogBlock
+{
+    std::atomic<LogBlock*> next;
+    std::atomic<unsigned> committed;
+    unsigned allocated;
+    char data[1];
+
+    static LogBlock* create(size_t size)
+    {
+        LogBlock* block = (LogBlock*)malloc(size + sizeof(LogBlock));
+        if (block)
+        {
+            new (&block->next) std::atomic<LogBlock*>(nullptr);
+            new (&block->committed) std::atomic<unsigned>(0);
+            block->allocated = unsigned(size);
+        }
+        return block;
+    }
+
+    bool lineFits(size_t size) const
+    {
+        return committed.load(std::memory_order_relaxed) + size < allocated;
+    }
+};
+
+struct ThreadLogBuffer
+{
+    // Only used by the thread that owns the buffer
+    LogBlock* writeBlock = nullptr;
+    int lastmessage = -1;
+    unsigned lastmessageRepeats = 0;
+    std::string threadName;
+    time_t lastT = 0;
+    struct tm lastTm;
+
+    // Only used by the logging thread
+    LogBlock* readBlock = nullptr;
+    unsigned readOffset = 0;
+
+    std::atomic<size_t> pendingBytes{0};
+    std::atomic<bool> threadFinished{false};
+    // Lower bound of the sequence of the line being written, NO_LOG_LINE_SEQUENCE between lines
+    std::atomic<unsigned long long> writingSequence{NO_LOG_LINE_SEQUENCE};
+
+    ~ThreadLogBuffer()
+    {
+        while (readBlock)
+        {
+            auto next = readBlock->next.load(std::memory_order_acquire);
+            free(readBlock);
+            readBlock = next;
+        }
+    }
+};
+
 MegaSyncLogger *g_megaSyncLogger = nullptr;
 std::atomic<bool> gAppExit(false);
 
@@ -156,11 +233,17 @@ struct LoggingThread
     std::unique_ptr<std::thread> logThread;
     std::condition_variable logConditionVariable;
     std::mutex logMutex;
-    std::mutex logRotationMutex;
+    // Only for direct messages (ENABLE_LOG_PERFORMANCE), the normal lines go to the per thread buffers
     LogLinkedList logListFirst;
     LogLinkedList* logListLast = &logListFirst;
+    std::mutex threadBuffersMutex;
+    std::vector<std::shared_ptr<ThreadLogBuffer>> threadBuffers;
+    std::atomic<bool> pendingThreadBlocks{false};
+    std::atomic<unsigned long long> nextLineSequence{0};
+    std::atomic<unsigned long long> lostLines{0};
+    unsigned long long reportedLostLines = 0;
     bool logExit = false;
-    bool flushLog = false;
+    std::atomic<bool> flushLog{false};
     bool closeLog = false;
     bool forceRotationForReporting = false;
     bool forceRenew = false; //to force removal of all logs and create an empty MEGAsync.log
@@ -183,6 +266,118 @@ struct LoggingThread
     void log(int loglevel, const char *message, const char **directMessages = nullptr, size_t *directMessagesSizes = nullptr, int numberMessages = 0);
 
 private:
+    ThreadLogBuffer* getThreadBuffer();
+    void logDirect(const char* timebuf, const char* threadname, const char* loglevelstring,
+                   const char **directMessages, size_t *directMessagesSizes, int numberMessages);
+
+    template <typename WriteFunction>
+    void harvestThreadBuffers(WriteFunction write)
+    {
+        // A line that is still being written holds back the lines logged after it (by any thread) until
+        // the next harvest. Its writer publishes writingSequence before taking its sequence number, so
+        // every line below the limit is already committed. The limit is read before copying the buffers,
+        // the threads that register a buffer later get sequences above it
+        auto limit = nextLineSequence.load();
+
+        std::vector<std::shared_ptr<ThreadLogBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> g(threadBuffersMutex);
+            buffers = threadBuffers;
+        }
+
+        for (auto& buffer : buffers)
+        {
+            limit = std::min(limit, buffer->writingSequence.load());
+        }
+
+        struct HarvestedLine
+        {
+            unsigned long long sequence;
+            const char* data;
+            unsigned size;
+        };
+        struct ReadPosition
+        {
+            LogBlock* block;
+            unsigned offset;
+        };
+        std::vector<HarvestedLine> lines;
+        std::vector<ReadPosition> positions;
+        positions.reserve(buffers.size());
+
+        for (auto& buffer : buffers)
+        {
+            ReadPosition position{buffer->readBlock, buffer->readOffset};
+            bool heldBack = false;
+            while (position.block)
+            {
+                // Read "next" before "committed": once the block is sealed, its last lines are already committed
+                auto next = position.block->next.load(std::memory_order_acquire);
+                auto committed = position.block->committed.load(std::memory_order_acquire);
+                while (position.offset < committed)
+                {
+                    LogLineHeader header;
+                    memcpy(&header, position.block->data + position.offset, sizeof(header));
+                    if (header.sequence >= limit)
+                    {
+                        heldBack = true;
+                        break;
+                    }
+                    lines.push_back({header.sequence, position.block->data + position.offset + sizeof(header), header.size});
+                    position.offset += unsigned(sizeof(header)) + header.size;
+                }
+
+                if (!next || heldBack)
+                {
+                    break;
+                }
+                position = {next, 0};
+            }
+            positions.push_back(position);
+        }
+
+        // The lines of each thread are already in order, this interleaves them
+        std::sort(lines.begin(), lines.end(), [](const HarvestedLine& a, const HarvestedLine& b){
+            return a.sequence < b.sequence;
+        });
+        for (auto& line : lines)
+        {
+            write(line.data, line.size);
+        }
+
+        // The blocks are freed once their lines are written
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            auto& buffer = buffers[i];
+            while (buffer->readBlock != positions[i].block)
+            {
+                auto next = buffer->readBlock->next.load(std::memory_order_acquire);
+                buffer->pendingBytes -= buffer->readBlock->allocated;
+                free(buffer->readBlock);
+                buffer->readBlock = next;
+            }
+            buffer->readOffset = positions[i].offset;
+        }
+
+        bool removeFinished = false;
+        for (auto& buffer : buffers)
+        {
+            removeFinished |= buffer->threadFinished.load(std::memory_order_acquire);
+        }
+
+        if (removeFinished)
+        {
+            std::lock_guard<std::mutex> g(threadBuffersMutex);
+            threadBuffers.erase(std::remove_if(threadBuffers.begin(), threadBuffers.end(), [](const std::shared_ptr<ThreadLogBuffer>& buffer){
+                // The finished thread does not write anymore, so this is everything it logged
+                return buffer->threadFinished.load(std::memory_order_acquire)
+                       && buffer->readBlock
+                       && !buffer->readBlock->next.load(std::memory_order_acquire)
+                       && buffer->readOffset == buffer->readBlock->committed.load(std::memory_order_acquire);
+            }), threadBuffers.end());
+        }
+    }
+
     QString numberedLogFilename(QString baseName, int logNumber)
     {
         QString newName = baseName;
@@ -207,21 +402,77 @@ private:
             logCountToClean = std::max(logCountToRotate, logCountToClean);
         }
 
-    #ifdef WIN32
-        std::ofstream outputFile(filename.toStdWString().data(), std::ofstream::out | std::ofstream::app);
-    #else
-        std::ofstream outputFile(filename.toUtf8().data(), std::ofstream::out | std::ofstream::app);
-    #endif
-        outputFile << "----------------------------- program start -----------------------------\n";
-        long long outFileSize = outputFile.tellp();
+        auto renumberRotatedLogs = [&]()
+        {
+            for (int i = logCountToClean; i--; )
+            {
+                QString toRename = numberedLogFilename(filename, i);
+
+                if (QFile::exists(toRename))
+                {
+                    if (i + 1 >= logCountToRotate)
+                    {
+                        if (!QFile::remove(toRename))
+                        {
+                            std::cerr << "Error removing log file " << i << std::endl;
+                        }
+
+                    }
+                    else
+                    {
+                        if (!QFile(toRename).rename(numberedLogFilename(filename, i + 1)))
+                        {
+                            std::cerr << "Error renaming log file " << i << std::endl;
+                        }
+                    }
+                }
+            }
+        };
+
+        // MEGAsync.log is written compressed (only the debug log in the desktop is plain), so rotating it is just
+        // closing and renaming it, without reading it again. Every execution starts a new log: the previous one
+        // cannot be continued because gzjoin only reads the first gzip member of each rotated log
+        if (QFileInfo(filename).size() > 0)
+        {
+            renumberRotatedLogs();
+            rotatePreviousLog(filename, numberedLogFilename(filename, 0));
+        }
+        QFile::remove(filename);
+        gzFile_s* outputFile = openCompressedLog(filename);
+        long long outFileSize = 0; // Uncompressed bytes, that is what MEGA_MAX_LOG_FILESIZE_MB limits
+
         std::ofstream logDesktopFile;
         bool logDesktopFileOpen = false;
 
-        while (!logExit)
+        auto writeToLogFile = [&](const char* lines, size_t size)
+        {
+            if (outputFile)
+            {
+                if (gzwrite(outputFile, lines, static_cast<unsigned>(size)) != static_cast<int>(size))
+                {
+                    std::cerr << "Unable to write log file: "; CERRQSTRING(filename) << std::endl;
+                }
+                outFileSize += static_cast<long long>(size);
+            }
+        };
+
+        auto closeLogFile = [&]()
+        {
+            if (outputFile)
+            {
+                gzclose(outputFile);
+                outputFile = nullptr;
+            }
+        };
+
+        static const std::string programStart("----------------------------- program start -----------------------------\n");
+        writeToLogFile(programStart.data(), programStart.size());
+
+        bool exiting = false;
+        while (!exiting)
         {
             if (forceRenew)
             {
-                std::lock_guard<std::mutex> g(logRotationMutex);
                 for (int i = logCountToClean; i--; )
                 {
                     QString toDelete = numberedLogFilename(filename, i);
@@ -235,17 +486,13 @@ private:
                     }
                 }
 
-                outputFile.close();
+                closeLogFile();
                 if (!QFile::remove(filename) )
                 {
                     std::cerr << "Error removing log file!! " << std::endl;
                 }
 
-    #ifdef WIN32
-                outputFile.open(filename.toStdWString().data(), std::ofstream::out);
-    #else
-                outputFile.open(filename.toUtf8().data(), std::ofstream::out);
-    #endif
+                outputFile = openCompressedLog(filename);
                 outFileSize = 0;
 
                 forceRenew = false;
@@ -257,74 +504,43 @@ private:
             }
             else if (forceRotationForReporting || outFileSize > logSizeBeforeCompressMb*1024*1024)
             {
-                std::lock_guard<std::mutex> g(logRotationMutex);
-                for (int i = logCountToClean; i--; )
-                {
-                    QString toRename = numberedLogFilename(filename, i);
+                renumberRotatedLogs();
 
-                    if (QFile::exists(toRename))
-                    {
-                        if (i + 1 >= logCountToRotate)
-                        {
-                            if (!QFile::remove(toRename))
-                            {
-                                std::cerr << "Error removing log file " << i << std::endl;
-                            }
-
-                        }
-                        else
-                        {
-                            if (!QFile(toRename).rename(numberedLogFilename(filename, i + 1)))
-                            {
-                                std::cerr << "Error renaming log file " << i << std::endl;
-                            }
-                        }
-                    }
+                closeLogFile();
+                if (!QFile(filename).rename(numberedLogFilename(filename, 0)))
+                {
+                    std::cerr << "Error renaming log file" << std::endl;
                 }
-                auto newNameDone = numberedLogFilename(filename, 0);
-                auto newNameZipping = newNameDone + QString::fromUtf8(".zipping");
-
-                outputFile.close();
-                QFile::remove(newNameZipping);
-                QFile(filename).rename(newNameZipping);
 
-                bool report = forceRotationForReporting;
-                forceRotationForReporting = false;
+                outputFile = openCompressedLog(filename);
+                outFileSize = 0;
 
-                std::thread t([=]() {
-                    std::lock_guard<std::mutex> g(logRotationMutex); // prevent another rotation while we work on this file (in case of unfortunate timing with bug report etc)
-                    gzipCompressOnRotate(newNameZipping, newNameDone);
-                    if (report && g_megaSyncLogger)
+                if (forceRotationForReporting)
+                {
+                    forceRotationForReporting = false;
+                    if (g_megaSyncLogger)
                     {
                         emit g_megaSyncLogger->logReadyForReporting();
                     }
-                });
-                t.detach();
-
-    #ifdef WIN32
-                outputFile.open(filename.toStdWString().data(), std::ofstream::out);
-    #else
-                outputFile.open(filename.toUtf8().data(), std::ofstream::out);
-    #endif
-                outFileSize = 0;
+                }
             }
 
             LogLinkedList* newMessages = nullptr;
-            bool topLevelMemoryGap = false;
             {
                 std::unique_lock<std::mutex> lock(logMutex);
-                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages, &topLevelMemoryGap]() {
-                        if (forceRenew || logListFirst.next || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog)
+                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages]() {
+                        if (forceRenew || logListFirst.next || pendingThreadBlocks || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog)
                         {
                             newMessages = logListFirst.next;
                             logListFirst.next = nullptr;
                             logListLast = &logListFirst;
-                            topLevelMemoryGap = logListFirst.oomGap;
-                            logListFirst.oomGap = false;
+                            pendingThreadBlocks = false;
                             return true;
                         }
                         else return false;
                 });
+                // Lines logged after this point are harvested below, before leaving the loop
+                exiting = logExit;
             }
 
             if (logToDesktopChanged)
@@ -346,71 +562,57 @@ private:
                 }
             }
 
-            if (topLevelMemoryGap)
+            auto writeLines = [&](const char* lines, size_t size)
             {
-                if (outputFile)
+                writeToLogFile(lines, size);
+                if (logDesktopFile)
                 {
-                    outputFile << "<log gap - out of logging memory at this point>\n";
+                    logDesktopFile.write(lines, static_cast<std::streamsize>(size));
                 }
-                if (logDesktopFile)
+                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
                 {
-                    logDesktopFile << "<log gap - out of logging memory at this point>\n";
+                    std::cout.write(lines, static_cast<std::streamsize>(size));
                 }
+            };
+
+            harvestThreadBuffers(writeLines);
+
+            auto currentLostLines = lostLines.load();
+            if (currentLostLines != reportedLostLines)
+            {
+                std::ostringstream gapStream;
+                gapStream << "<log gap - out of logging memory at this point: " << currentLostLines - reportedLostLines << " lines lost>\n";
+                auto gap = gapStream.str();
+                writeLines(gap.data(), gap.size());
+                reportedLostLines = currentLostLines;
+            }
+
+            if (logDesktopFile)
+            {
+                logDesktopFile.flush(); //always flush in `active` logging
+            }
+            if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
+            {
+                std::cout << std::flush; //always flush into stdout (DEBUG mode)
             }
 
             while (newMessages)
             {
                 auto p = newMessages;
                 newMessages = newMessages->next;
-                if (outputFile)
+                if (p->needsDirectOutput())
                 {
-                    if (p->needsDirectOutput())
+                    std::ostringstream directLine;
+                    (*p->mDirectLoggingFunction)(&directLine);
+                    auto line = directLine.str();
+                    writeLines(line.data(), line.size());
+                    if (logDesktopFile)
                     {
-                        (*p->mDirectLoggingFunction)(&outputFile);
+                        logDesktopFile.flush();
                     }
-                    else
+                    if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
                     {
-                        outputFile << p->message;
-                        outFileSize += p->used;
-                        if (p->oomGap)
-                        {
-                            outputFile << "<log gap - out of logging memory at this point>\n";
-                        }
-                    }
-                }
-                if (logDesktopFile)
-                {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&logDesktopFile);
-                    }
-                    else
-                    {
-                        logDesktopFile << p->message;
-                        if (p->oomGap)
-                        {
-                            logDesktopFile << "<log gap - out of logging memory at this point>\n";
-                        }
-                    }
-                    if (!newMessages)
-                    {
-                        logDesktopFile.flush(); //always flush in `active` logging
-                    }
-                }
-
-                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
-                {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&std::cout);
-                    }
-                    else
-                    {
-                        std::cout << p->message;
-                    }
-                    if (!newMessages)
-                    {
-                        std::cout << std::flush; //always flush into stdout (DEBUG mode)
+                        std::cout << std::flush;
                     }
                 }
                 p->notifyWaiter();
@@ -419,7 +621,11 @@ private:
             if (flushLog || forceRotationForReporting || nextFlushTime <= std::chrono::steady_clock::now())
             {
                 flushLog = false;
-                outputFile.flush();
+                if (outputFile)
+                {
+                    // Everything written so far can be decompressed, even if the log is never closed
+                    gzflush(outputFile, Z_SYNC_FLUSH);
+                }
                 if (logDesktopFile)
                 {
                     logDesktopFile.flush();
@@ -433,7 +639,7 @@ private:
 
             if (closeLog)
             {
-                outputFile.close();
+                closeLogFile();
                 if (logDesktopFile)
                 {
                     logDesktopFile.close();
@@ -441,6 +647,8 @@ private:
                 return;  // This request means we have received a termination signal; close and exit the thread as quick & clean as possible
             }
         }
+
+        closeLogFile();
     }
 
 };
@@ -522,39 +730,64 @@ char* filltime(char* s, struct tm*  gmt, int microsec)
     return s;
 }
 
-std::mutex threadNameMutex;
-std::map<std::thread::id, std::string> threadNames;
-struct tm lastTm;
-time_t lastT = 0;
-std::thread::id lastThreadId;
-const char* lastThreadName;
-
-void cacheThreadNameAndTimeT(time_t t, struct tm& gmt, const char*& threadname)
+namespace
 {
-    std::lock_guard<std::mutex> g(threadNameMutex);
+struct ThreadLogBufferHolder
+{
+    LoggingThread* owner = nullptr;
+    std::shared_ptr<ThreadLogBuffer> buffer;
 
-    if (t != lastT)
+    ~ThreadLogBufferHolder()
     {
-        lastTm = *std::gmtime(&t);
-        lastT = t;
+        if (buffer)
+        {
+            buffer->threadFinished = true;
+        }
     }
-    gmt = lastTm;
+};
 
-    if (lastThreadId == std::this_thread::get_id())
-    {
-        threadname = lastThreadName;
-        return;
-    }
+void safeGmtime(time_t t, struct tm& gmt)
+{
+#ifdef WIN32
+    gmtime_s(&gmt, &t);
+#else
+    gmtime_r(&t, &gmt);
+#endif
+}
+}
+
+ThreadLogBuffer* LoggingThread::getThreadBuffer()
+{
+    thread_local ThreadLogBufferHolder holder;
 
-    auto& entry = threadNames[std::this_thread::get_id()];
-    if (entry.empty())
+    if (holder.owner != this || !holder.buffer)
     {
+        auto buffer = std::make_shared<ThreadLogBuffer>();
+        buffer->writeBlock = buffer->readBlock = LogBlock::create(THREAD_LOG_BLOCK_SIZE);
+        if (!buffer->writeBlock)
+        {
+            return nullptr;
+        }
+        buffer->pendingBytes = THREAD_LOG_BLOCK_SIZE;
+
         std::ostringstream s;
         s << std::this_thread::get_id() << " ";
-        entry = s.str();
+        buffer->threadName = s.str();
+
+        {
+            std::lock_guard<std::mutex> g(threadBuffersMutex);
+            threadBuffers.push_back(buffer);
+        }
+
+        if (holder.buffer)
+        {
+            holder.buffer->threadFinished = true;
+        }
+        holder.buffer = buffer;
+        holder.owner = this;
     }
-    threadname = lastThreadName = entry.c_str();
-    lastThreadId = std::this_thread::get_id();
+
+    return holder.buffer.get();
 }
 
 void MegaSyncLogger::log(const char*, int loglevel, const char*, const char *message
@@ -598,18 +831,26 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
         return;
     }
 
-    bool direct = directMessages != nullptr;
+    auto buffer = getThreadBuffer();
+    if (!buffer)
+    {
+        ++lostLines;
+        return;
+    }
 
     char timebuf[LOG_TIME_CHARS + 1];
     auto now = std::chrono::system_clock::now();
     time_t t = std::chrono::system_clock::to_time_t(now);
 
-    struct tm gmt;
-    const char* threadname;
-    cacheThreadNameAndTimeT(t, gmt, threadname);
+    if (t != buffer->lastT)
+    {
+        safeGmtime(t, buffer->lastTm);
+        buffer->lastT = t;
+    }
+    const char* threadname = buffer->threadName.c_str();
 
     auto microsec = std::chrono::duration_cast<std::chrono::microseconds>(now - std::chrono::system_clock::from_time_t(t));
-    filltime(timebuf, &gmt, (int)microsec.count() % 1000000);
+    filltime(timebuf, &buffer->lastTm, (int)microsec.count() % 1000000);
 
     const char* loglevelstring = "     ";
     switch (loglevel) // keeping these at 4 chars makes nice columns, easy to read
@@ -622,127 +863,175 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     case mega::MegaApi::LOG_LEVEL_MAX: loglevelstring = "DTL  "; break;
     }
 
-    auto messageLen = strlen(message);
-    auto threadnameLen = strlen(threadname);
-    auto lineLen = LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen;
-    bool notify = false;
+    bool flush = loglevel <= flushOnLevel;
 
+    if (directMessages)
     {
-        std::unique_ptr<std::lock_guard<std::mutex>> g(new std::lock_guard<std::mutex>(logMutex));
-
-        bool isRepeat = !direct && logListLast != &logListFirst &&
-                        logListLast->lastmessage >= 0 &&
-                        !strncmp(message, logListLast->message + logListLast->lastmessage, messageLen);
-
-        if (isRepeat)
+        if (flush)
         {
-            ++logListLast->lastmessageRepeats;
+            flushLog = true;
         }
-        else
-        {
-            unsigned reportRepeats = logListLast != &logListFirst ? logListLast->lastmessageRepeats : 0;
-            if (reportRepeats)
-            {
-                lineLen += 30;
-                logListLast->lastmessageRepeats = 0;
-            }
+        logDirect(timebuf, threadname, loglevelstring, directMessages, directMessagesSizes, numberMessages);
+        return;
+    }
 
-#if defined(WIN32) && defined(DEBUG)
-            OutputDebugStringA(std::string(timebuf).c_str());
-            OutputDebugStringA(std::string(threadname).c_str());
-            OutputDebugStringA(std::string(loglevelstring).c_str());
-            if (message)
-            {
-                OutputDebugStringA(std::string(message, messageLen).c_str());
-            }
-            for(int i = 0; i < numberMessages; i++)
-            {
-                OutputDebugStringA(std::string(directMessages[i], directMessagesSizes[i]).c_str());
-            }
-            OutputDebugStringA("\r\n");
-#endif
-            if (direct)
-            {
-                if (LogLinkedList* newentry = LogLinkedList::create(logListLast, 1 + sizeof(LogLinkedList))) //create a new "empty" element
-                {
-                    logListLast = newentry;
-                    std::promise<void> promise;
-                    logListLast->mCompletionPromise = &promise;
-                    auto future = logListLast->mCompletionPromise->get_future();
-                    DirectLogFunction func = [&timebuf, &threadname, &loglevelstring, &directMessages, &directMessagesSizes, numberMessages](std::ostream *oss)
-                    {
-                        *oss << timebuf << threadname << loglevelstring;
+    auto messageLen = strlen(message);
+    auto threadnameLen = buffer->threadName.size();
+    auto lineLen = sizeof(LogLineHeader) + LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen + 1;
 
-                        for(int i = 0; i < numberMessages; i++)
-                        {
-                            oss->write(directMessages[i], directMessagesSizes[i]);
-                        }
-                        *oss << std::endl;
-                    };
+    auto block = buffer->writeBlock;
+    auto used = block->committed.load(std::memory_order_relaxed);
 
-                    logListLast->mDirectLoggingFunction = &func;
+    bool isRepeat = buffer->lastmessage >= 0 &&
+                    size_t(buffer->lastmessage) + messageLen < used &&
+                    !strncmp(message, block->data + buffer->lastmessage, messageLen) &&
+                    block->data[buffer->lastmessage + messageLen] == '\n';
+    if (isRepeat)
+    {
+        ++buffer->lastmessageRepeats;
+        return;
+    }
 
-                    g.reset(); //to liberate the mutex and let the logging thread call the logging function
+    unsigned reportRepeats = buffer->lastmessageRepeats;
+    if (reportRepeats)
+    {
+        lineLen += 30;
+        buffer->lastmessageRepeats = 0;
+    }
 
-                    logConditionVariable.notify_one();
+#if defined(WIN32) && defined(DEBUG)
+    OutputDebugStringA(std::string(timebuf).c_str());
+    OutputDebugStringA(std::string(threadname).c_str());
+    OutputDebugStringA(std::string(loglevelstring).c_str());
+    OutputDebugStringA(std::string(message, messageLen).c_str());
+    OutputDebugStringA("\r\n");
+#endif
 
-                    //wait for until logging thread completes the outputting
-                    future.get();
-                    return;
-                }
-                else
-                {
-                    logListLast->oomGap = true;
-                }
+    bool notify = false;
+    if (!block->lineFits(lineLen))
+    {
+        auto blockSize = std::max<size_t>(lineLen + 1, THREAD_LOG_BLOCK_SIZE);
+        LogBlock* newBlock = nullptr;
+        if (buffer->pendingBytes + blockSize <= MAX_THREAD_LOG_PENDING_BYTES)
+        {
+            newBlock = LogBlock::create(blockSize);
+        }
 
-            }
-            else
-            {
-                if (logListLast == &logListFirst || logListLast->oomGap || !logListLast->messageFits(lineLen))
-                {
-                    if (LogLinkedList* newentry = LogLinkedList::create(logListLast, std::max<size_t>(lineLen, 8192) + sizeof(LogLinkedList) + 10))
-                    {
-                        logListLast = newentry;
-                    }
-                    else
-                    {
-                        logListLast->oomGap = true;
-                    }
-                }
-                if (!logListLast->oomGap)
-                {
-                    if (reportRepeats)
-                    {
-                        char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
-                        int n = snprintf(repeatbuf, 30, "[repeated x%u]\n", reportRepeats);
-                        logListLast->append(repeatbuf, n);
-                    }
-                    logListLast->append(timebuf, LOG_TIME_CHARS);
-                    logListLast->append(threadname, unsigned(threadnameLen));
-                    logListLast->append(loglevelstring, LOG_LEVEL_CHARS);
-                    logListLast->lastmessage = logListLast->used;
-                    logListLast->append(message, unsigned(messageLen));
-                    logListLast->append("\n", 1);
-                    notify = logListLast->used + 1024 > logListLast->allocated;
-                }
-            }
+        if (!newBlock)
+        {
+            // Reported by the logging thread as a log gap
+            ++lostLines;
+            buffer->lastmessage = -1;
+            return;
         }
 
-        if (loglevel <= flushOnLevel)
+        buffer->pendingBytes += blockSize;
+        block->next.store(newBlock, std::memory_order_release);
+        buffer->writeBlock = block = newBlock;
+        used = 0;
+        notify = true;
+    }
+
+    auto write = [block, &used](const char* s, size_t n)
+    {
+        memcpy(block->data + used, s, n);
+        used += unsigned(n);
+    };
+
+    // Published before taking the sequence, so the logging thread does not write later lines before this one
+    buffer->writingSequence = nextLineSequence.load();
+    LogLineHeader header{nextLineSequence++, 0};
+    auto headerOffset = used;
+    used += unsigned(sizeof(header));
+
+    if (reportRepeats)
+    {
+        char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
+        int n = snprintf(repeatbuf, 30, "[repeated x%u]\n", reportRepeats);
+        write(repeatbuf, size_t(n));
+    }
+    write(timebuf, LOG_TIME_CHARS);
+    write(threadname, threadnameLen);
+    write(loglevelstring, LOG_LEVEL_CHARS);
+    buffer->lastmessage = int(used);
+    write(message, messageLen);
+    write("\n", 1);
+
+    header.size = used - headerOffset - unsigned(sizeof(header));
+    memcpy(block->data + headerOffset, &header, sizeof(header));
+    block->committed.store(used, std::memory_order_release);
+    buffer->writingSequence = NO_LOG_LINE_SEQUENCE;
+
+    if (flush)
+    {
+        // Set once the line is committed, so the logging thread writes and flushes it now.
+        // Under the mutex, so the logging thread cannot miss the notification
         {
+            std::lock_guard<std::mutex> g(logMutex);
             flushLog = true;
         }
+        logConditionVariable.notify_one();
+    }
+    else if (notify)
+    {
+        // A block is full: wake up the logging thread instead of waiting for its periodic harvest.
+        // Notifying without the mutex, the logging thread wakes up by itself every 500ms anyway
+        pendingThreadBlocks = true;
+        logConditionVariable.notify_one();
     }
+}
+
+void LoggingThread::logDirect(const char* timebuf, const char* threadname, const char* loglevelstring,
+                              const char **directMessages, size_t *directMessagesSizes, int numberMessages)
+{
+    std::unique_ptr<std::lock_guard<std::mutex>> g(new std::lock_guard<std::mutex>(logMutex));
 
-    if (notify)
+#if defined(WIN32) && defined(DEBUG)
+    OutputDebugStringA(std::string(timebuf).c_str());
+    OutputDebugStringA(std::string(threadname).c_str());
+    OutputDebugStringA(std::string(loglevelstring).c_str());
+    for(int i = 0; i < numberMessages; i++)
+    {
+        OutputDebugStringA(std::string(directMessages[i], directMessagesSizes[i]).c_str());
+    }
+    OutputDebugStringA("\r\n");
+#endif
+
+    if (LogLinkedList* newentry = LogLinkedList::create(logListLast)) //create a new "empty" element
     {
-        // notify outside the mutex lock is better (and correct) for much less chance the other
-        // thread wakes up just to find the mutex locked. (saw lower cpu on the other thread like this)
-        // Still, this notify call was taking 1% when notifying on every log line, so let the other thead
-        // wake up by itself every 500ms without notify for the common case.
-        // But still wake it if our memory block is getting full
+        logListLast = newentry;
+        std::promise<void> promise;
+        logListLast->mCompletionPromise = &promise;
+        auto future = logListLast->mCompletionPromise->get_future();
+        DirectLogFunction func = [&timebuf, &threadname, &loglevelstring, &directMessages, &directMessagesSizes, numberMessages](std::ostream *oss)
+        {
+            *oss << timebuf << threadname << loglevelstring;
+
+            for(int i = 0; i < numberMessages; i++)
+            {
+                oss->write(directMessages[i], directMessagesSizes[i]);
+            }
+            *oss << std::endl;
+        };
+
+        logListLast->mDirectLoggingFunction = &func;
+
+        g.reset(); //to liberate the mutex and let the logging thread call the logging function
+
         logConditionVariable.notify_one();
+
+        //wait for until logging thread completes the outputting
+        future.get();
     }
+    else
+    {
+        ++lostLines;
+    }
+}
+
+unsigned long long MegaSyncLogger::getLostLines() const
+{
+    return g_loggingThread->lostLines;
 }
 
 void MegaSyncLogger::setDebug(const bool enable)
@@ -27,6 +27,8 @@ public:
              ) override;
     void setDebug(bool enable);
     bool isDebug() const;
+    // Lines that could not be logged because the logging memory was exhausted
+    unsigned long long getLostLines() const;
     bool mLogToStdout = false;
 
     // this one is called on signal (flush log before crash report)
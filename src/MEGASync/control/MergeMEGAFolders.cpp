@@ -1,134 +1,125 @@
 #include "MergeMEGAFolders.h"
 
-#include <MegaApiSynchronizedRequest.h>
 #include <MegaApplication.h>
 #include <MoveToMEGABin.h>
+#include <QTMegaRequestListener.h>
 #include <Utilities.h>
 
+#include <QEventLoop>
 
-std::shared_ptr<mega::MegaError> MergeMEGAFolders::merge(ActionForDuplicates action)
+namespace
 {
-    std::shared_ptr<mega::MegaError> error(nullptr);
-
-    QStringList itemsBeingRenamed;
-
-    std::unique_ptr<mega::MegaNodeList> folderTargetNodes(MegaSyncApp->getMegaApi()->getChildren(mFolderTarget));
-    QMultiMap<QString, int> nodesIndexesByName;
-    for(int index = 0; index < folderTargetNodes->size(); ++index)
-    {
-        auto node(folderTargetNodes->get(index));
-        nodesIndexesByName.insert(QString::fromUtf8(node->getName()), index);
-    }
+class MegaApiMergeFolders : public MergeMEGAFoldersApi
+{
+public:
+    MegaApiMergeFolders()
+        : mMegaApi(MegaSyncApp->getMegaApi())
+    {}
 
-    std::unique_ptr<mega::MegaNodeList> folderToMergeNodes(MegaSyncApp->getMegaApi()->getChildren(mFolderToMerge));
-    for(int index = 0; index < folderToMergeNodes->size(); ++index)
+    QList<MergeMEGAFoldersNode> getChildren(mega::MegaHandle folder) override
     {
-        auto node(folderToMergeNodes->get(index));
-        QString nodeName(QString::fromUtf8(node->getName()));
-        auto targetIndexes(nodesIndexesByName.values(nodeName));
-        if(!targetIndexes.isEmpty())
+        QList<MergeMEGAFoldersNode> children;
+        std::unique_ptr<mega::MegaNode> folderNode(mMegaApi->getNodeByHandle(folder));
+        if(folderNode)
         {
-            bool duplicateFound(false);
-            foreach(auto targetIndex, targetIndexes)
+            std::unique_ptr<mega::MegaNodeList> nodes(mMegaApi->getChildren(folderNode.get()));
+            children.reserve(nodes->size());
+            for(int index = 0; index < nodes->size(); ++index)
             {
-                auto targetNode(folderTargetNodes->get(targetIndex));
-                if(node->isFile() && targetNode->isFile())
-                {
-                    auto nodeFp(QString::fromUtf8(node->getFingerprint()));
-                    auto targetNodeFp(QString::fromUtf8(targetNode->getFingerprint()));
-                    if(nodeFp == targetNodeFp)
-                    {
-                        duplicateFound = true;
-                        break;
-                    }
-                }
-                else if(node->isFolder() && targetNode->isFolder())
-                {
-                    mDepth++;
-                    MergeMEGAFolders folderMerge(targetNode, node);
-                    folderMerge.merge(action);
-                    mDepth--;
-                    std::unique_ptr<mega::MegaNodeList>folderChild(MegaSyncApp->getMegaApi()->getChildren(node));
-                    if(action == ActionForDuplicates::IgnoreAndRemove || folderChild->size() == 0)
-                    {
-                        error = MegaApiSynchronizedRequest::runRequest(&mega::MegaApi::remove, MegaSyncApp->getMegaApi(), node);
-                        if(error)
-                        {
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        duplicateFound = true;
-                    }
-                }
+                auto node(nodes->get(index));
+                MergeMEGAFoldersNode child;
+                child.handle = node->getHandle();
+                child.name = QString::fromUtf8(node->getName());
+                child.isFile = node->isFile();
+                child.fingerprint = QString::fromUtf8(node->getFingerprint());
+                children.append(child);
             }
+        }
+        return children;
+    }
 
-            if(!duplicateFound || action == ActionForDuplicates::Rename)
-            {
-                auto newName = Utilities::getNonDuplicatedNodeName(
-                    node, mFolderTarget, nodeName, true, itemsBeingRenamed);
-
-                error = MegaApiSynchronizedRequest::runRequestLambda([this](mega::MegaNode* node,
-                                                           mega::MegaNode* targetNode,
-                                                           const char* newName,
-                                                           mega::MegaRequestListener* listener)
-                       { MegaSyncApp->getMegaApi()->moveNode(node, targetNode, newName, listener); },
-                       MegaSyncApp->getMegaApi(),
-                       node,
-                       mFolderTarget,
-                    newName.toStdString().c_str());
-
-                if(error)
-                {
-                    break;
-                }
-            }
+    void moveNode(mega::MegaHandle node, mega::MegaHandle targetFolder, const QString& newName,
+                  RequestFinished onFinished) override
+    {
+        //The SDK reports the nodes not found as request errors
+        std::unique_ptr<mega::MegaNode> nodeToMove(mMegaApi->getNodeByHandle(node));
+        std::unique_ptr<mega::MegaNode> targetNode(mMegaApi->getNodeByHandle(targetFolder));
+        if(newName.isEmpty())
+        {
+            mMegaApi->moveNode(nodeToMove.get(), targetNode.get(), createListener(onFinished));
         }
         else
         {
-            error = MegaApiSynchronizedRequest::runRequestLambda([this](mega::MegaNode* node,
-                                                       mega::MegaNode* targetNode,
-                                                       mega::MegaRequestListener* listener)
-                   { MegaSyncApp->getMegaApi()->moveNode(node, targetNode, listener); },
-                   MegaSyncApp->getMegaApi(),
-                   node,
-                mFolderTarget);
-
-            if(error)
-            {
-                break;
-            }
+            mMegaApi->moveNode(nodeToMove.get(), targetNode.get(), newName.toUtf8().constData(), createListener(onFinished));
         }
     }
 
-    //Only done when the recursion finishes and there is no error
-    if(!error && mDepth == 0)
+    void remove(mega::MegaHandle node, RequestFinished onFinished) override
+    {
+        std::unique_ptr<mega::MegaNode> nodeToRemove(mMegaApi->getNodeByHandle(node));
+        mMegaApi->remove(nodeToRemove.get(), createListener(onFinished));
+    }
+
+    void moveToBin(mega::MegaHandle node, RequestFinished onFinished) override
+    {
+        //Only done once per merge, so it is fine to wait for it
+        auto moveToBinError = MoveToMEGABin::moveToBin(node, QLatin1String("FoldersMerge"), true);
+        onFinished(moveToBinError.binFolderCreationError ? moveToBinError.binFolderCreationError
+                                                         : moveToBinError.moveError);
+    }
+
+private:
+    mega::OnFinishOneShot* createListener(RequestFinished onFinished)
     {
-        std::unique_ptr<mega::MegaNodeList>folderChild(MegaSyncApp->getMegaApi()->getChildren(mFolderToMerge));
-        if(folderChild->size() != 0)
+        return new mega::OnFinishOneShot(mMegaApi, [onFinished](bool, const mega::MegaRequest&, const mega::MegaError& e)
         {
-            MoveToMEGABin toBin;
-            auto moveToBinError = toBin.moveToBin(mFolderToMerge->getHandle(), QLatin1String("FoldersMerge"), true);
-            if(moveToBinError.binFolderCreationError)
-            {
-                error = moveToBinError.binFolderCreationError;
-            }
-            else if(!moveToBinError.moveError)
+            std::shared_ptr<mega::MegaError> error(nullptr);
+            if(e.getErrorCode() != mega::MegaError::API_OK)
             {
-                error = moveToBinError.moveError;
+                error.reset(e.copy());
             }
-        }
-        else
-        {
-            error = MegaApiSynchronizedRequest::runRequest(&mega::MegaApi::remove, MegaSyncApp->getMegaApi(), mFolderToMerge);
-        }
+            onFinished(error);
+        });
     }
 
+    mega::MegaApi* mMegaApi;
+};
+}
+
+std::shared_ptr<mega::MegaError> MergeMEGAFolders::merge(ActionForDuplicates action)
+{
+    auto executor(createExecutor(action));
+
+    //One event loop for the whole merge
+    QEventLoop eventLoop;
+    QObject::connect(executor.get(), &MergeMEGAFoldersExecutor::finished, &eventLoop, &QEventLoop::quit);
+    executor->start();
+    if(executor->isRunning())
+    {
+        eventLoop.exec();
+    }
+
+    auto error(executor->getError());
     if(error)
     {
-        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Merge folders failed. Error: %1").arg(Utilities::getTranslatedError(error.get()))
-                                                   .toUtf8().constData());
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Merge folders failed (%1/%2 done). Error: %3")
+                                                               .arg(QString::number(executor->getFinishedSteps()),
+                                                                    QString::number(executor->getTotalSteps()),
+                                                                    Utilities::getTranslatedError(error.get()))
+                                                               .toUtf8().constData());
     }
     return error;
 }
+
+std::unique_ptr<MergeMEGAFoldersExecutor> MergeMEGAFolders::createExecutor(ActionForDuplicates action)
+{
+    auto api(std::make_shared<MegaApiMergeFolders>());
+    auto plan(MergeMEGAFoldersPlan::create(api.get(), mFolderTarget->getHandle(), mFolderToMerge->getHandle(), action));
+
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Merge folders plan: %1 moves, %2 removals")
+                                                           .arg(QString::number(plan.count(MergeMEGAFoldersPlan::Step::Type::Move)),
+                                                                QString::number(plan.count(MergeMEGAFoldersPlan::Step::Type::Remove)))
+                                                           .toUtf8().constData());
+
+    return std::unique_ptr<MergeMEGAFoldersExecutor>(new MergeMEGAFoldersExecutor(api, plan));
+}
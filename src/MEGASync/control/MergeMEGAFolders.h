@@ -1,6 +1,8 @@
 #ifndef MERGEMEGAFOLDERS_H
 #define MERGEMEGAFOLDERS_H
 
+#include "MergeMEGAFoldersPlan.h"
+
 #include <megaapi.h>
 #include <memory>
 
@@ -18,28 +20,28 @@
         c. If the secondary and the main folder have a folder with the same name:
             i.  We run this algorithm recursively but updating the main and the secondary folders pointer.
         d. If the secondary folder has a folder which is not in the main folder, we move it directly
+
+   The whole merge is planned first (MergeMEGAFoldersPlan) from the children of both folders,
+   and then the requests are sent in parallel (MergeMEGAFoldersExecutor)
 */
 class MergeMEGAFolders
 {
 public:
     MergeMEGAFolders(mega::MegaNode* folderTarget, mega::MegaNode* folderToMerge)
         : mFolderTarget(folderTarget),
-          mFolderToMerge(folderToMerge),
-          mDepth(0)
+          mFolderToMerge(folderToMerge)
     {}
 
-    enum ActionForDuplicates
-    {
-        Rename,
-        IgnoreAndRemove,
-        IgnoreAndMoveToBin,
-    };
+    using ActionForDuplicates = MergeMEGAFoldersPlan::ActionForDuplicates;
+
+    //Runs the merge synchronously
     std::shared_ptr<mega::MegaError> merge(ActionForDuplicates action);
 
 private:
+    std::unique_ptr<MergeMEGAFoldersExecutor> createExecutor(ActionForDuplicates action);
+
     mega::MegaNode* mFolderTarget;
     mega::MegaNode* mFolderToMerge;
-    int mDepth;
 };
 
 #endif // MERGEMEGAFOLDERS_H
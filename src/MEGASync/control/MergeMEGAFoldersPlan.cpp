@@ -0,0 +1,327 @@
+#include "MergeMEGAFoldersPlan.h"
+
+#include <Utilities.h>
+
+#include <QMultiHash>
+
+#include <algorithm>
+
+const int MergeMEGAFoldersExecutor::DEFAULT_MAX_REQUESTS_IN_FLIGHT = 16;
+
+//PLAN
+MergeMEGAFoldersPlan MergeMEGAFoldersPlan::create(MergeMEGAFoldersApi* api,
+                                                  mega::MegaHandle folderTarget,
+                                                  mega::MegaHandle folderToMerge,
+                                                  ActionForDuplicates action)
+{
+    MergeMEGAFoldersPlan plan;
+    QList<int> folderSteps;
+    auto itemsLeft(plan.addFolder(api, folderTarget, folderToMerge, action, folderSteps));
+
+    //The merged folder is removed, or moved to the bin if it still has children
+    plan.addStep(itemsLeft ? Step::Type::MoveToBin : Step::Type::Remove,
+                 folderToMerge, mega::INVALID_HANDLE, QString(), folderSteps);
+    return plan;
+}
+
+const std::vector<MergeMEGAFoldersPlan::Step>& MergeMEGAFoldersPlan::getSteps() const
+{
+    return mSteps;
+}
+
+int MergeMEGAFoldersPlan::count(Step::Type type) const
+{
+    return static_cast<int>(std::count_if(mSteps.begin(), mSteps.end(), [type](const Step& step)
+    {
+        return step.type == type;
+    }));
+}
+
+bool MergeMEGAFoldersPlan::addFolder(MergeMEGAFoldersApi* api,
+                                     mega::MegaHandle folderTarget,
+                                     mega::MegaHandle folderToMerge,
+                                     ActionForDuplicates action,
+                                     QList<int>& folderSteps)
+{
+    bool itemsLeft(false);
+
+    const auto targetNodes(api->getChildren(folderTarget));
+    QMultiHash<QString, int> nodesIndexesByName;
+    UniqueNameIndex usedNames;
+    for(int index = 0; index < targetNodes.size(); ++index)
+    {
+        nodesIndexesByName.insert(targetNodes.at(index).name, index);
+        usedNames.addName(targetNodes.at(index).name);
+    }
+
+    const auto nodesToMerge(api->getChildren(folderToMerge));
+    for(const auto& node : nodesToMerge)
+    {
+        auto targetIndexes(nodesIndexesByName.values(node.name));
+        if(targetIndexes.isEmpty())
+        {
+            folderSteps.append(addStep(Step::Type::Move, node.handle, folderTarget, QString(), QList<int>()));
+            usedNames.addName(node.name);
+            continue;
+        }
+
+        bool duplicateFound(false);
+        bool folderMerged(false);
+        for(auto targetIndex : qAsConst(targetIndexes))
+        {
+            const auto& targetNode(targetNodes.at(targetIndex));
+            if(node.isFile && targetNode.isFile)
+            {
+                if(node.fingerprint == targetNode.fingerprint)
+                {
+                    duplicateFound = true;
+                    break;
+                }
+            }
+            else if(!node.isFile && !targetNode.isFile)
+            {
+                QList<int> mergeSteps;
+                auto folderItemsLeft(addFolder(api, targetNode.handle, node.handle, action, mergeSteps));
+                if(action == ActionForDuplicates::IgnoreAndRemove || !folderItemsLeft)
+                {
+                    //Removed once its children are moved
+                    folderSteps.append(addStep(Step::Type::Remove, node.handle, mega::INVALID_HANDLE, QString(), mergeSteps));
+                    folderMerged = true;
+                }
+                else
+                {
+                    folderSteps.append(mergeSteps);
+                    duplicateFound = true;
+                }
+                break;
+            }
+        }
+
+        if(folderMerged)
+        {
+            continue;
+        }
+
+        if(!duplicateFound || action == ActionForDuplicates::Rename)
+        {
+            auto newName(getNonDuplicatedName(node, usedNames));
+            usedNames.addName(newName);
+            folderSteps.append(addStep(Step::Type::Move, node.handle, folderTarget, newName, QList<int>()));
+        }
+        else
+        {
+            itemsLeft = true;
+        }
+    }
+
+    return itemsLeft;
+}
+
+int MergeMEGAFoldersPlan::addStep(Step::Type type, mega::MegaHandle node, mega::MegaHandle targetFolder,
+                                  const QString& newName, const QList<int>& dependencies)
+{
+    int index(static_cast<int>(mSteps.size()));
+    for(auto dependency : dependencies)
+    {
+        mSteps[dependency].dependent = index;
+    }
+    mSteps.push_back(Step{type, node, targetFolder, newName, dependencies.size(), -1});
+    return index;
+}
+
+QString MergeMEGAFoldersPlan::getNonDuplicatedName(const MergeMEGAFoldersNode& node, const UniqueNameIndex& usedNames)
+{
+    QString baseName(node.name);
+    QString suffix;
+    if(node.isFile)
+    {
+        auto nameSplitted(Utilities::getFilenameBasenameAndSuffix(node.name));
+        if(nameSplitted != QPair<QString, QString>())
+        {
+            baseName = nameSplitted.first;
+            suffix = nameSplitted.second;
+        }
+    }
+
+    return UniqueNameIndex::getCounterName(baseName, usedNames.getFreeCounter(baseName, suffix), suffix);
+}
+
+//EXECUTOR
+MergeMEGAFoldersExecutor::MergeMEGAFoldersExecutor(std::shared_ptr<MergeMEGAFoldersApi> api,
+                                                   const MergeMEGAFoldersPlan& plan,
+                                                   int maxRequestsInFlight,
+                                                   QObject* parent)
+    : QObject(parent),
+      mApi(api),
+      mSteps(plan.getSteps()),
+      mMaxRequestsInFlight(std::max(1, maxRequestsInFlight)),
+      mStates(mSteps.size(), StepState::Pending),
+      mRequestsInFlight(0),
+      mFinishedSteps(0),
+      mRunning(false),
+      mCancelled(false),
+      mIssuingRequests(false)
+{
+    mRemainingDependencies.reserve(mSteps.size());
+    for(int index = 0; index < static_cast<int>(mSteps.size()); ++index)
+    {
+        mRemainingDependencies.push_back(mSteps.at(index).dependencies);
+        if(mSteps.at(index).dependencies == 0)
+        {
+            mReadySteps.push_back(index);
+        }
+    }
+}
+
+void MergeMEGAFoldersExecutor::start()
+{
+    if(mRunning)
+    {
+        return;
+    }
+
+    mRunning = true;
+    mCancelled = false;
+    mError.reset();
+    for(int index = 0; index < static_cast<int>(mStates.size()); ++index)
+    {
+        if(mStates.at(index) == StepState::Failed)
+        {
+            mStates[index] = StepState::Pending;
+            mReadySteps.push_back(index);
+        }
+    }
+
+    issueRequests();
+}
+
+void MergeMEGAFoldersExecutor::cancel()
+{
+    if(mRunning)
+    {
+        mCancelled = true;
+        issueRequests();
+    }
+}
+
+bool MergeMEGAFoldersExecutor::isRunning() const
+{
+    return mRunning;
+}
+
+bool MergeMEGAFoldersExecutor::isCancelled() const
+{
+    return mCancelled;
+}
+
+bool MergeMEGAFoldersExecutor::isCompleted() const
+{
+    return mFinishedSteps == getTotalSteps();
+}
+
+int MergeMEGAFoldersExecutor::getFinishedSteps() const
+{
+    return mFinishedSteps;
+}
+
+int MergeMEGAFoldersExecutor::getTotalSteps() const
+{
+    return static_cast<int>(mSteps.size());
+}
+
+std::shared_ptr<mega::MegaError> MergeMEGAFoldersExecutor::getError() const
+{
+    return mError;
+}
+
+void MergeMEGAFoldersExecutor::issueRequests()
+{
+    //The requests finished synchronously are handled by the loop, not by recursion
+    if(mIssuingRequests)
+    {
+        return;
+    }
+
+    mIssuingRequests = true;
+    while(!mCancelled && !mError
+          && mRequestsInFlight < mMaxRequestsInFlight
+          && !mReadySteps.empty())
+    {
+        auto index(mReadySteps.front());
+        mReadySteps.pop_front();
+        startStep(index);
+    }
+    mIssuingRequests = false;
+
+    if(mRunning && mRequestsInFlight == 0
+       && (mCancelled || mError || mReadySteps.empty()))
+    {
+        mRunning = false;
+        emit finished();
+    }
+}
+
+void MergeMEGAFoldersExecutor::startStep(int index)
+{
+    mStates[index] = StepState::InFlight;
+    ++mRequestsInFlight;
+
+    QPointer<MergeMEGAFoldersExecutor> executor(this);
+    auto onFinished = [executor, index](std::shared_ptr<mega::MegaError> error)
+    {
+        if(executor)
+        {
+            executor->onStepFinished(index, error);
+        }
+    };
+
+    const auto& step(mSteps.at(index));
+    switch(step.type)
+    {
+        case MergeMEGAFoldersPlan::Step::Type::Move:
+        {
+            mApi->moveNode(step.node, step.targetFolder, step.newName, onFinished);
+            break;
+        }
+        case MergeMEGAFoldersPlan::Step::Type::Remove:
+        {
+            mApi->remove(step.node, onFinished);
+            break;
+        }
+        case MergeMEGAFoldersPlan::Step::Type::MoveToBin:
+        {
+            mApi->moveToBin(step.node, onFinished);
+            break;
+        }
+    }
+}
+
+void MergeMEGAFoldersExecutor::onStepFinished(int index, std::shared_ptr<mega::MegaError> error)
+{
+    --mRequestsInFlight;
+
+    if(error)
+    {
+        //The steps waiting for it are not started
+        mStates[index] = StepState::Failed;
+        if(!mError)
+        {
+            mError = error;
+        }
+    }
+    else
+    {
+        mStates[index] = StepState::Done;
+        ++mFinishedSteps;
+
+        auto dependent(mSteps.at(index).dependent);
+        if(dependent >= 0 && --mRemainingDependencies[dependent] == 0)
+        {
+            mReadySteps.push_back(dependent);
+        }
+
+        emit progress(mFinishedSteps, getTotalSteps());
+    }
+
+    issueRequests();
+}
@@ -0,0 +1,152 @@
+#ifndef MERGEMEGAFOLDERSPLAN_H
+#define MERGEMEGAFOLDERSPLAN_H
+
+#include "UniqueNameIndex.h"
+
+#include <megaapi.h>
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct MergeMEGAFoldersNode
+{
+    mega::MegaHandle handle = mega::INVALID_HANDLE;
+    QString name;
+    bool isFile = false;
+    QString fingerprint;
+};
+
+/// Responsability: access the cloud nodes merged by MergeMEGAFolders, so the merge can run against a mock
+class MergeMEGAFoldersApi
+{
+public:
+    // nullptr when the request succeeds. Called in the thread that started the request
+    using RequestFinished = std::function<void(std::shared_ptr<mega::MegaError>)>;
+
+    virtual ~MergeMEGAFoldersApi() = default;
+
+    virtual QList<MergeMEGAFoldersNode> getChildren(mega::MegaHandle folder) = 0;
+    // The node keeps its name when newName is empty
+    virtual void moveNode(mega::MegaHandle node, mega::MegaHandle targetFolder, const QString& newName,
+                          RequestFinished onFinished) = 0;
+    virtual void remove(mega::MegaHandle node, RequestFinished onFinished) = 0;
+    virtual void moveToBin(mega::MegaHandle node, RequestFinished onFinished) = 0;
+};
+
+/// Responsability: compute every request of a folders merge from snapshots of the folders children
+class MergeMEGAFoldersPlan
+{
+public:
+    enum ActionForDuplicates
+    {
+        Rename,
+        IgnoreAndRemove,
+        IgnoreAndMoveToBin,
+    };
+
+    struct Step
+    {
+        enum class Type
+        {
+            Move,
+            Remove,
+            MoveToBin,
+        };
+
+        Type type;
+        mega::MegaHandle node;
+        mega::MegaHandle targetFolder;
+        QString newName;
+        // Steps to finish before starting this one
+        int dependencies;
+        // Step waiting for this one, -1 if none
+        int dependent;
+    };
+
+    static MergeMEGAFoldersPlan create(MergeMEGAFoldersApi* api,
+                                       mega::MegaHandle folderTarget,
+                                       mega::MegaHandle folderToMerge,
+                                       ActionForDuplicates action);
+
+    const std::vector<Step>& getSteps() const;
+    int count(Step::Type type) const;
+
+private:
+    // Returns true when some children are left in folderToMerge
+    bool addFolder(MergeMEGAFoldersApi* api,
+                   mega::MegaHandle folderTarget,
+                   mega::MegaHandle folderToMerge,
+                   ActionForDuplicates action,
+                   QList<int>& folderSteps);
+    int addStep(Step::Type type, mega::MegaHandle node, mega::MegaHandle targetFolder,
+                const QString& newName, const QList<int>& dependencies);
+
+    static QString getNonDuplicatedName(const MergeMEGAFoldersNode& node, const UniqueNameIndex& usedNames);
+
+    std::vector<Step> mSteps;
+};
+
+/// Responsability: run the steps of a MergeMEGAFoldersPlan keeping a window of requests in flight
+class MergeMEGAFoldersExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_MAX_REQUESTS_IN_FLIGHT;
+
+    MergeMEGAFoldersExecutor(std::shared_ptr<MergeMEGAFoldersApi> api,
+                             const MergeMEGAFoldersPlan& plan,
+                             int maxRequestsInFlight = DEFAULT_MAX_REQUESTS_IN_FLIGHT,
+                             QObject* parent = nullptr);
+
+    // Also resumes the merge after a cancel or an error, retrying the failed steps
+    void start();
+    // The requests in flight are not cancelled, finished is emitted when they finish
+    void cancel();
+
+    bool isRunning() const;
+    bool isCancelled() const;
+    bool isCompleted() const;
+    int getFinishedSteps() const;
+    int getTotalSteps() const;
+    std::shared_ptr<mega::MegaError> getError() const;
+
+signals:
+    void progress(int finishedSteps, int totalSteps);
+    void finished();
+
+private:
+    enum class StepState
+    {
+        Pending,
+        InFlight,
+        Done,
+        Failed,
+    };
+
+    void issueRequests();
+    void startStep(int index);
+    void onStepFinished(int index, std::shared_ptr<mega::MegaError> error);
+
+    std::shared_ptr<MergeMEGAFoldersApi> mApi;
+    const std::vector<MergeMEGAFoldersPlan::Step> mSteps;
+    const int mMaxRequestsInFlight;
+    std::vector<int> mRemainingDependencies;
+    std::vector<StepState> mStates;
+    std::deque<int> mReadySteps;
+    std::shared_ptr<mega::MegaError> mError;
+    int mRequestsInFlight;
+    int mFinishedSteps;
+    bool mRunning;
+    bool mCancelled;
+    bool mIssuingRequests;
+};
+
+#endif // MERGEMEGAFOLDERSPLAN_H
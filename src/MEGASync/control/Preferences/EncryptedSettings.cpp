@@ -1,6 +1,8 @@
 #include "EncryptedSettings.h"
 #include "platform/Platform.h"
 
+#include <iterator>
+
 EncryptedSettings::EncryptedSettings(QString file) :
     QSettings(file, QSettings::IniFormat)
 {
@@ -9,6 +11,8 @@ EncryptedSettings::EncryptedSettings(QString file) :
     // Use the cached one if available, and only get it from the OS if not.
     QString keyTag = QString::fromUtf8("LocalStorageKey");
     encryptionKey = QByteArray::fromHex(value(keyTag).toByteArray());
+    // The key hashes depend on the encryption key, so the values read without it are not kept
+    mCache.clear();
     if (!encryptionKey.isEmpty())
         return;
 #endif
@@ -25,42 +29,89 @@ EncryptedSettings::EncryptedSettings(QString file) :
     auto bkp = encryptionKey;
     encryptionKey.clear(); // switch to no key internally when caching the OS one
     setValue(keyTag, bkp.toHex());
+    flush(); // encrypted with no key
+    mCache.clear();
     encryptionKey = bkp; // switch back to the real encryptionKey
 #endif
 }
 
+EncryptedSettings::~EncryptedSettings()
+{
+    flush();
+}
+
 void EncryptedSettings::setValue(const QString &key, const QVariant &value)
 {
-    QSettings::setValue(hash(key), encrypt(key, value.toString()));
+    const QString group(QSettings::group());
+    QString newValue(value.toString());
+
+    auto& groupCache(mCache[group]);
+    auto cachedValue(groupCache.constFind(key));
+    if (cachedValue != groupCache.constEnd() && cachedValue->exists && cachedValue->value == newValue)
+    {
+        return;
+    }
+    groupCache.insert(key, CachedValue{newValue, true});
+
+    bool hadPendingChanges(!mPendingValues.isEmpty());
+    mPendingValues[group].insert(key, newValue);
+    if (!hadPendingChanges && mChangesPendingCallback)
+    {
+        mChangesPendingCallback();
+    }
 }
 
 QVariant EncryptedSettings::value(const QString &key, const QVariant &defaultValue)
 {
-    return QVariant(decrypt(key, QSettings::value(hash(key), encrypt(key, defaultValue.toString())).toString()));
+    auto& groupCache(mCache[QSettings::group()]);
+    auto cachedValue(groupCache.constFind(key));
+    if (cachedValue == groupCache.constEnd())
+    {
+        QString hashedKey(hash(key));
+        CachedValue storedValue{QString(), QSettings::contains(hashedKey)};
+        if (storedValue.exists)
+        {
+            storedValue.value = decrypt(key, QSettings::value(hashedKey).toString());
+        }
+        cachedValue = groupCache.insert(key, storedValue);
+    }
+    return QVariant(cachedValue->exists ? cachedValue->value : defaultValue.toString());
 }
 
 void EncryptedSettings::beginGroup(const QString &prefix)
 {
-    QSettings::beginGroup(hash(prefix));
+    QString hashedPrefix(hash(prefix));
+    QSettings::beginGroup(hashedPrefix);
+    mGroupStack.append(hashedPrefix);
 }
 
 void EncryptedSettings::beginGroup(int numGroup)
 {
-     QSettings::beginGroup(QSettings::childGroups().at(numGroup));
+    // The groups with pending values only exist in QSettings after flushing
+    flush();
+    QString prefix(QSettings::childGroups().at(numGroup));
+    QSettings::beginGroup(prefix);
+    mGroupStack.append(prefix);
 }
 
 void EncryptedSettings::endGroup()
 {
     QSettings::endGroup();
+    if (!mGroupStack.isEmpty())
+    {
+        mGroupStack.removeLast();
+    }
 }
 
 int EncryptedSettings::numChildGroups()
 {
+    flush();
     return QSettings::childGroups().size();
 }
 
 bool EncryptedSettings::containsGroup(QString groupName)
 {
+    flush();
     return QSettings::childGroups().contains(hash(groupName));
 }
 
@@ -74,22 +125,109 @@ void EncryptedSettings::remove(const QString &key)
     if (!key.length())
     {
         QSettings::remove(QString::fromLatin1(""));
+        removeCachedGroup(QSettings::group());
     }
     else
     {
+        const QString group(QSettings::group());
         QSettings::remove(hash(key));
+        mCache[group].insert(key, CachedValue{QString(), false});
+
+        auto pendingGroup(mPendingValues.find(group));
+        if (pendingGroup != mPendingValues.end())
+        {
+            pendingGroup->remove(key);
+            if (pendingGroup->isEmpty())
+            {
+                mPendingValues.erase(pendingGroup);
+            }
+        }
     }
 }
 
 void EncryptedSettings::clear()
 {
     QSettings::clear();
+    mCache.clear();
+    mPendingValues.clear();
 }
 
 void EncryptedSettings::sync()
 {
+    flush();
     QSettings::sync();
 }
+
+void EncryptedSettings::flush()
+{
+    if (mPendingValues.isEmpty())
+    {
+        return;
+    }
+
+    // The values are encrypted with the group they were set in
+    for (int i = 0; i < mGroupStack.size(); ++i)
+    {
+        QSettings::endGroup();
+    }
+
+    for (auto pendingGroup = mPendingValues.cbegin(); pendingGroup != mPendingValues.cend(); ++pendingGroup)
+    {
+        const bool isRootGroup(pendingGroup.key().isEmpty());
+        if (!isRootGroup)
+        {
+            QSettings::beginGroup(pendingGroup.key());
+        }
+        for (auto pendingValue = pendingGroup->cbegin(); pendingValue != pendingGroup->cend(); ++pendingValue)
+        {
+            QSettings::setValue(hash(pendingValue.key()), encrypt(pendingValue.key(), pendingValue.value()));
+        }
+        if (!isRootGroup)
+        {
+            QSettings::endGroup();
+        }
+    }
+    mPendingValues.clear();
+
+    for (const auto& prefix : qAsConst(mGroupStack))
+    {
+        QSettings::beginGroup(prefix);
+    }
+}
+
+bool EncryptedSettings::hasPendingChanges() const
+{
+    return !mPendingValues.isEmpty();
+}
+
+void EncryptedSettings::setChangesPendingCallback(std::function<void()> callback)
+{
+    mChangesPendingCallback = callback;
+}
+
+void EncryptedSettings::removeCachedGroup(const QString& group)
+{
+    if (group.isEmpty())
+    {
+        mCache.clear();
+        mPendingValues.clear();
+        return;
+    }
+
+    auto isInGroup = [&group](const QString& cachedGroup)
+    {
+        return cachedGroup == group || cachedGroup.startsWith(group + QLatin1Char('/'));
+    };
+
+    for (auto it = mCache.begin(); it != mCache.end();)
+    {
+        it = isInGroup(it.key()) ? mCache.erase(it) : std::next(it);
+    }
+    for (auto it = mPendingValues.begin(); it != mPendingValues.end();)
+    {
+        it = isInGroup(it.key()) ? mPendingValues.erase(it) : std::next(it);
+    }
+}
  
 //Simplified XOR fun
 QByteArray EncryptedSettings::XOR(const QByteArray& key, const QByteArray& data) const
@@ -5,13 +5,19 @@
 #include <QVariant>
 #include <QStringList>
 #include <QCryptographicHash>
+#include <QHash>
 
+#include <functional>
+
+// The values are kept decoded in memory. The changes are encrypted and written to the file by flush() or sync(),
+// the changes pending callback is called when there are changes to flush
 class EncryptedSettings : protected QSettings
 {
     Q_OBJECT
 
 public:
     explicit EncryptedSettings(QString file);
+    ~EncryptedSettings();
 
     void setValue(const QString & key, const QVariant & value);
     QVariant value(const QString & key, const QVariant & defaultValue = QVariant());
@@ -24,6 +30,9 @@ public:
     void remove(const QString & key);
     void clear();
     void sync();
+    void flush();
+    bool hasPendingChanges() const;
+    void setChangesPendingCallback(std::function<void()> callback);
 
 protected:
     QByteArray XOR(const QByteArray &key, const QByteArray& data) const;
@@ -33,6 +42,23 @@ protected:
     QByteArray encryptionKey;
 
     bool event(QEvent* event) override;
+
+private:
+    struct CachedValue
+    {
+        QString value;
+        bool exists;
+    };
+
+    void removeCachedGroup(const QString& group);
+
+    // Prefixes passed to QSettings::beginGroup, to restore the groups after flushing
+    QStringList mGroupStack;
+    // Decoded values by group and key
+    QHash<QString, QHash<QString, CachedValue>> mCache;
+    // Values not written to QSettings yet, by group and key
+    QHash<QString, QHash<QString, QString>> mPendingValues;
+    std::function<void()> mChangesPendingCallback;
 };
 
 #endif // ENCRYPTEDSETTINGS_H
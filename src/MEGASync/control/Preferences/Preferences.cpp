@@ -29,6 +29,9 @@ const QString Preferences::TRANSLATION_PREFIX = QString::fromLatin1("MEGASyncStr
 int Preferences::STATE_REFRESH_INTERVAL_MS        = 10000;
 int Preferences::NETWORK_REFRESH_INTERVAL_MS      = 30000;
 int Preferences::FINISHED_TRANSFER_REFRESH_INTERVAL_MS        = 10000;
+int Preferences::SETTINGS_FLUSH_DELAY_MS          = 2000;
+int Preferences::SHELL_NOTIFICATIONS_WINDOW_MS    = 200;
+int Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND = 500;
 
 long long Preferences::OQ_DIALOG_INTERVAL_MS = 604800000; // 7 daysm
 long long Preferences::OQ_NOTIFICATION_INTERVAL_MS = 129600000; // 36 hours
@@ -330,7 +333,7 @@ void Preferences::initialize(QString dataPath)
     bool retryFlag = false;
 
     errorFlag = false;
-    mSettings.reset(new EncryptedSettings(settingsFile));
+    resetSettings(settingsFile);
 
     QString currentAccount = mSettings->value(currentAccountKey).toString();
     if (currentAccount.size())
@@ -361,7 +364,7 @@ void Preferences::initialize(QString dataPath)
 
         if (QFile::rename(bakSettingsFile, settingsFile))
         {
-            mSettings.reset(new EncryptedSettings(settingsFile));
+            resetSettings(settingsFile);
 
             //Retry with backup file
             currentAccount = mSettings->value(currentAccountKey).toString();
@@ -401,6 +404,34 @@ Preferences::Preferences() :
     lastTransferNotification(0)
 {
     clearTemporalBandwidth();
+
+    mSettingsFlushTimer.setSingleShot(true);
+    connect(&mSettingsFlushTimer, &QTimer::timeout, this, &Preferences::flushSettings);
+}
+
+void Preferences::resetSettings(const QString& settingsFile)
+{
+    mSettings.reset(new EncryptedSettings(settingsFile));
+    // Queued when the values are set from other threads
+    mSettings->setChangesPendingCallback([this]()
+    {
+        QMetaObject::invokeMethod(this, &Preferences::onSettingsChangesPending, Qt::AutoConnection);
+    });
+}
+
+void Preferences::onSettingsChangesPending()
+{
+    if (!mSettingsFlushTimer.isActive())
+    {
+        mSettingsFlushTimer.start(SETTINGS_FLUSH_DELAY_MS);
+    }
+}
+
+void Preferences::flushSettings()
+{
+    // QSettings writes the file once, in the next iteration of the event loop
+    QMutexLocker locker(&mutex);
+    mSettings->flush();
 }
 
 QString Preferences::email()
@@ -2949,6 +2980,9 @@ void Preferences::overridePreferences(const QSettings &settings)
     overridePreference(settings, QString::fromUtf8("USER_INACTIVITY_MS"), Preferences::USER_INACTIVITY_MS);
     overridePreference(settings, QString::fromUtf8("STATE_REFRESH_INTERVAL_MS"), Preferences::STATE_REFRESH_INTERVAL_MS);
     overridePreference(settings, QString::fromUtf8("NETWORK_REFRESH_INTERVAL_MS"), Preferences::NETWORK_REFRESH_INTERVAL_MS);
+    overridePreference(settings, QString::fromUtf8("SETTINGS_FLUSH_DELAY_MS"), Preferences::SETTINGS_FLUSH_DELAY_MS);
+    overridePreference(settings, QString::fromUtf8("SHELL_NOTIFICATIONS_WINDOW_MS"), Preferences::SHELL_NOTIFICATIONS_WINDOW_MS);
+    overridePreference(settings, QString::fromUtf8("MAX_SHELL_NOTIFICATIONS_PER_SECOND"), Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND);
 
     overridePreference(settings, QString::fromUtf8("TRANSFER_OVER_QUOTA_DIALOG_DISABLE_DURATION_MS"), Preferences::OVER_QUOTA_DIALOG_DISABLE_DURATION);
     overridePreference(settings, QString::fromUtf8("TRANSFER_OVER_QUOTA_OS_NOTIFICATION_DISABLE_DURATION_MS"), Preferences::OVER_QUOTA_OS_NOTIFICATION_DISABLE_DURATION);
@@ -9,6 +9,7 @@
 #include <QLocale>
 #include <QStringList>
 #include <QMutex>
+#include <QTimer>
 #include <QDataStream>
 
 #include <iostream>
@@ -489,6 +490,9 @@ public:
     static int STATE_REFRESH_INTERVAL_MS;
     static int NETWORK_REFRESH_INTERVAL_MS;
     static int FINISHED_TRANSFER_REFRESH_INTERVAL_MS;
+    static int SETTINGS_FLUSH_DELAY_MS;
+    static int SHELL_NOTIFICATIONS_WINDOW_MS;
+    static int MAX_SHELL_NOTIFICATIONS_PER_SECOND;
 
     static long long MIN_UPDATE_NOTIFICATION_INTERVAL_MS;
     static unsigned int UPDATE_INITIAL_DELAY_SECS;
@@ -604,6 +608,8 @@ protected:
     std::chrono::system_clock::time_point transferOverQuotaStreamDialogDisabledUntil;
     std::chrono::system_clock::time_point storageOverQuotaUploadsDialogDisabledUntil;
     std::chrono::system_clock::time_point storageOverQuotaSyncsDialogDisabledUntil;
+    // Writes the changed settings a while after the first change, to write them to the file at once
+    QTimer mSettingsFlushTimer;
 
     static const QString currentAccountKey;
     static const QString currentAccountStatusKey;
@@ -800,9 +806,12 @@ protected:
 
 private:
     void updateFullName();
+    void resetSettings(const QString& settingsFile);
 
 private slots:
     void setFullName(const QString& newFirstName, const QString& newLastName);
+    void onSettingsChangesPending();
+    void flushSettings();
 
 };
 
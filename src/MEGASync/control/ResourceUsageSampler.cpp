@@ -0,0 +1,158 @@
+#include "ResourceUsageSampler.h"
+
+#include <QFile>
+#include <QStringList>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+const int ResourceUsageSampler::DEFAULT_CAPACITY = 1440;
+
+namespace
+{
+constexpr long long BYTES_PER_MB = 1024 * 1024;
+
+void appendValue(QStringList& values, const char* name, long long value, long long divisor = 1, const char* unit = "")
+{
+    if (value >= 0)
+    {
+        values.append(QString::fromUtf8("%1 %2%3").arg(QString::fromUtf8(name)).arg(value / divisor)
+                      .arg(QString::fromUtf8(unit)));
+    }
+}
+
+#ifdef Q_OS_LINUX
+QByteArray readProcFile(const char* path)
+{
+    // The size of the /proc files is 0, they are read until the end
+    QFile file(QString::fromUtf8(path));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+#endif
+}
+
+QString ResourceUsageSample::toString() const
+{
+    QStringList values;
+    appendValue(values, "memory", memoryUsage, BYTES_PER_MB, " MB");
+    appendValue(values, "RSS", residentBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "PSS", proportionalBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "anon", anonymousBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "file", fileBackedBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "voluntary ctxt switches", voluntaryContextSwitches);
+    appendValue(values, "involuntary ctxt switches", involuntaryContextSwitches);
+    appendValue(values, "read", readBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "written", writtenBytes, BYTES_PER_MB, " MB");
+    appendValue(values, "nodes", nodes);
+    appendValue(values, "local nodes", localNodes);
+    appendValue(values, "transfers", transfers);
+    return values.join(QLatin1String(" / "));
+}
+
+ResourceUsageSampler::ResourceUsageSampler(int capacity)
+    : mSamples(std::max(capacity, 1))
+    , mNext(0)
+    , mFull(false)
+{
+}
+
+void ResourceUsageSampler::addSample(const ResourceUsageSample& sample)
+{
+    mSamples[mNext] = sample;
+    mNext = (mNext + 1) % mSamples.size();
+    mFull |= (mNext == 0);
+}
+
+QVector<ResourceUsageSample> ResourceUsageSampler::getSamples() const
+{
+    if (!mFull)
+    {
+        return mSamples.mid(0, mNext);
+    }
+    return mSamples.mid(mNext) + mSamples.mid(0, mNext);
+}
+
+int ResourceUsageSampler::getCapacity() const
+{
+    return mSamples.size();
+}
+
+#ifdef Q_OS_LINUX
+bool ResourceUsageSampler::readProcessUsage(ResourceUsageSample& sample)
+{
+    if (!parseStatm(readProcFile("/proc/self/statm"), sysconf(_SC_PAGESIZE), sample))
+    {
+        return false;
+    }
+
+    // smaps_rollup walks the page tables of the process, but it is cheap enough for a sample per minute.
+    // It does not exist before Linux 4.14
+    auto rollup(parseKeyValues(readProcFile("/proc/self/smaps_rollup")));
+    sample.proportionalBytes = rollup.value("Pss", -1);
+
+    auto status(parseKeyValues(readProcFile("/proc/self/status")));
+    sample.anonymousBytes = status.value("RssAnon", -1);
+    sample.fileBackedBytes = status.value("RssFile", -1);
+    sample.voluntaryContextSwitches = status.value("voluntary_ctxt_switches", -1);
+    sample.involuntaryContextSwitches = status.value("nonvoluntary_ctxt_switches", -1);
+
+    // Bytes read from and written to the storage, not the page cache
+    auto io(parseKeyValues(readProcFile("/proc/self/io")));
+    sample.readBytes = io.value("read_bytes", -1);
+    sample.writtenBytes = io.value("write_bytes", -1);
+    return true;
+}
+#endif
+
+bool ResourceUsageSampler::parseStatm(const QByteArray& contents, long long pageSize, ResourceUsageSample& sample)
+{
+    // size resident shared text lib data dt, in pages
+    const auto fields(contents.simplified().split(' '));
+    if (fields.size() < 2)
+    {
+        return false;
+    }
+
+    bool isNumber(false);
+    auto residentPages(fields.at(1).toLongLong(&isNumber));
+    if (!isNumber)
+    {
+        return false;
+    }
+    sample.residentBytes = residentPages * pageSize;
+    return true;
+}
+
+QHash<QByteArray, long long> ResourceUsageSampler::parseKeyValues(const QByteArray& contents)
+{
+    QHash<QByteArray, long long> values;
+    for (const auto& line : contents.split('\n'))
+    {
+        auto separator(line.indexOf(':'));
+        if (separator <= 0)
+        {
+            continue;
+        }
+
+        const auto tokens(line.mid(separator + 1).simplified().split(' '));
+        bool isNumber(false);
+        auto value(tokens.first().toLongLong(&isNumber));
+        if (!isNumber)
+        {
+            continue;
+        }
+        if (tokens.size() > 1 && tokens.at(1) == "kB")
+        {
+            value *= 1024;
+        }
+        values.insert(line.left(separator).trimmed(), value);
+    }
+    return values;
+}
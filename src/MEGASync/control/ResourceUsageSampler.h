@@ -0,0 +1,61 @@
+#ifndef RESOURCEUSAGESAMPLER_H
+#define RESOURCEUSAGESAMPLER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// -1 when the platform does not report the value
+struct ResourceUsageSample
+{
+    qint64 timestamp = 0;
+    // The value checked for the MEM_USAGE event: private bytes on Windows, resident bytes elsewhere
+    long long memoryUsage = -1;
+    long long residentBytes = -1;
+    long long proportionalBytes = -1;
+    long long anonymousBytes = -1;
+    long long fileBackedBytes = -1;
+    long long voluntaryContextSwitches = -1;
+    long long involuntaryContextSwitches = -1;
+    long long readBytes = -1;
+    long long writtenBytes = -1;
+    long long nodes = 0;
+    long long localNodes = 0;
+    long long transfers = 0;
+
+    QString toString() const;
+};
+
+/// Responsability: keep the last samples of the resources used by the app, to relate the memory growth with the
+/// number of nodes and transfers. On Linux the samples are read from /proc/self (statm, smaps_rollup, status and io).
+class ResourceUsageSampler
+{
+public:
+    static const int DEFAULT_CAPACITY;
+
+    explicit ResourceUsageSampler(int capacity = DEFAULT_CAPACITY);
+
+    void addSample(const ResourceUsageSample& sample);
+    // From the oldest to the newest
+    QVector<ResourceUsageSample> getSamples() const;
+    int getCapacity() const;
+
+#ifdef Q_OS_LINUX
+    // Fills the process values of the sample. False when the memory usage can not be read
+    static bool readProcessUsage(ResourceUsageSample& sample);
+#endif
+
+    // Parsers of the /proc files, public for the tests
+    static bool parseStatm(const QByteArray& contents, long long pageSize, ResourceUsageSample& sample);
+    // "Key: value [kB]" lines. The values in kB are returned in bytes
+    static QHash<QByteArray, long long> parseKeyValues(const QByteArray& contents);
+
+private:
+    QVector<ResourceUsageSample> mSamples;
+    // Position of the next sample, the oldest one when the buffer is full
+    int mNext;
+    bool mFull;
+};
+
+#endif // RESOURCEUSAGESAMPLER_H
@@ -1,7 +1,6 @@
 #include "ThreadPool.h"
 
-#include <array>
-#include <chrono>
+#include <algorithm>
 #include <string>
 
 #include <QtGlobal>
@@ -10,11 +9,47 @@
 #include <pthread.h>
 #endif
 
+namespace
+{
+constexpr std::size_t MIN_THREADS = 5;
+constexpr std::size_t MAX_THREADS = 16;
+}
+
 thread_local std::atomic<bool>* ThreadPool::mLocalToThreadDone = nullptr;
+thread_local const std::atomic<bool>* ThreadPool::mLocalToTaskCancelled = nullptr;
+thread_local const ThreadPool* ThreadPool::mLocalToWorkerPool = nullptr;
+thread_local std::size_t ThreadPool::mLocalToWorkerIndex = 0;
+
+ThreadPool::CancellationToken::CancellationToken()
+    : mCancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void ThreadPool::CancellationToken::cancel()
+{
+    *mCancelled = true;
+}
+
+bool ThreadPool::CancellationToken::isCancelled() const
+{
+    return *mCancelled;
+}
 
 ThreadPool::ThreadPool(const std::size_t threadCount)
 {
     Q_ASSERT(threadCount > 0);
+
+    // The lower lanes leave workers free for the higher ones
+    mLanes[static_cast<std::size_t>(Lane::INTERACTIVE)].maxRunning = threadCount;
+    mLanes[static_cast<std::size_t>(Lane::BACKGROUND)].maxRunning = std::max<std::size_t>(1, threadCount - 1);
+    mLanes[static_cast<std::size_t>(Lane::BULK_IO)].maxRunning = std::max<std::size_t>(1, threadCount / 2);
+    mMaxLowerLanesRunning = std::max<std::size_t>(1, threadCount - 1);
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        mQueues.emplace_back(new WorkerQueues());
+    }
+
     for (std::size_t i = 0; i < threadCount; ++i)
     {
         std::thread thread;
@@ -45,18 +80,41 @@ ThreadPool::~ThreadPool()
     shutdown();
 }
 
-void ThreadPool::push(std::function<void()> functor)
+void ThreadPool::push(std::function<void()> functor, Lane lane)
+{
+    push(Task{std::move(functor), nullptr, std::chrono::steady_clock::now()}, lane);
+}
+
+void ThreadPool::push(std::function<void()> functor, Lane lane, const CancellationToken& token)
+{
+    push(Task{std::move(functor), token.mCancelled, std::chrono::steady_clock::now()}, lane);
+}
+
+void ThreadPool::push(Task task, Lane lane)
 {
+    const auto laneIndex = static_cast<std::size_t>(lane);
+
+    // The functors pushed from a worker stay in its queues, the rest are spread among the workers
+    const auto queueIndex = mLocalToWorkerPool == this ? mLocalToWorkerIndex
+                                                       : mNextQueue++ % mQueues.size();
+
+    // Counted before it can be taken, so the counter never goes below zero
+    mLanes[laneIndex].queued++;
+    {
+        std::lock_guard<std::mutex> lock{mQueues[queueIndex]->mutex};
+        mQueues[queueIndex]->lanes[laneIndex].push_back(std::move(task));
+    }
+
     {
         std::lock_guard<std::mutex> lock{mMutex};
-        mFunctors.push(std::move(functor));
     }
     mCv.notify_one();
 }
 
 bool ThreadPool::isThreadInterrupted()
 {
-    if(mLocalToThreadDone && (*mLocalToThreadDone))
+    if((mLocalToThreadDone && (*mLocalToThreadDone))
+       || (mLocalToTaskCancelled && (*mLocalToTaskCancelled)))
     {
         return true;
     }
@@ -66,6 +124,35 @@ bool ThreadPool::isThreadInterrupted()
     }
 }
 
+ThreadPool::LaneStats ThreadPool::getLaneStats(Lane lane) const
+{
+    const LaneCounters& counters = mLanes[static_cast<std::size_t>(lane)];
+
+    LaneStats stats;
+    stats.queued = counters.queued;
+    stats.running = counters.running;
+    stats.executed = counters.executed;
+    stats.cancelled = counters.cancelled;
+    if (stats.executed)
+    {
+        stats.averageWait = std::chrono::microseconds(counters.totalWaitUs / stats.executed);
+    }
+    stats.maxWait = std::chrono::microseconds(counters.maxWaitUs);
+    return stats;
+}
+
+std::size_t ThreadPool::getThreadCount() const
+{
+    return mQueues.size();
+}
+
+std::size_t ThreadPool::defaultThreadCount()
+{
+    // One more than the cores, as many functors spend their time waiting for the SDK
+    const std::size_t threads = std::thread::hardware_concurrency() + 1;
+    return std::min(MAX_THREADS, std::max(MIN_THREADS, threads));
+}
+
 void ThreadPool::worker(const std::size_t index)
 {
     const auto threadName = "TPw" + std::to_string(index);
@@ -77,32 +164,176 @@ void ThreadPool::worker(const std::size_t index)
     }
 #endif
     mLocalToThreadDone = &mDone;
+    mLocalToWorkerPool = this;
+    mLocalToWorkerIndex = index;
     for (;;)
     {
-        std::function<void()> functor;
+        if (runNextTask(index))
         {
-            std::unique_lock<std::mutex> lock{mMutex};
-            mCv.wait(lock, [this]
-            {
-                return mDone || !mFunctors.empty();
-            });
-            if (mDone && mFunctors.empty())
-            {
-                break;
-            }
-            functor = std::move(mFunctors.front());
-            mFunctors.pop();
+            continue;
         }
-        try
+
+        std::unique_lock<std::mutex> lock{mMutex};
+        if (mDone)
         {
-            functor();
+            // The queued functors of a full lane are run by the workers running that lane
+            break;
         }
-        catch (const std::exception& e)
+        mCv.wait(lock, [this]
+        {
+            return mDone || hasRunnableTasks();
+        });
+    }
+}
+
+bool ThreadPool::runNextTask(const std::size_t index)
+{
+    for (std::size_t lane = 0; lane < LANES; ++lane)
+    {
+        LaneCounters& counters = mLanes[lane];
+        if (!counters.queued)
+        {
+            continue;
+        }
+
+        if (!reserveLane(lane))
+        {
+            continue;
+        }
+
+        Task task;
+        const bool taken = takeTask(index, lane, task);
+        if (taken)
+        {
+            counters.queued--;
+            runTask(task, lane);
+        }
+        releaseLane(lane);
+
+        if (taken)
         {
-            qCritical("ThreadPool: Error: %s", e.what());
-            Q_ASSERT(false);
+            return true;
         }
     }
+    return false;
+}
+
+bool ThreadPool::takeTask(const std::size_t index, const std::size_t lane, Task& task)
+{
+    // Own queue first, then steal from the others. Always the oldest functor, to keep the order they were pushed
+    for (std::size_t i = 0; i < mQueues.size(); ++i)
+    {
+        WorkerQueues& queues = *mQueues[(index + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock{queues.mutex};
+        auto& queue = queues.lanes[lane];
+        if (!queue.empty())
+        {
+            task = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::hasRunnableTasks() const
+{
+    for (std::size_t lane = 0; lane < LANES; ++lane)
+    {
+        if (mLanes[lane].queued && canRunLane(lane))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::canRunLane(const std::size_t lane) const
+{
+    return mLanes[lane].running < mLanes[lane].maxRunning
+           && (lane == static_cast<std::size_t>(Lane::INTERACTIVE) || mLowerLanesRunning < mMaxLowerLanesRunning);
+}
+
+bool ThreadPool::reserveLane(const std::size_t lane)
+{
+    // Reserve a place in the counter, if it is not full
+    auto tryReserve = [](std::atomic<std::size_t>& running, const std::size_t maxRunning)
+    {
+        auto current = running.load();
+        while (current < maxRunning)
+        {
+            if (running.compare_exchange_weak(current, current + 1))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    LaneCounters& counters = mLanes[lane];
+    if (!tryReserve(counters.running, counters.maxRunning))
+    {
+        return false;
+    }
+
+    // BACKGROUND and BULK_IO share their places, so they never take the last worker
+    if (lane != static_cast<std::size_t>(Lane::INTERACTIVE)
+        && !tryReserve(mLowerLanesRunning, mMaxLowerLanesRunning))
+    {
+        counters.running--;
+        return false;
+    }
+    return true;
+}
+
+void ThreadPool::releaseLane(const std::size_t lane)
+{
+    mLanes[lane].running--;
+    if (lane != static_cast<std::size_t>(Lane::INTERACTIVE))
+    {
+        mLowerLanesRunning--;
+    }
+
+    // A functor held back by a full lane can be run now by an idle worker
+    if (hasRunnableTasks())
+    {
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+        }
+        mCv.notify_one();
+    }
+}
+
+void ThreadPool::runTask(Task& task, const std::size_t lane)
+{
+    LaneCounters& counters = mLanes[lane];
+
+    if (task.cancelled && *task.cancelled)
+    {
+        counters.cancelled++;
+        return;
+    }
+
+    const auto waitUs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - task.queuedAt).count());
+    counters.totalWaitUs += waitUs;
+    auto maxWaitUs = counters.maxWaitUs.load();
+    while (waitUs > maxWaitUs && !counters.maxWaitUs.compare_exchange_weak(maxWaitUs, waitUs))
+    {
+    }
+
+    mLocalToTaskCancelled = task.cancelled.get();
+    try
+    {
+        task.functor();
+    }
+    catch (const std::exception& e)
+    {
+        qCritical("ThreadPool: Error: %s", e.what());
+        Q_ASSERT(false);
+    }
+    mLocalToTaskCancelled = nullptr;
+    counters.executed++;
 }
 
 void ThreadPool::shutdown()
@@ -118,4 +349,3 @@ void ThreadPool::shutdown()
     }
     mThreads.clear();
 }
-
@@ -1,38 +1,131 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
 #include <QtGlobal>
 
+/// Responsability: run functors in worker threads.
+/// Each worker has its own queues, one per lane, and takes work from the other workers when its own queues are
+/// empty. The lanes are served by priority, and the lower ones together can not take every worker, so the interactive
+/// work (like megaApi->update()) never waits for the slow work to finish.
 class ThreadPool
 {
 public:
+    // Ordered by priority
+    enum class Lane
+    {
+        INTERACTIVE = 0,
+        BACKGROUND,
+        BULK_IO,
+        LAST = BULK_IO
+    };
+    static constexpr std::size_t LANES = static_cast<std::size_t>(Lane::LAST) + 1;
+
+    // Cooperative cancellation of the functors pushed with it.
+    // The functors not started yet are discarded, the running ones see isThreadInterrupted() == true
+    class CancellationToken
+    {
+    public:
+        CancellationToken();
+
+        void cancel();
+        bool isCancelled() const;
+
+    private:
+        friend class ThreadPool;
+        std::shared_ptr<std::atomic<bool>> mCancelled;
+    };
+
+    struct LaneStats
+    {
+        std::size_t queued = 0;
+        std::size_t running = 0;
+        std::uint64_t executed = 0;
+        std::uint64_t cancelled = 0;
+        // Time from the push to the start of the functor
+        std::chrono::microseconds averageWait{0};
+        std::chrono::microseconds maxWait{0};
+    };
 
     explicit ThreadPool(std::size_t threadCount);
     ~ThreadPool();
 
     Q_DISABLE_COPY(ThreadPool)
 
-    void push(std::function<void()> functor);
+    void push(std::function<void()> functor, Lane lane = Lane::BACKGROUND);
+    void push(std::function<void()> functor, Lane lane, const CancellationToken& token);
+
+    // True when the pool is being destroyed or the token of the running functor was cancelled
     static bool isThreadInterrupted();
 
+    LaneStats getLaneStats(Lane lane) const;
+    std::size_t getThreadCount() const;
+
+    // Sized from the hardware concurrency, with room for the functors blocked on the SDK
+    static std::size_t defaultThreadCount();
+
 private:
+    struct Task
+    {
+        std::function<void()> functor;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    struct WorkerQueues
+    {
+        std::mutex mutex;
+        std::array<std::deque<Task>, LANES> lanes;
+    };
+
+    struct LaneCounters
+    {
+        std::size_t maxRunning = 0;
+        std::atomic<std::size_t> queued {0};
+        std::atomic<std::size_t> running {0};
+        std::atomic<std::uint64_t> executed {0};
+        std::atomic<std::uint64_t> cancelled {0};
+        std::atomic<std::uint64_t> totalWaitUs {0};
+        std::atomic<std::uint64_t> maxWaitUs {0};
+    };
+
+    void push(Task task, Lane lane);
     void worker(std::size_t index);
+    bool runNextTask(std::size_t index);
+    bool takeTask(std::size_t index, std::size_t lane, Task& task);
+    bool hasRunnableTasks() const;
+    bool canRunLane(std::size_t lane) const;
+    bool reserveLane(std::size_t lane);
+    void releaseLane(std::size_t lane);
+    void runTask(Task& task, std::size_t lane);
 
     void shutdown();
 
     std::atomic<bool> mDone {false} ;
     static thread_local std::atomic<bool>* mLocalToThreadDone;
+    static thread_local const std::atomic<bool>* mLocalToTaskCancelled;
+    static thread_local const ThreadPool* mLocalToWorkerPool;
+    static thread_local std::size_t mLocalToWorkerIndex;
+
+    std::vector<std::unique_ptr<WorkerQueues>> mQueues;
+    std::array<LaneCounters, LANES> mLanes;
+    // BACKGROUND and BULK_IO together, so one worker is always left for INTERACTIVE
+    std::size_t mMaxLowerLanesRunning = 0;
+    std::atomic<std::size_t> mLowerLanesRunning {0};
+    std::atomic<std::size_t> mNextQueue {0};
 
     std::vector<std::thread> mThreads;
-    std::queue<std::function<void()>> mFunctors;
     std::condition_variable mCv;
     std::mutex mMutex;
 };
-
@@ -0,0 +1,77 @@
+#include "UniqueNameIndex.h"
+
+#include <MegaApplication.h>
+#include <Utilities.h>
+
+#include <QDirIterator>
+
+void UniqueNameIndex::addNodeChildren(mega::MegaNode* parentNode)
+{
+    if(!parentNode || mLoadedNodes.contains(parentNode->getHandle()))
+    {
+        return;
+    }
+    mLoadedNodes.insert(parentNode->getHandle());
+
+    std::unique_ptr<mega::MegaNodeList> nodes(MegaSyncApp->getMegaApi()->getChildren(parentNode));
+    mNames.reserve(mNames.size() + nodes->size());
+    for(int index = 0; index < nodes->size(); ++index)
+    {
+        addName(QString::fromUtf8(nodes->get(index)->getName()));
+    }
+}
+
+void UniqueNameIndex::addLocalEntries(const QString& folderPath, bool unescapeNames)
+{
+    if(mLoadedFolders.contains(folderPath))
+    {
+        return;
+    }
+    mLoadedFolders.insert(folderPath);
+
+    QDirIterator filesIt(folderPath, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::NoIteratorFlags);
+    while(filesIt.hasNext())
+    {
+        filesIt.next();
+        if(unescapeNames)
+        {
+            addName(QString::fromUtf8(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(filesIt.fileName().toUtf8().constData())));
+        }
+        else
+        {
+            addName(filesIt.fileName());
+        }
+    }
+}
+
+void UniqueNameIndex::addName(const QString& name)
+{
+    mNames.insert(name.toCaseFolded());
+}
+
+bool UniqueNameIndex::contains(const QString& name) const
+{
+    return mNames.contains(name.toCaseFolded());
+}
+
+int UniqueNameIndex::getFreeCounter(const QString& stem, const QString& suffix) const
+{
+    auto key((stem + QLatin1Char('/') + suffix).toCaseFolded());
+    auto counter(mFreeCounters.value(key, 1));
+    while(contains(getCounterName(stem, counter, suffix)))
+    {
+        ++counter;
+    }
+    mFreeCounters.insert(key, counter);
+    return counter;
+}
+
+QString UniqueNameIndex::getCounterName(const QString& stem, int counter, const QString& suffix)
+{
+    return stem + QString(QLatin1Literal("(%1)")).arg(QString::number(counter)) + suffix;
+}
+
+UniqueNameIndex& UniqueNameIndexes::getIndex(mega::MegaHandle parentHandle)
+{
+    return mIndexes[parentHandle];
+}
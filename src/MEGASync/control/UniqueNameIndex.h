@@ -0,0 +1,50 @@
+#ifndef UNIQUENAMEINDEX_H
+#define UNIQUENAMEINDEX_H
+
+#include <megaapi.h>
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include <unordered_map>
+
+/// Responsability: keep the names used in a folder, so the free "name(N)" names are found without reading the folder again
+class UniqueNameIndex
+{
+public:
+    UniqueNameIndex() = default;
+
+    // Every folder is only read once
+    void addNodeChildren(mega::MegaNode* parentNode);
+    void addLocalEntries(const QString& folderPath, bool unescapeNames);
+
+    // The names are case insensitive
+    void addName(const QString& name);
+    bool contains(const QString& name) const;
+
+    // Lowest N so that stem(N)suffix is not used
+    int getFreeCounter(const QString& stem, const QString& suffix) const;
+    static QString getCounterName(const QString& stem, int counter, const QString& suffix);
+
+private:
+    QSet<QString> mNames;
+    QSet<mega::MegaHandle> mLoadedNodes;
+    QSet<QString> mLoadedFolders;
+    // Counter to start from, by stem and suffix. The names are never removed, so the lower ones are used
+    mutable QHash<QString, int> mFreeCounters;
+};
+
+/// Responsability: share the name indexes of the parent folders of a batch of renames
+class UniqueNameIndexes
+{
+public:
+    UniqueNameIndexes() = default;
+
+    UniqueNameIndex& getIndex(mega::MegaHandle parentHandle);
+
+private:
+    std::unordered_map<mega::MegaHandle, UniqueNameIndex> mIndexes;
+};
+
+#endif // UNIQUENAMEINDEX_H
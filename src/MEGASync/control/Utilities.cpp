@@ -250,29 +250,6 @@ void Utilities::queueFunctionInObjectThread(QObject* object, std::function<void(
    QObject::connect(&temporary, &QObject::destroyed, object, std::move(fun), Qt::QueuedConnection);
 }
 
-void Utilities::getFolderSize(QString folderPath, long long *size)
-{
-    if (!folderPath.size())
-    {
-        return;
-    }
-
-    QDir dir(folderPath);
-    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
-    for (int i = 0; i < entries.size(); i++)
-    {
-        QFileInfo info = entries[i];
-        if (info.isFile())
-        {
-            (*size) += info.size();
-        }
-        else if (info.isDir())
-        {
-            getFolderSize(info.absoluteFilePath(), size);
-        }
-    }
-}
-
 qreal Utilities::getDevicePixelRatio()
 {
     return qApp->testAttribute(Qt::AA_UseHighDpiPixmaps) ? qApp->devicePixelRatio() : 1.0;
@@ -1275,9 +1252,8 @@ void Utilities::getDaysAndHoursToTimestamp(int64_t secsTimestamps, int64_t &rema
     remainDays  = remainHours / 24;
 }
 
-QString Utilities::getNonDuplicatedNodeName(MegaNode *node, MegaNode *parentNode, const QString &currentName, bool unescapeName, const QStringList& itemsBeingRenamed)
+QString Utilities::getNonDuplicatedNodeName(MegaNode *node, MegaNode *parentNode, const QString &currentName, bool unescapeName, UniqueNameIndex& nameIndex)
 {
-    QString newName;
     QString nodeName;
     QString suffix;
 
@@ -1306,48 +1282,17 @@ QString Utilities::getNonDuplicatedNodeName(MegaNode *node, MegaNode *parentNode
         nodeName = QString::fromUtf8(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(nodeName.toUtf8().constData()));
     }
 
-    int counter(1);
-    while(newName.isEmpty())
-    {
-        bool nameFound = false;
-        QString suggestedName = nodeName + QString(QLatin1Literal("(%1)")).arg(QString::number(counter));
-        if(node)
-        {
-            if(node->isFile() && !suffix.isEmpty())
-            {
-                suggestedName.append(suffix);
-            }
-        }
-
-        if(!itemsBeingRenamed.contains(suggestedName, Qt::CaseInsensitive))
-        {
-            std::unique_ptr<MegaNodeList>nodes(MegaSyncApp->getMegaApi()->getChildren(parentNode));
-            for(int index = 0; index < nodes->size(); ++index)
-            {
-                QString nodeName(QString::fromUtf8(nodes->get(index)->getName()));
-                if(suggestedName.compare(nodeName, Qt::CaseInsensitive) == 0)
-                {
-                    nameFound = true;
-                }
-            }
-
-
-            if(!nameFound)
-            {
-                newName = suggestedName;
-            }
-        }
-
-        counter++;
-    }
-
-    return newName;
+    nameIndex.addNodeChildren(parentNode);
+    return UniqueNameIndex::getCounterName(nodeName, nameIndex.getFreeCounter(nodeName, suffix), suffix);
 }
 
-QString Utilities::getNonDuplicatedLocalName(const QFileInfo &currentFile, bool unescapeName, const QStringList& itemsBeingRenamed)
+QString Utilities::getNonDuplicatedLocalName(const QFileInfo &currentFile, bool unescapeName, UniqueNameIndex& nameIndex)
 {
-    QString repeatedName;
     QString suffix = currentFile.completeSuffix();
+    if(!suffix.isEmpty())
+    {
+        suffix = QString(QLatin1Literal(".%1")).arg(suffix);
+    }
 
     QString fileName;
     if(unescapeName)
@@ -1359,55 +1304,9 @@ QString Utilities::getNonDuplicatedLocalName(const QFileInfo &currentFile, bool
         fileName = currentFile.baseName();
     }
 
-    QDirIterator filesIt(currentFile.path(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::NoIteratorFlags);
-
-    int counter(0);
-    bool notFound(true);
-    do
-    {
-        notFound = true;
-        counter++;
-
-        QString suggestedName = fileName + QString(QLatin1Literal("(%1)")).arg(QString::number(counter));
-        if(!suffix.isEmpty())
-        {
-            suggestedName += QString(QLatin1Literal(".%1")).arg(suffix);
-        }
-
-        if(!itemsBeingRenamed.contains(suggestedName))
-        {
-            while (filesIt.hasNext())
-            {
-                QString checkFileName;
-
-                if(unescapeName)
-                {
-                    checkFileName = QString::fromUtf8(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(filesIt.fileName().toUtf8().constData()));
-                }
-                else
-                {
-                    checkFileName = filesIt.fileName();
-                }
-
-                if (checkFileName.compare(suggestedName, Qt::CaseInsensitive) == 0)
-                {
-                    notFound = false;
-                    break;
-                }
-
-                filesIt.next();
-            }
-        }
-
-    } while(!notFound);
-
-    repeatedName = currentFile.baseName() + QString(QLatin1Literal("(%1)")).arg(QString::number(counter));
-    if(!suffix.isEmpty())
-    {
-        repeatedName += QString(QLatin1Literal(".%1")).arg(suffix);
-    }
-
-    return repeatedName;
+    //The free counter is looked for with the unescaped names, but the local name keeps the escaped base name
+    nameIndex.addLocalEntries(currentFile.path(), unescapeName);
+    return UniqueNameIndex::getCounterName(currentFile.baseName(), nameIndex.getFreeCounter(fileName, suffix), suffix);
 }
 
 QPair<QString, QString> Utilities::getFilenameBasenameAndSuffix(const QString& fileName)
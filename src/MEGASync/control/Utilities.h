@@ -4,6 +4,7 @@
 #include "megaapi.h"
 #include "ThreadPool.h"
 #include "QTMegaRequestListener.h"
+#include "UniqueNameIndex.h"
 
 #include <QString>
 #include <QHash>
@@ -200,7 +201,7 @@ class ThreadPoolSingleton
         {
             if (instance == nullptr)
             {
-                instance.reset(new ThreadPool(5));
+                instance.reset(new ThreadPool(ThreadPool::defaultThreadCount()));
             }
 
             return instance.get();
@@ -351,8 +352,9 @@ public:
     // i.e. for 1 day & 3 hours remaining, remainingHours will be 27, not 3.
     static void getDaysAndHoursToTimestamp(int64_t secsTimestamps, int64_t &remaininDays, int64_t &remainingHours);
 
-    static QString getNonDuplicatedNodeName(mega::MegaNode* node, mega::MegaNode* parentNode, const QString& currentName, bool unescapeName, const QStringList &itemsBeingRenamed);
-    static QString getNonDuplicatedLocalName(const QFileInfo& currentFile, bool unescapeName, const QStringList &itemsBeingRenamed);
+    //The names of the items being renamed are added to nameIndex by the caller
+    static QString getNonDuplicatedNodeName(mega::MegaNode* node, mega::MegaNode* parentNode, const QString& currentName, bool unescapeName, UniqueNameIndex& nameIndex);
+    static QString getNonDuplicatedLocalName(const QFileInfo& currentFile, bool unescapeName, UniqueNameIndex& nameIndex);
     static QPair<QString, QString> getFilenameBasenameAndSuffix(const QString& fileName);
 
     static void upgradeClicked();
@@ -403,7 +405,6 @@ public:
     static void queueFunctionInAppThread(std::function<void()> fun);
     static void queueFunctionInObjectThread(QObject* object, std::function<void()> fun);
 
-    static void getFolderSize(QString folderPath, long long *size);
     static qreal getDevicePixelRatio();
 
     static QIcon getCachedPixmap(QString fileName);
@@ -0,0 +1,117 @@
+#include "WebTransferProgressTable.h"
+
+#include <QDateTime>
+
+using namespace mega;
+
+const long long WebTransferProgressTable::EXPIRY_BUCKET_SECS = 60;
+
+RequestTransferData::RequestTransferData()
+{
+    state = MegaTransfer::STATE_NONE;
+    progress = 0;
+    size = 0;
+    speed = 0;
+    tsStart = QDateTime::currentMSecsSinceEpoch() / 1000;
+    tsEnd = -1;
+    tPath = QString();
+}
+
+bool RequestTransferData::isFinished() const
+{
+    return state == MegaTransfer::STATE_CANCELLED
+           || state == MegaTransfer::STATE_COMPLETED
+           || state == MegaTransfer::STATE_FAILED;
+}
+
+void WebTransferProgressTable::track(MegaHandle handle)
+{
+    //The old expiry bucket entry, if any, is ignored when purging as the transfer is not finished
+    mTransfers.insert(handle, RequestTransferData());
+    mChangedHandles.insert(handle);
+}
+
+bool WebTransferProgressTable::update(MegaHandle handle, int state, long long progress, long long size, long long speed,
+                                      const QString& localPath, long long nowSecs)
+{
+    auto it = mTransfers.find(handle);
+    if (it == mTransfers.end())
+    {
+        return false;
+    }
+
+    RequestTransferData& tData = it.value();
+    tData.state = state;
+    tData.progress = progress;
+    tData.size = size;
+    tData.speed = speed;
+
+    if (!localPath.isEmpty() && tData.tPath != localPath)
+    {
+        tData.tPath = localPath;
+    }
+
+    if (tData.isFinished())
+    {
+        tData.tsEnd = nowSecs;
+        mExpiryBuckets[nowSecs / EXPIRY_BUCKET_SECS].insert(handle);
+    }
+
+    mChangedHandles.insert(handle);
+    return true;
+}
+
+void WebTransferProgressTable::purgeExpired(long long nowSecs, long long maxAgeSecs)
+{
+    //Only the buckets whose transfers all finished more than maxAgeSecs ago
+    auto bucketIt = mExpiryBuckets.begin();
+    while (bucketIt != mExpiryBuckets.end()
+           && nowSecs - ((bucketIt->first + 1) * EXPIRY_BUCKET_SECS - 1) > maxAgeSecs)
+    {
+        for (auto handle : qAsConst(bucketIt->second))
+        {
+            auto it = mTransfers.find(handle);
+            //Skip the transfers started again or finished later, they are in a newer bucket (if finished)
+            if (it != mTransfers.end() && it.value().isFinished()
+                && it.value().tsEnd / EXPIRY_BUCKET_SECS == bucketIt->first)
+            {
+                mTransfers.erase(it);
+                mChangedHandles.remove(handle);
+            }
+        }
+        bucketIt = mExpiryBuckets.erase(bucketIt);
+    }
+}
+
+bool WebTransferProgressTable::contains(MegaHandle handle) const
+{
+    return mTransfers.contains(handle);
+}
+
+const RequestTransferData* WebTransferProgressTable::value(MegaHandle handle) const
+{
+    auto it = mTransfers.constFind(handle);
+    return it != mTransfers.constEnd() ? &it.value() : nullptr;
+}
+
+QList<MegaHandle> WebTransferProgressTable::handles() const
+{
+    return mTransfers.keys();
+}
+
+int WebTransferProgressTable::size() const
+{
+    return mTransfers.size();
+}
+
+QList<MegaHandle> WebTransferProgressTable::takeChangedHandles()
+{
+    QList<MegaHandle> changedHandles = mChangedHandles.values();
+    mChangedHandles.clear();
+    return changedHandles;
+}
+
+void WebTransferProgressTable::clearChangedHandles()
+{
+    mChangedHandles.clear();
+}
@@ -0,0 +1,58 @@
+#ifndef WEBTRANSFERPROGRESSTABLE_H
+#define WEBTRANSFERPROGRESSTABLE_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include <megaapi.h>
+
+#include <map>
+
+class RequestTransferData
+{
+public:
+    RequestTransferData();
+    int state;
+    long long progress;
+    long long size;
+    long long speed;
+    long long tsStart;
+    long long tsEnd;
+    QString tPath;
+
+    bool isFinished() const;
+};
+
+/// Responsability: progress of the transfers started from the webclient, indexed by node handle.
+/// Finished transfers are also filed in expiry buckets by their end time, so purging the expired ones only visits
+/// the buckets old enough instead of every transfer. The handles updated since the last call to takeChangedHandles
+/// are kept to push only the changes to the webclient.
+class WebTransferProgressTable
+{
+public:
+    static const long long EXPIRY_BUCKET_SECS;
+
+    // Starts tracking the handle. Any previous progress of the handle is discarded
+    void track(mega::MegaHandle handle);
+    // Returns false if the handle is not tracked
+    bool update(mega::MegaHandle handle, int state, long long progress, long long size, long long speed,
+                const QString& localPath, long long nowSecs);
+    void purgeExpired(long long nowSecs, long long maxAgeSecs);
+
+    bool contains(mega::MegaHandle handle) const;
+    // nullptr if the handle is not tracked
+    const RequestTransferData* value(mega::MegaHandle handle) const;
+    QList<mega::MegaHandle> handles() const;
+    int size() const;
+
+    QList<mega::MegaHandle> takeChangedHandles();
+    void clearChangedHandles();
+
+private:
+    QHash<mega::MegaHandle, RequestTransferData> mTransfers;
+    std::map<long long, QSet<mega::MegaHandle>> mExpiryBuckets;
+    QSet<mega::MegaHandle> mChangedHandles;
+};
+
+#endif // WEBTRANSFERPROGRESSTABLE_H
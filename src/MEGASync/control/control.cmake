@@ -5,16 +5,24 @@ set(DESKTOP_APP_CONTROL_HEADERS
     control/AsyncHandler.h
     control/ConnectivityChecker.h
     control/CrashHandler.h
+    control/DebrisCleaner.h
     control/DialogOpener.h
     control/DownloadQueueController.h
     control/EmailRequester.h
     control/StatsEventHandler.h
     control/ProxyStatsEventHandler.h
+    control/ResourceUsageSampler.h
     control/ExportProcessor.h
     control/FileFolderAttributes.h
+    control/FolderSizeScanner.h
+    control/LocalAttributesScanner.h
     control/HTTPServer.h
+    control/HTTPRequestParser.h
+    control/WebTransferProgressTable.h
     control/IntervalExecutioner.h
     control/LinkProcessor.h
+    control/LinkImportPlanner.h
+    control/LockFreeQueue.h
     control/LinkObject.h
     control/LoginController.h
     control/MegaDownloader.h
@@ -34,6 +42,8 @@ set(DESKTOP_APP_CONTROL_HEADERS
     control/qrcodegen.h
     control/MegaApiSynchronizedRequest.h
     control/MergeMEGAFolders.h
+    control/MergeMEGAFoldersPlan.h
+    control/UniqueNameIndex.h
     control/MEGAPathCreator.h
     control/MoveToMEGABin.h
     control/Preferences/EncryptedSettings.h
@@ -46,15 +56,22 @@ set(DESKTOP_APP_CONTROL_SOURCES
     control/AppStatsEvents.cpp
     control/ConnectivityChecker.cpp
     control/CrashHandler.cpp
+    control/DebrisCleaner.cpp
     control/DialogOpener.cpp
     control/DownloadQueueController.cpp
     control/EmailRequester.cpp
     control/ProxyStatsEventHandler.cpp
+    control/ResourceUsageSampler.cpp
     control/ExportProcessor.cpp
     control/FileFolderAttributes.cpp
+    control/FolderSizeScanner.cpp
+    control/LocalAttributesScanner.cpp
     control/HTTPServer.cpp
+    control/HTTPRequestParser.cpp
+    control/WebTransferProgressTable.cpp
     control/IntervalExecutioner.cpp
     control/LinkProcessor.cpp
+    control/LinkImportPlanner.cpp
     control/LinkObject.cpp
     control/LoginController.cpp
     control/MegaDownloader.cpp
@@ -70,6 +87,8 @@ set(DESKTOP_APP_CONTROL_SOURCES
     control/Utilities.cpp
     control/qrcodegen.c
     control/MergeMEGAFolders.cpp
+    control/MergeMEGAFoldersPlan.cpp
+    control/UniqueNameIndex.cpp
     control/MEGAPathCreator.cpp
     control/MoveToMEGABin.cpp
     control/Preferences/EncryptedSettings.cpp
@@ -8,20 +8,29 @@ QT       += network
 CONFIG += object_parallel_to_source
 
 SOURCES += $$PWD/HTTPServer.cpp \
+    $$PWD/HTTPRequestParser.cpp \
+    $$PWD/WebTransferProgressTable.cpp \
     $$PWD/AccountStatusController.cpp \
     $$PWD/AppStatsEvents.cpp \
+    $$PWD/DebrisCleaner.cpp \
     $$PWD/DialogOpener.cpp \
     $$PWD/DownloadQueueController.cpp \
     $$PWD/FileFolderAttributes.cpp \
+    $$PWD/FolderSizeScanner.cpp \
+    $$PWD/LocalAttributesScanner.cpp \
     $$PWD/LinkObject.cpp \
     $$PWD/LoginController.cpp \
     $$PWD/Preferences/Preferences.cpp \
     $$PWD/Preferences/EphemeralCredentials.cpp \
     $$PWD/Preferences/EncryptedSettings.cpp \
     $$PWD/LinkProcessor.cpp \
+    $$PWD/LinkImportPlanner.cpp \
     $$PWD/MegaUploader.cpp \
+    $$PWD/MergeMEGAFoldersPlan.cpp \
     $$PWD/SetManager.cpp \
     $$PWD/ProxyStatsEventHandler.cpp \
+    $$PWD/ResourceUsageSampler.cpp \
+    $$PWD/UniqueNameIndex.cpp \
     $$PWD/TransferRemainingTime.cpp \
     $$PWD/UpdateTask.cpp \
     $$PWD/CrashHandler.cpp \
@@ -38,11 +47,16 @@ SOURCES += $$PWD/HTTPServer.cpp \
     $$PWD/qrcodegen.c
 
 HEADERS  +=  $$PWD/HTTPServer.h \
+    $$PWD/HTTPRequestParser.h \
+    $$PWD/WebTransferProgressTable.h \
     $$PWD/AccountStatusController.h \
     $$PWD/AppStatsEvents.h \
     $$PWD/AsyncHandler.h \
+    $$PWD/DebrisCleaner.h \
     $$PWD/DialogOpener.h \
     $$PWD/FileFolderAttributes.h \
+    $$PWD/FolderSizeScanner.h \
+    $$PWD/LocalAttributesScanner.h \
     $$PWD/DownloadQueueController.h \
     $$PWD/IStatsEventHandler.h \
     $$PWD/LinkObject.h \
@@ -52,11 +66,16 @@ HEADERS  +=  $$PWD/HTTPServer.h \
     $$PWD/Preferences/EncryptedSettings.h \
     $$PWD/FileFolderAttributes.h \
     $$PWD/LinkProcessor.h \
+    $$PWD/LinkImportPlanner.h \
     $$PWD/MegaUploader.h \
+    $$PWD/MergeMEGAFoldersPlan.h \
+    $$PWD/LockFreeQueue.h \
     $$PWD/ProtectedQueue.h \
     $$PWD/ProxyStatsEventHandler.h \
+    $$PWD/ResourceUsageSampler.h \
     $$PWD/SetManager.h \
     $$PWD/SetTypes.h \
+    $$PWD/UniqueNameIndex.h \
     $$PWD/TransferRemainingTime.h \
     $$PWD/UpdateTask.h \
     $$PWD/CrashHandler.h \
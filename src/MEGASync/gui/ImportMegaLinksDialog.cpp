@@ -26,6 +26,7 @@ ImportMegaLinksDialog::ImportMegaLinksDialog(const QStringList& linkList, QWidge
     , mDownloadPathChangedByUser(false)
     , mUseDefaultImportPath(true)
     , mImportPathChangedByUser(false)
+    , mSelectedItemsCount(0)
 {
     ui->setupUi(this);
 
@@ -185,9 +186,10 @@ void ImportMegaLinksDialog::on_bMegaFolder_clicked()
 
 void ImportMegaLinksDialog::setSelectedItem(int index, bool selected)
 {
-    if (index >= 0 && index < mSelectedItems.size())
+    if (index >= 0 && index < mSelectedItems.size() && mSelectedItems[index] != selected)
     {
         mSelectedItems[index] = selected;
+        mSelectedItemsCount += selected ? 1 : -1;
     }
 
 }
@@ -204,6 +206,9 @@ void ImportMegaLinksDialog::onLinkInfoAvailable(int index,
 
     setSelectedItem(index, item->isSelected());
     emit linkSelected(index, item->isSelected());
+
+    // The links are resolved in parallel, the options are available since the first valid one arrives
+    checkLinkValidAndSelected();
 }
 
 
@@ -318,7 +323,7 @@ void ImportMegaLinksDialog::setInvalidImportFolder()
 void ImportMegaLinksDialog::enableOkButton() const
 {
     const bool downloadOrImportChecked{ui->cDownload->isChecked() || ui->cImport->isChecked()};
-    const bool enable{mFinished && downloadOrImportChecked && (mSelectedItems.contains(true))};
+    const bool enable{mFinished && downloadOrImportChecked && (mSelectedItemsCount > 0)};
     ui->bOk->setEnabled(enable);
 }
 
@@ -337,7 +342,7 @@ void ImportMegaLinksDialog::enableMegaFolder(bool enable)
 void ImportMegaLinksDialog::checkLinkValidAndSelected()
 {
     // Set enable to true if at least one item is selected
-    bool enable = mSelectedItems.contains(true);
+    bool enable = mSelectedItemsCount > 0;
     ui->cDownload->setEnabled(enable);
     ui->cImport->setEnabled(enable);
     enableOkButton();
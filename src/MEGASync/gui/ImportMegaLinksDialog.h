@@ -60,6 +60,7 @@ private:
     bool mUseDefaultImportPath;
     bool mImportPathChangedByUser;
     QVector<bool> mSelectedItems;
+    int mSelectedItemsCount;
 
     void initUiAsLogged();
     void initUiAsUnlogged();
@@ -3,6 +3,8 @@
 #include "QMegaMessageBox.h"
 #include "ui_SettingsDialog.h"
 #include "Utilities.h"
+#include "FolderSizeScanner.h"
+#include "DebrisCleaner.h"
 #include "platform/Platform.h"
 #include "BandwidthSettings.h"
 #include "BugReportDialog.h"
@@ -64,9 +66,9 @@ const QString SYNCS_TAB_MENU_LABEL_QSS = QString::fromUtf8("QLabel{ border-image
 static constexpr int NUMBER_OF_CLICKS_TO_DEBUG {5};
 static constexpr int NETWORK_LIMITS_MAX {9999};
 
-long long calculateCacheSize()
+QStringList getDebrisFolders()
 {
-    long long cacheSize = 0;
+    QStringList debrisFolders;
     auto model (SyncInfo::instance());
     for (auto syncType : SyncInfo::AllHandledSyncTypes)
     {
@@ -76,12 +78,12 @@ long long calculateCacheSize()
             QString syncPath = syncSetting->getLocalFolder();
             if (!syncPath.isEmpty())
             {
-                Utilities::getFolderSize(syncPath + QDir::separator()
-                                         + QString::fromUtf8(MEGA_DEBRIS_FOLDER), &cacheSize);
+                debrisFolders.append(syncPath + QDir::separator()
+                                     + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
             }
         }
     }
-    return cacheSize;
+    return debrisFolders;
 }
 
 long long calculateRemoteCacheSize(MegaApi* mMegaApi)
@@ -212,12 +214,17 @@ SettingsDialog::SettingsDialog(MegaApplication* app, bool proxyOnly, QWidget* pa
 
     connect(mApp, &MegaApplication::shellNotificationsProcessed,
             this, &SettingsDialog::onShellNotificationsProcessed);
+    // The size left after removing the debris
+    connect(mApp->getDebrisCleaner(), &DebrisCleaner::finished,
+            this, &SettingsDialog::startCacheSizeScan);
     setOverlayCheckboxEnabled(!mApp->isShellNotificationProcessingOngoing(),
                               mUi->cOverlayIcons->isChecked());
 }
 
 SettingsDialog::~SettingsDialog()
 {
+    mCacheSizeScan.cancel();
+
     mApp->dettachStorageObserver(*this);
     mApp->dettachBandwidthObserver(*this);
     mApp->dettachAccountObserver(*this);
@@ -445,10 +452,7 @@ void SettingsDialog::loadSettings()
 
     if (mPreferences->logged())
     {
-        connect(&mCacheSizeWatcher, &QFutureWatcher<long long>::finished,
-                this, &SettingsDialog::onLocalCacheSizeAvailable);
-        QFuture<long long> futureCacheSize = QtConcurrent::run(calculateCacheSize);
-        mCacheSizeWatcher.setFuture(futureCacheSize);
+        startCacheSizeScan();
 
         connect(&mRemoteCacheSizeWatcher, &QFutureWatcher<long long>::finished,
                 this, &SettingsDialog::onRemoteCacheSizeAvailable);
@@ -578,11 +582,6 @@ void SettingsDialog::loadSettings()
 
 // General -----------------------------------------------------------------------------------------
 
-void deleteCache()
-{
-    MegaSyncApp->cleanLocalCaches(true);
-}
-
 void deleteRemoteCache(MegaApi* mMegaApi)
 {
     MegaNode* n = mMegaApi->getNodeByPath("//bin/SyncDebris");
@@ -590,6 +589,24 @@ void deleteRemoteCache(MegaApi* mMegaApi)
     delete n;
 }
 
+void SettingsDialog::startCacheSizeScan()
+{
+    // The size is shown while the debris folders are scanned
+    mCacheSizeScan.cancel();
+    QPointer<SettingsDialog> dialog(this);
+    mCacheSizeScan = FolderSizeScanner::instance()->scan(getDebrisFolders(),
+                                                         [dialog](long long size, bool)
+    {
+        Utilities::queueFunctionInAppThread([dialog, size]()
+        {
+            if (dialog)
+            {
+                dialog->onLocalCacheSizeAvailable(size);
+            }
+        });
+    });
+}
+
 void SettingsDialog::setUpdateAvailable(bool updateAvailable)
 {
     if (updateAvailable)
@@ -607,9 +624,9 @@ void SettingsDialog::storageChanged()
     onCacheSizeAvailable();
 }
 
-void SettingsDialog::onLocalCacheSizeAvailable()
+void SettingsDialog::onLocalCacheSizeAvailable(long long size)
 {
-    mCacheSize = mCacheSizeWatcher.result();
+    mCacheSize = size;
     onCacheSizeAvailable();
 }
 
@@ -800,7 +817,8 @@ void SettingsDialog::on_bClearCache_clicked()
     {
         if(msg->result() == QMessageBox::Yes)
         {
-            QtConcurrent::run(deleteCache);
+            mCacheSizeScan.cancel();
+            mApp->cleanLocalCaches(true);
             mCacheSize = 0;
             onCacheSizeAvailable();
         }
@@ -944,7 +962,7 @@ void SettingsDialog::on_cLanguage_currentIndexChanged(int index)
         {
             mMegaApi->setLanguage(currentLanguage.toUtf8().constData());
             mMegaApi->setLanguagePreference(currentLanguage.toUtf8().constData());
-        });
+        }, ThreadPool::Lane::INTERACTIVE);
     }
 }
 
@@ -1026,7 +1044,7 @@ void SettingsDialog::on_cOverlayIcons_toggled(bool checked)
 
     setOverlayCheckboxEnabled(false, checked);
 
-#ifdef Q_OS_MACOS
+#if defined(Q_OS_MACOS) || defined(Q_OS_LINUX)
     Platform::getInstance()->notifyRestartSyncFolders();
 #endif
     mApp->notifyChangeToAllFolders();
@@ -76,7 +76,7 @@ public slots:
     void showGuestMode();
 
     // General
-    void onLocalCacheSizeAvailable();
+    void onLocalCacheSizeAvailable(long long size);
     void onRemoteCacheSizeAvailable();
 
     //Enable/Disable controls
@@ -160,6 +160,7 @@ private slots:
 
 private:
     void loadSettings();
+    void startCacheSizeScan();
     void onCacheSizeAvailable();
     void saveExcludeSyncNames();
     void updateNetworkTab();
@@ -197,7 +198,7 @@ private:
     int mLoadingSettings;
     ThreadPool* mThreadPool;
     QStringList mLanguageCodes;
-    QFutureWatcher<long long> mCacheSizeWatcher;
+    ThreadPool::CancellationToken mCacheSizeScan;
     QFutureWatcher<long long> mRemoteCacheSizeWatcher;
     long long mCacheSize;
     long long mRemoteCacheSize;
@@ -91,6 +91,8 @@ void NodeSelector::onSearch(const QString &text)
     if(senderViewWidget != mSearchWidget)
     {
         senderViewWidget->clearSearchText();
+        // The search starts while typing, so the user keeps typing in the search view
+        mSearchWidget->focusSearchText();
     }
 }
 
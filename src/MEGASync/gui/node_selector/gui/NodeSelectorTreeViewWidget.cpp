@@ -133,6 +133,11 @@ void NodeSelectorTreeViewWidget::clearSearchText()
     ui->leSearch->onClearClicked();
 }
 
+void NodeSelectorTreeViewWidget::focusSearchText()
+{
+    ui->leSearch->setFocus();
+}
+
 void NodeSelectorTreeViewWidget::clearSelection()
 {
     ui->tMegaFolders->clearSelection();
@@ -58,6 +58,7 @@ public:
     void setSearchText(const QString& text);
     void setTitleText(const QString& nodeName);
     void clearSearchText();
+    void focusSearchText();
     void clearSelection();
     void abort();
     NodeSelectorProxyModel* getProxyModel();
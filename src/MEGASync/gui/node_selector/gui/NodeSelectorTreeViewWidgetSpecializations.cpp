@@ -262,13 +262,48 @@ void NodeSelectorTreeViewWidgetSearch::modelLoaded()
     if(searchModel)
     {
         searchedTypes = searchModel->searchedTypes();
+        connect(searchModel, &NodeSelectorModelSearch::searchedTypesChanged,
+                this, &NodeSelectorTreeViewWidgetSearch::onSearchedTypesChanged, Qt::UniqueConnection);
     }
 
+    updateSearchButtons(searchedTypes);
+    ui->searchButtonsWidget->setVisible(true);
+
+    checkAndClick(getButtonToCheck());
+
+    if(ui->tMegaFolders->model())
+    {
+        mHasRows = ui->tMegaFolders->model()->rowCount() > 0;
+        if(!mHasRows && showEmptyView())
+        {
+            ui->stackedWidget->setCurrentWidget(ui->emptyPage);
+            return;
+        }
+    }
+    ui->stackedWidget->setCurrentWidget(ui->treeViewPage);
+}
+
+void NodeSelectorTreeViewWidgetSearch::onSearchedTypesChanged(NodeSelectorModelItemSearch::Types types)
+{
+    updateSearchButtons(types);
+
+    // The type selected is kept, unless there was none to select
+    auto buttonToCheck(getButtonToCheck());
+    if(buttonToCheck && !buttonToCheck->isChecked())
+    {
+        checkAndClick(buttonToCheck);
+    }
+}
+
+void NodeSelectorTreeViewWidgetSearch::updateSearchButtons(NodeSelectorModelItemSearch::Types searchedTypes)
+{
     ui->backupsSearch->setVisible(searchedTypes.testFlag(NodeSelectorModelItemSearch::Type::BACKUP));
     ui->incomingSharesSearch->setVisible(searchedTypes.testFlag(NodeSelectorModelItemSearch::Type::INCOMING_SHARE));
     ui->cloudDriveSearch->setVisible(searchedTypes.testFlag(NodeSelectorModelItemSearch::Type::CLOUD_DRIVE));
-    ui->searchButtonsWidget->setVisible(true);
+}
 
+QToolButton* NodeSelectorTreeViewWidgetSearch::getButtonToCheck() const
+{
     QToolButton* buttonToCheck(nullptr);
 
     auto buttons = ui->searchButtonsWidget->findChildren<QToolButton*>();
@@ -285,18 +320,7 @@ void NodeSelectorTreeViewWidgetSearch::modelLoaded()
         }
     }
 
-    checkAndClick(buttonToCheck);
-
-    if(ui->tMegaFolders->model())
-    {
-        mHasRows = ui->tMegaFolders->model()->rowCount() > 0;
-        if(!mHasRows && showEmptyView())
-        {
-            ui->stackedWidget->setCurrentWidget(ui->emptyPage);
-            return;
-        }
-    }
-    ui->stackedWidget->setCurrentWidget(ui->treeViewPage);
+    return buttonToCheck;
 }
 
 void NodeSelectorTreeViewWidgetSearch::checkAndClick(QToolButton* button)
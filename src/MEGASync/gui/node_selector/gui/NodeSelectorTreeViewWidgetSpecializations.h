@@ -86,8 +86,11 @@ private slots:
     void onIncomingSharesSearchClicked();
     void onCloudDriveSearchClicked();
     void onItemDoubleClick(const QModelIndex &index) override;
+    void onSearchedTypesChanged(NodeSelectorModelItemSearch::Types types);
 
 private:
+    void updateSearchButtons(NodeSelectorModelItemSearch::Types searchedTypes);
+    QToolButton* getButtonToCheck() const;
     void checkAndClick(QToolButton* button);
     void changeButtonsWidgetSizePolicy(bool state);
     QString getRootText() override;
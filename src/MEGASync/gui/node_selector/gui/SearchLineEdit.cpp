@@ -8,6 +8,12 @@
 
 #include <functional>
 
+namespace
+{
+constexpr int SEARCH_TYPING_DELAY_MS = 300;
+// Shorter texts are searched only with Enter
+constexpr int MIN_TYPED_SEARCH_LENGTH = 3;
+}
 
 SearchLineEdit::SearchLineEdit(QWidget *parent)
     : QFrame(parent),
@@ -20,8 +26,13 @@ SearchLineEdit::SearchLineEdit(QWidget *parent)
     mButtonManager.addButton(ui->tSearchCancel);
     connect(ui->tSearchCancel, &QToolButton::clicked, this, &SearchLineEdit::onClearClicked);
     connect(ui->leSearchField, &QLineEdit::textChanged, this, &SearchLineEdit::onTextChanged);
+    connect(ui->leSearchField, &QLineEdit::textEdited, this, &SearchLineEdit::onTextEdited);
+    mSearchTimer.setSingleShot(true);
+    mSearchTimer.setInterval(SEARCH_TYPING_DELAY_MS);
+    connect(&mSearchTimer, &QTimer::timeout, this, &SearchLineEdit::emitSearch);
     ui->tSearchCancel->setGraphicsEffect(new QGraphicsOpacityEffect());
     ui->leSearchField->installEventFilter(this);
+    setFocusProxy(ui->leSearchField);
 
 #ifdef Q_OS_MACOS
     ui->leSearchField->setAttribute(Qt::WA_MacShowFocusRect, 0);
@@ -36,6 +47,9 @@ SearchLineEdit::~SearchLineEdit()
 
 void SearchLineEdit::setText(const QString &text)
 {
+    // Not edited by the user, nothing to search
+    mSearchTimer.stop();
+    mOldString = text;
     ui->leSearchField->setText(text);
 }
 
@@ -55,11 +69,8 @@ bool SearchLineEdit::eventFilter(QObject *obj, QEvent *evnt)
         QKeyEvent* keyEvent = dynamic_cast<QKeyEvent*>(evnt);
         if(keyEvent->key() == Qt::Key_Enter || keyEvent->key() == Qt::Key_Return)
         {
-            if(!ui->leSearchField->text().isEmpty() && mOldString != ui->leSearchField->text())
-            {
-                mOldString = ui->leSearchField->text();
-                emit search(ui->leSearchField->text());
-            }
+            mSearchTimer.stop();
+            emitSearch();
         }
     }
     return QFrame::eventFilter(obj, evnt);
@@ -67,6 +78,7 @@ bool SearchLineEdit::eventFilter(QObject *obj, QEvent *evnt)
 
 void SearchLineEdit::onClearClicked()
 {
+    mSearchTimer.stop();
     ui->leSearchField->clear();
     if(ui->tSearchCancel->isVisible())
     {
@@ -91,6 +103,27 @@ void SearchLineEdit::onTextChanged(const QString &text)
     }
 }
 
+void SearchLineEdit::onTextEdited()
+{
+    if(ui->leSearchField->text().trimmed().size() >= MIN_TYPED_SEARCH_LENGTH)
+    {
+        mSearchTimer.start();
+    }
+    else
+    {
+        mSearchTimer.stop();
+    }
+}
+
+void SearchLineEdit::emitSearch()
+{
+    if(!ui->leSearchField->text().isEmpty() && mOldString != ui->leSearchField->text())
+    {
+        mOldString = ui->leSearchField->text();
+        emit search(ui->leSearchField->text());
+    }
+}
+
 void SearchLineEdit::animationFinished()
 {
    ui->tSearchCancel->setVisible(!ui->leSearchField->text().isEmpty());
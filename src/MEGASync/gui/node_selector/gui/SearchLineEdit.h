@@ -7,6 +7,7 @@
 #include <QIcon>
 #include <QGraphicsOpacityEffect>
 #include <QPropertyAnimation>
+#include <QTimer>
 
 namespace Ui {
 class SearchLineEdit;
@@ -35,13 +36,17 @@ public slots:
 
 private slots:
     void onTextChanged(const QString& text);
+    void onTextEdited();
     void animationFinished();
 
 private:
     void makeEffect(bool fadeIn);
+    void emitSearch();
     Ui::SearchLineEdit *ui;
     ButtonIconManager mButtonManager;
     QString mOldString;
+    // Searches when the user stops typing
+    QTimer mSearchTimer;
 };
 
 #endif // SEARCHLINEEDIT_H
@@ -9,7 +9,11 @@
 #include <QApplication>
 #include <QToolTip>
 
+#include <algorithm>
+
 const char* INDEX_PROPERTY = "INDEX";
+// The first page is small to show the first results soon, the next ones double its size
+const size_t SEARCH_FIRST_PAGE_SIZE = 100;
 
 NodeRequester::NodeRequester(NodeSelectorModel *model)
     : QObject(nullptr),
@@ -20,6 +24,7 @@ NodeRequester::NodeRequester(NodeSelectorModel *model)
 NodeRequester::~NodeRequester()
 {
     qDeleteAll(mRootItems);
+    qDeleteAll(mPendingSearchItems);
 }
 
 void NodeRequester::lockDataMutex(bool state) const
@@ -86,46 +91,81 @@ void NodeRequester::search(const QString &text, NodeSelectorModelItemSearch::Typ
         QMutexLocker d(&mDataMutex);
         qDeleteAll(mRootItems);
         mRootItems.clear();
+        qDeleteAll(mPendingSearchItems);
+        mPendingSearchItems.clear();
+        mSearchedTypes = NodeSelectorModelItemSearch::Type::NONE;
     }
     mSearchCanceled = false;
 
     std::unique_ptr<mega::MegaSearchFilter> searchFilter(mega::MegaSearchFilter::createInstance());
     searchFilter->byName(text.toUtf8().constData());
 
-    auto nodeList = std::unique_ptr<mega::MegaNodeList>(MegaSyncApp->getMegaApi()->search(searchFilter.get(), mega::MegaApi::ORDER_NONE, mCancelToken.get()));
-    QList<NodeSelectorModelItem*> items;
-    mSearchedTypes = NodeSelectorModelItemSearch::Type::NONE;
-
-    for(int i = 0; i < nodeList->size(); i++)
-    {
-        auto item = createSearchItem(nodeList->get(i), typesAllowed);
-        if(item)
+    // The results are requested by pages: the model is loaded with the first page that has results,
+    // the next pages are inserted while they are found
+    bool rootItemsCreated(false);
+    size_t offset(0);
+    size_t pageSize(SEARCH_FIRST_PAGE_SIZE);
+    bool lastPage(false);
+    while(!lastPage)
+    {
+        std::unique_ptr<mega::MegaSearchPage> searchPage(mega::MegaSearchPage::createInstance(offset, pageSize));
+        auto nodeList = std::unique_ptr<mega::MegaNodeList>(MegaSyncApp->getMegaApi()->search(searchFilter.get(),
+                                                                                              mega::MegaApi::ORDER_NONE,
+                                                                                              mCancelToken.get(),
+                                                                                              searchPage.get()));
+        QList<NodeSelectorModelItem*> items;
+        NodeSelectorModelItemSearch::Types pageTypes(NodeSelectorModelItemSearch::Type::NONE);
+        for(int i = 0; i < nodeList->size(); i++)
         {
-            items.append(item);
+            auto item = createSearchItem(nodeList->get(i), typesAllowed);
+            if(item)
+            {
+                items.append(item);
+                pageTypes |= item->getType();
+            }
         }
-    }
 
-    if(isAborted() || mSearchCanceled)
-    {
-        qDeleteAll(items);
-    }
-    else
-    {
+        lastPage = static_cast<size_t>(nodeList->size()) < pageSize;
+        offset += pageSize;
+        pageSize *= 2;
+
         QMutexLocker d(&mDataMutex);
-        mRootItems.append(items);
-        emit searchItemsCreated();
+        if(isAborted() || mSearchCanceled)
+        {
+            qDeleteAll(items);
+            return;
+        }
+
+        mSearchedTypes |= pageTypes;
+        if(!rootItemsCreated)
+        {
+            if(items.isEmpty() && !lastPage)
+            {
+                continue;
+            }
+            mRootItems.append(items);
+            rootItemsCreated = true;
+            emit searchItemsCreated();
+        }
+        else if(!items.isEmpty())
+        {
+            mPendingSearchItems.append(items);
+            emit searchItemsPageReady();
+        }
     }
 }
 
 void NodeRequester::addSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nodes, NodeSelectorModelItemSearch::Types typesAllowed)
 {
     QList<NodeSelectorModelItem*> items;
+    NodeSelectorModelItemSearch::Types itemsTypes(NodeSelectorModelItemSearch::Type::NONE);
     foreach(auto node, nodes)
     {
         auto item = createSearchItem(node.get(), typesAllowed);
         if(item)
         {
             items.append(item);
+            itemsTypes |= item->getType();
         }
     }
 
@@ -139,12 +179,13 @@ void NodeRequester::addSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nod
         {
             QMutexLocker d(&mDataMutex);
             mRootItems.append(items);
+            mSearchedTypes |= itemsTypes;
             emit rootItemsAdded();
         }
     }
 }
 
-NodeSelectorModelItem *NodeRequester::createSearchItem(mega::MegaNode *node, NodeSelectorModelItemSearch::Types typesAllowed)
+NodeSelectorModelItemSearch *NodeRequester::createSearchItem(mega::MegaNode *node, NodeSelectorModelItemSearch::Types typesAllowed)
 {
     if(isAborted() || mSearchCanceled)
     {
@@ -188,7 +229,6 @@ NodeSelectorModelItem *NodeRequester::createSearchItem(mega::MegaNode *node, Nod
 
     if(typesAllowed & type)
     {
-        mSearchedTypes |= type;
         auto nodeUptr = std::unique_ptr<mega::MegaNode>(node->copy());
         auto item = new NodeSelectorModelItemSearch(std::move(nodeUptr), type);
         return item;
@@ -416,6 +456,29 @@ void NodeRequester::restartSearch()
         mSearchCanceled = true;
         mCancelToken.reset(mega::MegaCancelToken::createInstance());
     }
+    clearPendingSearchItems();
+}
+
+int NodeRequester::pendingSearchItemsCount() const
+{
+    QMutexLocker lock(&mDataMutex);
+    return mPendingSearchItems.size();
+}
+
+void NodeRequester::addPendingSearchItems(int count)
+{
+    QMutexLocker lock(&mDataMutex);
+    count = std::min(count, mPendingSearchItems.size());
+    mRootItems.append(mPendingSearchItems.mid(0, count));
+    mPendingSearchItems.erase(mPendingSearchItems.begin(), mPendingSearchItems.begin() + count);
+}
+
+void NodeRequester::clearPendingSearchItems()
+{
+    // The search checks mSearchCanceled with the data mutex locked, so no pages are added after this
+    QMutexLocker lock(&mDataMutex);
+    qDeleteAll(mPendingSearchItems);
+    mPendingSearchItems.clear();
 }
 
 void NodeRequester::cancelCurrentRequest()
@@ -437,8 +500,9 @@ bool NodeRequester::showFiles() const
     return mShowFiles.load();
 }
 
-const NodeSelectorModelItemSearch::Types &NodeRequester::searchedTypes() const
+NodeSelectorModelItemSearch::Types NodeRequester::searchedTypes() const
 {
+    QMutexLocker lock(&mDataMutex);
     return mSearchedTypes;
 }
 
@@ -67,8 +67,12 @@ public:
 
     void cancelCurrentRequest();
     void restartSearch();
+    int pendingSearchItemsCount() const;
+    // Moves the first pending search items to the root items
+    void addPendingSearchItems(int count);
 
-    const NodeSelectorModelItemSearch::Types &searchedTypes() const;
+    // Types of the search results found until now
+    NodeSelectorModelItemSearch::Types searchedTypes() const;
 
     bool showFiles() const;
 
@@ -98,12 +102,14 @@ signals:
      void rootItemsDeleted();
      void megaBackupRootItemsCreated();
      void searchItemsCreated();
+     void searchItemsPageReady();
      void nodeAdded(NodeSelectorModelItem* item);
      void nodesAdded(QList<QPointer<NodeSelectorModelItem>> item);
 
 private:
      bool isAborted();
-    NodeSelectorModelItem* createSearchItem(mega::MegaNode* node, NodeSelectorModelItemSearch::Types typesAllowed);
+    NodeSelectorModelItemSearch* createSearchItem(mega::MegaNode* node, NodeSelectorModelItemSearch::Types typesAllowed);
+    void clearPendingSearchItems();
 
      std::atomic<bool> mShowFiles{true};
      std::atomic<bool> mShowReadOnlyFolders{true};
@@ -113,9 +119,12 @@ private:
      std::atomic<bool> mNodesRequested{false};
      NodeSelectorModel* mModel;
      QList<NodeSelectorModelItem*> mRootItems;
+     // Search results found after the first page, waiting to be inserted in the model
+     QList<NodeSelectorModelItem*> mPendingSearchItems;
      mutable QMutex mDataMutex;
      mutable QMutex mSearchMutex;
      std::shared_ptr<mega::MegaCancelToken> mCancelToken;
+     // Updated with each page of results, with the data mutex locked
      NodeSelectorModelItemSearch::Types mSearchedTypes;
 };
 
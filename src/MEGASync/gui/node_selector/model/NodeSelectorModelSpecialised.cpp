@@ -11,8 +11,13 @@
 #include <QApplication>
 #include <QToolTip>
 
+#include <algorithm>
+
 using namespace mega;
 
+// Search results inserted in each iteration of the event loop
+const int SEARCH_INSERT_CHUNK_SIZE = 500;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 NodeSelectorModelCloudDrive::NodeSelectorModelCloudDrive(QObject *parent)
     : NodeSelectorModel(parent)
@@ -311,7 +316,9 @@ void NodeSelectorModelBackups::onRootItemCreated()
 
 NodeSelectorModelSearch::NodeSelectorModelSearch(NodeSelectorModelItemSearch::Types allowedTypes, QObject *parent)
     : NodeSelectorModel(parent),
-      mAllowedTypes(allowedTypes)
+      mAllowedTypes(allowedTypes),
+      mSearchResetStarted(false),
+      mLoadedTypes(NodeSelectorModelItemSearch::Type::NONE)
 {
     qRegisterMetaType<NodeSelectorModelItemSearch::Types>("NodeSelectorModelItemSearch::Types");
 }
@@ -330,6 +337,11 @@ void NodeSelectorModelSearch::firstLoad()
                 mNodeRequesterWorker->removeRootItem(node);
             });
     connect(mNodeRequesterWorker, &NodeRequester::searchItemsCreated, this, &NodeSelectorModelSearch::onRootItemsCreated, Qt::QueuedConnection);
+    connect(mNodeRequesterWorker, &NodeRequester::searchItemsPageReady, this, &NodeSelectorModelSearch::insertPendingSearchItems, Qt::QueuedConnection);
+    // Queued, so each chunk is inserted in a different iteration of the event loop. Also retries the chunks
+    // skipped while other rows were being inserted or removed
+    connect(this, &NodeSelectorModelSearch::rowsInserted, this, &NodeSelectorModelSearch::insertPendingSearchItems, Qt::QueuedConnection);
+    connect(this, &NodeSelectorModelSearch::rowsRemoved, this, &NodeSelectorModelSearch::insertPendingSearchItems, Qt::QueuedConnection);
 }
 
 void NodeSelectorModelSearch::createRootNodes()
@@ -340,7 +352,12 @@ void NodeSelectorModelSearch::createRootNodes()
 void NodeSelectorModelSearch::searchByText(const QString &text)
 {
     mNodeRequesterWorker->restartSearch();
-    addRootItems();
+    // A search typed before the results of the previous one arrive is part of the same reset
+    if(!mSearchResetStarted)
+    {
+        mSearchResetStarted = true;
+        addRootItems();
+    }
     emit searchNodes(text, mAllowedTypes);
 }
 
@@ -443,18 +460,49 @@ bool NodeSelectorModelSearch::rootNodeUpdated(mega::MegaNode *node)
 void NodeSelectorModelSearch::proxyInvalidateFinished()
 {
     mNodeRequesterWorker->lockSearchMutex(false);
+    // The proxy has not emitted layoutChanged yet
+    QMetaObject::invokeMethod(this, &NodeSelectorModelSearch::insertPendingSearchItems, Qt::QueuedConnection);
 }
 
 void NodeSelectorModelSearch::onRootItemsCreated()
 {
     if(mNodeRequesterWorker->trySearchLock())
     {
+        mSearchResetStarted = false;
+        mLoadedTypes = searchedTypes();
         rootItemsLoaded();
         emit levelsAdded(mIndexesActionInfo.indexesToBeExpanded, true);
     }
 }
 
-const NodeSelectorModelItemSearch::Types &NodeSelectorModelSearch::searchedTypes() const
+void NodeSelectorModelSearch::insertPendingSearchItems()
+{
+    // Retried when the model is modified or sorted
+    if(isBeingModified() || !mNodeRequesterWorker->trySearchLock())
+    {
+        return;
+    }
+
+    auto count = std::min(mNodeRequesterWorker->pendingSearchItemsCount(), SEARCH_INSERT_CHUNK_SIZE);
+    if(count > 0)
+    {
+        auto totalRows = rowCount(QModelIndex());
+        beginInsertRows(QModelIndex(), totalRows, totalRows + count - 1);
+        mNodeRequesterWorker->addPendingSearchItems(count);
+        endInsertRows();
+    }
+    mNodeRequesterWorker->lockSearchMutex(false);
+
+    // The results of a type can come in any page
+    auto types(searchedTypes());
+    if(count > 0 && types != mLoadedTypes)
+    {
+        mLoadedTypes = types;
+        emit searchedTypesChanged(types);
+    }
+}
+
+NodeSelectorModelItemSearch::Types NodeSelectorModelSearch::searchedTypes() const
 {
     return mNodeRequesterWorker->searchedTypes();
 }
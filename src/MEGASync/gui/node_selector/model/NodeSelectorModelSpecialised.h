@@ -109,7 +109,7 @@ public:
     void addNodes(QList<std::shared_ptr<mega::MegaNode> > nodes, const QModelIndex &parent) override;
     bool rootNodeUpdated(mega::MegaNode*node) override;
 
-    const NodeSelectorModelItemSearch::Types &searchedTypes() const;
+    NodeSelectorModelItemSearch::Types searchedTypes() const;
 
 protected:
     void proxyInvalidateFinished() override;
@@ -118,12 +118,18 @@ signals:
     void searchNodes(const QString& text, NodeSelectorModelItemSearch::Types);
     void requestAddSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nodes, NodeSelectorModelItemSearch::Types typesAllowed);
     void requestDeleteSearchRootItem(std::shared_ptr<mega::MegaNode> node);
+    // Results of new types were inserted after the model was loaded
+    void searchedTypesChanged(NodeSelectorModelItemSearch::Types types);
 
 private slots:
     void onRootItemsCreated();
+    void insertPendingSearchItems();
 
 private:
     NodeSelectorModelItemSearch::Types mAllowedTypes;
+    // The model reset started by the search ends with the first results
+    bool mSearchResetStarted;
+    NodeSelectorModelItemSearch::Types mLoadedTypes;
 };
 
 #endif // NODESELECTORMODELSPECIALISED_H
@@ -2,6 +2,8 @@
 
 #include "MultiQFileDialog.h"
 #include "DialogOpener.h"
+#include "CoalescingShellNotifier.h"
+#include "Preferences.h"
 
 #include <QScreen>
 #include <QDesktopWidget>
@@ -279,6 +281,14 @@ std::shared_ptr<AbstractShellNotifier> AbstractPlatform::getShellNotifier()
     return mShellNotifier;
 }
 
+void AbstractPlatform::updateShellNotificationLimits()
+{
+    if (auto notifier = std::dynamic_pointer_cast<CoalescingShellNotifier>(mShellNotifier))
+    {
+        notifier->setRateLimits(Preferences::SHELL_NOTIFICATIONS_WINDOW_MS, Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND);
+    }
+}
+
 QString AbstractPlatform::rectToString(const QRect &rect)
 {
     return QString::fromUtf8("[%1,%2,%3,%4]").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
@@ -90,6 +90,8 @@ public:
     virtual void processSymLinks() = 0;
 
     std::shared_ptr<AbstractShellNotifier> getShellNotifier();
+    // The notifiers are created before the preferences can be overridden, so they take the new limits here
+    virtual void updateShellNotificationLimits();
     virtual DriveSpaceData getDriveData(const QString& path) = 0;
 
 protected:
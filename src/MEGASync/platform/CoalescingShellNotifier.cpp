@@ -0,0 +1,329 @@
+#include "CoalescingShellNotifier.h"
+#include "megaapi.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+const int CoalescingShellNotifier::FLUSH_INTERVAL_MS = 25;
+const std::uint64_t CoalescingShellNotifier::REPORT_INTERVAL_NOTIFICATIONS = 1000;
+
+CoalescingShellNotifier::CoalescingShellNotifier(std::shared_ptr<AbstractShellNotifier> baseNotifier,
+                                                 const Options& options)
+    : ShellNotifierDecorator(baseNotifier)
+    , mOptions(options)
+    , mFlushRequested(false)
+    , mBudget(0.0)
+    , mLastRefill(0)
+    , mLastReportedReceived(0)
+{
+    mClock.start();
+    mFlushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&mFlushTimer, &QTimer::timeout, this, [this]()
+    {
+        flush();
+    });
+
+    // The base notifier can process the paths in other threads
+    if (mOptions.baseReportsProcessed)
+    {
+        connect(mBaseNotifier.get(), &AbstractShellNotifier::shellNotificationProcessed, this, [this]()
+        {
+            onBaseNotificationProcessed();
+        }, Qt::DirectConnection);
+    }
+}
+
+void CoalescingShellNotifier::notify(const QString& path)
+{
+    bool isDropped(false);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.received++;
+
+        auto pendingPath(mPendingPaths.find(path));
+        auto parentPath(mOptions.maxPendingChildren > 0 ? getParentPath(path) : QString());
+        auto pendingParent(parentPath.isEmpty() ? mPendingPaths.end() : mPendingPaths.find(parentPath));
+        if (pendingPath != mPendingPaths.end())
+        {
+            pendingPath->notifications++;
+            mStats.deduplicated++;
+        }
+        else if (pendingParent != mPendingPaths.end() && pendingParent->isCollapsed)
+        {
+            // The parent refreshes it too
+            pendingParent->notifications++;
+            mStats.collapsed++;
+        }
+        else if (mPendingPaths.size() >= mOptions.maxPendingPaths)
+        {
+            // A folder notified in its place refreshes it, and the extensions forget the states inside a sync root
+            auto fallbackPath(getFallbackPath(path));
+            auto pendingFallback(fallbackPath.isEmpty() ? mPendingPaths.end() : mPendingPaths.find(fallbackPath));
+            if (pendingFallback != mPendingPaths.end())
+            {
+                pendingFallback->notifications++;
+                pendingFallback->isCollapsed = true;
+                mStats.collapsed++;
+            }
+            else if (!fallbackPath.isEmpty())
+            {
+                // Beyond the limit, but there are only a few root paths
+                auto now(mClock.elapsed());
+                mPendingPaths.insert(fallbackPath, PendingPath{now + mOptions.windowMs, 1, true});
+                mOrder.emplace_back(fallbackPath, now + mOptions.windowMs);
+                mStats.collapsed++;
+            }
+            else
+            {
+                mStats.dropped++;
+                isDropped = true;
+            }
+        }
+        else
+        {
+            auto now(mClock.elapsed());
+            mPendingPaths.insert(path, PendingPath{now + mOptions.windowMs, 1, false});
+            mOrder.emplace_back(path, now + mOptions.windowMs);
+
+            if (!parentPath.isEmpty())
+            {
+                auto& children(mPendingChildren[parentPath]);
+                children.insert(path);
+                if (children.size() > mOptions.maxPendingChildren)
+                {
+                    collapseChildren(parentPath, now);
+                }
+            }
+        }
+
+        mStats.queueDepth = mPendingPaths.size();
+        mStats.maxQueueDepth = std::max(mStats.maxQueueDepth, mStats.queueDepth);
+    }
+
+    if (isDropped)
+    {
+        emit shellNotificationProcessed();
+    }
+    else
+    {
+        requestFlush();
+    }
+}
+
+CoalescingShellNotifier::Stats CoalescingShellNotifier::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void CoalescingShellNotifier::collapseChildren(const QString& folder, qint64 now)
+{
+    // mutex already locked
+
+    int notifications(0);
+    const auto children(mPendingChildren.take(folder));
+    for (const auto& child : children)
+    {
+        auto pendingChild(mPendingPaths.find(child));
+        if (pendingChild != mPendingPaths.end())
+        {
+            notifications += pendingChild->notifications;
+            mPendingPaths.erase(pendingChild);
+            mStats.collapsed++;
+        }
+    }
+
+    auto pendingFolder(mPendingPaths.find(folder));
+    if (pendingFolder != mPendingPaths.end())
+    {
+        pendingFolder->notifications += notifications;
+        pendingFolder->isCollapsed = true;
+    }
+    else
+    {
+        // Counted as one of the collapsed notifications
+        mStats.collapsed--;
+        mPendingPaths.insert(folder, PendingPath{now + mOptions.windowMs, notifications, true});
+        mOrder.emplace_back(folder, now + mOptions.windowMs);
+    }
+}
+
+QString CoalescingShellNotifier::getFallbackPath(const QString& path) const
+{
+    // mutex already locked
+
+    // Only the base notifiers that refresh the subfolders replace the children by the folder
+    if (mOptions.maxPendingChildren > 0)
+    {
+        for (auto ancestor(getParentPath(path)); !ancestor.isEmpty(); ancestor = getParentPath(ancestor))
+        {
+            if (mPendingPaths.contains(ancestor))
+            {
+                return ancestor;
+            }
+        }
+    }
+
+    return mOptions.getRootPath ? mOptions.getRootPath(path) : QString();
+}
+
+void CoalescingShellNotifier::requestFlush()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFlushRequested)
+        {
+            return;
+        }
+        mFlushRequested = true;
+    }
+
+    if (QThread::currentThread() == thread())
+    {
+        mFlushTimer.start();
+    }
+    else
+    {
+        QMetaObject::invokeMethod(this, [this]()
+        {
+            mFlushTimer.start();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void CoalescingShellNotifier::setRateLimits(int windowMs, int maxNotificationsPerSecond)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOptions.windowMs = windowMs;
+    mOptions.maxNotificationsPerSecond = maxNotificationsPerSecond;
+}
+
+void CoalescingShellNotifier::flush()
+{
+    QList<QPair<QString, int>> readyPaths;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto now(mClock.elapsed());
+
+        // Token bucket holding up to one second of notifications
+        auto isLimited(mOptions.maxNotificationsPerSecond > 0);
+        if (isLimited)
+        {
+            mBudget = std::min<double>(mOptions.maxNotificationsPerSecond,
+                                       mBudget + (now - mLastRefill) * mOptions.maxNotificationsPerSecond / 1000.0);
+            mLastRefill = now;
+        }
+
+        while (!mOrder.empty())
+        {
+            const auto& next(mOrder.front());
+            auto pendingPath(mPendingPaths.find(next.first));
+            if (pendingPath == mPendingPaths.end() || pendingPath->readyTime != next.second)
+            {
+                mOrder.pop_front();
+                continue;
+            }
+
+            if (pendingPath->readyTime > now || (isLimited && mBudget < 1.0))
+            {
+                break;
+            }
+
+            if (isLimited)
+            {
+                mBudget -= 1.0;
+            }
+            readyPaths.append(qMakePair(next.first, pendingPath->notifications));
+
+            if (mOptions.maxPendingChildren > 0)
+            {
+                auto siblings(mPendingChildren.find(getParentPath(next.first)));
+                if (siblings != mPendingChildren.end())
+                {
+                    siblings->remove(next.first);
+                    if (siblings->isEmpty())
+                    {
+                        mPendingChildren.erase(siblings);
+                    }
+                }
+            }
+            mPendingPaths.erase(pendingPath);
+            mOrder.pop_front();
+        }
+
+        mStats.notified += readyPaths.size();
+        mStats.queueDepth = mPendingPaths.size();
+        if (mOptions.baseReportsProcessed)
+        {
+            for (const auto& readyPath : qAsConst(readyPaths))
+            {
+                mSentNotifications.push_back(readyPath.second);
+            }
+        }
+
+        if (mPendingPaths.isEmpty())
+        {
+            mOrder.clear();
+            mFlushTimer.stop();
+            mFlushRequested = false;
+            checkReportStats();
+        }
+    }
+
+    for (const auto& readyPath : qAsConst(readyPaths))
+    {
+        mBaseNotifier->notify(readyPath.first);
+
+        if (!mOptions.baseReportsProcessed)
+        {
+            for (int i = 0; i < readyPath.second; ++i)
+            {
+                emit shellNotificationProcessed();
+            }
+        }
+    }
+}
+
+void CoalescingShellNotifier::onBaseNotificationProcessed()
+{
+    int notifications(0);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mSentNotifications.empty())
+        {
+            notifications = mSentNotifications.front();
+            mSentNotifications.pop_front();
+        }
+    }
+
+    for (int i = 0; i < notifications; ++i)
+    {
+        emit shellNotificationProcessed();
+    }
+}
+
+void CoalescingShellNotifier::checkReportStats()
+{
+    // mutex already locked
+
+    if (mStats.received - mLastReportedReceived < REPORT_INTERVAL_NOTIFICATIONS)
+    {
+        return;
+    }
+    mLastReportedReceived = mStats.received;
+
+    ::mega::MegaApi::log(::mega::MegaApi::LOG_LEVEL_INFO,
+                         ("Shell notifications received: " + std::to_string(mStats.received)
+                          + " sent: " + std::to_string(mStats.notified)
+                          + " deduplicated: " + std::to_string(mStats.deduplicated)
+                          + " collapsed: " + std::to_string(mStats.collapsed)
+                          + " dropped: " + std::to_string(mStats.dropped)
+                          + " max queue size: " + std::to_string(mStats.maxQueueDepth)).c_str());
+}
+
+QString CoalescingShellNotifier::getParentPath(const QString& path)
+{
+    auto separator(std::max(path.lastIndexOf(QLatin1Char('/')), path.lastIndexOf(QLatin1Char('\\'))));
+    return separator > 0 ? path.left(separator) : QString();
+}
@@ -0,0 +1,105 @@
+#ifndef COALESCINGSHELLNOTIFIER_H
+#define COALESCINGSHELLNOTIFIER_H
+
+#include "ShellNotifier.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief Delays the notifications for a time window, so the notifications of the same path
+ * in the window are sent to baseNotifier only once, and limits the notifications sent per second.
+ *
+ * When baseNotifier refreshes the children of a folder, the pending children of a folder can be
+ * replaced by one notification of the folder. The paths are sent from the thread of this object,
+ * and shellNotificationProcessed is emitted once per notify() call.
+ */
+class CoalescingShellNotifier : public ShellNotifierDecorator
+{
+public:
+    struct Options
+    {
+        int windowMs = 200;
+        // No limit when <= 0
+        int maxNotificationsPerSecond = 0;
+        // Pending children of a folder replaced by the folder. Never when <= 0
+        int maxPendingChildren = 0;
+        // The notifications beyond it are sent as a pending ancestor (when the children are collapsed)
+        // or as their root path, and dropped when there is none
+        int maxPendingPaths = 100000;
+        // Root path of a path (i.e. its sync folder), empty if there is none
+        std::function<QString(const QString&)> getRootPath;
+        // When baseNotifier never emits shellNotificationProcessed, it is emitted once the paths are sent to it
+        bool baseReportsProcessed = true;
+    };
+
+    struct Stats
+    {
+        std::uint64_t received = 0;
+        std::uint64_t notified = 0;
+        std::uint64_t deduplicated = 0;
+        std::uint64_t collapsed = 0;
+        std::uint64_t dropped = 0;
+        int queueDepth = 0;
+        int maxQueueDepth = 0;
+    };
+
+    CoalescingShellNotifier(std::shared_ptr<AbstractShellNotifier> baseNotifier, const Options& options);
+    virtual ~CoalescingShellNotifier() = default;
+
+    void notify(const QString& path) override;
+
+    // Replaces the windowMs and maxNotificationsPerSecond of the options, for the next notifications
+    void setRateLimits(int windowMs, int maxNotificationsPerSecond);
+
+    Stats getStats() const;
+
+private:
+    struct PendingPath
+    {
+        qint64 readyTime;
+        // notify() calls merged in this path
+        int notifications;
+        bool isCollapsed;
+    };
+
+    void collapseChildren(const QString& folder, qint64 now);
+    QString getFallbackPath(const QString& path) const;
+    void requestFlush();
+    void flush();
+    void onBaseNotificationProcessed();
+    void checkReportStats();
+
+    static QString getParentPath(const QString& path);
+
+    static const int FLUSH_INTERVAL_MS;
+    static const std::uint64_t REPORT_INTERVAL_NOTIFICATIONS;
+
+    Options mOptions;
+    QTimer mFlushTimer;
+    QElapsedTimer mClock;
+
+    mutable std::mutex mMutex;
+    // Arrival order, with the ready time to skip the paths collapsed or sent since then
+    std::deque<QPair<QString, qint64>> mOrder;
+    QHash<QString, PendingPath> mPendingPaths;
+    QHash<QString, QSet<QString>> mPendingChildren;
+    // notify() calls merged in each path sent to baseNotifier and not processed yet
+    std::deque<int> mSentNotifications;
+    bool mFlushRequested;
+    double mBudget;
+    qint64 mLastRefill;
+    Stats mStats;
+    std::uint64_t mLastReportedReceived;
+};
+
+#endif // COALESCINGSHELLNOTIFIER_H
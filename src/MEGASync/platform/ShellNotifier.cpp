@@ -14,3 +14,14 @@ void SignalShellNotifier::notify(const QString &path)
 {
     emit shellNotificationProcessed();
 }
+
+FunctionShellNotifier::FunctionShellNotifier(std::function<void(const QString&)> function)
+    : mFunction(function)
+{
+}
+
+void FunctionShellNotifier::notify(const QString& path)
+{
+    mFunction(path);
+    emit shellNotificationProcessed();
+}
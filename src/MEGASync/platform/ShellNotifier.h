@@ -1,6 +1,7 @@
 #ifndef SHELLNOTIFIER_H
 #define SHELLNOTIFIER_H
 
+#include <functional>
 #include <memory>
 #include <QObject>
 
@@ -35,4 +36,16 @@ public:
     void notify(const QString& path) override;
 };
 
+class FunctionShellNotifier : public AbstractShellNotifier
+{
+public:
+    FunctionShellNotifier(std::function<void(const QString&)> function);
+    virtual ~FunctionShellNotifier() = default;
+
+    void notify(const QString& path) override;
+
+private:
+    std::function<void(const QString&)> mFunction;
+};
+
 #endif // SHELLNOTIFIER_H
@@ -4,13 +4,18 @@
 #include <pwd.h>
 #include <unistd.h>
 #include "CommonMessages.h"
+#include "ThreadPool.h"
 #include "Utilities.h"
 
+#include <algorithm>
+
 using namespace mega;
 using namespace std;
 
 constexpr char ASCII_FILE_SEP = 0x1C;
 constexpr int  BUFSIZE = 1024;
+constexpr char OP_BATCH_PATH_STATE = 'B';
+constexpr int  MAX_PENDING_REQUEST_SIZE = 16 * 1024 * 1024;
 constexpr char RESPONSE_SYNCED[]  = "0";
 constexpr char RESPONSE_PENDING[] = "1";
 constexpr char RESPONSE_SYNCING[] = "2";
@@ -19,7 +24,7 @@ constexpr char RESPONSE_PAUSED[]  = "4";
 constexpr char RESPONSE_DEFAULT[] = "9";
 constexpr char RESPONSE_ERROR[]   = "10";
 
-ExtServer::ExtServer(MegaApplication *app): QObject(),
+ExtServer::ExtServer(MegaApplication *app, const QString& socketName): QObject(),
     m_localServer(0)
 {
     connect(this, SIGNAL(newUploadQueue(QQueue<QString>)), app, SLOT(shellUpload(QQueue<QString>)),Qt::QueuedConnection);
@@ -28,7 +33,7 @@ ExtServer::ExtServer(MegaApplication *app): QObject(),
 
 
     // construct local socket path
-    sockPath = MegaApplication::applicationDataPath() + QDir::separator() + QString::fromLatin1("mega.socket");
+    sockPath = MegaApplication::applicationDataPath() + QDir::separator() + socketName;
 
     //LOG_info << "Starting Ext server";
 
@@ -49,6 +54,8 @@ ExtServer::ExtServer(MegaApplication *app): QObject(),
 
 ExtServer::~ExtServer()
 {
+    mBatchRequestsToken.cancel();
+
     for (auto client : m_clients)
     {
         client->deleteLater();
@@ -83,6 +90,8 @@ void ExtServer::onClientDisconnected()
     if (!client)
         return;
     m_clients.removeAll(client);
+    mPendingRequests.remove(client);
+    mBusyClients.remove(client);
     client->deleteLater();
 
     //LOG_debug << "Client disconnected";
@@ -100,13 +109,47 @@ void ExtServer::onClientData()
         return;
     }
 
+    QByteArray& pending = mPendingRequests[client];
+    pending.append(client->readAll());
+    if (pending.size() > MAX_PENDING_REQUEST_SIZE)
+    {
+        //LOG_err << "Request too large";
+        mPendingRequests.remove(client);
+        mBusyClients.remove(client);
+        client->abort();
+        return;
+    }
+
+    processPendingRequests(client);
+}
+
+void ExtServer::processPendingRequests(QLocalSocket *client)
+{
     static thread_local char buf[BUFSIZE] = {'\0'};
-    qint64 count;
-    do
+    QByteArray& pending = mPendingRequests[client];
+    // The requests that come after a batched one wait for its answer, so the answers keep their order
+    while (!pending.isEmpty() && !mBusyClients.contains(client))
     {
-        count = client->readLine(buf, sizeof(buf));
-        if (count > 0)
+        int requestEnd = pending.indexOf('\n');
+        if (pending.at(0) == OP_BATCH_PATH_STATE)
         {
+            // Batched requests may not fit in a single read, they are answered once the whole line is received
+            if (requestEnd < 0)
+            {
+                break;
+            }
+
+            answerBatchRequest(client, pending.mid(2, std::max(requestEnd - 2, 0)));
+            pending.remove(0, requestEnd + 1);
+        }
+        else
+        {
+            // The rest of the requests are not always newline terminated: each read is a request,
+            // as long as it fits in the buffer
+            int count = std::min(requestEnd >= 0 ? requestEnd + 1 : pending.size(), BUFSIZE - 1);
+            std::copy_n(pending.constData(), count, buf);
+            pending.remove(0, count);
+
             const char *out = GetAnswerToRequest(buf);
             if (out) {
                 client->write(out);
@@ -114,7 +157,7 @@ void ExtServer::onClientData()
             }
             std::fill_n(buf, count, '\0');
         }
-    } while (count > 0);
+    }
 }
 
 // parse incoming request and send response back to client
@@ -183,7 +226,6 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
         // get the state of an object
         case 'P':
         {
-            int state = MegaApi::STATE_NONE;
             string scontent(content);
 
             // ASCII_FILE_SEP is used to separate the file name and an optional '1' or '0'
@@ -193,71 +235,18 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
             bool forceGetState = possep != string::npos
                                  && (possep + 1) < scontent.size()
                                  && scontent.at(possep + 1) == '1';
+            bool overlayIconsDisabled = Preferences::instance()->overlayIconsDisabled();
 
-            if (forceGetState || !Preferences::instance()->overlayIconsDisabled())
+            if (possep != string::npos)
             {
-                if (possep != string::npos)
-                {
-                    scontent.resize(possep);
-                }
-                if (!scontent.empty())
-                {
-                    state = MegaSyncApp->getMegaApi()->syncPathState(&scontent);
-                    mLastPath = scontent;
-                }
+                scontent.resize(possep);
             }
-
-            const char* syncStatus = RESPONSE_DEFAULT;
-            switch(state)
+            if (!scontent.empty() && (forceGetState || !overlayIconsDisabled))
             {
-                case MegaApi::STATE_SYNCED:
-                    syncStatus = RESPONSE_SYNCED;
-                    break;
-                case MegaApi::STATE_SYNCING:
-                    syncStatus = RESPONSE_SYNCING;
-                    break;
-                case MegaApi::STATE_PENDING:
-                    syncStatus = RESPONSE_PENDING;
-                    break;
-                case MegaApi::STATE_IGNORED:
-                {
-                    int runState = MegaSync::SyncRunningState::RUNSTATE_DISABLED;
-                    auto megaSync = MegaSyncApp->getMegaApi()->getSyncByPath(scontent.c_str());
-                    if (megaSync != nullptr)
-                    {
-                        runState = megaSync->getRunState();
-                    }
-
-                    if (runState == MegaSync::SyncRunningState::RUNSTATE_PAUSED ||
-                        runState == MegaSync::SyncRunningState::RUNSTATE_SUSPENDED)
-                    {
-                        syncStatus = RESPONSE_PAUSED;
-                    }
-                    else
-                    {
-                        syncStatus = RESPONSE_IGNORED;
-                    }
-                    break;
-                }
-                case MegaApi::STATE_NONE:                
-                default:
-                {
-                    // This case is when the extension wants to display overlays.
-                    // RESPONSE_ERROR will make it display no overlay and keep the folder icon.
-                    // We don't want to send RESPONSE_ERROR when forceGetState is true
-                    // to avoid breaking contextual menu.
-                    if (!forceGetState && Preferences::instance()->overlayIconsDisabled())
-                    {
-                        syncStatus = RESPONSE_ERROR;
-                    }
-                    else
-                    {
-                        syncStatus = RESPONSE_DEFAULT;
-                    }
-                }
+                mLastPath = scontent;
             }
 
-            strncpy(out, syncStatus, BUFSIZE);
+            strncpy(out, getPathStateResponse(scontent, forceGetState, overlayIconsDisabled), BUFSIZE);
             break;
         }
         case 'E':
@@ -288,6 +277,136 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
     return out;
 }
 
+// the states of a whole folder are asked to the SDK in a worker, so the GUI thread is not blocked by the big folders
+void ExtServer::answerBatchRequest(QLocalSocket *client, const QByteArray &request)
+{
+    mBusyClients.insert(client);
+
+    QPointer<ExtServer> server(this);
+    QPointer<QLocalSocket> safeClient(client);
+    // The preferences are checked once for the whole batch, in this thread
+    const bool overlayIconsDisabled = Preferences::instance()->overlayIconsDisabled();
+    ThreadPoolSingleton::getInstance()->push([server, safeClient, request, overlayIconsDisabled]()
+    {
+        if (!server)
+        {
+            return;
+        }
+
+        std::string out = server->GetAnswerToBatchRequest(request.constData(), request.size(), overlayIconsDisabled);
+        Utilities::queueFunctionInAppThread([server, safeClient, out]()
+        {
+            if (server && safeClient && server->mBusyClients.remove(safeClient))
+            {
+                safeClient->write(out.data(), static_cast<qint64>(out.size()));
+                safeClient->write("\n");
+                server->processPendingRequests(safeClient);
+            }
+        });
+    }, ThreadPool::Lane::INTERACTIVE, mBatchRequestsToken);
+}
+
+// parse a batched path state request: "<0|1>ASCII_FILE_SEP<folder>ASCII_FILE_SEP<name>ASCII_FILE_SEP<name>..."
+// and return the states of the names in the same order, separated by commas.
+// The first field is the same force-get flag of the 'P' requests
+std::string ExtServer::GetAnswerToBatchRequest(const char *content, int size, bool overlayIconsDisabled)
+{
+    std::string out;
+    if (size < 2 || content[1] != ASCII_FILE_SEP)
+    {
+        return out;
+    }
+
+    const bool forceGetState = content[0] == '1';
+    const char *end = content + size;
+    const char *folderStart = content + 2;
+    const char *nameStart = std::find(folderStart, end, ASCII_FILE_SEP);
+    string path(folderStart, nameStart);
+    if (path.empty() || path.back() != '/')
+    {
+        path.push_back('/');
+    }
+    const size_t folderSize = path.size();
+
+    out.reserve(static_cast<size_t>(std::count(nameStart, end, ASCII_FILE_SEP)) * 2);
+
+    while (nameStart != end)
+    {
+        if (ThreadPool::isThreadInterrupted())
+        {
+            return std::string();
+        }
+
+        ++nameStart;
+        const char *nameEnd = std::find(nameStart, end, ASCII_FILE_SEP);
+
+        path.resize(folderSize);
+        path.append(nameStart, nameEnd);
+
+        if (!out.empty())
+        {
+            out.push_back(',');
+        }
+        out.append(getPathStateResponse(path, forceGetState, overlayIconsDisabled));
+        nameStart = nameEnd;
+    }
+
+    return out;
+}
+
+const char *ExtServer::getPathStateResponse(std::string &path, bool forceGetState, bool overlayIconsDisabled)
+{
+    int state = MegaApi::STATE_NONE;
+    if (!path.empty() && (forceGetState || !overlayIconsDisabled))
+    {
+        state = getSyncPathState(path);
+    }
+
+    switch(state)
+    {
+        case MegaApi::STATE_SYNCED:
+            return RESPONSE_SYNCED;
+        case MegaApi::STATE_SYNCING:
+            return RESPONSE_SYNCING;
+        case MegaApi::STATE_PENDING:
+            return RESPONSE_PENDING;
+        case MegaApi::STATE_IGNORED:
+        {
+            int runState = MegaSync::SyncRunningState::RUNSTATE_DISABLED;
+            std::unique_ptr<MegaSync> megaSync(MegaSyncApp->getMegaApi()->getSyncByPath(path.c_str()));
+            if (megaSync != nullptr)
+            {
+                runState = megaSync->getRunState();
+            }
+
+            if (runState == MegaSync::SyncRunningState::RUNSTATE_PAUSED ||
+                runState == MegaSync::SyncRunningState::RUNSTATE_SUSPENDED)
+            {
+                return RESPONSE_PAUSED;
+            }
+            return RESPONSE_IGNORED;
+        }
+        case MegaApi::STATE_NONE:
+        default:
+        {
+            // This case is when the extension wants to display overlays.
+            // RESPONSE_ERROR will make it display no overlay and keep the folder icon.
+            // We don't want to send RESPONSE_ERROR when forceGetState is true
+            // to avoid breaking contextual menu.
+            if (!forceGetState && overlayIconsDisabled)
+            {
+                return RESPONSE_ERROR;
+            }
+            return RESPONSE_DEFAULT;
+        }
+    }
+}
+
+int ExtServer::getSyncPathState(std::string &path)
+{
+    return MegaSyncApp->getMegaApi()->syncPathState(&path);
+}
+
 QString ExtServer::getActionName(const int actionId)
 {
     QString name(QString::fromLatin1(RESPONSE_DEFAULT));
@@ -2,8 +2,11 @@
 #define EXTSERVER_H
 
 #include "MegaApplication.h"
+#include "ThreadPool.h"
 #include "megaapi.h"
 
+#include <QSet>
+
 typedef enum {
    STRING_UPLOAD = 0,
    STRING_GETLINK = 1,
@@ -18,7 +21,7 @@ class ExtServer: public QObject
     Q_OBJECT
 
  public:
-    ExtServer(MegaApplication *app);
+    ExtServer(MegaApplication *app, const QString& socketName = QString::fromLatin1("mega.socket"));
     virtual ~ExtServer();
 
  protected:
@@ -26,6 +29,8 @@ class ExtServer: public QObject
     QQueue<QString> uploadQueue;
     QQueue<QString> exportQueue;
 
+    virtual int getSyncPathState(std::string &path);
+
  public Q_SLOTS:
     void acceptConnection();
     void onClientData();
@@ -33,9 +38,18 @@ class ExtServer: public QObject
  private:
     QString sockPath;
     QList<QLocalSocket *> m_clients;
+    // Data received from each client which is not a complete request yet
+    QHash<QLocalSocket *, QByteArray> mPendingRequests;
+    // Clients waiting for the answer of a batched request
+    QSet<QLocalSocket *> mBusyClients;
+    ThreadPool::CancellationToken mBatchRequestsToken;
     std::string mLastPath;
 
     const char *GetAnswerToRequest(const char *buf);
+    void processPendingRequests(QLocalSocket *client);
+    void answerBatchRequest(QLocalSocket *client, const QByteArray &request);
+    std::string GetAnswerToBatchRequest(const char *content, int size, bool overlayIconsDisabled);
+    const char *getPathStateResponse(std::string &path, bool forceGetState, bool overlayIconsDisabled);
     QString getActionName(const int actionId);
 
     void addToQueue(QQueue<QString>& queue, const char* content);
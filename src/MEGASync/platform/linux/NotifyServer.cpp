@@ -53,21 +53,15 @@ void NotifyServer::acceptConnection()
         connect(client, SIGNAL(disconnected()), this, SLOT(onClientDisconnected()));
 
         // send the list of current synced folders to the new client
-        int localFolders = 0;
-        SyncInfo *model = SyncInfo::instance();
-        for (auto syncSetting : model->getAllSyncSettings())
+        const QStringList syncPaths = activeSyncPaths();
+        for (const auto& syncPath : syncPaths)
         {
-            QString c = QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
-            if (!c.isEmpty() && syncSetting->isActive())
-            {
-                localFolders++;
-                client->write("A");
-                client->write(c.toUtf8().constData());
-                client->write("\n");
-            }
+            client->write("A");
+            client->write(syncPath.toUtf8().constData());
+            client->write("\n");
         }
 
-        if (!localFolders)
+        if (syncPaths.isEmpty())
         {
             // send an empty sync
             client->write("A");
@@ -118,3 +112,34 @@ void NotifyServer::notifySyncDel(QString path)
     emit sendToAll("D", path.toUtf8());
 }
 
+// the extensions forget what they know about the syncs, the states of their items too
+void NotifyServer::notifyAllSyncsDel()
+{
+    for (const auto& syncPath : activeSyncPaths())
+    {
+        notifySyncDel(syncPath);
+    }
+}
+
+void NotifyServer::notifyAllSyncsAdd()
+{
+    for (const auto& syncPath : activeSyncPaths())
+    {
+        notifySyncAdd(syncPath);
+    }
+}
+
+QStringList NotifyServer::activeSyncPaths() const
+{
+    QStringList syncPaths;
+    SyncInfo *model = SyncInfo::instance();
+    for (auto syncSetting : model->getAllSyncSettings())
+    {
+        QString c = QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
+        if (!c.isEmpty() && syncSetting->isActive())
+        {
+            syncPaths.append(c);
+        }
+    }
+    return syncPaths;
+}
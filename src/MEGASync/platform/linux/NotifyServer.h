@@ -14,6 +14,8 @@ class NotifyServer: public QObject
     void notifyItemChange(std::string *localPath);
     void notifySyncAdd(QString path);
     void notifySyncDel(QString path);
+    void notifyAllSyncsAdd();
+    void notifyAllSyncsDel();
 
  protected:
     QLocalServer *m_localServer;
@@ -28,6 +30,8 @@ class NotifyServer: public QObject
     QString sockPath;
     QList<QLocalSocket *> m_clients;
 
+    QStringList activeSyncPaths() const;
+
 signals:
     void sendToAll(const char *type, QByteArray str);
 
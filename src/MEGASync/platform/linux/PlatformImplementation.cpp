@@ -11,9 +11,11 @@
 #include <map>
 #include <sys/statvfs.h>
 
+#include "platform/CoalescingShellNotifier.h"
 #include "DolphinFileManager.h"
 #include "NautilusFileManager.h"
 #include "QMegaMessageBox.h"
+#include "syncs/control/SyncInfo.h"
 
 using namespace std;
 using namespace mega;
@@ -31,18 +33,32 @@ PlatformImplementation::PlatformImplementation()
 
 void PlatformImplementation::initialize(int /*argc*/, char** /*argv*/)
 {
-    mShellNotifier = std::make_shared<SignalShellNotifier>();
-}
+    // The file managers refresh only the notified path, so the children are not collapsed
+    CoalescingShellNotifier::Options options;
+    options.windowMs = Preferences::SHELL_NOTIFICATIONS_WINDOW_MS;
+    options.maxNotificationsPerSecond = Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND;
+    // The extensions forget the cached states inside a notified sync folder, as they do when it is added
+    options.getRootPath = [](const QString& path)
+    {
+        QString localFolder(SyncInfo::instance()->getLocalFolderContaining(path));
+        return localFolder.isEmpty() ? localFolder : QDir::toNativeSeparators(QDir(localFolder).canonicalPath());
+    };
 
-void PlatformImplementation::notifyItemChange(const QString& path, int)
-{
-    if (!path.isEmpty())
+    auto baseNotifier = std::make_shared<FunctionShellNotifier>([this](const QString& path)
     {
         if (notify_server && !Preferences::instance()->overlayIconsDisabled())
         {
             std::string stdPath = path.toStdString();
             notify_server->notifyItemChange(&stdPath);
         }
+    });
+    mShellNotifier = std::make_shared<CoalescingShellNotifier>(baseNotifier, options);
+}
+
+void PlatformImplementation::notifyItemChange(const QString& path, int)
+{
+    if (!path.isEmpty())
+    {
         mShellNotifier->notify(path);
     }
 }
@@ -199,17 +215,24 @@ void PlatformImplementation::syncFolderRemoved(QString syncPath, QString /*syncN
 
 void PlatformImplementation::notifyRestartSyncFolders()
 {
-
+    notifyAllSyncFoldersRemoved();
+    notifyAllSyncFoldersAdded();
 }
 
 void PlatformImplementation::notifyAllSyncFoldersAdded()
 {
-
+    if (notify_server)
+    {
+        notify_server->notifyAllSyncsAdd();
+    }
 }
 
 void PlatformImplementation::notifyAllSyncFoldersRemoved()
 {
-
+    if (notify_server)
+    {
+        notify_server->notifyAllSyncsDel();
+    }
 }
 
 void PlatformImplementation::processSymLinks()
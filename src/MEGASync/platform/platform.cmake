@@ -2,6 +2,7 @@ set(DESKTOP_APP_PLATFORM_HEADERS
     platform/Platform.h
     platform/AbstractPlatform.h
     platform/ShellNotifier.h
+    platform/CoalescingShellNotifier.h
     platform/PowerOptions.h
     platform/PlatformStrings.h
 )
@@ -10,6 +11,7 @@ set(DESKTOP_APP_PLATFORM_SOURCES
     platform/AbstractPlatform.cpp
     platform/Platform.cpp
     platform/ShellNotifier.cpp
+    platform/CoalescingShellNotifier.cpp
 )
 
 target_sources_conditional(MEGAsync
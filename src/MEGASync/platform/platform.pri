@@ -3,11 +3,13 @@ INCLUDEPATH += $$PWD
 
 SOURCES += $$PWD/AbstractPlatform.cpp \
     $$PWD/Platform.cpp \
-    $$PWD/ShellNotifier.cpp
+    $$PWD/ShellNotifier.cpp \
+    $$PWD/CoalescingShellNotifier.cpp
 
 HEADERS +=  $$PWD/Platform.h \
             $$PWD/AbstractPlatform.h \
             $$PWD/ShellNotifier.h \
+            $$PWD/CoalescingShellNotifier.h \
             $$PWD/PowerOptions.h \
             $$PWD/PlatformStrings.h
 
@@ -3,6 +3,7 @@
 #include <platform/win/WinAPIShell.h>
 #include <platform/win/RecursiveShellNotifier.h>
 #include <platform/win/ThreadedQueueShellNotifier.h>
+#include <platform/CoalescingShellNotifier.h>
 
 #include <QtPlatformHeaders/QWindowsWindowFunctions>
 
@@ -81,11 +82,26 @@ static const QString NotAllowedDefaultFactoryBiosName = QString::fromUtf8("To be
 void PlatformImplementation::initialize(int, char *[])
 {
     CoInitializeEx(NULL, COINIT_MULTITHREADED);
+    CoalescingShellNotifier::Options options;
+    options.windowMs = Preferences::SHELL_NOTIFICATIONS_WINDOW_MS;
+    options.maxNotificationsPerSecond = Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND;
+    options.getRootPath = [](const QString& path)
+    {
+        return SyncInfo::instance()->getLocalFolderContaining(path);
+    };
+
+    // WindowsApiShellNotifier does not report the processed paths
     auto baseNotifier = std::make_shared<WindowsApiShellNotifier>();
-    mSyncFileNotifier = std::make_shared<ThreadedQueueShellNotifier>(baseNotifier);
-    mShellNotifier = std::make_shared<ThreadedQueueShellNotifier>(
-                std::make_shared<RecursiveShellNotifier>(baseNotifier)
-                );
+    options.baseReportsProcessed = false;
+    mSyncFileNotifier = std::make_shared<CoalescingShellNotifier>(
+                std::make_shared<ThreadedQueueShellNotifier>(baseNotifier), options);
+
+    // The recursive notifier refreshes the subfolders, so the pending children of a folder are replaced by the folder
+    options.baseReportsProcessed = true;
+    options.maxPendingChildren = 64;
+    mShellNotifier = std::make_shared<CoalescingShellNotifier>(
+                std::make_shared<ThreadedQueueShellNotifier>(std::make_shared<RecursiveShellNotifier>(baseNotifier)),
+                options);
 
     //In order to show dialogs when the application is inactive (for example, from the webclient)
     QWindowsWindowFunctions::setWindowActivationBehavior(QWindowsWindowFunctions::AlwaysActivateWindow);
@@ -209,6 +225,16 @@ void PlatformImplementation::notifyItemChange(const QString& path, int)
     notifyItemChange(path, mShellNotifier);
 }
 
+void PlatformImplementation::updateShellNotificationLimits()
+{
+    AbstractPlatform::updateShellNotificationLimits();
+
+    if (auto notifier = std::dynamic_pointer_cast<CoalescingShellNotifier>(mSyncFileNotifier))
+    {
+        notifier->setRateLimits(Preferences::SHELL_NOTIFICATIONS_WINDOW_MS, Preferences::MAX_SHELL_NOTIFICATIONS_PER_SECOND);
+    }
+}
+
 void PlatformImplementation::notifySyncFileChange(std::string *localPath, int)
 {
     QString path = QString::fromUtf8(localPath->c_str());
@@ -33,6 +33,7 @@ public:
     bool enableTrayIcon(QString executable) override;
     void notifyItemChange(const QString& localPath, int newState) override;
     void notifySyncFileChange(std::string *localPath, int newState) override;
+    void updateShellNotificationLimits() override;
     bool startOnStartup(bool value) override;
     bool isStartOnStartupActive() override;
     bool showInFolder(QString pathIn) override;
@@ -41,7 +41,8 @@ void StalledIssueBaseDelegateWidget::updateUi(const QModelIndex& index, const St
 {
     MegaSyncApp->getStalledIssuesModel()->UiItemUpdate(mCurrentIndex, index);
 
-    if(mCurrentIndex != index)
+    //The row can keep its index but get a new issue when the stall is received again
+    if(mCurrentIndex != index || mData.consultData() != issueData.consultData())
     {
         mCurrentIndex = QPersistentModelIndex(index);
         mData = issueData;
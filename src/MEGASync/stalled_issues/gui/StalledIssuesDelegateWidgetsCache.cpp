@@ -56,6 +56,7 @@ StalledIssueHeader *StalledIssuesDelegateWidgetsCache::getStalledIssueHeaderWidg
     bool isNew(!header);
     bool needsUpdate(isNew ||
                header->getCurrentIndex() != sourceIndex ||
+               header->getData().consultData() != issue.consultData() ||
                issue.consultData()->needsUIUpdate(StalledIssue::Type::Header));
 
     if(isNew)
@@ -107,7 +108,8 @@ StalledIssueBaseDelegateWidget *StalledIssuesDelegateWidgetsCache::getStalledIss
     auto& item = itemsByRowMap[row];
 
     bool isNew(!item ||
-               item->getCurrentIndex() != sourceIndex);
+               item->getCurrentIndex() != sourceIndex ||
+               item->getData().consultData() != issue.consultData());
 
     if(isNew)
     {
@@ -222,7 +222,6 @@ void StalledIssuesDialog::onUiUnblocked()
 
 void StalledIssuesDialog::onStalledIssuesLoaded()
 {
-    mDelegate->resetCache();
     mProxyModel->updateFilter();
 }
 
@@ -89,16 +89,8 @@ void LocalOrRemoteUserMustChooseStalledIssue::setIsSolved(SolveType type)
 
 bool LocalOrRemoteUserMustChooseStalledIssue::checkForExternalChanges()
 {
-    QString localCRC;
-    QString remoteCRC;
-
-    getLocalData()->getAttributes()->requestCRC(this, [&localCRC](const QString& crc){
-        localCRC = crc;
-    });
-
-    getCloudData()->getAttributes()->requestCRC(this, [&remoteCRC](const QString& crc){
-        remoteCRC = crc;
-    });
+    auto localCRC(getLocalData()->getAttributes()->calculateCRC());
+    auto remoteCRC(getCloudData()->getAttributes()->calculateCRC());
 
     if(localCRC.compare(mLocalCRCAtStart) != 0 || remoteCRC.compare(mRemoteCRCAtStart) != 0)
     {
@@ -134,13 +126,9 @@ void LocalOrRemoteUserMustChooseStalledIssue::endFillingIssue()
         getLocalData()->getAttributes()->requestModifiedTime(nullptr, nullptr);
         getCloudData()->getAttributes()->requestModifiedTime(nullptr, nullptr);
 
-        getLocalData()->getAttributes()->requestCRC(this, [this](const QString& crc){
-            mLocalCRCAtStart = crc;
-            });
-
-        getCloudData()->getAttributes()->requestCRC(this, [this](const QString& crc){
-            mRemoteCRCAtStart = crc;
-        });
+        //The issue is filled outside the GUI thread, so the CRCs are read here and checkForExternalChanges always has them
+        mLocalCRCAtStart = getLocalData()->getAttributes()->calculateCRC();
+        mRemoteCRCAtStart = getCloudData()->getAttributes()->calculateCRC();
     }
 }
 
@@ -194,7 +182,7 @@ bool LocalOrRemoteUserMustChooseStalledIssue::chooseRemoteSide()
     return utilities.removeLocalFile(consultLocalData()->getNativeFilePath(), syncId);
 }
 
-bool LocalOrRemoteUserMustChooseStalledIssue::chooseBothSides(QStringList* namesUsed)
+bool LocalOrRemoteUserMustChooseStalledIssue::chooseBothSides(UniqueNameIndexes* nameIndexes)
 {
     auto result(false);
     auto node(getCloudData()->getNode());
@@ -203,8 +191,10 @@ bool LocalOrRemoteUserMustChooseStalledIssue::chooseBothSides(QStringList* names
         std::unique_ptr<mega::MegaNode> parentNode(MegaSyncApp->getMegaApi()->getParentNode(node.get()));
         if(parentNode)
         {
-            mNewName = Utilities::getNonDuplicatedNodeName(node.get(), parentNode.get(), QString::fromUtf8(node->getName()), true, (*namesUsed));
-            namesUsed->append(mNewName);
+            //The local item is in the same folder
+            auto& nameIndex(nameIndexes->getIndex(parentNode->getHandle()));
+            mNewName = Utilities::getNonDuplicatedNodeName(node.get(), parentNode.get(), QString::fromUtf8(node->getName()), true, nameIndex);
+            nameIndex.addName(mNewName);
 
             auto error = MegaApiSynchronizedRequest::runRequest(&mega::MegaApi::renameNode,
                               MegaSyncApp->getMegaApi(),
@@ -221,7 +211,8 @@ bool LocalOrRemoteUserMustChooseStalledIssue::chooseBothSides(QStringList* names
                 QFile file(currentFile.filePath());
                 if(file.exists())
                 {
-                    mNewName = Utilities::getNonDuplicatedLocalName(currentFile, true, (*namesUsed));
+                    mNewName = Utilities::getNonDuplicatedLocalName(currentFile, true, nameIndex);
+                    nameIndex.addName(mNewName);
                     currentFile.setFile(currentFile.path(), mNewName);
                     if(file.rename(QDir::toNativeSeparators(currentFile.filePath())))
                     {
@@ -5,6 +5,7 @@
 #include <TransfersModel.h>
 
 class MegaUploader;
+class UniqueNameIndexes;
 
 class LocalOrRemoteUserMustChooseStalledIssue : public StalledIssue
 {
@@ -23,7 +24,7 @@ public:
     bool chooseLocalSide();
     bool chooseRemoteSide();
     bool chooseLastMTimeSide();
-    bool chooseBothSides(QStringList *namesUsed);
+    bool chooseBothSides(UniqueNameIndexes* nameIndexes);
 
     bool UIShowFileAttributes() const override;
 
@@ -232,6 +232,16 @@ bool NameConflictedStalledIssue::containsHandle(mega::MegaHandle handle)
     return false;
 }
 
+QList<mega::MegaHandle> NameConflictedStalledIssue::getHandles() const
+{
+    QList<mega::MegaHandle> handles;
+    foreach(auto& cloudConflictedName, mCloudConflictedNames.getConflictedNames())
+    {
+        handles.append(cloudConflictedName->mHandle);
+    }
+    return handles;
+}
+
 void NameConflictedStalledIssue::updateHandle(mega::MegaHandle handle)
 {
     if(mLastModifiedNode.isValid())
@@ -486,15 +496,16 @@ bool NameConflictedStalledIssue::renameNodesAutomatically()
     auto localConflictedNames(mLocalConflictedNames);
     sortLogic(localConflictedNames);
 
-    QStringList itemsBeingRenamed;
+    //Every conflicted name is in the same folder
+    UniqueNameIndex nameIndex;
 
     if(localConflictedNames.isEmpty())
     {
-        result = renameCloudNodesAutomatically(cloudConflictedNames, localConflictedNames, true, itemsBeingRenamed);
+        result = renameCloudNodesAutomatically(cloudConflictedNames, localConflictedNames, true, nameIndex);
     }
     else if(cloudConflictedNames.isEmpty())
     {
-        result = renameLocalItemsAutomatically(cloudConflictedNames, localConflictedNames, true, itemsBeingRenamed);
+        result = renameLocalItemsAutomatically(cloudConflictedNames, localConflictedNames, true, nameIndex);
     }
     else
     {
@@ -505,19 +516,19 @@ bool NameConflictedStalledIssue::renameNodesAutomatically()
             lastModifiedLocalName->mItemAttributes->modifiedTime())
         {
             if((result = renameCloudNodesAutomatically(
-                   cloudConflictedNames, localConflictedNames, true, itemsBeingRenamed)))
+                   cloudConflictedNames, localConflictedNames, true, nameIndex)))
             {
                 result = renameLocalItemsAutomatically(
-                    cloudConflictedNames, localConflictedNames, false, itemsBeingRenamed);
+                    cloudConflictedNames, localConflictedNames, false, nameIndex);
             }
         }
         else
         {
             if((result = renameLocalItemsAutomatically(
-                    cloudConflictedNames, localConflictedNames, true, itemsBeingRenamed)))
+                    cloudConflictedNames, localConflictedNames, true, nameIndex)))
             {
                 result = renameCloudNodesAutomatically(
-                    cloudConflictedNames, localConflictedNames, false, itemsBeingRenamed);
+                    cloudConflictedNames, localConflictedNames, false, nameIndex);
             }
         }
     }
@@ -528,7 +539,7 @@ bool NameConflictedStalledIssue::renameNodesAutomatically()
 bool NameConflictedStalledIssue::renameCloudNodesAutomatically(const QList<std::shared_ptr<ConflictedNameInfo>>& cloudConflictedNames,
                                                                const QList<std::shared_ptr<ConflictedNameInfo>>& localConflictedNames,
                                                                bool ignoreLastModifiedName,
-                                                               QStringList& cloudItemsBeingRenamed)
+                                                               UniqueNameIndex& nameIndex)
 {
     auto result(true);
     for(int index = cloudConflictedNames.size() - 1; index >= 0; --index)
@@ -556,7 +567,7 @@ bool NameConflictedStalledIssue::renameCloudNodesAutomatically(const QList<std::
                     std::shared_ptr<mega::MegaError> error(nullptr);
 
                     std::unique_ptr<mega::MegaNode> parentNode(MegaSyncApp->getMegaApi()->getNodeByHandle(conflictedNode->getParentHandle()));
-                    auto newName = Utilities::getNonDuplicatedNodeName(conflictedNode.get(), parentNode.get(), cloudConflictedName->getConflictedName(), true, cloudItemsBeingRenamed);
+                    auto newName = Utilities::getNonDuplicatedNodeName(conflictedNode.get(), parentNode.get(), cloudConflictedName->getConflictedName(), true, nameIndex);
                     MegaApiSynchronizedRequest::runRequestWithResult(
                         &mega::MegaApi::renameNode,
                         MegaSyncApp->getMegaApi(),
@@ -578,7 +589,7 @@ bool NameConflictedStalledIssue::renameCloudNodesAutomatically(const QList<std::
                     }
                     else
                     {
-                        cloudItemsBeingRenamed.append(newName);
+                        nameIndex.addName(newName);
                         renameLocalSibling(localConflictedName, newName);
                         cloudConflictedName->solveByRename(newName);
                     }
@@ -593,7 +604,7 @@ bool NameConflictedStalledIssue::renameCloudNodesAutomatically(const QList<std::
 bool NameConflictedStalledIssue::renameLocalItemsAutomatically(const QList<std::shared_ptr<ConflictedNameInfo>>& cloudConflictedNames,
                                                                const QList<std::shared_ptr<ConflictedNameInfo>>& localConflictedNames,
                                                                bool ignoreLastModifiedName,
-                                                               QStringList& cloudItemsBeingRenamed)
+                                                               UniqueNameIndex& nameIndex)
 {
     auto result(true);
     for(int index = localConflictedNames.size() - 1; index >= 0; --index)
@@ -622,11 +633,12 @@ bool NameConflictedStalledIssue::renameLocalItemsAutomatically(const QList<std::
                 if(file.exists())
                 {
                     bool isFile(fileInfo.isFile());
-                    auto newName = Utilities::getNonDuplicatedLocalName(fileInfo, true, cloudItemsBeingRenamed);
+                    auto newName = Utilities::getNonDuplicatedLocalName(fileInfo, true, nameIndex);
 
                     fileInfo.setFile(fileInfo.path(), newName);
                     if(file.rename(QDir::toNativeSeparators(fileInfo.filePath())))
                     {
+                        nameIndex.addName(newName);
                         localConflictedName->solveByRename(newName);
                         renameCloudSibling(cloudConflictedName, newName);
                     }
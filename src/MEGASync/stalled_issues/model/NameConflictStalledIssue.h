@@ -518,6 +518,7 @@ public:
     void setLocalFailed(int errorConflictIndex, const QString& error);
 
     bool containsHandle(mega::MegaHandle handle) override;
+    QList<mega::MegaHandle> getHandles() const override;
     void updateHandle(mega::MegaHandle handle) override;
     void updateName() override;
 
@@ -562,11 +563,11 @@ private:
     bool renameCloudNodesAutomatically(const QList<std::shared_ptr<ConflictedNameInfo>>& cloudConflictedNames,
                                        const QList<std::shared_ptr<ConflictedNameInfo>>& localConflictedNames,
                                        bool ignoreLastModifiedName,
-                                       QStringList &cloudItemsBeingRenamed);
+                                       UniqueNameIndex& nameIndex);
     bool renameLocalItemsAutomatically(const QList<std::shared_ptr<ConflictedNameInfo>>& cloudConflictedNames,
                                        const QList<std::shared_ptr<ConflictedNameInfo>>& localConflictedNames,
                                        bool ignoreLastModifiedName,
-                                       QStringList &cloudItemsBeingRenamed);
+                                       UniqueNameIndex& nameIndex);
 
     //Rename siblings
     bool renameCloudSibling(std::shared_ptr<ConflictedNameInfo> item, const QString& newName);
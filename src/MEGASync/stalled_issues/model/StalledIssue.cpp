@@ -194,6 +194,7 @@ StalledIssue::StalledIssue(const mega::MegaSyncStall* stallIssue)
     , mAutoResolutionApplied(false)
 {
     originalStall.reset(stallIssue->copy());
+    mKey = getKey(stallIssue);
     fillBasicInfo(stallIssue);
 }
 
@@ -538,6 +539,16 @@ const QExplicitlySharedDataPointer<CloudStalledIssueData>& StalledIssue::getClou
     return mCloudData;
 }
 
+QList<mega::MegaHandle> StalledIssue::getHandles() const
+{
+    QList<mega::MegaHandle> handles;
+    if(consultCloudData())
+    {
+        handles.append(consultCloudData()->getPathHandle());
+    }
+    return handles;
+}
+
 bool StalledIssue::checkForExternalChanges()
 {
     if(!isSolved())
@@ -718,6 +729,38 @@ QString StalledIssue::getFileName(bool preferCloud) const
     return fileName;
 }
 
+QString StalledIssue::getKey(const mega::MegaSyncStall* stall)
+{
+    //Everything the issues are filled with, so two stalls with the same key create the same issue
+    const QChar separator(0x1F);
+    QString key(QString::number(stall->reason()));
+    key.append(separator).append(QString::number(stall->detectedCloudSide()));
+
+    for(auto cloudSide : {false, true})
+    {
+        auto paths(stall->pathCount(cloudSide));
+        for(decltype(paths) index = 0; index < paths || index < 2; ++index)
+        {
+            key.append(separator).append(QString::fromUtf8(stall->path(cloudSide, index)));
+            if(index < 2)
+            {
+                key.append(separator).append(QString::number(stall->pathProblem(cloudSide, index)));
+            }
+            if(cloudSide && index < paths)
+            {
+                key.append(separator).append(QString::number(stall->cloudNodeHandle(index)));
+            }
+        }
+    }
+
+    return key;
+}
+
+const QString& StalledIssue::key() const
+{
+    return mKey;
+}
+
 bool StalledIssue::operator==(const StalledIssue& data)
 {
     bool equal(true);
@@ -291,6 +291,8 @@ public:
     const QExplicitlySharedDataPointer<CloudStalledIssueData>& getCloudData();
 
     virtual bool containsHandle(mega::MegaHandle handle){return getCloudData() && getCloudData()->getPathHandle() == handle;}
+    //Every handle containsHandle returns true for
+    virtual QList<mega::MegaHandle> getHandles() const;
     virtual void updateHandle(mega::MegaHandle handle){if(getCloudData()){getCloudData()->setPathHandle(handle);}}
     virtual void updateName(){}
 
@@ -298,6 +300,9 @@ public:
 
     mega::MegaSyncStall::SyncStallReason getReason() const;
     QString getFileName(bool preferCloud) const;
+    //Identifies the stall the issue was created from, and it is the same in every stall list received
+    static QString getKey(const mega::MegaSyncStall* stall);
+    const QString& key() const;
     static StalledIssueFilterCriterion getCriterionByReason(mega::MegaSyncStall::SyncStallReason reason);
 
     bool operator==(const StalledIssue &data);
@@ -404,6 +409,7 @@ protected:
     void performFinishAsyncIssueSolving(bool hasFailed);
 
     std::shared_ptr<mega::MegaSyncStall> originalStall;
+    QString mKey;
     mega::MegaSyncStall::SyncStallReason mReason = mega::MegaSyncStall::SyncStallReason::NoReason;
     QSet<mega::MegaHandle> mSyncIds;
     mutable SolveType mIsSolved = SolveType::UNSOLVED;
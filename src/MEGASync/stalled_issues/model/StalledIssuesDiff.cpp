@@ -0,0 +1,112 @@
+#include "StalledIssuesDiff.h"
+
+#include <QHash>
+#include <QPair>
+
+#include <algorithm>
+
+//Below this number of changed rows the lists are always updated row by row
+const int MIN_INCREMENTAL_CHANGED_ROWS = 100;
+//Percentage of the rows that can change before reloading everything
+const int MAX_INCREMENTAL_CHANGED_ROWS_PERCENT = 5;
+const int MAX_INCREMENTAL_INSERTED_ROWS = 5000;
+
+StalledIssuesDiff::StalledIssuesDiff(const QVector<QString>& oldKeys, const QVector<QString>& newKeys)
+    : mOldRows(newKeys.size(), -1)
+    , mReordered(false)
+    , mRemovedCount(0)
+    , mInsertedCount(0)
+    , mRowCount(std::max(oldKeys.size(), newKeys.size()))
+{
+    QHash<QPair<QString, int>, int> oldRowsByKey;
+    oldRowsByKey.reserve(oldKeys.size());
+    QHash<QString, int> occurrences;
+    for(int row = 0; row < oldKeys.size(); ++row)
+    {
+        const auto& key(oldKeys.at(row));
+        oldRowsByKey.insert(qMakePair(key, occurrences[key]++), row);
+    }
+
+    QVector<bool> keptRows(oldKeys.size(), false);
+    occurrences.clear();
+    auto previousOldRow(-1);
+    for(int row = 0; row < newKeys.size(); ++row)
+    {
+        const auto& key(newKeys.at(row));
+        auto oldRow(oldRowsByKey.value(qMakePair(key, occurrences[key]++), -1));
+        mOldRows[row] = oldRow;
+
+        if(oldRow >= 0)
+        {
+            keptRows[oldRow] = true;
+            mReordered |= oldRow < previousOldRow;
+            previousOldRow = oldRow;
+        }
+        else
+        {
+            if(!mInsertedRows.isEmpty() && mInsertedRows.last().last == row - 1)
+            {
+                mInsertedRows.last().last = row;
+            }
+            else
+            {
+                mInsertedRows.append(Rows{row, row});
+            }
+            mInsertedCount++;
+        }
+    }
+
+    for(int row = oldKeys.size() - 1; row >= 0; --row)
+    {
+        if(!keptRows.at(row))
+        {
+            if(!mRemovedRows.isEmpty() && mRemovedRows.last().first == row + 1)
+            {
+                mRemovedRows.last().first = row;
+            }
+            else
+            {
+                mRemovedRows.append(Rows{row, row});
+            }
+            mRemovedCount++;
+        }
+    }
+}
+
+const QVector<StalledIssuesDiff::Rows>& StalledIssuesDiff::removedRows() const
+{
+    return mRemovedRows;
+}
+
+const QVector<StalledIssuesDiff::Rows>& StalledIssuesDiff::insertedRows() const
+{
+    return mInsertedRows;
+}
+
+const QVector<int>& StalledIssuesDiff::oldRows() const
+{
+    return mOldRows;
+}
+
+bool StalledIssuesDiff::isReordered() const
+{
+    return mReordered;
+}
+
+int StalledIssuesDiff::removedCount() const
+{
+    return mRemovedCount;
+}
+
+int StalledIssuesDiff::insertedCount() const
+{
+    return mInsertedCount;
+}
+
+bool StalledIssuesDiff::isIncremental() const
+{
+    auto changedRows(mRemovedCount + mInsertedCount);
+    auto maxChangedRows(std::max(MIN_INCREMENTAL_CHANGED_ROWS,
+                                 static_cast<int>(static_cast<qint64>(mRowCount) * MAX_INCREMENTAL_CHANGED_ROWS_PERCENT / 100)));
+    return changedRows <= maxChangedRows && mInsertedCount <= MAX_INCREMENTAL_INSERTED_ROWS;
+}
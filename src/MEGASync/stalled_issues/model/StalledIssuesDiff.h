@@ -0,0 +1,46 @@
+#ifndef STALLEDISSUESDIFF_H
+#define STALLEDISSUESDIFF_H
+
+#include <QString>
+#include <QVector>
+
+/// Responsability: find the rows to remove, insert and reorder to turn a list of issue keys into a new one.
+/// The same key can be found more than once in a list, the occurrences are matched in order.
+class StalledIssuesDiff
+{
+public:
+    struct Rows
+    {
+        int first;
+        int last;
+    };
+
+    StalledIssuesDiff(const QVector<QString>& oldKeys, const QVector<QString>& newKeys);
+
+    //Rows of the old list not found in the new one, from the last to the first so they can be removed in order
+    const QVector<Rows>& removedRows() const;
+    //Rows of the new list not found in the old one, from the first to the last so they can be inserted in order
+    const QVector<Rows>& insertedRows() const;
+    //Row in the old list of each row of the new list, -1 for the inserted rows
+    const QVector<int>& oldRows() const;
+    //The rows found in both lists are not in the same order
+    bool isReordered() const;
+
+    int removedCount() const;
+    int insertedCount() const;
+
+    //The changed rows are few compared with the size of the lists, so applying them row by row is faster for the
+    //views than reloading everything
+    bool isIncremental() const;
+
+private:
+    QVector<Rows> mRemovedRows;
+    QVector<Rows> mInsertedRows;
+    QVector<int> mOldRows;
+    bool mReordered;
+    int mRemovedCount;
+    int mInsertedCount;
+    int mRowCount;
+};
+
+#endif // STALLEDISSUESDIFF_H
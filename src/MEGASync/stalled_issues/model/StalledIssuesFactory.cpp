@@ -27,6 +27,12 @@ void StalledIssuesCreator::createIssues(mega::MegaSyncStallList* stalls, UpdateT
 {
     clear();
 
+    QMultiHash<QString, StalledIssueVariant> previousIssuesByKey;
+    if(updateType == UpdateType::UI)
+    {
+        previousIssuesByKey.swap(mIssuesByKey);
+    }
+
     if(stalls)
     {
         StalledIssuesVariantList solvableIssues;
@@ -50,6 +56,20 @@ void StalledIssuesCreator::createIssues(mega::MegaSyncStallList* stalls, UpdateT
             StalledIssueVariant variant;
             std::shared_ptr<StalledIssue> d;
 
+            //The issues already shown are reused, so the model only changes the rows that are different
+            //The auto solvable ones are created again, as they must go through the solvable issues below
+            if(updateType == UpdateType::UI && !multiStepIssueSolver &&
+                stall->reason() != mega::MegaSyncStall::SyncStallReason::MoveOrRenameCannotOccur)
+            {
+                auto previousVariant(previousIssuesByKey.take(StalledIssue::getKey(stall)));
+                if(previousVariant.isValid() && previousVariant.consultData()->isUnsolved() &&
+                    !previousVariant.shouldBeIgnored() && !previousVariant.consultData()->isAutoSolvable())
+                {
+                    mStalledIssues.mActiveStalledIssues.append(previousVariant);
+                    continue;
+                }
+            }
+
             if(stall->reason() == mega::MegaSyncStall::SyncStallReason::MoveOrRenameCannotOccur)
             {
                 d = mMoveOrRenameCannotOccurFactory->createIssue(multiStepIssueSolver, stall);
@@ -194,6 +214,16 @@ void StalledIssuesCreator::createIssues(mega::MegaSyncStallList* stalls, UpdateT
                 issueIt.remove();
             }
         }
+
+        if(updateType == UpdateType::UI)
+        {
+            //Inserted backwards, as take() returns the last one inserted for a key and the order must be kept
+            for(auto row = mStalledIssues.mActiveStalledIssues.size() - 1; row >= 0; --row)
+            {
+                const auto& issue(mStalledIssues.mActiveStalledIssues.at(row));
+                mIssuesByKey.insert(issue.consultData()->key(), issue);
+            }
+        }
     }
 }
 
@@ -4,6 +4,8 @@
 #include <StalledIssue.h>
 #include <MultiStepIssueSolver.h>
 
+#include <QMultiHash>
+
 class MoveOrRenameCannotOccurFactory;
 
 class ReceivedStalledIssues
@@ -107,6 +109,8 @@ private:
     QMultiMap<mega::MegaSyncStall::SyncStallReason,
         MultiStepIssueSolverBase*> mMultiStepIssueSolversByReason;
     std::shared_ptr<MoveOrRenameCannotOccurFactory> mMoveOrRenameCannotOccurFactory;
+    //Issues sent to the UI in the last update, by stall key
+    QMultiHash<QString, StalledIssueVariant> mIssuesByKey;
 };
 
 Q_DECLARE_METATYPE(StalledIssuesCreator::IssuesCount)
@@ -1,6 +1,7 @@
 #include "StalledIssuesModel.h"
 
 #include "MegaApplication.h"
+#include "StalledIssuesDiff.h"
 #include <StalledIssuesDelegateWidgetsCache.h>
 #include "NameConflictStalledIssue.h"
 #include "MoveOrRenameCannotOccurIssue.h"
@@ -14,6 +15,7 @@
 #include "StatsEventHandler.h"
 
 #include <QSortFilterProxyModel>
+#include <QSet>
 
 StalledIssuesReceiver::StalledIssuesReceiver(QObject* parent) : QObject(parent), mega::MegaRequestListener()
 {
@@ -198,106 +200,293 @@ void StalledIssuesModel::onProcessStalledIssues(ReceivedStalledIssues issuesRece
         mEventTimer.start(EVENT_REQUEST_DELAY);
     }
 
-    Utilities::queueFunctionInObjectThread(mStalledIssuesReceiver, [this, issuesReceived]()
+    auto activeIssues(issuesReceived.activeStalledIssues());
+    mSolvedStalledIssues.append(issuesReceived.autoSolvedStalledIssues());
+    mFailedStalledIssues = issuesReceived.failedAutoSolvedStalledIssues();
+
+    //The issues received again are already connected
+    QSet<const StalledIssue*> issuesInModel;
+    for(const auto& issue : qAsConst(mStalledIssues))
     {
-        reset();
-        mModelMutex.lockForWrite();
+        issuesInModel.insert(issue.consultData().get());
+    }
 
-        blockSignals(true);
+    for(auto& issue : activeIssues)
+    {
+        if(!issuesInModel.contains(issue.consultData().get()) && !issue.consultData()->isBeingSolved())
+        {
+            //Connect issue signals
+            connect(
+                issue.getData().get(),
+                &StalledIssue::asyncIssueSolvingStarted,
+                this,
+                [this]()
+                {
+                    //In case we want to implement it in the future
+                });
+
+            connect(
+                issue.getData().get(),
+                &StalledIssue::asyncIssueSolvingFinished,
+                this, &StalledIssuesModel::onAsyncIssueSolvingFinished, Qt::UniqueConnection);
+
+            connect(
+                issue.getData().get(),
+                &StalledIssue::dataUpdated,
+                this, &StalledIssuesModel::onStalledIssueUpdated, Qt::UniqueConnection);
+        }
+    }
 
-        auto totalRows = rowCount(QModelIndex());
-        auto activeIssues(issuesReceived.activeStalledIssues());
-        auto rowsToBeInserted(static_cast<int>(activeIssues.size()));
+    StalledIssuesVariantList issues;
+    issues.reserve(activeIssues.size() + mSolvedStalledIssues.size() + mFailedStalledIssues.size());
+    issues << activeIssues << mSolvedStalledIssues << mFailedStalledIssues;
+    updateRows(issues);
 
-        if(rowsToBeInserted > 0)
-        {
-            beginInsertRows(QModelIndex(), totalRows, totalRows + rowsToBeInserted - 1);
+    mCountByFilterCriterion.clear();
+    foreach(auto issue, activeIssues)
+    {
+        mCountByFilterCriterion[static_cast<int>(StalledIssue::getCriterionByReason(issue.consultData()->getReason()))]++;
+    }
+    mCountByFilterCriterion[static_cast<int>(StalledIssueFilterCriterion::SOLVED_CONFLICTS)] += mSolvedStalledIssues.size();
+    mCountByFilterCriterion[static_cast<int>(StalledIssueFilterCriterion::FAILED_CONFLICTS)] += mFailedStalledIssues.size();
 
-            for (auto it = activeIssues.begin(); it != activeIssues.end();)
-            {
-                if(mThreadFinished)
-                {
-                    return;
-                }
+    mIssuesRequested = false;
 
-                StalledIssueVariant issue(*it);
-                mStalledIssues.append(issue);
-                mStalledIssuesByOrder.insert(issue.consultData().get(), rowCount(QModelIndex()) - 1);
-                mCountByFilterCriterion[static_cast<int>(StalledIssue::getCriterionByReason((*it).consultData()->getReason()))]++;
+    emit stalledIssuesCountChanged();
+    emit stalledIssuesReceived();
+    emit stalledIssuesChanged();
+}
 
-                if(!(*it).consultData()->isBeingSolved())
-                {
-                    //Connect issue signals
-                    connect(
-                        issue.getData().get(),
-                        &StalledIssue::asyncIssueSolvingStarted,
-                        this,
-                        [this]()
-                        {
-                            //In case we want to implement it in the future
-                        });
-
-                    connect(
-                        issue.getData().get(),
-                        &StalledIssue::asyncIssueSolvingFinished,
-                        this, &StalledIssuesModel::onAsyncIssueSolvingFinished, Qt::UniqueConnection);
-
-                    connect(
-                        issue.getData().get(),
-                        &StalledIssue::dataUpdated,
-                        this, &StalledIssuesModel::onStalledIssueUpdated, Qt::UniqueConnection);
-                }
+void StalledIssuesModel::updateRows(const StalledIssuesVariantList& issues)
+{
+    QVector<QString> oldKeys;
+    oldKeys.reserve(mStalledIssues.size());
+    for(const auto& issue : qAsConst(mStalledIssues))
+    {
+        oldKeys.append(issue.consultData()->key());
+    }
 
-                it++;
-            }
+    QVector<QString> newKeys;
+    newKeys.reserve(issues.size());
+    for(const auto& issue : issues)
+    {
+        newKeys.append(issue.consultData()->key());
+    }
+
+    StalledIssuesDiff diff(oldKeys, newKeys);
 
-            endInsertRows();
+    //When the lists are too different, it is faster for the views to reload everything
+    if(!diff.isIncremental())
+    {
+        beginResetModel();
+        mModelMutex.lockForWrite();
+        mStalledIssues.clear();
+        mStalledIssues.reserve(issues.size());
+        mIssuesByHandle.clear();
+        mHandlesByIssue.clear();
+        for(const auto& issue : issues)
+        {
+            mStalledIssues.append(issue);
+            addIssueHandles(issue);
         }
+        mStalledIssuesByOrder.clear();
+        updateStalledIssuesOrder(0);
+        mModelMutex.unlock();
+        endResetModel();
+        return;
+    }
 
-        mSolvedStalledIssues.append(issuesReceived.autoSolvedStalledIssues());
-        appendCachedIssuesToModel(mSolvedStalledIssues, StalledIssueFilterCriterion::SOLVED_CONFLICTS);
+    //The rows are kept up to date after every change, as the parent of the body indexes depends on them
+    for(const auto& rows : diff.removedRows())
+    {
+        beginRemoveRows(QModelIndex(), rows.first, rows.last);
+        mModelMutex.lockForWrite();
+        for(int row = rows.first; row <= rows.last; ++row)
+        {
+            mStalledIssuesByOrder.remove(mStalledIssues.at(row).consultData().get());
+            removeIssueHandles(mStalledIssues.at(row));
+        }
+        mStalledIssues.erase(mStalledIssues.begin() + rows.first, mStalledIssues.begin() + rows.last + 1);
+        updateStalledIssuesOrder(rows.first);
+        mModelMutex.unlock();
+        endRemoveRows();
+    }
 
-        mFailedStalledIssues.append(issuesReceived.failedAutoSolvedStalledIssues());
-        appendCachedIssuesToModel(mFailedStalledIssues, StalledIssueFilterCriterion::FAILED_CONFLICTS);
+    if(diff.isReordered())
+    {
+        reorderRows(diff);
+    }
 
-        blockSignals(false);
+    for(const auto& rows : diff.insertedRows())
+    {
+        beginInsertRows(QModelIndex(), rows.first, rows.last);
+        mModelMutex.lockForWrite();
+        for(int row = rows.first; row <= rows.last; ++row)
+        {
+            mStalledIssues.insert(row, issues.at(row));
+            addIssueHandles(issues.at(row));
+        }
+        updateStalledIssuesOrder(rows.first);
         mModelMutex.unlock();
+        endInsertRows();
+    }
 
-        mIssuesRequested = false;
+    //Same stall but a new issue (i.e. created again after being solved)
+    auto firstChangedRow(-1);
+    for(int row = 0; row <= issues.size(); ++row)
+    {
+        auto changed(row < issues.size() && diff.oldRows().at(row) >= 0 &&
+                     mStalledIssues.at(row).consultData() != issues.at(row).consultData());
+        if(changed)
+        {
+            mModelMutex.lockForWrite();
+            mStalledIssuesByOrder.remove(mStalledIssues.at(row).consultData().get());
+            removeIssueHandles(mStalledIssues.at(row));
+            mStalledIssues[row] = issues.at(row);
+            mStalledIssuesByOrder.insert(mStalledIssues.at(row).consultData().get(), row);
+            addIssueHandles(issues.at(row));
+            mModelMutex.unlock();
+
+            if(firstChangedRow < 0)
+            {
+                firstChangedRow = row;
+            }
+        }
+        else if(firstChangedRow >= 0)
+        {
+            emit dataChanged(index(firstChangedRow, 0), index(row - 1, 0));
+            firstChangedRow = -1;
+        }
+    }
 
-        emit stalledIssuesCountChanged();
-        emit stalledIssuesReceived();
-        emit stalledIssuesChanged();
-    });
+    //The reused issues can be filled again (i.e. a MoveOrRenameCannotOccur issue with one more stall)
+    mModelMutex.lockForWrite();
+    for(const auto& issue : qAsConst(mStalledIssues))
+    {
+        updateIssueHandles(issue);
+    }
+    mModelMutex.unlock();
 }
 
-void StalledIssuesModel::appendCachedIssuesToModel(
-    const StalledIssuesVariantList& list, StalledIssueFilterCriterion type)
+void StalledIssuesModel::updateStalledIssuesOrder(int firstRow)
 {
-    auto totalRows = rowCount(QModelIndex());
-    auto rowsToBeInserted = static_cast<int>(list.size());
+    for(int row = firstRow; row < mStalledIssues.size(); ++row)
+    {
+        mStalledIssuesByOrder.insert(mStalledIssues.at(row).consultData().get(), row);
+    }
+}
 
-    if(rowsToBeInserted > 0)
+void StalledIssuesModel::addIssueHandles(const StalledIssueVariant& issue)
+{
+    auto handles(issue.consultData()->getHandles());
+    mHandlesByIssue.insert(issue.consultData().get(), handles);
+    foreach(auto handle, handles)
     {
-        beginInsertRows(QModelIndex(), totalRows, totalRows + rowsToBeInserted - 1);
+        mIssuesByHandle.insert(handle, issue);
+    }
+}
 
-        for (auto it = list.begin(); it != list.end();)
+void StalledIssuesModel::removeIssueHandles(const StalledIssueVariant& issue)
+{
+    //The handles indexed, the issue may contain others by now
+    foreach(auto handle, mHandlesByIssue.take(issue.consultData().get()))
+    {
+        auto it(mIssuesByHandle.find(handle));
+        while(it != mIssuesByHandle.end() && it.key() == handle)
         {
-            if(mThreadFinished)
+            if(it.value().consultData() == issue.consultData())
             {
-                return;
+                it = mIssuesByHandle.erase(it);
             }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
 
-            StalledIssueVariant issue(*it);
-            mStalledIssues.append(issue);
-            mStalledIssuesByOrder.insert(issue.consultData().get(), rowCount(QModelIndex()) - 1);
-            mCountByFilterCriterion[static_cast<int>(type)]++;
+//Every change of the handles of an issue in the model goes through here, so it is found by its new handles
+void StalledIssuesModel::updateIssueHandles(const StalledIssueVariant& issue)
+{
+    auto indexedHandles(mHandlesByIssue.constFind(issue.consultData().get()));
+    //Only if it is still in the model
+    if(indexedHandles != mHandlesByIssue.constEnd() && indexedHandles.value() != issue.consultData()->getHandles())
+    {
+        removeIssueHandles(issue);
+        addIssueHandles(issue);
+    }
+}
 
-            it++;
+//Called after removing the rows, so the rows kept are the only ones in the model
+void StalledIssuesModel::reorderRows(const StalledIssuesDiff& diff)
+{
+    //Row of each old row once the removed rows are gone
+    QVector<int> currentRowsByOldRow(diff.oldRows().size() - diff.insertedCount() + diff.removedCount(), -1);
+    QVector<int> keptOldRows;
+    keptOldRows.reserve(mStalledIssues.size());
+    for(auto oldRow : diff.oldRows())
+    {
+        if(oldRow >= 0)
+        {
+            keptOldRows.append(oldRow);
         }
+    }
+    auto sortedOldRows(keptOldRows);
+    std::sort(sortedOldRows.begin(), sortedOldRows.end());
+    for(int row = 0; row < sortedOldRows.size(); ++row)
+    {
+        currentRowsByOldRow[sortedOldRows.at(row)] = row;
+    }
 
-        endInsertRows();
+    emit layoutAboutToBeChanged();
+
+    QVector<int> newRowsByCurrentRow(mStalledIssues.size(), -1);
+    StalledIssuesVariantList reorderedIssues;
+    reorderedIssues.reserve(mStalledIssues.size());
+    for(auto oldRow : keptOldRows)
+    {
+        auto currentRow(currentRowsByOldRow.at(oldRow));
+        newRowsByCurrentRow[currentRow] = reorderedIssues.size();
+        reorderedIssues.append(mStalledIssues.at(currentRow));
+    }
+
+    //The body indexes point to the issue in the list
+    QHash<const void*, int> currentRowsByBody;
+    for(int row = 0; row < mStalledIssues.size(); ++row)
+    {
+        currentRowsByBody.insert(&mStalledIssues.at(row), row);
+    }
+
+    mModelMutex.lockForWrite();
+    mStalledIssues.swap(reorderedIssues);
+    updateStalledIssuesOrder(0);
+    mModelMutex.unlock();
+
+    auto oldIndexes(persistentIndexList());
+    QModelIndexList newIndexes;
+    for(const auto& oldIndex : qAsConst(oldIndexes))
+    {
+        auto isBody(oldIndex.internalPointer() != nullptr);
+        auto currentRow(isBody ? currentRowsByBody.value(oldIndex.internalPointer(), -1) : oldIndex.row());
+        auto newRow(currentRow >= 0 ? newRowsByCurrentRow.value(currentRow, -1) : -1);
+
+        if(newRow < 0)
+        {
+            newIndexes.append(QModelIndex());
+        }
+        else if(isBody)
+        {
+            newIndexes.append(createIndex(0, 0, &mStalledIssues[newRow]));
+        }
+        else
+        {
+            newIndexes.append(createIndex(newRow, oldIndex.column()));
+        }
     }
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged();
 }
 
 void StalledIssuesModel::onSendEvent()
@@ -368,34 +557,40 @@ void StalledIssuesModel::onNodesUpdate(mega::MegaApi*, mega::MegaNodeList* nodes
         mega::MegaNodeList* copiedNodes(nodes->copy());
         Utilities::queueFunctionInObjectThread(mStalledIssuesReceiver, [this, copiedNodes]()
         {
+            //Shared by the whole batch, as a move usually brings many nodes with the same parent
+            QHash<mega::MegaHandle, mega::MegaHandle> lastVersionByParent;
+
             for (int i = 0; i < copiedNodes->size(); i++)
             {
                 mega::MegaNode *node = copiedNodes->get(i);
                 if (node->getChanges() & mega::MegaNode::CHANGE_TYPE_PARENT)
                 {
-                    std::unique_ptr<mega::MegaNode> parentNode(MegaSyncApp->getMegaApi()->getNodeByHandle(node->getParentHandle()));
-                    if(parentNode && parentNode->getType() == mega::MegaNode::TYPE_FILE)
+                    mModelMutex.lockForRead();
+                    auto issues(mIssuesByHandle.values(node->getHandle()));
+                    mModelMutex.unlock();
+
+                    if(issues.isEmpty())
                     {
-                        for(int row = 0; row < rowCount(QModelIndex()); ++row)
+                        continue;
+                    }
+
+                    //The node is now a version of the file it has been moved to
+                    auto lastVersionHandle(getLastVersionHandle(node->getParentHandle(), lastVersionByParent));
+                    if(lastVersionHandle == mega::INVALID_HANDLE)
+                    {
+                        continue;
+                    }
+
+                    foreach(auto item, issues)
+                    {
+                        if(item.getData()->containsHandle(node->getHandle()))
                         {
-                            auto item(getStalledIssueByRow(row));
+                            mModelMutex.lockForWrite();
+                            item.getData()->updateHandle(lastVersionHandle);
+                            updateIssueHandles(item);
+                            mModelMutex.unlock();
 
-                            if(item.getData()->containsHandle(node->getHandle()))
-                            {
-                                auto parentFound(false);
-                                while (!parentFound)
-                                {
-                                    auto currentParentHandle(parentNode->getHandle());
-                                    auto parentNodeRaw(MegaSyncApp->getMegaApi()->getParentNode(parentNode.get()));
-                                    parentNode.reset(parentNodeRaw);
-                                    if(!parentNode || parentNode->getType() != mega::MegaNode::TYPE_FILE)
-                                    {
-                                        item.getData()->updateHandle(currentParentHandle);
-                                        item.getData()->resetUIUpdated();
-                                        parentFound = true;
-                                    }
-                                }
-                            }
+                            item.getData()->resetUIUpdated();
                         }
                     }
                 }
@@ -413,6 +608,42 @@ void StalledIssuesModel::onNodesUpdate(mega::MegaApi*, mega::MegaNodeList* nodes
     }
 }
 
+mega::MegaHandle StalledIssuesModel::getLastVersionHandle(mega::MegaHandle parentHandle,
+                                                          QHash<mega::MegaHandle, mega::MegaHandle>& lastVersionByParent) const
+{
+    auto cachedHandle(lastVersionByParent.constFind(parentHandle));
+    if(cachedHandle != lastVersionByParent.constEnd())
+    {
+        return cachedHandle.value();
+    }
+
+    //Go up while the parent is a file, the last one is the current version
+    auto lastVersionHandle(mega::INVALID_HANDLE);
+    QList<mega::MegaHandle> versionHandles;
+    std::unique_ptr<mega::MegaNode> parentNode(MegaSyncApp->getMegaApi()->getNodeByHandle(parentHandle));
+    while(parentNode && parentNode->getType() == mega::MegaNode::TYPE_FILE)
+    {
+        cachedHandle = lastVersionByParent.constFind(parentNode->getHandle());
+        if(cachedHandle != lastVersionByParent.constEnd())
+        {
+            lastVersionHandle = cachedHandle.value();
+            break;
+        }
+
+        lastVersionHandle = parentNode->getHandle();
+        versionHandles.append(lastVersionHandle);
+        parentNode.reset(MegaSyncApp->getMegaApi()->getParentNode(parentNode.get()));
+    }
+
+    lastVersionByParent.insert(parentHandle, lastVersionHandle);
+    foreach(auto versionHandle, versionHandles)
+    {
+        lastVersionByParent.insert(versionHandle, lastVersionHandle);
+    }
+
+    return lastVersionHandle;
+}
+
 Qt::DropActions StalledIssuesModel::supportedDropActions() const
 {
     return Qt::IgnoreAction;
@@ -591,10 +822,13 @@ bool StalledIssuesModel::removeRows(int row, int count, const QModelIndex& paren
     {
         beginRemoveRows(parent, row, row + count - 1);
 
+        mModelMutex.lockForWrite();
         for (auto i (0); i < count; ++i)
         {
-            mStalledIssues.removeAt(i);
+            removeIssueHandles(mStalledIssues.at(row));
+            mStalledIssues.removeAt(row);
         }
+        mModelMutex.unlock();
 
         endRemoveRows();
 
@@ -620,6 +854,15 @@ void StalledIssuesModel::updateStalledIssuedByOrder()
         mCountByFilterCriterion[static_cast<int>(StalledIssue::getCriterionByReason(item.consultData()->getReason()))]++;
     }
 
+    mModelMutex.lockForWrite();
+    mIssuesByHandle.clear();
+    mHandlesByIssue.clear();
+    foreach(auto item, mStalledIssues)
+    {
+        addIssueHandles(item);
+    }
+    mModelMutex.unlock();
+
     emit stalledIssuesCountChanged();
 }
 
@@ -732,7 +975,11 @@ void StalledIssuesModel::reset()
 {
     beginResetModel();
 
+    mModelMutex.lockForWrite();
     mStalledIssues.clear();
+    mIssuesByHandle.clear();
+    mHandlesByIssue.clear();
+    mModelMutex.unlock();
     mFailedStalledIssues.clear();
     mStalledIssuesByOrder.clear();
     mCountByFilterCriterion.clear();
@@ -1086,9 +1333,9 @@ void StalledIssuesModel::chooseSideManually(bool remote, const QModelIndexList&
 
 void StalledIssuesModel::chooseBothSides(const QModelIndexList& list)
 {
-    std::shared_ptr<QStringList> namesUsed(new QStringList());
+    auto nameIndexes(std::make_shared<UniqueNameIndexes>());
 
-    auto resolveIssue = [this, namesUsed](int row) -> bool
+    auto resolveIssue = [this, nameIndexes](int row) -> bool
     {
         auto result(false);
         auto item(getStalledIssueByRow(row));
@@ -1097,7 +1344,7 @@ void StalledIssuesModel::chooseBothSides(const QModelIndexList& list)
         {
             if(auto issue = item.convert<LocalOrRemoteUserMustChooseStalledIssue>())
             {
-                result = issue->chooseBothSides(namesUsed.get());
+                result = issue->chooseBothSides(nameIndexes.get());
             }
 
             if(result)
@@ -20,6 +20,7 @@
 
 class LoadingSceneMessageHandler;
 class NameConflictedStalledIssue;
+class StalledIssuesDiff;
 
 namespace StalledIssuesStrings
 {
@@ -221,7 +222,14 @@ private slots:
 private:
     void showIssueExternallyChangedMessageBox();
 
-    void appendCachedIssuesToModel(const StalledIssuesVariantList& list, StalledIssueFilterCriterion type);
+    void updateRows(const StalledIssuesVariantList& issues);
+    void reorderRows(const StalledIssuesDiff& diff);
+    void updateStalledIssuesOrder(int firstRow);
+    void addIssueHandles(const StalledIssueVariant& issue);
+    void removeIssueHandles(const StalledIssueVariant& issue);
+    void updateIssueHandles(const StalledIssueVariant& issue);
+    mega::MegaHandle getLastVersionHandle(mega::MegaHandle parentHandle,
+                                          QHash<mega::MegaHandle, mega::MegaHandle>& lastVersionByParent) const;
 
     void removeRows(QModelIndexList& indexesToRemove);
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
@@ -284,6 +292,10 @@ private:
     mutable StalledIssuesVariantList mSolvedStalledIssues;
     mutable StalledIssuesVariantList mFailedStalledIssues;
     mutable QHash<const StalledIssue*, int> mStalledIssuesByOrder;
+    //Issues of the rows by the cloud handles they contain, protected by mModelMutex
+    QMultiHash<mega::MegaHandle, StalledIssueVariant> mIssuesByHandle;
+    //Handles indexed for each issue, as they can change once indexed
+    QHash<const StalledIssue*, QList<mega::MegaHandle>> mHandlesByIssue;
 
     QHash<int, int> mCountByFilterCriterion;
 
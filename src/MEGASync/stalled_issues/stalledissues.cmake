@@ -26,6 +26,7 @@ set(DESKTOP_APP_STALLED_ISSUES_HEADERS
     stalled_issues/model/NameConflictStalledIssue.h
     stalled_issues/model/StalledIssuesUtilities.h
     stalled_issues/model/StalledIssuesModel.h
+    stalled_issues/model/StalledIssuesDiff.h
     stalled_issues/model/StalledIssue.h
     stalled_issues/model/StalledIssuesProxyModel.h
     stalled_issues/model/StalledIssuesFactory.h
@@ -60,6 +61,7 @@ set(DESKTOP_APP_STALLED_ISSUES_SOURCES
     stalled_issues/model/StalledIssuesUtilities.cpp
     stalled_issues/model/StalledIssue.cpp
     stalled_issues/model/StalledIssuesModel.cpp
+    stalled_issues/model/StalledIssuesDiff.cpp
     stalled_issues/model/StalledIssuesProxyModel.cpp
     stalled_issues/model/StalledIssuesFactory.cpp
     stalled_issues/model/MultiStepIssueSolver.cpp
@@ -32,6 +32,7 @@ SOURCES +=  \
     $$PWD/model/StalledIssuesUtilities.cpp \
     $$PWD/model/StalledIssue.cpp \
     $$PWD/model/StalledIssuesModel.cpp \
+    $$PWD/model/StalledIssuesDiff.cpp \
     $$PWD/model/StalledIssuesProxyModel.cpp
 
 HEADERS  +=   \
@@ -62,6 +63,7 @@ HEADERS  +=   \
     $$PWD/model/NameConflictStalledIssue.h \
     $$PWD/model/StalledIssuesUtilities.h \
     $$PWD/model/StalledIssuesModel.h \
+    $$PWD/model/StalledIssuesDiff.h \
     $$PWD/model/StalledIssue.h \
     $$PWD/model/StalledIssuesProxyModel.h
 
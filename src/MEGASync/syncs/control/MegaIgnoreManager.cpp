@@ -243,6 +243,11 @@ QStringList MegaIgnoreManager::getExcludedExtensions() const
     return extensions;
 }
 
+MegaIgnoreRuleSet MegaIgnoreManager::compileRules() const
+{
+    return MegaIgnoreRuleSet(mRules);
+}
+
 MegaIgnoreManager::ApplyChangesError MegaIgnoreManager::applyChanges(bool updateExtensionRules, const QStringList& updatedExtensions)
 {
     ApplyChangesError result(ApplyChangesError::NO_UPDATE_NEEDED);
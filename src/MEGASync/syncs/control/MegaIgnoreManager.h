@@ -2,6 +2,7 @@
 #define MEGAIGNOREMANAGER_H
 
 #include <syncs/control/MegaIgnoreRules.h>
+#include <syncs/control/MegaIgnoreRuleSet.h>
 
 #include <QString>
 #include <QFile>
@@ -36,6 +37,8 @@ public:
     std::shared_ptr<MegaIgnoreRule> findRule(const QString& ruleToCompare);
     static MegaIgnoreRule::RuleType getRuleType(const QString& line);
     QStringList getExcludedExtensions() const;
+    // The enabled rules, including the ones not applied yet, ready to be matched against paths
+    MegaIgnoreRuleSet compileRules() const;
 
     void parseIgnoresFile();
 
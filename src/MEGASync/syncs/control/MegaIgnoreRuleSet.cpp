@@ -0,0 +1,425 @@
+#include "MegaIgnoreRuleSet.h"
+
+#include "megaapi.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr int CASE_SENSITIVE = 0;
+constexpr int CASE_INSENSITIVE = 1;
+
+const QChar PATH_SEPARATOR = QLatin1Char('/');
+const QChar ASTERISK = QLatin1Char('*');
+}
+
+MegaIgnoreRuleSet::MegaIgnoreRuleSet(const QList<std::shared_ptr<MegaIgnoreRule>>& rules)
+{
+    foreach(auto rule, rules)
+    {
+        if (rule->isCommented() || rule->isDeleted() || !rule->isValid())
+        {
+            continue;
+        }
+
+        switch (rule->ruleType())
+        {
+            case MegaIgnoreRule::RuleType::NAMERULE:
+            case MegaIgnoreRule::RuleType::EXTENSIONRULE:
+            {
+                addNameRule(std::dynamic_pointer_cast<MegaIgnoreNameRule>(rule), mRules.size());
+                break;
+            }
+            case MegaIgnoreRule::RuleType::SIZERULE:
+            {
+                addSizeRule(std::dynamic_pointer_cast<MegaIgnoreSizeRule>(rule));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    for (auto& matchersByText : mMatchers)
+    {
+        for (auto& matchersByCase : matchersByText)
+        {
+            compileGlobs(matchersByCase[CASE_SENSITIVE], Qt::CaseSensitive);
+            compileGlobs(matchersByCase[CASE_INSENSITIVE], Qt::CaseInsensitive);
+        }
+    }
+}
+
+MegaIgnoreRuleSet::Match MegaIgnoreRuleSet::match(const Entry& entry) const
+{
+    QHash<QString, Match> folderMatches;
+    return matchEntry(entry, folderMatches);
+}
+
+QVector<MegaIgnoreRuleSet::Match> MegaIgnoreRuleSet::match(const QVector<Entry>& entries) const
+{
+    QVector<Match> matches;
+    matches.reserve(entries.size());
+
+    QHash<QString, Match> folderMatches;
+    for (const auto& entry : entries)
+    {
+        matches.append(matchEntry(entry, folderMatches));
+    }
+    return matches;
+}
+
+int MegaIgnoreRuleSet::compiledRulesCount() const
+{
+    return mRules.size();
+}
+
+void MegaIgnoreRuleSet::addNameRule(const std::shared_ptr<MegaIgnoreNameRule>& rule, int ruleIndex)
+{
+    if (!rule)
+    {
+        return;
+    }
+
+    // The pattern kept by the rule has no asterisks, so the one written in the file is used
+    const auto ruleText(rule->getModifiedRule());
+    const auto separator(ruleText.indexOf(QLatin1Char(':')));
+    if (separator < 0)
+    {
+        return;
+    }
+    const auto pattern(ruleText.mid(separator + 1));
+
+    mRules.append(rule);
+    mExcludingRules.append(rule->getClass() == MegaIgnoreNameRule::Class::EXCLUDE);
+
+    QVector<EntryKind> kinds;
+    switch (rule->getTarget())
+    {
+        case MegaIgnoreNameRule::Target::d:
+            kinds << FOLDER_ENTRY;
+            break;
+        case MegaIgnoreNameRule::Target::f:
+            kinds << FILE_ENTRY;
+            break;
+        case MegaIgnoreNameRule::Target::s:
+            kinds << SYMLINK_ENTRY;
+            break;
+        default:
+            kinds << FILE_ENTRY << FOLDER_ENTRY << SYMLINK_ENTRY;
+            break;
+    }
+
+    auto matchedText(NAME);
+    if (rule->getType() == MegaIgnoreNameRule::Type::N)
+    {
+        matchedText = ROOT_NAME;
+    }
+    else if (rule->getType() == MegaIgnoreNameRule::Type::p)
+    {
+        matchedText = PATH;
+    }
+
+    const auto caseSensitivity(rule->getCaseSensitivity());
+    const auto caseIndex(caseSensitivity == Qt::CaseSensitive ? CASE_SENSITIVE : CASE_INSENSITIVE);
+
+    if (rule->getStrategy() == MegaIgnoreNameRule::Strategy::r)
+    {
+        QRegularExpression regExp(QLatin1String("\\A(?:") + pattern + QLatin1String(")\\z"),
+                                  caseSensitivity == Qt::CaseSensitive ? QRegularExpression::NoPatternOption
+                                                                       : QRegularExpression::CaseInsensitiveOption);
+        if (!regExp.isValid())
+        {
+            mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                               QString::fromUtf8("Invalid .megaignore regular expression: %1").arg(pattern).toUtf8().constData());
+            return;
+        }
+        regExp.optimize();
+
+        for (auto kind : kinds)
+        {
+            mMatchers[kind][matchedText][caseIndex].regExps.prepend(qMakePair(regExp, ruleIndex));
+        }
+        return;
+    }
+
+    // Literal names, prefixes and suffixes do not need the regular expression
+    const auto leadingAsterisk(pattern.startsWith(ASTERISK));
+    const auto trailingAsterisk(pattern.size() > 1 && pattern.endsWith(ASTERISK));
+    auto literal(pattern.mid(leadingAsterisk ? 1 : 0, pattern.size() - (leadingAsterisk ? 1 : 0) - (trailingAsterisk ? 1 : 0)));
+    const auto isLiteral(!literal.contains(ASTERISK) && !literal.contains(QLatin1Char('?'))
+                         && !literal.contains(QLatin1Char('[')) && !(leadingAsterisk && trailingAsterisk));
+    if (caseIndex == CASE_INSENSITIVE)
+    {
+        literal = literal.toLower();
+    }
+
+    for (auto kind : kinds)
+    {
+        auto& matcher(mMatchers[kind][matchedText][caseIndex]);
+        if (!isLiteral)
+        {
+            matcher.globPatterns.prepend(globToRegExp(pattern));
+            matcher.globRules.prepend(ruleIndex);
+        }
+        else if (leadingAsterisk)
+        {
+            matcher.suffixes.insert(literal, ruleIndex);
+            if (!matcher.suffixLengths.contains(literal.size()))
+            {
+                matcher.suffixLengths.append(literal.size());
+            }
+        }
+        else if (trailingAsterisk)
+        {
+            matcher.prefixes.insert(literal, ruleIndex);
+            if (!matcher.prefixLengths.contains(literal.size()))
+            {
+                matcher.prefixLengths.append(literal.size());
+            }
+        }
+        else
+        {
+            matcher.names.insert(literal, ruleIndex);
+        }
+    }
+}
+
+void MegaIgnoreRuleSet::addSizeRule(const std::shared_ptr<MegaIgnoreSizeRule>& rule)
+{
+    if (!rule)
+    {
+        return;
+    }
+
+    // As in MegaIgnoreManager, the last one enabled is the one applied
+    if (rule->threshold() == MegaIgnoreSizeRule::Threshold::LOW)
+    {
+        mLowLimitRule = rule;
+        mLowLimit = rule->valueInBytes();
+    }
+    else
+    {
+        mHighLimitRule = rule;
+        mHighLimit = rule->valueInBytes();
+    }
+}
+
+void MegaIgnoreRuleSet::compileGlobs(Matcher& matcher, Qt::CaseSensitivity caseSensitivity)
+{
+    if (matcher.globPatterns.isEmpty())
+    {
+        return;
+    }
+
+    // Each rule is a group, and only the group of the first alternative matching is captured
+    const auto pattern(QLatin1String("\\A(?:(") + matcher.globPatterns.join(QLatin1String(")|(")) + QLatin1String("))\\z"));
+    matcher.globs = QRegularExpression(pattern, caseSensitivity == Qt::CaseSensitive ? QRegularExpression::NoPatternOption
+                                                                                     : QRegularExpression::CaseInsensitiveOption);
+    if (!matcher.globs.isValid())
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                           QString::fromUtf8("Invalid .megaignore glob rules: %1").arg(matcher.globs.errorString()).toUtf8().constData());
+        matcher.globRules.clear();
+    }
+    else
+    {
+        matcher.globs.optimize();
+    }
+    matcher.globPatterns.clear();
+}
+
+int MegaIgnoreRuleSet::matchRule(const QString& path, EntryKind kind) const
+{
+    const auto nameStart(path.lastIndexOf(PATH_SEPARATOR) + 1);
+    const auto name(path.mid(nameStart));
+
+    auto bestRule(-1);
+    for (int matchedText = NAME; matchedText < MATCHED_TEXTS; ++matchedText)
+    {
+        if (matchedText == ROOT_NAME && nameStart > 0)
+        {
+            continue;
+        }
+
+        const auto& text(matchedText == PATH ? path : name);
+        const auto& matchers(mMatchers[kind][matchedText]);
+        bestRule = matchers[CASE_SENSITIVE].match(text, bestRule);
+        if (!matchers[CASE_INSENSITIVE].isEmpty())
+        {
+            bestRule = matchers[CASE_INSENSITIVE].match(text.toLower(), bestRule);
+        }
+    }
+    return bestRule;
+}
+
+MegaIgnoreRuleSet::Match MegaIgnoreRuleSet::matchEntry(const Entry& entry, QHash<QString, Match>& folderMatches) const
+{
+    if (entry.isFolder && !entry.isSymLink)
+    {
+        return matchFolder(entry.path, folderMatches);
+    }
+
+    Match result;
+    const auto parentEnd(entry.path.lastIndexOf(PATH_SEPARATOR));
+    if (parentEnd > 0)
+    {
+        result = matchFolder(entry.path.left(parentEnd), folderMatches);
+        if (result.excluded)
+        {
+            return result;
+        }
+    }
+
+    const auto kind(entry.isSymLink ? SYMLINK_ENTRY : FILE_ENTRY);
+    const auto rule(matchRule(entry.path, kind));
+    if (rule >= 0)
+    {
+        result.excluded = mExcludingRules.at(rule);
+        result.rule = mRules.at(rule);
+    }
+
+    if (!result.excluded && kind == FILE_ENTRY)
+    {
+        if (mLowLimitRule && entry.size < mLowLimit)
+        {
+            result.excluded = true;
+            result.rule = mLowLimitRule;
+        }
+        else if (mHighLimitRule && entry.size > mHighLimit)
+        {
+            result.excluded = true;
+            result.rule = mHighLimitRule;
+        }
+    }
+
+    return result;
+}
+
+MegaIgnoreRuleSet::Match MegaIgnoreRuleSet::matchFolder(const QString& folderPath, QHash<QString, Match>& folderMatches) const
+{
+    auto cachedMatch(folderMatches.constFind(folderPath));
+    if (cachedMatch != folderMatches.constEnd())
+    {
+        return cachedMatch.value();
+    }
+
+    // The contents of an excluded folder are never scanned, so no rule can include them again
+    Match result;
+    const auto parentEnd(folderPath.lastIndexOf(PATH_SEPARATOR));
+    if (parentEnd > 0)
+    {
+        result = matchFolder(folderPath.left(parentEnd), folderMatches);
+    }
+
+    if (!result.excluded)
+    {
+        const auto rule(matchRule(folderPath, FOLDER_ENTRY));
+        if (rule >= 0)
+        {
+            result.excluded = mExcludingRules.at(rule);
+            result.rule = mRules.at(rule);
+        }
+    }
+
+    folderMatches.insert(folderPath, result);
+    return result;
+}
+
+QString MegaIgnoreRuleSet::globToRegExp(const QString& glob)
+{
+    QString regExp;
+    for (int index = 0; index < glob.size(); ++index)
+    {
+        const auto character(glob.at(index));
+        if (character == ASTERISK)
+        {
+            regExp.append(QLatin1String(".*"));
+        }
+        else if (character == QLatin1Char('?'))
+        {
+            regExp.append(QLatin1Char('.'));
+        }
+        else if (character == QLatin1Char('[') && glob.indexOf(QLatin1Char(']'), index + 2) > 0)
+        {
+            // The first character of the set can be a ']'
+            const auto setEnd(glob.indexOf(QLatin1Char(']'), index + 2));
+            auto set(glob.mid(index + 1, setEnd - index - 1));
+            set.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+            if (set.startsWith(QLatin1Char('!')))
+            {
+                set[0] = QLatin1Char('^');
+            }
+            else if (set.startsWith(QLatin1Char('^')))
+            {
+                set.prepend(QLatin1Char('\\'));
+            }
+            regExp.append(QLatin1Char('[') + set + QLatin1Char(']'));
+            index = setEnd;
+        }
+        else
+        {
+            regExp.append(QRegularExpression::escape(QString(character)));
+        }
+    }
+    return regExp;
+}
+
+bool MegaIgnoreRuleSet::Matcher::isEmpty() const
+{
+    return names.isEmpty() && prefixLengths.isEmpty() && suffixLengths.isEmpty() && globRules.isEmpty()
+           && regExps.isEmpty();
+}
+
+int MegaIgnoreRuleSet::Matcher::match(const QString& text, int bestRule) const
+{
+    bestRule = std::max(bestRule, names.value(text, -1));
+
+    for (auto length : prefixLengths)
+    {
+        if (length <= text.size())
+        {
+            bestRule = std::max(bestRule, prefixes.value(text.left(length), -1));
+        }
+    }
+
+    for (auto length : suffixLengths)
+    {
+        if (length <= text.size())
+        {
+            bestRule = std::max(bestRule, suffixes.value(text.right(length), -1));
+        }
+    }
+
+    // Only when one of them could win
+    if (!globRules.isEmpty() && globRules.first() > bestRule)
+    {
+        const auto globMatch(globs.match(text));
+        if (globMatch.hasMatch())
+        {
+            for (int group = 0; group < globRules.size(); ++group)
+            {
+                if (globMatch.capturedStart(group + 1) >= 0)
+                {
+                    bestRule = std::max(bestRule, globRules.at(group));
+                    break;
+                }
+            }
+        }
+    }
+
+    for (const auto& regExp : regExps)
+    {
+        if (regExp.second <= bestRule)
+        {
+            break;
+        }
+        if (regExp.first.match(text).hasMatch())
+        {
+            bestRule = regExp.second;
+            break;
+        }
+    }
+
+    return bestRule;
+}
@@ -0,0 +1,107 @@
+#ifndef MEGAIGNORERULESET_H
+#define MEGAIGNORERULESET_H
+
+#include <syncs/control/MegaIgnoreRules.h>
+
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <memory>
+
+/// Responsability: tell if a path of a sync is excluded by the rules of its .megaignore, and by which rule.
+/// The rules are compiled once: literal names, prefixes and suffixes (i.e. extensions) go to hash tables and the
+/// rest of glob rules are merged in a single regular expression, so a path is not tested against every rule.
+/// As in the .megaignore file, the last matching name rule wins, and the contents of an excluded folder are
+/// excluded too. The files not excluded by name are checked against the size rules.
+class MegaIgnoreRuleSet
+{
+public:
+    struct Entry
+    {
+        // Relative to the sync root, separated by '/'
+        QString path;
+        bool isFolder = false;
+        bool isSymLink = false;
+        long long size = 0;
+    };
+
+    struct Match
+    {
+        bool excluded = false;
+        // nullptr when no rule matches the entry or one of its parent folders
+        std::shared_ptr<MegaIgnoreRule> rule;
+    };
+
+    explicit MegaIgnoreRuleSet(const QList<std::shared_ptr<MegaIgnoreRule>>& rules);
+
+    Match match(const Entry& entry) const;
+    // The folders shared by the entries are matched only once
+    QVector<Match> match(const QVector<Entry>& entries) const;
+
+    int compiledRulesCount() const;
+
+private:
+    enum EntryKind
+    {
+        FILE_ENTRY,
+        FOLDER_ENTRY,
+        SYMLINK_ENTRY,
+        ENTRY_KINDS
+    };
+
+    enum MatchedText
+    {
+        NAME,
+        // Only the entries in the sync root
+        ROOT_NAME,
+        PATH,
+        MATCHED_TEXTS
+    };
+
+    // Rules for one kind of entry, one matched text and one case sensitivity. The values are the indexes of the
+    // rules, and the case insensitive keys are in lower case
+    struct Matcher
+    {
+        QHash<QString, int> names;
+        QHash<QString, int> prefixes;
+        QHash<QString, int> suffixes;
+        QVector<int> prefixLengths;
+        QVector<int> suffixLengths;
+
+        // Alternatives from the last rule to the first one, so the first one matching is the one that wins
+        QStringList globPatterns;
+        QVector<int> globRules;
+        QRegularExpression globs;
+        // From the last rule to the first one
+        QVector<QPair<QRegularExpression, int>> regExps;
+
+        bool isEmpty() const;
+        // The rule that wins over bestRule, or bestRule
+        int match(const QString& text, int bestRule) const;
+    };
+
+    void addNameRule(const std::shared_ptr<MegaIgnoreNameRule>& rule, int ruleIndex);
+    void addSizeRule(const std::shared_ptr<MegaIgnoreSizeRule>& rule);
+    void compileGlobs(Matcher& matcher, Qt::CaseSensitivity caseSensitivity);
+
+    int matchRule(const QString& path, EntryKind kind) const;
+    Match matchEntry(const Entry& entry, QHash<QString, Match>& folderMatches) const;
+    Match matchFolder(const QString& folderPath, QHash<QString, Match>& folderMatches) const;
+
+    static QString globToRegExp(const QString& glob);
+
+    QVector<std::shared_ptr<MegaIgnoreRule>> mRules;
+    QVector<bool> mExcludingRules;
+    std::array<std::array<std::array<Matcher, 2>, MATCHED_TEXTS>, ENTRY_KINDS> mMatchers;
+
+    std::shared_ptr<MegaIgnoreSizeRule> mLowLimitRule;
+    std::shared_ptr<MegaIgnoreSizeRule> mHighLimitRule;
+    double mLowLimit = 0;
+    double mHighLimit = 0;
+};
+
+#endif // MEGAIGNORERULESET_H
@@ -96,6 +96,7 @@ MegaIgnoreNameRule::MegaIgnoreNameRule(const QString& rule, bool isCommented)
 
                     if (detectValue(chr, &mStrategy, Qt::CaseInsensitive))
                     {
+                        mCaseSensitivity = chr.isUpper() ? Qt::CaseSensitive : Qt::CaseInsensitive;
                         continue;
                     }
                 }
@@ -145,7 +146,8 @@ QString MegaIgnoreNameRule::getModifiedRule() const
         if (mStrategy != Strategy::NONE)
         {
             EnumConversions<Strategy> convertEnum;
-            rule.append(convertEnum.getString(mStrategy));
+            auto strategy(convertEnum.getString(mStrategy));
+            rule.append(mCaseSensitivity == Qt::CaseSensitive ? strategy.toUpper() : strategy);
         }
         rule.append(QLatin1String(":"));
         // Extension rules we ignore the wild card type
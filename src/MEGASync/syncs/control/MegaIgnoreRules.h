@@ -119,8 +119,13 @@ public:
     QString getModifiedRule() const override;
     QString getDisplayText() const override { return mPattern; }
     RuleType ruleType() const override { return RuleType::NAMERULE;}
-    Target getTarget() { return mTarget; }
+    Target getTarget() const { return mTarget; }
     void setTarget(Target target);
+    Class getClass() const { return mClass; }
+    Type getType() const { return mType; }
+    Strategy getStrategy() const { return mStrategy; }
+    //Upper case strategies (G, R) are case sensitive
+    Qt::CaseSensitivity getCaseSensitivity() const { return mCaseSensitivity; }
     WildCardType getWildCardType();
     void setWildCardType(WildCardType wildCard);
     virtual void setPattern(const QString &pattern);
@@ -155,6 +160,7 @@ private:
     Target mTarget = Target::NONE;
     Type mType = Type::NONE;
     Strategy mStrategy = Strategy::NONE;
+    Qt::CaseSensitivity mCaseSensitivity = Qt::CaseInsensitive;
     WildCardType mWildCardType = WildCardType::EQUAL;
 };
 
@@ -199,6 +205,7 @@ public:
 
     RuleType ruleType() const override { return RuleType::SIZERULE; }
     QString getModifiedRule() const override;
+    Threshold threshold() const { return mThreshold; }
 
     double valueInBytes();
     void setValueInBytes(double value)
@@ -7,6 +7,8 @@
 #include <mega/types.h>
 #include "StatsEventHandler.h"
 
+#include <QDir>
+
 #include <assert.h>
 
 using namespace mega;
@@ -495,6 +497,27 @@ QStringList SyncInfo::getLocalFolders(const QVector<SyncType>& types)
     return value;
 }
 
+QString SyncInfo::getLocalFolderContaining(const QString& localPath)
+{
+    QMutexLocker qm(&syncMutex);
+    const QString path(QDir::toNativeSeparators(localPath));
+
+    for (auto type : SyncInfo::AllHandledSyncTypes)
+    {
+        for (auto &cs : configuredSyncs[type])
+        {
+            QString localFolder(QDir::toNativeSeparators(configuredSyncsMap[cs]->getLocalFolder()));
+            if (path.startsWith(localFolder)
+                && (path.size() == localFolder.size() || localFolder.endsWith(QDir::separator())
+                    || path.at(localFolder.size()) == QDir::separator()))
+            {
+                return configuredSyncsMap[cs]->getLocalFolder();
+            }
+        }
+    }
+    return QString();
+}
+
 QMap<QString, SyncInfo::SyncType> SyncInfo::getLocalFoldersAndTypeMap(bool normalized)
 {
     QMutexLocker qm(&syncMutex);
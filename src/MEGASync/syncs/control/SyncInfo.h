@@ -150,6 +150,8 @@ public:
     QStringList getLocalFolders(SyncType type)
         {return getLocalFolders(QVector<SyncType>({type}));}
     QMap<QString, SyncType> getLocalFoldersAndTypeMap(bool normalized = false);
+    //Local folder of the sync that contains localPath, empty if it is not synced
+    QString getLocalFolderContaining(const QString& localPath);
     QList<mega::MegaHandle> getMegaFolderHandles(const QVector<SyncType>& types);
     QList<mega::MegaHandle> getMegaFolderHandles(SyncType type)
         {return getMegaFolderHandles(QVector<SyncType>({type}));}
@@ -17,6 +17,7 @@ set(DESKTOP_APP_SYNCS_HEADERS
     syncs/model/SyncItemModel.h
     syncs/control/MegaIgnoreManager.h
     syncs/control/MegaIgnoreRules.h
+    syncs/control/MegaIgnoreRuleSet.h
     syncs/control/SyncController.h
     syncs/control/SyncInfo.h
     syncs/control/SyncSettings.h
@@ -40,6 +41,7 @@ set(DESKTOP_APP_SYNCS_SOURCES
     syncs/model/SyncItemModel.cpp
     syncs/control/MegaIgnoreManager.cpp
     syncs/control/MegaIgnoreRules.cpp
+    syncs/control/MegaIgnoreRuleSet.cpp
     syncs/control/SyncInfo.cpp
     syncs/control/SyncController.cpp
     syncs/control/SyncSettings.cpp
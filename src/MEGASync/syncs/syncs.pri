@@ -18,6 +18,7 @@ SOURCES += $$PWD/gui/Backups/BackupSettingsElements.cpp \
            $$PWD/model/SyncItemModel.cpp \
            $$PWD/control/MegaIgnoreManager.cpp \
            $$PWD/control/MegaIgnoreRules.cpp \
+           $$PWD/control/MegaIgnoreRuleSet.cpp \
            $$PWD/control/SyncInfo.cpp \
            $$PWD/control/SyncController.cpp \
            $$PWD/control/SyncSettings.cpp
@@ -39,6 +40,7 @@ HEADERS += $$PWD/gui/Backups/BackupSettingsElements.h \
            $$PWD/model/SyncItemModel.h \
            $$PWD/control/MegaIgnoreManager.h \
            $$PWD/control/MegaIgnoreRules.h \
+           $$PWD/control/MegaIgnoreRuleSet.h \
            $$PWD/control/SyncController.h \
            $$PWD/control/SyncInfo.h \
            $$PWD/control/SyncSettings.h
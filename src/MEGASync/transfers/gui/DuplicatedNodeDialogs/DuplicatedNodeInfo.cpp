@@ -68,10 +68,9 @@ const QString &DuplicatedNodeInfo::getNewName()
     {
         if(mNewName.isEmpty() && mRemoteConflictNode)
         {
-            mNewName = Utilities::getNonDuplicatedNodeName(mRemoteConflictNode.get(), mParentNode.get(), mName, false, mChecker->getCheckedNames());
-            auto& checkedNames = mChecker->getCheckedNames();
-            checkedNames.removeOne(mName);
-            checkedNames.append(mNewName);
+            auto& nameIndex = getNameIndex();
+            mNewName = Utilities::getNonDuplicatedNodeName(mRemoteConflictNode.get(), mParentNode.get(), mName, false, nameIndex);
+            nameIndex.addName(mNewName);
         }
     }
 
@@ -82,12 +81,17 @@ const QString &DuplicatedNodeInfo::getDisplayNewName()
 {
     if(mDisplayNewName.isEmpty())
     {
-        mDisplayNewName = Utilities::getNonDuplicatedNodeName(mRemoteConflictNode.get(), mParentNode.get(), mName, false, mChecker->getCheckedNames());
+        mDisplayNewName = Utilities::getNonDuplicatedNodeName(mRemoteConflictNode.get(), mParentNode.get(), mName, false, getNameIndex());
     }
 
     return mDisplayNewName;
 }
 
+UniqueNameIndex& DuplicatedNodeInfo::getNameIndex()
+{
+    return mChecker->getNameIndexes().getIndex(mParentNode ? mParentNode->getHandle() : mega::INVALID_HANDLE);
+}
+
 const QString &DuplicatedNodeInfo::getName() const
 {
     return mName;
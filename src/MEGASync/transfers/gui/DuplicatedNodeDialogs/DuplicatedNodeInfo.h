@@ -19,6 +19,7 @@ enum class NodeItemType
 };
 
 class DuplicatedUploadBase;
+class UniqueNameIndex;
 
 class DuplicatedNodeInfo : public QObject
 {
@@ -66,6 +67,8 @@ signals:
     void localModifiedDateUpdated();
 
 private:
+    UniqueNameIndex& getNameIndex();
+
     std::shared_ptr<mega::MegaNode> mParentNode;
     std::shared_ptr<mega::MegaNode> mRemoteConflictNode;
     QString mLocalPath;
@@ -18,9 +18,9 @@ void DuplicatedUploadBase::onNodeItemSelected()
     }
 }
 
-QStringList &DuplicatedUploadBase::getCheckedNames()
+UniqueNameIndexes& DuplicatedUploadBase::getNameIndexes()
 {
-    return checkedNames;
+    return mNameIndexes;
 }
 
 QString DuplicatedUploadBase::getHeader(std::shared_ptr<DuplicatedNodeInfo> conflict)
@@ -2,6 +2,7 @@
 #define DUPLICATEDUPLOADFILE_H
 
 #include <DuplicatedNodeDialogs/DuplicatedNodeItem.h>
+#include <UniqueNameIndex.h>
 #include <megaapi.h>
 
 #include <QObject>
@@ -21,7 +22,7 @@ public:
     QString getHeader(std::shared_ptr<DuplicatedNodeInfo> conflict);
     QString getSkipText(bool isFile);
 
-    QStringList& getCheckedNames();
+    UniqueNameIndexes& getNameIndexes();
 
 signals:
     void selectionDone();
@@ -35,7 +36,7 @@ protected slots:
     void onNodeItemSelected();
 
 private:
-    QStringList checkedNames;
+    UniqueNameIndexes mNameIndexes;
 };
 
 class DuplicatedUploadFile : public DuplicatedUploadBase
@@ -3,11 +3,38 @@
 #include "MegaApplication.h"
 #include "TransfersModel.h"
 
+#include <QHash>
+
 using namespace mega;
 
 const unsigned long long ACTIVE_PRIORITY_OFFSET = 90000000000000;
 const unsigned long long COMPLETING_PRIORITY_OFFSET = 100000000000000;
 const unsigned long long COMPLETED_PRIORITY_OFFSET = 200000000000000;
+const int MAX_INTERNED_PARENT_PATHS = 20000;
+
+namespace
+{
+// Transfers of the same folder share the same parent path buffer (QString is implicitly shared).
+// There is one pool per thread, so no locking is needed when the data is created from the SDK events.
+QString internParentPath(const QString& parentPath)
+{
+    static thread_local QHash<QString, QString> pool;
+
+    auto it = pool.constFind(parentPath);
+    if(it != pool.constEnd())
+    {
+        return it.value();
+    }
+
+    if(pool.size() >= MAX_INTERNED_PARENT_PATHS)
+    {
+        pool.clear();
+    }
+    pool.insert(parentPath, parentPath);
+
+    return parentPath;
+}
+}
 
 const TransferData::TransferStates TransferData::STATE_MASK = TransferData::TransferStates (
         TransferData::TransferState::TRANSFER_QUEUED |
@@ -64,10 +91,10 @@ void TransferData::update(mega::MegaTransfer* transfer)
     {   
         mTag = transfer->getTag();
 
-        mPath = QString::fromUtf8(transfer->getPath());
         mFolderTransferTag = transfer->getFolderTransferTag();
 
         mFilename = QString::fromUtf8(transfer->getFileName());
+        setPath(QString::fromUtf8(transfer->getPath()));
         mType = static_cast<TransferData::TransferType>(1 << transfer->getType());
         if (transfer->isSyncTransfer())
         {
@@ -306,9 +333,19 @@ std::unique_ptr<MegaNode> TransferData::getNode() const
     }
 }
 
+void TransferData::setPath(const QString& path)
+{
+    auto separatorIndex = std::max(path.lastIndexOf(QLatin1Char('/')), path.lastIndexOf(QLatin1Char('\\')));
+    mParentPath = internParentPath(path.left(separatorIndex + 1));
+
+    auto leafName = path.mid(separatorIndex + 1);
+    //Most of the times the leaf is the file name, reuse its buffer
+    mLeafName = leafName == mFilename ? mFilename : leafName;
+}
+
 QString TransferData::path() const
 {
-    QString localPath = mPath;
+    QString localPath = mParentPath + mLeafName;
     #ifdef WIN32
     if (localPath.startsWith(QString::fromLatin1("\\\\?\\")))
     {
@@ -73,7 +73,7 @@ public:
         mFileType(dr->mFileType),
         mParentHandle (dr->mParentHandle), mNodeHandle (dr->mNodeHandle), mFailedTransfer(dr->mFailedTransfer),
         mFilename(dr->mFilename), mNodeAccess(mega::MegaShare::ACCESS_UNKNOWN),
-        mPath(dr->mPath), mFinishedTime(dr->mFinishedTime),mState(dr->mState), mIgnorePauseQueueState(dr->mIgnorePauseQueueState)
+        mParentPath(dr->mParentPath), mLeafName(dr->mLeafName), mFinishedTime(dr->mFinishedTime),mState(dr->mState), mIgnorePauseQueueState(dr->mIgnorePauseQueueState)
     {}
 
     void update(mega::MegaTransfer* transfer);
@@ -114,6 +114,8 @@ public:
     void resetStateHasChanged();
     bool stateHasChanged() const;
 
+    // Set after mFilename, as the leaf name reuses its buffer
+    void setPath(const QString& path);
     QString path() const;
     bool isPublicNode() const;
     bool isCancelable() const;
@@ -143,7 +145,9 @@ public:
     std::unique_ptr<mega::MegaNode> getNode() const;
 
 private:
-    QString         mPath;
+    // The path is split so the parent folder can be shared by all the transfers of the same folder
+    QString         mParentPath;
+    QString         mLeafName;
     int64_t         mFinishedTime = 0;
     TransferState   mState = TransferState::TRANSFER_NONE;
     TransferState   mPreviousState = TransferState::TRANSFER_NONE;
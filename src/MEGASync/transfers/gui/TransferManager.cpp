@@ -13,6 +13,8 @@
 #include "Platform.h"
 
 #include <QMouseEvent>
+#include <QShowEvent>
+#include <QHideEvent>
 #include <QScrollBar>
 #include <QPalette>
 #include <QStyleOptionFocusRect>
@@ -1426,6 +1428,18 @@ void TransferManager::closeEvent(QCloseEvent *event)
     }
 }
 
+void TransferManager::showEvent(QShowEvent* event)
+{
+    mModel->setTransferManagerVisible(true);
+    QDialog::showEvent(event);
+}
+
+void TransferManager::hideEvent(QHideEvent* event)
+{
+    mModel->setTransferManagerVisible(false);
+    QDialog::hideEvent(event);
+}
+
 void TransferManager::changeEvent(QEvent *event)
 {
     if (event->type() == QEvent::LanguageChange)
@@ -0,0 +1,76 @@
+#include "TransferColumns.h"
+
+#include <algorithm>
+
+void TransferColumns::append(const TransferData& data)
+{
+    mIsUpload.push_back(data.isUpload());
+    mNodeHandles.push_back(data.mNodeHandle);
+    mParentHandles.push_back(data.mParentHandle);
+}
+
+void TransferColumns::update(int row, const TransferData& data)
+{
+    if(row >= 0 && row < static_cast<int>(mNodeHandles.size()))
+    {
+        mIsUpload[row] = data.isUpload();
+        mNodeHandles[row] = data.mNodeHandle;
+        mParentHandles[row] = data.mParentHandle;
+    }
+}
+
+void TransferColumns::remove(int row, int count)
+{
+    if(row >= 0 && count > 0 && row + count <= static_cast<int>(mNodeHandles.size()))
+    {
+        mIsUpload.erase(mIsUpload.begin() + row, mIsUpload.begin() + row + count);
+        mNodeHandles.erase(mNodeHandles.begin() + row, mNodeHandles.begin() + row + count);
+        mParentHandles.erase(mParentHandles.begin() + row, mParentHandles.begin() + row + count);
+    }
+}
+
+void TransferColumns::reset(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers)
+{
+    clear();
+
+    auto size(static_cast<size_t>(transfers.size()));
+    mIsUpload.reserve(size);
+    mNodeHandles.reserve(size);
+    mParentHandles.reserve(size);
+
+    for(const auto& transfer : transfers)
+    {
+        append(*transfer);
+    }
+}
+
+void TransferColumns::clear()
+{
+    mIsUpload.clear();
+    mNodeHandles.clear();
+    mParentHandles.clear();
+}
+
+int TransferColumns::findDownloadByNodeHandle(mega::MegaHandle nodeHandle, int fromRow) const
+{
+    return find(false, mNodeHandles, nodeHandle, fromRow);
+}
+
+int TransferColumns::findUploadByParentHandle(mega::MegaHandle parentHandle, int fromRow) const
+{
+    return find(true, mParentHandles, parentHandle, fromRow);
+}
+
+int TransferColumns::find(bool isUpload, const std::vector<mega::MegaHandle>& handles, mega::MegaHandle handle, int fromRow) const
+{
+    auto size(static_cast<int>(handles.size()));
+    for(int row = std::max(fromRow, 0); row < size; ++row)
+    {
+        if(handles[row] == handle && mIsUpload[row] == isUpload)
+        {
+            return row;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,36 @@
+#ifndef TRANSFERCOLUMNS_H
+#define TRANSFERCOLUMNS_H
+
+#include "TransferItem.h"
+
+#include <megaapi.h>
+
+#include <vector>
+
+/// Responsability: keeps, row by row and in contiguous arrays, the TransfersModel fields used to look for
+/// transfers (direction, node handle and parent handle). Scans walk these arrays and only dereference the
+/// TransferData of the candidate rows, instead of copying the list and touching every row.
+/// The state is not cached, as it is modified in place in the TransferData. The class is not thread safe,
+/// the owner must protect it.
+class TransferColumns
+{
+public:
+    void append(const TransferData& data);
+    void update(int row, const TransferData& data);
+    void remove(int row, int count);
+    void reset(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers);
+    void clear();
+
+    // Next row from "fromRow" (included) that matches, or -1
+    int findDownloadByNodeHandle(mega::MegaHandle nodeHandle, int fromRow = 0) const;
+    int findUploadByParentHandle(mega::MegaHandle parentHandle, int fromRow = 0) const;
+
+private:
+    int find(bool isUpload, const std::vector<mega::MegaHandle>& handles, mega::MegaHandle handle, int fromRow) const;
+
+    std::vector<bool> mIsUpload;
+    std::vector<mega::MegaHandle> mNodeHandles;
+    std::vector<mega::MegaHandle> mParentHandles;
+};
+
+#endif // TRANSFERCOLUMNS_H
@@ -0,0 +1,82 @@
+#include "TransferEventQueue.h"
+
+TransferEventQueue::TransferEventQueue(size_t capacity)
+    : mEvents(capacity),
+      mOverflowing(false),
+      mReceivedEvents(0),
+      mOverflowedEvents(0),
+      mOverflowCoalescedEvents(0),
+      mMaxOverflowEvents(0)
+{
+}
+
+void TransferEventQueue::push(Event&& event)
+{
+    mReceivedEvents++;
+
+    //Once an event has gone to the overflow list, the following ones go there too in order to keep the order
+    if(mOverflowing.load(std::memory_order_acquire) || !mEvents.tryPush(std::move(event)))
+    {
+        pushToOverflow(std::move(event));
+    }
+}
+
+void TransferEventQueue::pushToOverflow(Event&& event)
+{
+    QMutexLocker lock(&mOverflowMutex);
+    mOverflowedEvents++;
+
+    auto tag(event.data->mTag);
+    auto lastEventIt(mOverflowLastEventByTag.constFind(tag));
+    if(event.cache == Cache::UPDATE && lastEventIt != mOverflowLastEventByTag.constEnd())
+    {
+        //Nothing of this transfer came after its pending update, so replacing it keeps the order
+        auto& lastEvent(mOverflowEvents[lastEventIt.value()]);
+        if(lastEvent.cache == Cache::UPDATE)
+        {
+            if(lastEvent.data->mNotificationNumber < event.data->mNotificationNumber)
+            {
+                lastEvent = std::move(event);
+            }
+            mOverflowCoalescedEvents++;
+            return;
+        }
+    }
+
+    mOverflowLastEventByTag.insert(tag, mOverflowEvents.size());
+    mOverflowEvents.append(std::move(event));
+    mOverflowing.store(true, std::memory_order_release);
+
+    if(static_cast<uint64_t>(mOverflowEvents.size()) > mMaxOverflowEvents)
+    {
+        mMaxOverflowEvents = static_cast<uint64_t>(mOverflowEvents.size());
+    }
+}
+
+void TransferEventQueue::clear()
+{
+    //Discard the pending events
+    Event event;
+    while(mEvents.tryPop(event))
+    {}
+
+    QMutexLocker lock(&mOverflowMutex);
+    mOverflowEvents.clear();
+    mOverflowLastEventByTag.clear();
+    mOverflowing = false;
+}
+
+bool TransferEventQueue::hasEvents() const
+{
+    return mEvents.sizeApprox() > 0 || mOverflowing.load(std::memory_order_acquire);
+}
+
+TransferEventQueue::Stats TransferEventQueue::getStats() const
+{
+    Stats stats;
+    stats.receivedEvents = mReceivedEvents;
+    stats.overflowedEvents = mOverflowedEvents;
+    stats.overflowCoalescedEvents = mOverflowCoalescedEvents;
+    stats.maxOverflowEvents = mMaxOverflowEvents;
+    return stats;
+}
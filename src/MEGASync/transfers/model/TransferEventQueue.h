@@ -0,0 +1,115 @@
+#ifndef TRANSFEREVENTQUEUE_H
+#define TRANSFEREVENTQUEUE_H
+
+#include "TransferItem.h"
+#include "LockFreeQueue.h"
+
+#include <QExplicitlySharedDataPointer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+#include <atomic>
+#include <cstdint>
+
+/// Responsability: carries the SDK transfer events from the listener thread to the thread that processes them,
+/// without making the listener wait for the consumer. The events go through a bounded lock-free queue. When it
+/// is full, they go to an overflow list, in order; the consumer only holds its mutex to swap the list, so a
+/// producer never waits for the processing of the events. The overflow list keeps a single update per
+/// transfer (the latest one wins), so it is bounded by the number of transfers, not by the updates they get.
+class TransferEventQueue
+{
+public:
+    enum class Cache
+    {
+        NONE,
+        START,
+        START_SYNC,
+        UPDATE,
+        CANCELED,
+        FAILED_FOLDER,
+        FAILED
+    };
+
+    struct Event
+    {
+        QExplicitlySharedDataPointer<TransferData> data;
+        Cache cache = Cache::NONE;
+        bool updatesTempState = false;
+    };
+
+    struct Stats
+    {
+        uint64_t receivedEvents = 0;
+        //Events that did not fit in the lock-free queue and went through the overflow list
+        uint64_t overflowedEvents = 0;
+        //Updates merged in the overflow list with a pending update of the same transfer
+        uint64_t overflowCoalescedEvents = 0;
+        //Largest size of the overflow list
+        uint64_t maxOverflowEvents = 0;
+    };
+
+    explicit TransferEventQueue(size_t capacity);
+
+    void push(Event&& event);
+
+    //Calls onEvent with every pending event, in the order they were pushed. Only one thread may drain the queue
+    template <typename Function>
+    void drain(Function onEvent)
+    {
+        Event event;
+        while(mEvents.tryPop(event))
+        {
+            onEvent(event);
+        }
+
+        if(mOverflowing.load(std::memory_order_acquire))
+        {
+            QList<Event> overflowEvents;
+            {
+                QMutexLocker lock(&mOverflowMutex);
+                overflowEvents.swap(mOverflowEvents);
+                mOverflowLastEventByTag.clear();
+            }
+
+            //While the overflow list is in use nothing new goes to the queue, so what is there is older
+            while(mEvents.tryPop(event))
+            {
+                onEvent(event);
+            }
+
+            for(auto& overflowEvent : overflowEvents)
+            {
+                onEvent(overflowEvent);
+            }
+
+            QMutexLocker lock(&mOverflowMutex);
+            if(mOverflowEvents.isEmpty())
+            {
+                mOverflowing.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    void clear();
+    bool hasEvents() const;
+    Stats getStats() const;
+
+private:
+    void pushToOverflow(Event&& event);
+
+    LockFreeQueue<Event> mEvents;
+
+    QMutex mOverflowMutex;
+    QList<Event> mOverflowEvents;
+    //Index in mOverflowEvents of the last event of each transfer
+    QHash<TransferTag, int> mOverflowLastEventByTag;
+    std::atomic<bool> mOverflowing;
+
+    std::atomic<uint64_t> mReceivedEvents;
+    std::atomic<uint64_t> mOverflowedEvents;
+    std::atomic<uint64_t> mOverflowCoalescedEvents;
+    std::atomic<uint64_t> mMaxOverflowEvents;
+};
+
+#endif // TRANSFEREVENTQUEUE_H
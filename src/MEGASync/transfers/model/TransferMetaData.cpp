@@ -56,10 +56,10 @@ bool TransferMetaData::isRetriedFolder(mega::MegaTransfer* transfer)
         {
             if(folder->id.path == QString::fromUtf8(transfer->getPath()))
             {
-                mFolders.remove(folder->id);
+                removeFolder(folder->id);
                 //Update id with new tag (retried tag)
                 TransferMetaDataItemId id(transfer->getTag(), folder->id.handle, folder->id.name, folder->id.path);
-                mFolders.insert(id, folder);
+                insertFolder(id, folder);
                 return true;
             }
         }
@@ -75,7 +75,7 @@ void TransferMetaData::remove()
 
 bool TransferMetaData::isNonExistData() const
 {
-    return !mFiles.nonExistFailedTransfers.isEmpty();
+    return !mFiles.isEmpty(TransferMetaDataItemBucket::NON_EXIST_FAILED);
 }
 
 bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
@@ -110,7 +110,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
         auto value = mFolders.value(id);
         if(value)
         {
-            mFolders.remove(id);
+            removeFolder(id);
 
             value->id = id;
             TransferData::TransferState state(TransferData::TRANSFER_NONE);
@@ -139,7 +139,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 //Update Key
                 else
                 {
-                    mFolders.insert(id, value);
+                    insertFolder(id, value);
                 }
             }
             else
@@ -149,12 +149,11 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 {
                     if(isEmptyFolder)
                     {
-                        value->state = TransferData::TRANSFER_FAILED;
-                        nonExistData->mEmptyFolders.nonExistFailedTransfers.insert(id, value);
+                        nonExistData->mEmptyFolders.insertNonExistFailedItem(value);
                     }
                     else
                     {
-                        nonExistData->mFolders.insert(id, value);
+                        nonExistData->insertFolder(id, value);
                     }
                 }
             }
@@ -172,11 +171,10 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
     {
         TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
 
-        auto item = mFiles.pendingTransfers.value(id);
+        auto item = mFiles.value(TransferMetaDataItemBucket::PENDING, id.tag);
         if(item)
         {
             item->id = id;
-            mFiles.removeItem(item);
 
             TransferData::TransferState state = TransferData::convertState(transfer->getState());
             if(state == TransferData::TRANSFER_FAILED)
@@ -205,8 +203,11 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 auto nonExistData = TransferMetaDataContainer::getAppDataById(mNonExistsFailAppId);
                 if(nonExistData)
                 {
-                    item->state = TransferData::TRANSFER_FAILED;
-                    mFiles.nonExistFailedTransfers.insert(item->id, item);
+                    mFiles.insertNonExistFailedItem(item);
+                }
+                else
+                {
+                    mFiles.removeItem(TransferMetaDataItemBucket::PENDING, item->id.tag);
                 }
             }
         }
@@ -259,7 +260,7 @@ void TransferMetaData::increaseFinishedTopLevelTransfers(mega::MegaTransfer *tra
     }
     //If the transfermetadata has been created from other session from a folder download/upload
     //Increase the mFinishedTopLevelTransfers (which will be maximum 1, the folder) when all the nested files have finished
-    else if(mCreatedFromOtherSession && mFiles.pendingTransfers.isEmpty())
+    else if(mCreatedFromOtherSession && mFiles.isEmpty(TransferMetaDataItemBucket::PENDING))
     {
         if(transfer->getFolderTransferTag() > 0)
         {
@@ -272,10 +273,10 @@ bool TransferMetaData::isSingleTransfer() const
 {
     if(isNonExistData())
     {
-        return mFiles.nonExistFailedTransfers.size() == 1;
+        return mFiles.count(TransferMetaDataItemBucket::NON_EXIST_FAILED) == 1;
     }
 
-    return (mFiles.completedTransfers.size() + mFiles.failedTransfers.size() + getTotalEmptyFolders()) == 1;
+    return (mFiles.count(TransferMetaDataItemBucket::COMPLETED) + mFiles.count(TransferMetaDataItemBucket::FAILED) + getTotalEmptyFolders()) == 1;
 }
 
 int TransferMetaData::getTotalFiles() const
@@ -285,7 +286,7 @@ int TransferMetaData::getTotalFiles() const
 
 int TransferMetaData::getPendingFiles() const
 {
-    return mFiles.pendingTransfers.size() + mEmptyFolders.pendingTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::PENDING) + mEmptyFolders.count(TransferMetaDataItemBucket::PENDING);
 }
 
 int TransferMetaData::getTotalEmptyFolders() const
@@ -301,7 +302,7 @@ bool TransferMetaData::isRetriedFolder(const TransferMetaDataItemId &folderId) c
 QList<TransferMetaDataItemId> TransferMetaData::getFileFailedTagsFromFolderTag(const TransferMetaDataItemId& folderId) const
 {
     QList<TransferMetaDataItemId> ids;
-    foreach(auto& file, mFiles.failedTransfers)
+    foreach(auto& file, mFiles.getItems(TransferMetaDataItemBucket::FAILED))
     {
         if(file->topLevelFolderId == folderId)
         {
@@ -314,12 +315,12 @@ QList<TransferMetaDataItemId> TransferMetaData::getFileFailedTagsFromFolderTag(c
 
 int TransferMetaData::getFileTransfersOK() const
 {
-    return mFiles.completedTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::COMPLETED);
 }
 
 int TransferMetaData::getFileTransfersFailed() const
 {
-    return mFiles.failedTransfers.size() + mFiles.nonExistFailedTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::FAILED) + mFiles.count(TransferMetaDataItemBucket::NON_EXIST_FAILED);
 }
 
 void TransferMetaData::getFileTransferFailedTags(QList<std::shared_ptr<TransferMetaDataItem>>& files, QList<TransferMetaDataItemId>& folders) const
@@ -327,14 +328,11 @@ void TransferMetaData::getFileTransferFailedTags(QList<std::shared_ptr<TransferM
     if(isNonExistData())
     {
         //Retry only the non exist
-        foreach(auto file, mFiles.nonExistFailedTransfers)
-        {
-            files.append(file);
-        }
+        files.append(mFiles.getItems(TransferMetaDataItemBucket::NON_EXIST_FAILED));
     }
     else
     {
-        foreach(auto file, mFiles.failedTransfers)
+        foreach(auto file, mFiles.getItems(TransferMetaDataItemBucket::FAILED))
         {
             files.append(file);
             //For future folder retry
@@ -355,17 +353,17 @@ void TransferMetaData::getFileTransferFailedTags(QList<std::shared_ptr<TransferM
 
 int TransferMetaData::getFileTransfersCancelled() const
 {
-    return mFiles.cancelledTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::CANCELLED);
 }
 
 int TransferMetaData::getTotaTransfersCancelled() const
 {
-    return mFiles.cancelledTransfers.size() + mEmptyFolders.cancelledTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::CANCELLED) + mEmptyFolders.count(TransferMetaDataItemBucket::CANCELLED);
 }
 
 int TransferMetaData::getNonExistentCount() const
 {
-    return mFiles.nonExistFailedTransfers.size();
+    return mFiles.count(TransferMetaDataItemBucket::NON_EXIST_FAILED);
 }
 
 TransferMetaDataItemId TransferMetaData::getFirstTransferIdByState(TransferData::TransferState state) const
@@ -392,19 +390,19 @@ QList<TransferMetaDataItemId> TransferMetaData::getTransferIdsByState(TransferDa
 
 int TransferMetaData::getEmptyFolderTransfersOK() const
 {
-    return getEmptyFolders(mEmptyFolders.completedTransfers);
+    return getEmptyFolders(TransferMetaDataItemBucket::COMPLETED);
 }
 
 int TransferMetaData::getEmptyFolderTransfersFailed() const
 {
-    return getEmptyFolders(mEmptyFolders.failedTransfers);
+    return getEmptyFolders(TransferMetaDataItemBucket::FAILED);
 }
 
-int TransferMetaData::getEmptyFolders(const QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem>>& folders) const
+int TransferMetaData::getEmptyFolders(TransferMetaDataItemBucket bucket) const
 {
     auto counter(0);
 
-    foreach(auto& folder, folders)
+    foreach(auto& folder, mEmptyFolders.getItems(bucket))
     {
        folder->files.size() == 0 ? counter++ : counter;
     }
@@ -412,6 +410,33 @@ int TransferMetaData::getEmptyFolders(const QMap<TransferMetaDataItemId, std::sh
     return counter;
 }
 
+void TransferMetaData::insertFolder(const TransferMetaDataItemId& id, const std::shared_ptr<TransferMetaDataFolderItem>& folder)
+{
+    mFolders.insert(id, folder);
+    TransferMetaDataContainer::addFolderTag(id.tag, mAppId);
+}
+
+void TransferMetaData::removeFolder(const TransferMetaDataItemId& id)
+{
+    if(mFolders.remove(id) > 0)
+    {
+        TransferMetaDataContainer::removeFolderTag(id.tag, mAppId);
+    }
+}
+
+void TransferMetaData::setFolders(const QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem>>& folders)
+{
+    foreach(auto& id, mFolders.keys())
+    {
+        removeFolder(id);
+    }
+
+    for(auto folderIt = folders.constBegin(); folderIt != folders.constEnd(); ++folderIt)
+    {
+        insertFolder(folderIt.key(), folderIt.value());
+    }
+}
+
 void TransferMetaData::setCreatedFromOtherSession()
 {
     mCreatedFromOtherSession = true;
@@ -421,7 +446,7 @@ void TransferMetaData::addFile(int tag)
 {
     TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
     auto fileItem = std::make_shared<TransferMetaDataItem>(id);
-    mFiles.pendingTransfers.insert(id, fileItem);
+    mFiles.addPendingItem(fileItem);
     mTotalFileCount++;
 
     if(mStartedTopLevelTransfers <= mInitialTopLevelTransfers)
@@ -439,19 +464,19 @@ void TransferMetaData::addFileFromFolder(int folderTag, int fileTag)
     TransferMetaDataItemId fileId(fileTag, mega::INVALID_HANDLE);
     auto fileItem = std::make_shared<TransferMetaDataItem>(fileId);
     fileItem->topLevelFolderId.tag = folderTag;
-    mFiles.pendingTransfers.insert(fileId, fileItem);
+    mFiles.addPendingItem(fileItem);
 
     TransferMetaDataItemId folderId(folderTag, mega::INVALID_HANDLE);
     auto folderItem = mFolders.value(folderId, nullptr);
     if(!folderItem)
     {
         folderItem = std::make_shared<TransferMetaDataFolderItem>(folderId);
-        mFolders.insert(folderId,folderItem);
+        insertFolder(folderId, folderItem);
 
         addInitialPendingTopLevelTransferFromOtherSession(true);
     }
 
-    folderItem->files.pendingTransfers.insert(fileId, fileItem);
+    folderItem->files.addPendingItem(fileItem);
 }
 
 void TransferMetaData::topLevelFolderScanningFinished(int filecount)
@@ -471,7 +496,7 @@ void TransferMetaData::processCancelled()
 
 void TransferMetaData::checkAndSendNotification()
 {
-    if (mFinishedTopLevelTransfers == mInitialTopLevelTransfers && mFiles.pendingTransfers.isEmpty())
+    if (mFinishedTopLevelTransfers == mInitialTopLevelTransfers && mFiles.isEmpty(TransferMetaDataItemBucket::PENDING))
     {
         //If all the transfers have been cancelled, do not show any notification
         if (Preferences::instance()->isNotificationEnabled(Preferences::NotificationsTypes::COMPLETED_UPLOADS_DOWNLOADS))
@@ -499,7 +524,7 @@ void TransferMetaData::checkAndSendNotification()
                 nonExistData->mFiles = mFiles;
 
                 nonExistData->mEmptyFolders = mEmptyFolders;
-                nonExistData->mFolders = mFolders;
+                nonExistData->setFolders(mFolders);
 
                 nonExistData->mFiles.setHasChanged(false);
 
@@ -541,7 +566,7 @@ void TransferMetaData::checkScanningState()
     //Only for Top Level transfers
     if(mInitialTopLevelTransfers > 0 &&
             ((!mProcessCancelled && ((mTotalFileCount == mFiles.size() && mStartedTopLevelTransfers == mInitialTopLevelTransfers)))
-            || (mProcessCancelled && mFiles.pendingTransfers.isEmpty())))
+            || (mProcessCancelled && mFiles.isEmpty(TransferMetaDataItemBucket::PENDING))))
     {
         //This method is called from the transfer model secondary thread
         auto id = getAppId();
@@ -628,7 +653,7 @@ void TransferMetaData::start(mega::MegaTransfer *transfer)
         {
             TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
             auto folderItem = std::make_shared<TransferMetaDataFolderItem>(id);
-            mFolders.insert(id,folderItem);
+            insertFolder(id, folderItem);
         }
         else
         {
@@ -651,16 +676,13 @@ void TransferMetaData::retryFileFromFolderFailingItem(int fileTag, int folderTag
 {
     TransferMetaDataItemId fileId(fileTag, nodeHandle);
 
-    auto removed = mFiles.failedTransfers.remove(fileId);
-    removed += mFiles.nonExistFailedTransfers.remove(fileId);
+    auto removed = mFiles.removeItem(TransferMetaDataItemBucket::FAILED, fileId.tag);
+    removed |= mFiles.removeItem(TransferMetaDataItemBucket::NON_EXIST_FAILED, fileId.tag);
 
-    if(removed != 0)
+    if(removed)
     {
         TransferMetaDataItemId folderId(folderTag, mega::INVALID_HANDLE);
-        if(mFolders.contains(folderId))
-        {
-            mFolders.remove(folderId);
-        }
+        removeFolder(folderId);
 
         addInitialPendingTopLevelTransfer();
     }
@@ -673,10 +695,10 @@ void TransferMetaData::retryFailingFile(int tag, mega::MegaHandle nodeHandle)
     //Don´t use isSingleTransfer as this one takes into account empty folders
     auto isSingle(getTotalFiles() == 1);
 
-    auto removed = mFiles.failedTransfers.remove(fileId);
-    removed += mFiles.nonExistFailedTransfers.remove(fileId);
+    auto removed = mFiles.removeItem(TransferMetaDataItemBucket::FAILED, fileId.tag);
+    removed |= mFiles.removeItem(TransferMetaDataItemBucket::NON_EXIST_FAILED, fileId.tag);
 
-    if(removed != 0)
+    if(removed)
     {
         if(isSingle)
         {
@@ -692,8 +714,8 @@ void TransferMetaData::retryFailingFile(int tag, mega::MegaHandle nodeHandle)
 
 void TransferMetaData::retryAllPressed()
 {
-    mFiles.failedTransfers.clear();
-    mFiles.nonExistFailedTransfers.clear();
+    mFiles.clear(TransferMetaDataItemBucket::FAILED);
+    mFiles.clear(TransferMetaDataItemBucket::NON_EXIST_FAILED);
 
     if(mNotification)
     {
@@ -788,7 +810,7 @@ bool DownloadTransferMetaData::hasBeenPreviouslyCompleted(mega::MegaTransfer *tr
     //If the file has been previously completed, the node is already on the CD.
     //If not, the file should be uploaded again
     TransferMetaDataItemId fileId(-1, transfer->getNodeHandle());
-    return mFiles.completedTransfers.contains(fileId);
+    return mFiles.contains(TransferMetaDataItemBucket::COMPLETED, fileId.tag);
 }
 
 std::shared_ptr<TransferMetaData> DownloadTransferMetaData::createNonExistData()
@@ -877,7 +899,7 @@ bool UploadTransferMetaData::hasBeenPreviouslyCompleted(mega::MegaTransfer *tran
 {
     //If the file has been previously completed, the node is already on the CD.
     //If not, the file should be uploaded again
-    foreach(auto& file, mFiles.completedTransfersByFolderHandle.values(transfer->getParentHandle()))
+    foreach(auto& file, mFiles.getCompletedByFolderHandle(transfer->getParentHandle()))
     {
         if(file->id.name == QString::fromUtf8(transfer->getFileName()))
         {
@@ -955,9 +977,20 @@ bool UploadTransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaErro
 
 //////////CONTAINER AND MANAGER
 
-QHash<unsigned long long, std::shared_ptr<TransferMetaData>> TransferMetaDataContainer::transferAppData = QHash<unsigned long long, std::shared_ptr<TransferMetaData>>();
+std::shared_ptr<const TransferMetaDataContainer::Registry> TransferMetaDataContainer::mRegistry = std::make_shared<const TransferMetaDataContainer::Registry>();
+QMutex TransferMetaDataContainer::mRegistryMutex;
 QMutex TransferMetaDataContainer::mMutex;
 
+std::shared_ptr<const TransferMetaDataContainer::Registry> TransferMetaDataContainer::getRegistry()
+{
+    return std::atomic_load(&mRegistry);
+}
+
+void TransferMetaDataContainer::setRegistry(std::shared_ptr<const Registry> registry)
+{
+    std::atomic_store(&mRegistry, std::move(registry));
+}
+
 bool TransferMetaDataContainer::start(mega::MegaTransfer *transfer)
 {
     //Sync transfers are not included in notifications
@@ -1076,17 +1109,65 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
 
 bool TransferMetaDataContainer::addAppData(unsigned long long appId, std::shared_ptr<TransferMetaData> data)
 {
-    QMutexLocker lock(&mMutex);
-    return transferAppData.insert(appId, data) != transferAppData.end();
+    QMutexLocker lock(&mRegistryMutex);
+    auto registry = std::make_shared<Registry>(*getRegistry());
+    auto result = registry->transferAppData.insert(appId, data) != registry->transferAppData.end();
+    setRegistry(registry);
+    return result;
 }
 
 void TransferMetaDataContainer::removeAppData(unsigned long long appId)
 {
-    auto data = TransferMetaDataContainer::getAppDataById(appId);
-    if(data)
+    QMutexLocker lock(&mRegistryMutex);
+    auto currentRegistry = getRegistry();
+    if(currentRegistry->transferAppData.contains(appId))
+    {
+        auto registry = std::make_shared<Registry>(*currentRegistry);
+        registry->transferAppData.remove(appId);
+
+        for(auto appIdsIt = registry->appIdsByFolderTag.begin(); appIdsIt != registry->appIdsByFolderTag.end();)
+        {
+            appIdsIt.value().removeAll(appId);
+            if(appIdsIt.value().isEmpty())
+            {
+                appIdsIt = registry->appIdsByFolderTag.erase(appIdsIt);
+            }
+            else
+            {
+                ++appIdsIt;
+            }
+        }
+
+        setRegistry(registry);
+    }
+}
+
+void TransferMetaDataContainer::addFolderTag(int tag, unsigned long long appId)
+{
+    QMutexLocker lock(&mRegistryMutex);
+    auto currentRegistry = getRegistry();
+    if(!currentRegistry->appIdsByFolderTag.value(tag).contains(appId))
     {
-        QMutexLocker lock(&mMutex);
-        transferAppData.remove(appId);
+        auto registry = std::make_shared<Registry>(*currentRegistry);
+        registry->appIdsByFolderTag[tag].append(appId);
+        setRegistry(registry);
+    }
+}
+
+void TransferMetaDataContainer::removeFolderTag(int tag, unsigned long long appId)
+{
+    QMutexLocker lock(&mRegistryMutex);
+    auto currentRegistry = getRegistry();
+    if(currentRegistry->appIdsByFolderTag.value(tag).contains(appId))
+    {
+        auto registry = std::make_shared<Registry>(*currentRegistry);
+        auto& appIds(registry->appIdsByFolderTag[tag]);
+        appIds.removeAll(appId);
+        if(appIds.isEmpty())
+        {
+            registry->appIdsByFolderTag.remove(tag);
+        }
+        setRegistry(registry);
     }
 }
 
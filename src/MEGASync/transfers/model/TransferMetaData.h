@@ -6,6 +6,13 @@
 #include <QPair>
 #include <QPointer>
 #include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+#include <array>
+#include <vector>
 
 #include "Preferences.h"
 #include "TransferItem.h"
@@ -57,112 +64,108 @@ struct TransferMetaDataItem
     virtual TransferData::TransferState getState(){return state;}
 };
 
+enum class TransferMetaDataItemBucket : uint8_t
+{
+    PENDING = 0,
+    COMPLETED,
+    FAILED,
+    //Failed because the source does not exist anymore
+    NON_EXIST_FAILED,
+    CANCELLED,
+    COUNT
+};
+
+/// Responsability: keep the items of a transfer batch in a single slab, indexed by tag, with a counter by bucket.
+/// Changing the state of an item only updates its slot, it is not moved between containers.
 template <class Type>
-struct TransferMetaDataItemsByState
-{ 
-    int size() const {return pendingTransfers.size() + completedTransfers.size() + failedTransfers.size() + cancelledTransfers.size() + nonExistFailedTransfers.size();}
+class TransferMetaDataItemsByState
+{
+public:
+    using Bucket = TransferMetaDataItemBucket;
 
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> pendingTransfers;
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> completedTransfers;
-    QMultiMap<mega::MegaHandle, std::shared_ptr<Type>> completedTransfersByFolderHandle;
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> failedTransfers;
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> nonExistFailedTransfers;
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> cancelledTransfers;
+    int size() const {return static_cast<int>(mSlots.size());}
+    int count(Bucket bucket) const {return mCounters[static_cast<size_t>(bucket)];}
+    bool isEmpty(Bucket bucket) const {return count(bucket) == 0;}
 
-    TransferMetaDataItemId getFirstTransferIdByState(TransferData::TransferState state) const
+    bool contains(Bucket bucket, int tag) const
     {
-        switch(state)
+        auto slotIt = mSlotsByTag.constFind(tag);
+        return slotIt != mSlotsByTag.constEnd() && mSlots[slotIt.value()].bucket == bucket;
+    }
+
+    std::shared_ptr<Type> value(Bucket bucket, int tag) const
+    {
+        auto slotIt = mSlotsByTag.constFind(tag);
+        if(slotIt != mSlotsByTag.constEnd() && mSlots[slotIt.value()].bucket == bucket)
         {
-            case TransferData::TRANSFER_COMPLETED:
-            {
-                if(!completedTransfers.isEmpty())
-                {
-                    return completedTransfers.first()->id;
-                }
-                break;
-            }
-            case TransferData::TRANSFER_CANCELLED:
+            return mSlots[slotIt.value()].item;
+        }
+
+        return nullptr;
+    }
+
+    //Sorted by tag
+    QList<std::shared_ptr<Type>> getItems(Bucket bucket) const
+    {
+        QList<std::shared_ptr<Type>> items;
+        if(!isEmpty(bucket))
+        {
+            items.reserve(count(bucket));
+            for(const auto& slot : mSlots)
             {
-                if(!cancelledTransfers.isEmpty())
+                if(slot.bucket == bucket)
                 {
-                    return cancelledTransfers.first()->id;
+                    items.append(slot.item);
                 }
-                break;
             }
-            case TransferData::TRANSFER_FAILED:
+            std::sort(items.begin(), items.end(), [](const std::shared_ptr<Type>& first, const std::shared_ptr<Type>& second){
+                return first->id < second->id;
+            });
+        }
+
+        return items;
+    }
+
+    QList<std::shared_ptr<Type>> getCompletedByFolderHandle(mega::MegaHandle folderHandle) const
+    {
+        return mCompletedByFolderHandle.values(folderHandle);
+    }
+
+    TransferMetaDataItemId getFirstTransferIdByState(TransferData::TransferState state) const
+    {
+        const Type* first(nullptr);
+        const auto bucket(getBucket(state));
+        for(const auto& slot : mSlots)
+        {
+            if(slot.bucket == bucket && (!first || slot.item->id < first->id))
             {
-                if(!failedTransfers.isEmpty())
-                {
-                    return failedTransfers.first()->id;
-                }
-                if(!nonExistFailedTransfers.isEmpty())
-                {
-                    return nonExistFailedTransfers.first()->id;
-                }
-                break;
+                first = slot.item.get();
             }
-            default:
+        }
+
+        if(first)
+        {
+            return first->id;
+        }
+        //The non exist failed transfers are the last option for the failed ones
+        else if(state == TransferData::TRANSFER_FAILED)
+        {
+            auto nonExistFailed(getItems(Bucket::NON_EXIST_FAILED));
+            if(!nonExistFailed.isEmpty())
             {
-                if(!pendingTransfers.isEmpty())
-                {
-                    return pendingTransfers.first()->id;
-                }
-                break;
+                return nonExistFailed.first()->id;
             }
         }
 
         return TransferMetaDataItemId();
     }
+
     QList<TransferMetaDataItemId> getTransferIdsByState(TransferData::TransferState state) const
     {
         QList<TransferMetaDataItemId> ids;
-
-        switch(state)
+        foreach(auto& item, getItems(getBucket(state)))
         {
-            case TransferData::TRANSFER_COMPLETED:
-            {
-                if(!completedTransfers.isEmpty())
-                {
-                    foreach(auto& item, completedTransfers.keys())
-                    {
-                        ids.append(item);
-                    }
-                }
-                break;
-            }
-            case TransferData::TRANSFER_CANCELLED:
-            {
-                if(!cancelledTransfers.isEmpty())
-                {
-                    foreach(auto& item, cancelledTransfers.keys())
-                    {
-                        ids.append(item);
-                    }
-                }
-                break;
-            }
-            case TransferData::TRANSFER_FAILED:
-            {
-                if(!failedTransfers.isEmpty())
-                {
-                    foreach(auto& item, failedTransfers.keys())
-                    {
-                        ids.append(item);
-                    }
-                }
-                break;
-            }
-            default:
-            {
-                if(!pendingTransfers.isEmpty())
-                {
-                    foreach(auto& item, pendingTransfers.keys())
-                    {
-                        ids.append(item);
-                    }
-                }
-                break;
-            }
+            ids.append(item->id);
         }
 
         return ids;
@@ -179,69 +182,134 @@ struct TransferMetaDataItemsByState
     }
 
 private:
+    struct Slot
+    {
+        std::shared_ptr<Type> item;
+        Bucket bucket;
+        mega::MegaHandle folderHandle;
+    };
+
+    std::vector<Slot> mSlots;
+    QHash<int, int> mSlotsByTag;
+    std::array<int, static_cast<size_t>(Bucket::COUNT)> mCounters{};
+    QMultiHash<mega::MegaHandle, std::shared_ptr<Type>> mCompletedByFolderHandle;
     bool mHasChanged = false;
 
-    friend class TransferMetaData;
-    void insertItem(TransferData::TransferState state, const std::shared_ptr<Type>& item)
+    static Bucket getBucket(TransferData::TransferState state)
     {
-        removeItem(item);
-
-        item->state = state;
         switch(state)
         {
             case TransferData::TRANSFER_COMPLETED:
             {
-                completedTransfers.insert(item->id, item);
-                completedTransfersByFolderHandle.insert(item->folderId.handle, item);
-                break;
+                return Bucket::COMPLETED;
             }
             case TransferData::TRANSFER_CANCELLED:
             {
-                cancelledTransfers.insert(item->id, item);
-                break;
+                return Bucket::CANCELLED;
             }
             case TransferData::TRANSFER_FAILED:
             {
-                failedTransfers.insert(item->id, item);
-                break;
+                return Bucket::FAILED;
             }
             default:
             {
-                pendingTransfers.insert(item->id, item);
-                break;
+                return Bucket::PENDING;
             }
         }
+    }
 
+    friend class TransferMetaData;
+
+    void addPendingItem(const std::shared_ptr<Type>& item)
+    {
+        placeItem(Bucket::PENDING, item);
+    }
+
+    void insertItem(TransferData::TransferState state, const std::shared_ptr<Type>& item)
+    {
+        item->state = state;
+        placeItem(getBucket(state), item);
         setHasChanged(true);
     }
 
-    void removeItem(const std::shared_ptr<Type>& item)
+    void insertNonExistFailedItem(const std::shared_ptr<Type>& item)
     {
-        switch(item->state)
+        item->state = TransferData::TRANSFER_FAILED;
+        placeItem(Bucket::NON_EXIST_FAILED, item);
+    }
+
+    //Returns true if the item was in the bucket
+    bool removeItem(Bucket bucket, int tag)
+    {
+        auto slotIt = mSlotsByTag.find(tag);
+        if(slotIt == mSlotsByTag.end() || mSlots[slotIt.value()].bucket != bucket)
         {
-            case TransferData::TRANSFER_COMPLETED:
-            {
-                completedTransfers.remove(item->id);
-                completedTransfersByFolderHandle.remove(item->folderId.handle, item);
-                break;
-            }
-            case TransferData::TRANSFER_CANCELLED:
-            {
-                cancelledTransfers.remove(item->id);
-                break;
-            }
-            case TransferData::TRANSFER_FAILED:
-            {
-                failedTransfers.remove(item->id);
-                break;
-            }
-            default:
+            return false;
+        }
+
+        auto index(slotIt.value());
+        mSlotsByTag.erase(slotIt);
+        leaveBucket(mSlots[index]);
+
+        //The last slot fills the hole
+        if(index != static_cast<int>(mSlots.size()) - 1)
+        {
+            mSlots[index] = std::move(mSlots.back());
+            mSlotsByTag.insert(mSlots[index].item->id.tag, index);
+        }
+        mSlots.pop_back();
+
+        return true;
+    }
+
+    void clear(Bucket bucket)
+    {
+        for(int index = static_cast<int>(mSlots.size()) - 1; index >= 0; --index)
+        {
+            if(mSlots[index].bucket == bucket)
             {
-                pendingTransfers.remove(item->id);
-                break;
+                removeItem(bucket, mSlots[index].item->id.tag);
             }
         }
     }
+
+    void placeItem(Bucket bucket, const std::shared_ptr<Type>& item)
+    {
+        auto slotIt = mSlotsByTag.constFind(item->id.tag);
+        if(slotIt != mSlotsByTag.constEnd())
+        {
+            auto& slot(mSlots[slotIt.value()]);
+            leaveBucket(slot);
+            slot.item = item;
+            enterBucket(slot, bucket);
+        }
+        else
+        {
+            mSlotsByTag.insert(item->id.tag, static_cast<int>(mSlots.size()));
+            mSlots.push_back(Slot{item, bucket, mega::INVALID_HANDLE});
+            enterBucket(mSlots.back(), bucket);
+        }
+    }
+
+    void enterBucket(Slot& slot, Bucket bucket)
+    {
+        slot.bucket = bucket;
+        mCounters[static_cast<size_t>(bucket)]++;
+        if(bucket == Bucket::COMPLETED)
+        {
+            slot.folderHandle = slot.item->folderId.handle;
+            mCompletedByFolderHandle.insert(slot.folderHandle, slot.item);
+        }
+    }
+
+    void leaveBucket(const Slot& slot)
+    {
+        mCounters[static_cast<size_t>(slot.bucket)]--;
+        if(slot.bucket == Bucket::COMPLETED)
+        {
+            mCompletedByFolderHandle.remove(slot.folderHandle, slot.item);
+        }
+    }
 };
 
 struct TransferMetaDataFolderItem : public TransferMetaDataItem
@@ -327,7 +395,12 @@ protected:
     TransferMetaDataItemsByState<TransferMetaDataItem> mFiles;
     QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem>> mFolders;
     TransferMetaDataItemsByState<TransferMetaDataFolderItem> mEmptyFolders;
-    int getEmptyFolders(const QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem> > &folders) const;
+    int getEmptyFolders(TransferMetaDataItemBucket bucket) const;
+
+    //mFolders is only changed through these methods, so the folder tags index of the container is kept updated
+    void insertFolder(const TransferMetaDataItemId& id, const std::shared_ptr<TransferMetaDataFolderItem>& folder);
+    void removeFolder(const TransferMetaDataItemId& id);
+    void setFolders(const QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem>>& folders);
 
     int mTransferDirection;
     bool mCreateRootFolder;
@@ -408,6 +481,9 @@ private:
 
 Q_DECLARE_METATYPE(std::shared_ptr<UploadTransferMetaData>)
 
+/// Responsability: find the TransferMetaData of every transfer event.
+/// The readers take a snapshot of the registry without locking, the writers replace it. The folder tags are indexed,
+/// so the files of a folder transfer find their TransferMetaData without going through all of them.
 class TransferMetaDataContainer
 {
 public:
@@ -418,8 +494,9 @@ public:
     static void retryTransfer(mega::MegaTransfer* transfer, unsigned long long appDataId);
     static void retryAllPressed()
     {
+        auto registry(getRegistry());
         QMutexLocker lock(&mMutex);
-        foreach(auto& appdata, transferAppData)
+        foreach(auto& appdata, registry->transferAppData)
         {
             appdata->retryAllPressed();
         }
@@ -447,8 +524,7 @@ public:
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppDataById(unsigned long long appId)
     {
-        QMutexLocker lock(&mMutex);
-        auto data = transferAppData.value(appId);
+        auto data = getRegistry()->transferAppData.value(appId);
         return std::dynamic_pointer_cast<TYPE>(data);
     }
 
@@ -466,13 +542,17 @@ public:
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppDataByFolderTransferTag(int tag)
     {
-        QMutexLocker lock(&mMutex);
-        TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
-        foreach(auto& appdata, transferAppData)
+        auto registry(getRegistry());
+        auto appIdsIt = registry->appIdsByFolderTag.constFind(tag);
+        if(appIdsIt != registry->appIdsByFolderTag.constEnd())
         {
-            if(appdata->isRetriedFolder(id))
+            for(auto appId : appIdsIt.value())
             {
-                return std::dynamic_pointer_cast<TYPE>(appdata);
+                auto data = registry->transferAppData.value(appId);
+                if(data)
+                {
+                    return std::dynamic_pointer_cast<TYPE>(data);
+                }
             }
         }
 
@@ -511,7 +591,26 @@ public:
     }
 
 private:
-    static QHash<unsigned long long, std::shared_ptr<TransferMetaData>> transferAppData;
+    friend class TransferMetaData;
+
+    struct Registry
+    {
+        QHash<unsigned long long, std::shared_ptr<TransferMetaData>> transferAppData;
+        //The same folder may be in several TransferMetaData (the non exist data copies the folders), the first one is used
+        QHash<int, QVector<unsigned long long>> appIdsByFolderTag;
+    };
+
+    static std::shared_ptr<const Registry> getRegistry();
+    //Called with mRegistryMutex locked
+    static void setRegistry(std::shared_ptr<const Registry> registry);
+
+    static void addFolderTag(int tag, unsigned long long appId);
+    static void removeFolderTag(int tag, unsigned long long appId);
+
+    static std::shared_ptr<const Registry> mRegistry;
+    //Serializes the writers of mRegistry
+    static QMutex mRegistryMutex;
+    //Serializes the retries
     static QMutex mMutex;
 };
 
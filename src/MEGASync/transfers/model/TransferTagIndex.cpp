@@ -0,0 +1,182 @@
+#include "TransferTagIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+const int MIN_CAPACITY = 1024;
+}
+
+TransferTagIndex::TransferTagIndex()
+    : mUsedSlots(0),
+      mHighestBit(0)
+{
+}
+
+void TransferTagIndex::append(TransferTag tag)
+{
+    if(mSlotByTag.contains(tag))
+    {
+        remove(tag);
+    }
+
+    if(mUsedSlots >= static_cast<int>(mTagBySlot.size()))
+    {
+        //Compact the dead slots and leave room for as many rows as we have alive
+        rebuild(std::max(MIN_CAPACITY, 2 * (size() + 1)));
+    }
+
+    auto slot(mUsedSlots++);
+    mTagBySlot[slot] = tag;
+    mSlotByTag.insert(tag, slot);
+    addToTree(slot, 1);
+}
+
+bool TransferTagIndex::remove(TransferTag tag)
+{
+    auto it = mSlotByTag.find(tag);
+    if(it != mSlotByTag.end())
+    {
+        addToTree(it.value(), -1);
+        mSlotByTag.erase(it);
+        return true;
+    }
+
+    return false;
+}
+
+void TransferTagIndex::clear()
+{
+    mTagBySlot.clear();
+    mTree.clear();
+    mSlotByTag.clear();
+    mUsedSlots = 0;
+    mHighestBit = 0;
+}
+
+void TransferTagIndex::reset(const QList<TransferTag>& tagsByRow)
+{
+    clear();
+    mSlotByTag.reserve(tagsByRow.size());
+    rebuild(std::max(MIN_CAPACITY, 2 * tagsByRow.size()));
+
+    for(auto tag : tagsByRow)
+    {
+        auto slot(mUsedSlots++);
+        mTagBySlot[slot] = tag;
+        mSlotByTag.insert(tag, slot);
+        addToTree(slot, 1);
+    }
+}
+
+bool TransferTagIndex::contains(TransferTag tag) const
+{
+    return mSlotByTag.contains(tag);
+}
+
+int TransferTagIndex::rowOf(TransferTag tag) const
+{
+    auto it = mSlotByTag.constFind(tag);
+    if(it != mSlotByTag.constEnd())
+    {
+        //Alive slots before this one
+        return prefixCount(it.value()) - 1;
+    }
+
+    return -1;
+}
+
+TransferTag TransferTagIndex::tagAt(int row) const
+{
+    auto slot(findSlotByRow(row));
+    return slot >= 0 ? mTagBySlot[slot] : 0;
+}
+
+int TransferTagIndex::size() const
+{
+    return mSlotByTag.size();
+}
+
+void TransferTagIndex::rebuild(int capacity)
+{
+    std::vector<TransferTag> aliveTags;
+    aliveTags.reserve(mSlotByTag.size());
+    for(int slot = 0; slot < mUsedSlots; ++slot)
+    {
+        auto tag(mTagBySlot[slot]);
+        auto it = mSlotByTag.constFind(tag);
+        if(it != mSlotByTag.constEnd() && it.value() == slot)
+        {
+            aliveTags.push_back(tag);
+        }
+    }
+
+    mTagBySlot.assign(static_cast<size_t>(capacity), 0);
+    mTree.assign(static_cast<size_t>(capacity) + 1, 0);
+    mUsedSlots = static_cast<int>(aliveTags.size());
+
+    mHighestBit = 1;
+    while((mHighestBit << 1) <= capacity)
+    {
+        mHighestBit <<= 1;
+    }
+
+    //Linear Fenwick construction: every alive slot counts one and propagates to its parent
+    for(int slot = 0; slot < mUsedSlots; ++slot)
+    {
+        mTagBySlot[slot] = aliveTags[slot];
+        mSlotByTag[aliveTags[slot]] = slot;
+        mTree[slot + 1] += 1;
+    }
+    for(int node = 1; node <= capacity; ++node)
+    {
+        auto parent(node + (node & -node));
+        if(parent <= capacity)
+        {
+            mTree[parent] += mTree[node];
+        }
+    }
+}
+
+void TransferTagIndex::addToTree(int slot, int value)
+{
+    auto capacity(static_cast<int>(mTagBySlot.size()));
+    for(int node = slot + 1; node <= capacity; node += node & -node)
+    {
+        mTree[node] += value;
+    }
+}
+
+int TransferTagIndex::prefixCount(int slot) const
+{
+    int count(0);
+    for(int node = slot + 1; node > 0; node -= node & -node)
+    {
+        count += mTree[node];
+    }
+    return count;
+}
+
+int TransferTagIndex::findSlotByRow(int row) const
+{
+    if(row < 0 || row >= size())
+    {
+        return -1;
+    }
+
+    //Descend the tree looking for the last slot with less than row + 1 alive slots before it
+    auto capacity(static_cast<int>(mTagBySlot.size()));
+    int remaining(row + 1);
+    int node(0);
+    for(int step = mHighestBit; step > 0; step >>= 1)
+    {
+        auto next(node + step);
+        if(next <= capacity && mTree[next] < remaining)
+        {
+            node = next;
+            remaining -= mTree[next];
+        }
+    }
+
+    return node;
+}
@@ -0,0 +1,45 @@
+#ifndef TRANSFERTAGINDEX_H
+#define TRANSFERTAGINDEX_H
+
+#include "TransferItem.h"
+
+#include <QHash>
+
+#include <vector>
+
+/// Responsability: keeps the tag <-> row relation of the TransfersModel rows without using persistent indexes.
+/// Every tag gets a slot in append order and a Fenwick tree counts the alive slots, so the row of a tag is the
+/// number of alive slots before it. Lookups, appends and removals are O(log n) and removing rows never needs
+/// to walk the rest of the rows. Dead slots are compacted when the slot array is full (amortized O(1)).
+/// The class is not thread safe, the owner must protect it.
+class TransferTagIndex
+{
+public:
+    TransferTagIndex();
+
+    void append(TransferTag tag);
+    bool remove(TransferTag tag);
+    void clear();
+
+    // Rebuilds the index from the tags ordered by row
+    void reset(const QList<TransferTag>& tagsByRow);
+
+    bool contains(TransferTag tag) const;
+    int rowOf(TransferTag tag) const;
+    TransferTag tagAt(int row) const;
+    int size() const;
+
+private:
+    void rebuild(int capacity);
+    void addToTree(int slot, int value);
+    int prefixCount(int slot) const;
+    int findSlotByRow(int row) const;
+
+    std::vector<TransferTag> mTagBySlot;
+    std::vector<int> mTree;
+    QHash<TransferTag, int> mSlotByTag;
+    int mUsedSlots;
+    int mHighestBit;
+};
+
+#endif // TRANSFERTAGINDEX_H
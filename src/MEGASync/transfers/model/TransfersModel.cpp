@@ -15,6 +15,7 @@
 #include "StatsEventHandler.h"
 
 #include <QSharedData>
+#include <QElapsedTimer>
 
 #include <algorithm>
 
@@ -22,7 +23,8 @@ using namespace mega;
 
 static const QModelIndex DEFAULT_IDX = QModelIndex();
 
-const int MAX_TRANSFERS = 2000;
+const size_t EVENTS_QUEUE_SIZE = 32768;
+const qint64 EVENTS_STATS_LOG_INTERVAL_MS = 60000;
 const int CANCEL_THRESHOLD_THREAD = 100;
 const int QUICK_CANCEL_THRESHOLD = 10000;
 const int QUICK_CANCEL_MIN_THRESHOLD = 300;
@@ -33,46 +35,85 @@ const int PAUSE_RESUME_THRESHOLD_THREAD = 300;
 const int CLEAR_THRESHOLD_THREAD = 300;
 
 //LISTENER THREAD
-TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
+TransferThread::TransferThread()
+    : mEvents(EVENTS_QUEUE_SIZE),
+      mCoalescedEvents(0),
+      mDroppedEvents(0),
+      mMaxTransfersToProcess(TransfersProcessScheduler::DEFAULT_BATCH_SIZE)
 {}
 
 TransferThread::TransfersToProcess TransferThread::processTransfers()
 {
-   TransfersToProcess transfers;
-   if(mCacheMutex.tryLock())
-   {
-       int spaceForTransfers(mMaxTransfersToProcess);
+   mEvents.drain([this](const TransferEvent& event){
+       onTransferEvent(event);
+   });
 
-       transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.canceledTransfersByTag.size();
+   TransfersToProcess transfers;
+   int spaceForTransfers(mMaxTransfersToProcess);
 
-       transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
+   transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.canceledTransfersByTag.size();
 
-       transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedTransfersByTag.size();
+   transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
 
-       transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startTransfersByTag.size();
+   transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.failedTransfersByTag.size();
 
-       transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startSyncTransfersByTag.size();
+   transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.startTransfersByTag.size();
 
-       transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
+   transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.startSyncTransfersByTag.size();
 
-       mCacheMutex.unlock();
-   }
+   transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
 
    return transfers;
 }
 
 void TransferThread::clear()
 {
-    QMutexLocker lock(&mCacheMutex);
+    mEvents.clear();
     mTransfersToProcess.clear();
+
+    QMutexLocker counterLock(&mCountersMutex);
     mTransfersCount.clear();
 }
 
+bool TransferThread::hasTransfersToProcess() const
+{
+    return mEvents.hasEvents()
+           || !mTransfersToProcess.updateTransfersByTag.isEmpty()
+           || !mTransfersToProcess.startTransfersByTag.isEmpty()
+           || !mTransfersToProcess.startSyncTransfersByTag.isEmpty()
+           || !mTransfersToProcess.canceledTransfersByTag.isEmpty()
+           || !mTransfersToProcess.failedFolderTransfersByTag.isEmpty()
+           || !mTransfersToProcess.failedTransfersByTag.isEmpty();
+}
+
+TransferThread::EventsStats TransferThread::getEventsStats() const
+{
+    auto queueStats(mEvents.getStats());
+
+    EventsStats stats;
+    stats.receivedEvents = queueStats.receivedEvents;
+    stats.coalescedEvents = mCoalescedEvents + queueStats.overflowCoalescedEvents;
+    stats.droppedEvents = mDroppedEvents;
+    stats.overflowedEvents = queueStats.overflowedEvents;
+    stats.overflowCoalescedEvents = queueStats.overflowCoalescedEvents;
+    stats.maxOverflowEvents = queueStats.maxOverflowEvents;
+    return stats;
+}
+
+void TransferThread::pushEvent(QExplicitlySharedDataPointer<TransferData> data, EventCache cache, bool updatesTempState)
+{
+    TransferEvent event;
+    event.data = data;
+    event.cache = cache;
+    event.updatesTempState = updatesTempState;
+    mEvents.push(std::move(event));
+}
+
 QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers)
 {
     if(!dataMap.isEmpty() && spaceForTransfers > 0)
@@ -113,95 +154,133 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::createData(MegaTransf
     return d;
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const QExplicitlySharedDataPointer<TransferData>& data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto it = dataMap.find(data->mTag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(transfer->getState() == mega::MegaTransfer::STATE_CANCELLED)
+        if(data->getState() == TransferData::TRANSFER_CANCELLED)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.erase(it);
+            mCoalescedEvents++;
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
-        {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
-        }
-
-        return item;
+        return checkIfRepeatedAndSubstitute(dataMap, data);
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const QExplicitlySharedDataPointer<TransferData>& data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto it = dataMap.find(data->mTag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        if(it.value()->mNotificationNumber < data->mNotificationNumber)
+        {
+            it.value() = data;
+            mCoalescedEvents++;
+        }
+        else
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            mDroppedEvents++;
         }
 
-        return item;
+        return it.value();
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const QExplicitlySharedDataPointer<TransferData>& data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto it = dataMap.find(data->mTag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        if(it.value()->mNotificationNumber < data->mNotificationNumber)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.erase(it);
+            mCoalescedEvents++;
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
-        return item;
+        mDroppedEvents++;
+        return it.value();
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::onTransferEvent(MegaTransfer *transfer, mega::MegaError* e)
+void TransferThread::onTransferEvent(const TransferEvent& event)
 {
-    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, transfer);
+    auto& data(event.data);
+    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, data);
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, transfer);
+        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, data);
     }
 
-    updateFailedTransfer(result, transfer, e);
+    if(result)
+    {
+        //The pending event keeps the failure info and the temp state of the latest one
+        if(!result->mFailedTransfer && data->mFailedTransfer)
+        {
+            result->mFailedTransfer = data->mFailedTransfer;
+        }
 
-    return result;
+        if(event.updatesTempState)
+        {
+            result->mIsTempTransfer = data->mIsTempTransfer;
+        }
+    }
+    else
+    {
+        switch(event.cache)
+        {
+            case EventCache::START:
+                mTransfersToProcess.startTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::START_SYNC:
+                mTransfersToProcess.startSyncTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::UPDATE:
+                mTransfersToProcess.updateTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::CANCELED:
+                mTransfersToProcess.canceledTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::FAILED_FOLDER:
+                mTransfersToProcess.failedFolderTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::FAILED:
+                mTransfersToProcess.failedTransfersByTag.insert(data->mTag, data);
+                break;
+            case EventCache::NONE:
+                break;
+        }
+    }
 }
 
 void TransferThread::updateFailedTransfer(QExplicitlySharedDataPointer<TransferData> data,
@@ -270,26 +349,9 @@ void TransferThread::onTransferStart(MegaApi *, MegaTransfer *transfer)
                 }
             }
 
-            {
-                QMutexLocker cacheLock(&mCacheMutex);
-                auto data = onTransferEvent(transfer,  nullptr);
-
-                if(!data)
-                {
-                    data = createData(transfer, nullptr);
-
-                    if(transfer->isSyncTransfer())
-                    {
-                        mTransfersToProcess.startSyncTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.startTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                }
-
-                data->mIsTempTransfer = isTemp;
-            }
+            auto data = createData(transfer, nullptr);
+            data->mIsTempTransfer = isTemp;
+            pushEvent(data, transfer->isSyncTransfer() ? EventCache::START_SYNC : EventCache::START, true);
         }
 
 }
@@ -321,17 +383,7 @@ void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-
-            if(!data)
-            {
-                data =  createData(transfer, nullptr);
-
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-            }
-        }
+        pushEvent(createData(transfer, nullptr), EventCache::UPDATE);
     }
 }
 
@@ -465,44 +517,38 @@ void TransferThread::onTransferFinish(MegaApi* megaApi, MegaTransfer *transfer,
                 return;
             }
 
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, e);
+            auto data = createData(transfer, e);
+            data->mIsTempTransfer = isTemp;
 
-            if(!data)
+            auto cache(EventCache::NONE);
+            if(transfer->isFolderTransfer())
             {
-                data =  createData(transfer, e);
-
-                if(transfer->isFolderTransfer())
+                if(transfer->getState() == MegaTransfer::STATE_FAILED
+                        || e->getErrorCode() != mega::MegaError::API_OK)
                 {
-                    if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        //In some scenarios, the error code can be different to API_OK but the state is not failed
-                        data->setState(TransferData::TRANSFER_FAILED);
-                        mTransfersToProcess.failedFolderTransfersByTag.insert(transfer->getTag(), data);
-                    }
+                    //In some scenarios, the error code can be different to API_OK but the state is not failed
+                    data->setState(TransferData::TRANSFER_FAILED);
+                    cache = EventCache::FAILED_FOLDER;
+                }
+            }
+            else
+            {
+                if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
+                {
+                    cache = EventCache::CANCELED;
+                }
+                else if(transfer->getState() == MegaTransfer::STATE_FAILED
+                        || e->getErrorCode() != mega::MegaError::API_OK)
+                {
+                    cache = EventCache::FAILED;
                 }
                 else
                 {
-                    if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
-                    {
-                        mTransfersToProcess.canceledTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        mTransfersToProcess.failedTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                    }
+                    cache = EventCache::UPDATE;
                 }
-
-                data->mIsTempTransfer = isTemp;
             }
 
-            data->mIsTempTransfer = isTemp;
+            pushEvent(data, cache, true);
         }
     }
 }
@@ -534,17 +580,9 @@ void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer,
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-            if(!data)
-            {
-                data =  createData(transfer, e);
-
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                data->mTemporaryError = true;
-            }
-        }
+        auto data = createData(transfer, e);
+        data->mTemporaryError = true;
+        pushEvent(data, EventCache::UPDATE);
     }
 }
 
@@ -809,7 +847,6 @@ void TransferThread::setMaxTransfersToProcess(uint16_t max)
 
 ///////////////// TRANSFERS MODEL //////////////////////////////////////////////
 
-const int PROCESS_TIMER = 100;
 const int RESET_AFTER_EMPTY_RECEIVES = 10;
 const int MODEL_HAS_CHANGED_AFTER_EMPTY_RECEIVES = 5;
 
@@ -817,6 +854,7 @@ TransfersModel::TransfersModel(QObject *parent) :
     QAbstractItemModel (parent),
     mMegaApi (MegaSyncApp->getMegaApi()),
     mPreferences (Preferences::instance()),
+    mLoggedReceivedEvents(0),
     mTransfersProcessChanged(0),
     mUpdateMostPriorityTransfer(0),
     mUiBlockedCounter(0),
@@ -844,9 +882,14 @@ TransfersModel::TransfersModel(QObject *parent) :
     //Update transfers state for the first time
     updateTransfersCount();
 
-    mProcessTransfersTimer.setInterval(PROCESS_TIMER);
+    //The Transfer Manager is hidden until the user opens it
+    mProcessScheduler.setDrainAtFullSpeed(true);
+    mTransferEventWorker->setMaxTransfersToProcess(mProcessScheduler.nextBatchSize());
+
+    mProcessTransfersTimer.setInterval(mProcessScheduler.nextInterval());
     QObject::connect(&mProcessTransfersTimer, &QTimer::timeout, this, &TransfersModel::onProcessTransfers);
     mProcessTransfersTimer.start();
+    mEventsStatsTimer.start();
 
     mTransferEventThread->start();
 
@@ -886,7 +929,17 @@ void TransfersModel::pauseModelProcessing(bool value)
     }
     else
     {
-        mProcessTransfersTimer.start(PROCESS_TIMER);
+        mProcessTransfersTimer.start(mProcessScheduler.nextInterval());
+    }
+}
+
+void TransfersModel::setTransferManagerVisible(bool state)
+{
+    //Nobody is looking at the rows, so process the transfers as fast as possible
+    mProcessScheduler.setDrainAtFullSpeed(!state);
+    if(!isUiBlockedByCounter())
+    {
+        mTransferEventWorker->setMaxTransfersToProcess(mProcessScheduler.nextBatchSize());
     }
 }
 
@@ -899,19 +952,19 @@ const QExplicitlySharedDataPointer<const TransferData> TransfersModel::activeDow
 {
     QExplicitlySharedDataPointer<const TransferData> foundTransfer;
 
-    auto transfers = getTransfersToIterate();
+    QReadLocker lock(&mDataMutex);
 
-    foreach(auto transfer, transfers)
+    auto row(mTransferColumns.findDownloadByNodeHandle(info->nodeHandle));
+    while(row >= 0)
     {
-        if(transfer && !transfer->isUpload())
+        auto& transfer(mTransfers.at(row));
+        if(transfer && transfer->isActiveOrPending())
         {
-            if(transfer->mNodeHandle == info->nodeHandle &&
-               transfer->isActiveOrPending())
-            {
-                foundTransfer = transfer;
-                break;
-            }
+            foundTransfer = transfer;
+            break;
         }
+
+        row = mTransferColumns.findDownloadByNodeHandle(info->nodeHandle, row + 1);
     }
 
     return foundTransfer;
@@ -921,21 +974,22 @@ const QExplicitlySharedDataPointer<const TransferData> TransfersModel::activeUpl
 {
     QExplicitlySharedDataPointer<const TransferData> foundTransfer;
 
-    auto transfers = getTransfersToIterate();
+    QReadLocker lock(&mDataMutex);
 
-    foreach(auto transfer, transfers)
+    auto row(mTransferColumns.findUploadByParentHandle(info->parentHandle));
+    while(row >= 0)
     {
-        if(transfer && transfer->isUpload())
+        auto& transfer(mTransfers.at(row));
+        if(transfer &&
+           transfer->mFilename.compare(info->filename, Qt::CaseSensitive) == 0 &&
+           transfer->path() == info->localPath &&
+           transfer->isActiveOrPending())
         {
-            if(transfer->mFilename.compare(info->filename, Qt::CaseSensitive) == 0 &&
-               transfer->mParentHandle == info->parentHandle &&
-               transfer->path() == info->localPath &&
-               transfer->isActiveOrPending())
-            {
-                foundTransfer = transfer;
-                break;
-            }
+            foundTransfer = transfer;
+            break;
         }
+
+        row = mTransferColumns.findUploadByParentHandle(info->parentHandle, row + 1);
     }
 
     return foundTransfer;
@@ -993,6 +1047,11 @@ QModelIndex TransfersModel::index(int row, int column, const QModelIndex&) const
 
 void TransfersModel::onProcessTransfers()
 {
+    QElapsedTimer passTimer;
+    passTimer.start();
+    int transfersInPass(0);
+    bool asynchronousProcessed(false);
+
     if(mTransfersToProcess.isEmpty())
     {
         mTransfersToProcess = mTransferEventWorker->processTransfers();
@@ -1002,8 +1061,6 @@ void TransfersModel::onProcessTransfers()
     {
         mostPriorityTransferMayChanged(true);
 
-        bool asynchronousProcessed(false);
-
         int containsTransfersToStart(mTransfersToProcess.startTransfersByTag.size());
         int containsSyncTransfersToStart(mTransfersToProcess.startSyncTransfersByTag.size());
         int containsTransfersToUpdate(mTransfersToProcess.updateTransfersByTag.size());
@@ -1011,6 +1068,9 @@ void TransfersModel::onProcessTransfers()
         int containsFolderTransfersFailed(mTransfersToProcess.failedFolderTransfersByTag.size());
         int containsTransfersFailed(mTransfersToProcess.failedTransfersByTag.size());
 
+        transfersInPass = containsTransfersToStart + containsSyncTransfersToStart + containsTransfersToUpdate
+                          + containsTransfersToCancel + containsFolderTransfersFailed + containsTransfersFailed;
+
         if(containsTransfersToCancel > 0)
         {            
             cacheCancelTransfersTags();
@@ -1167,6 +1227,52 @@ void TransfersModel::onProcessTransfers()
             mostPriorityTransferMayChanged(false);
         }
     }
+
+    scheduleNextProcessTransfers(transfersInPass, passTimer.nsecsElapsed() / 1000, asynchronousProcessed);
+}
+
+void TransfersModel::scheduleNextProcessTransfers(int transfersInPass, qint64 elapsedUs, bool asynchronousProcessed)
+{
+    //The asynchronous passes do not run on the GUI thread, so they do not tell the cost of a transfer
+    mProcessScheduler.passFinished(asynchronousProcessed ? 0 : transfersInPass,
+                                   std::chrono::microseconds(elapsedUs),
+                                   !mTransfersToProcess.isEmpty() || mTransferEventWorker->hasTransfersToProcess());
+
+    //When the UI is blocked by counter, the batch size is forced until all the pending updates arrive
+    if(!isUiBlockedByCounter())
+    {
+        mTransferEventWorker->setMaxTransfersToProcess(mProcessScheduler.nextBatchSize());
+    }
+
+    auto interval(static_cast<int>(mProcessScheduler.nextInterval().count()));
+    if(mProcessTransfersTimer.isActive() && mProcessTransfersTimer.interval() != interval)
+    {
+        mProcessTransfersTimer.setInterval(interval);
+    }
+
+    logTransferEventsStats();
+}
+
+void TransfersModel::logTransferEventsStats()
+{
+    if(mEventsStatsTimer.elapsed() < EVENTS_STATS_LOG_INTERVAL_MS)
+    {
+        return;
+    }
+    mEventsStatsTimer.restart();
+
+    auto stats(mTransferEventWorker->getEventsStats());
+    if(stats.receivedEvents == mLoggedReceivedEvents)
+    {
+        return;
+    }
+    mLoggedReceivedEvents = stats.receivedEvents;
+
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Transfer events: %1 received, %2 coalesced, %3 dropped, "
+                                                             "%4 overflowed (%5 coalesced in the overflow list, %6 max pending)")
+                 .arg(stats.receivedEvents).arg(stats.coalescedEvents).arg(stats.droppedEvents)
+                 .arg(stats.overflowedEvents).arg(stats.overflowCoalescedEvents).arg(stats.maxOverflowEvents)
+                 .toUtf8().constData());
 }
 
 void TransfersModel::processStartTransfers(QList<QExplicitlySharedDataPointer<TransferData>>& transfersToStart)
@@ -1227,6 +1333,7 @@ void TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> t
 
     mDataMutex.lockForWrite();
     mTransfers[row] = transfer;
+    mTransferColumns.update(row, *transfer);
     mDataMutex.unlock();
 }
 
@@ -1327,16 +1434,17 @@ void TransfersModel::processCancelTransfers()
         if(indexesToCancel.size() >= QUICK_CANCEL_THRESHOLD
                 || (indexesToCancel.size() >  QUICK_CANCEL_MIN_THRESHOLD && cancelledPercentage > QUICK_CANCEL_PERCENTAGE_THRESHOLD))
         {
-            std::sort(indexesToCancel.begin(), indexesToCancel.end(),[](QModelIndex check1, QModelIndex check2){
-                return check1.row() > check2.row();
-            });
-
+            QSet<TransferTag> tagsToCancel;
             foreach(auto& index, indexesToCancel)
             {
-                removeTransfer(index.row());
+                auto transfer(getTransfer(index.row()));
+                if(transfer)
+                {
+                    tagsToCancel.insert(transfer->mTag);
+                }
             }
 
-            restoreTagsByRow();
+            removeTransfersByTag(tagsToCancel);
         }
         else
         {
@@ -2407,27 +2515,54 @@ QExplicitlySharedDataPointer<TransferData> TransfersModel::getTransferByTag(int
 
 int TransfersModel::getRowByTransferTag(int tag) const
 {
-    auto result = mTagByOrder.contains(tag) ? mTagByOrder.value(tag).row() : -1;
-    return result;
+    QReadLocker lock(&mDataMutex);
+    return mTagIndex.rowOf(tag);
 }
 
 void TransfersModel::addTransfer(QExplicitlySharedDataPointer<TransferData> transfer)
 {
     mDataMutex.lockForWrite();
     mTransfers.append(transfer);
+    mTagIndex.append(transfer->mTag);
+    mTransferColumns.append(*transfer);
     mDataMutex.unlock();
+}
 
-    mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(rowCount(DEFAULT_IDX) - 1,0)));
+void TransfersModel::removeTransfers(int row, int count)
+{
+    mDataMutex.lockForWrite();
+    if(row >= 0 && count > 0 && row + count <= mTransfers.size())
+    {
+        auto first(mTransfers.begin() + row);
+        auto last(first + count);
+        for(auto it = first; it != last; ++it)
+        {
+            mTagIndex.remove((*it)->mTag);
+        }
+        mTransfers.erase(first, last);
+        mTransferColumns.remove(row, count);
+    }
+    mDataMutex.unlock();
 }
 
-void TransfersModel::removeTransfer(int row)
+void TransfersModel::removeTransfersByTag(const QSet<TransferTag>& tags)
 {
+    //For large amount of transfers: a single pass over the rows and the tag index is rebuilt from scratch
     mDataMutex.lockForWrite();
-    if(row >= 0  && row < mTransfers.size())
+    auto newEnd = std::remove_if(mTransfers.begin(), mTransfers.end(),
+                                 [&tags](const QExplicitlySharedDataPointer<TransferData>& transfer){
+        return tags.contains(transfer->mTag);
+    });
+    mTransfers.erase(newEnd, mTransfers.end());
+
+    QList<TransferTag> tagsByRow;
+    tagsByRow.reserve(mTransfers.size());
+    for(const auto& transfer : qAsConst(mTransfers))
     {
-        auto transfer = mTransfers.takeAt(row);
-        mTagByOrder.remove(transfer->mTag);
+        tagsByRow.append(transfer->mTag);
     }
+    mTagIndex.reset(tagsByRow);
+    mTransferColumns.reset(mTransfers);
     mDataMutex.unlock();
 }
 
@@ -2448,19 +2583,6 @@ void TransfersModel::sendDataChanged(int row)
     }
 }
 
-void TransfersModel::restoreTagsByRow()
-{
-    mTagByOrder.clear();
-    for(int row = 0; row < rowCount(); ++row)
-    {
-        auto transfer = getTransfer(row);
-        if(transfer)
-        {
-            mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(row,0)));
-        }
-    }
-}
-
 QList<QExplicitlySharedDataPointer<TransferData> > TransfersModel::getTransfersToIterate() const
 {
     mDataMutex.lockForRead();
@@ -2522,7 +2644,7 @@ void TransfersModel::setUiBlockedModeByCounter(uint32_t transferCount)
         emit blockUi();
         setUiBlockedByCounterMode(true);
         mUiBlockedByCounter = transferCount;
-        mTransferEventWorker->setMaxTransfersToProcess(20000);
+        mTransferEventWorker->setMaxTransfersToProcess(TransfersProcessScheduler::MAX_BATCH_SIZE);
     }
     else if(transferCount == 0)
     {
@@ -2545,7 +2667,7 @@ void TransfersModel::updateUiBlockedByCounter(int updates)
 
         if(mUiBlockedByCounter == 0)
         {
-            mTransferEventWorker->setMaxTransfersToProcess(MAX_TRANSFERS);
+            mTransferEventWorker->setMaxTransfersToProcess(mProcessScheduler.nextBatchSize());
             emit unblockUiAndFilter();
         }
     }
@@ -2642,12 +2764,7 @@ bool TransfersModel::removeRows(int row, int count, const QModelIndex& parent)
     if (parent == DEFAULT_IDX && count > 0 && row >= 0)
     {
         beginRemoveRows(DEFAULT_IDX, row, row + count - 1);
-
-        for (auto i (0); i < count; ++i)
-        {
-            removeTransfer(row);
-        }
-
+        removeTransfers(row, count);
         endRemoveRows();
 
         return true;
@@ -2766,10 +2883,12 @@ void TransfersModel::resetModel()
     mTransfersProcessChanged = 0;
     mUpdateMostPriorityTransfer = 0;
     mUiBlockedCounter = 0;
+    mProcessScheduler.reset();
 
     mDataMutex.lockForWrite();
     mTransfers.clear();
-    mTagByOrder.clear();
+    mTagIndex.clear();
+    mTransferColumns.clear();
     mDataMutex.unlock();
 
     endResetModel();
@@ -5,7 +5,11 @@
 #include "TransferItem.h"
 #include "TransferMetaData.h"
 #include "TransferRemainingTime.h"
+#include "TransferTagIndex.h"
+#include "TransferColumns.h"
+#include "TransfersProcessScheduler.h"
 #include "Preferences.h"
+#include "TransferEventQueue.h"
 
 #include <megaapi.h>
 
@@ -14,6 +18,7 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QFutureWatcher>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
 
 #include <set>
 #include <memory>
@@ -118,6 +123,22 @@ public:
         }
     };
 
+    //Counters of the events received from the SDK, for profiling purposes
+    struct EventsStats
+    {
+        uint64_t receivedEvents = 0;
+        //Events merged into a pending event of the same transfer (the latest one wins)
+        uint64_t coalescedEvents = 0;
+        //Events dropped because a newer event of the same transfer was already pending
+        uint64_t droppedEvents = 0;
+        //Events that did not fit in the lock-free queue and went through the overflow list
+        uint64_t overflowedEvents = 0;
+        //Updates merged in the overflow list with a pending update of the same transfer
+        uint64_t overflowCoalescedEvents = 0;
+        //Largest size of the overflow list
+        uint64_t maxOverflowEvents = 0;
+    };
+
     TransferThread();
     ~TransferThread(){}
 
@@ -131,9 +152,12 @@ public:
     void setMaxTransfersToProcess(uint16_t max);
 
     TransfersToProcess processTransfers();
+    bool hasTransfersToProcess() const;
     void clear();
     void clearTransfersCount();
 
+    EventsStats getEventsStats() const;
+
 public slots:
     void onTransferStart(mega::MegaApi*, mega::MegaTransfer* transfer);
     void onTransferFinish(mega::MegaApi* megaApi, mega::MegaTransfer* transfer, mega::MegaError* e);
@@ -149,12 +173,16 @@ private:
     void updateFailedTransfer(QExplicitlySharedDataPointer<TransferData> data, mega::MegaTransfer* transfer,
                               mega::MegaError* e);
 
+    using EventCache = TransferEventQueue::Cache;
+    using TransferEvent = TransferEventQueue::Event;
+
     QExplicitlySharedDataPointer<TransferData> createData(mega::MegaTransfer* transfer, mega::MegaError *e);
-    QExplicitlySharedDataPointer<TransferData> onTransferEvent(mega::MegaTransfer* transfer, mega::MegaError *e);
+    void pushEvent(QExplicitlySharedDataPointer<TransferData> data, EventCache cache, bool updatesTempState = false);
+    void onTransferEvent(const TransferEvent& event);
     QList<QExplicitlySharedDataPointer<TransferData>> extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, mega::MegaTransfer *transfer);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const QExplicitlySharedDataPointer<TransferData>& data);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const QExplicitlySharedDataPointer<TransferData>& data);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, const QExplicitlySharedDataPointer<TransferData>& data);
 
     struct cacheTransfers
     {
@@ -176,8 +204,14 @@ private:
         }
     };
 
+    //Only accessed from the thread that processes the transfers (the GUI thread)
     cacheTransfers mTransfersToProcess;
-    QMutex mCacheMutex;
+
+    TransferEventQueue mEvents;
+
+    std::atomic<uint64_t> mCoalescedEvents;
+    std::atomic<uint64_t> mDroppedEvents;
+
     QMutex mCountersMutex;
     TransfersCount mTransfersCount;
     LastTransfersCount mLastTransfersCount;
@@ -275,6 +309,7 @@ public:
     void updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row);
 
     void pauseModelProcessing(bool value);
+    void setTransferManagerVisible(bool state);
 
     bool areAllPaused() const;
 
@@ -345,9 +380,9 @@ private:
     void removeRows(QModelIndexList &indexesToRemove);
     QExplicitlySharedDataPointer<TransferData> getTransfer(int row) const;
     void addTransfer(QExplicitlySharedDataPointer<TransferData>);
-    void removeTransfer(int row);
+    void removeTransfers(int row, int count);
+    void removeTransfersByTag(const QSet<TransferTag>& tags);
     void sendDataChanged(int row);
-    void restoreTagsByRow();
     QList<QExplicitlySharedDataPointer<TransferData>> getTransfersToIterate() const;
 
     void retryTransfers(const QMultiMap<unsigned long long, QExplicitlySharedDataPointer<TransferData>> &transfersToRetry);
@@ -361,6 +396,8 @@ private:
     void setUiBlockedByCounterMode(bool state);
 
     void modelHasChanged(bool state);
+    void scheduleNextProcessTransfers(int transfersInPass, qint64 elapsedUs, bool asynchronousProcessed);
+    void logTransferEventsStats();
 
     void mostPriorityTransferMayChanged(bool state);
 
@@ -378,6 +415,9 @@ private:
     TransferThread* mTransferEventWorker;
     mega::QTMegaTransferListener *mDelegateListener;
     QTimer mProcessTransfersTimer;
+    TransfersProcessScheduler mProcessScheduler;
+    QElapsedTimer mEventsStatsTimer;
+    uint64_t mLoggedReceivedEvents;
     TransfersCount mTransfersCount;
     LastTransfersCount mLastTransfersCount;
 
@@ -397,7 +437,8 @@ private:
     int mUiBlockedByCounter;
     uint8_t  mUiBlockedByCounterSafety;
 
-    QHash<TransferTag, QPersistentModelIndex> mTagByOrder;
+    TransferTagIndex mTagIndex;
+    TransferColumns mTransferColumns;
     QList<TransferTag> mRowsToCancel;
     QPointer<QWidget> mCancelledFrom;
     bool mSyncsInRowsToCancel;
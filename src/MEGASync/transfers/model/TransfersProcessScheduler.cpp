@@ -0,0 +1,96 @@
+#include "TransfersProcessScheduler.h"
+
+#include <algorithm>
+
+constexpr int TransfersProcessScheduler::MIN_BATCH_SIZE;
+constexpr int TransfersProcessScheduler::MAX_BATCH_SIZE;
+constexpr int TransfersProcessScheduler::DEFAULT_BATCH_SIZE;
+constexpr std::chrono::milliseconds TransfersProcessScheduler::DEFAULT_FRAME_BUDGET;
+constexpr std::chrono::milliseconds TransfersProcessScheduler::IDLE_INTERVAL;
+constexpr std::chrono::milliseconds TransfersProcessScheduler::MIN_INTERVAL;
+
+// Weight of the last measure in the moving average
+const double COST_SMOOTHING_FACTOR = 0.3;
+
+TransfersProcessScheduler::TransfersProcessScheduler()
+    : mFrameBudget(DEFAULT_FRAME_BUDGET),
+      mDrainAtFullSpeed(false),
+      mPendingTransfers(false),
+      mCostPerTransferUs(-1.0),
+      mLastPassElapsed(0)
+{
+}
+
+void TransfersProcessScheduler::setFrameBudget(std::chrono::milliseconds budget)
+{
+    mFrameBudget = std::max(budget, std::chrono::milliseconds(1));
+}
+
+std::chrono::milliseconds TransfersProcessScheduler::frameBudget() const
+{
+    return mFrameBudget;
+}
+
+void TransfersProcessScheduler::setDrainAtFullSpeed(bool state)
+{
+    mDrainAtFullSpeed = state;
+}
+
+bool TransfersProcessScheduler::drainAtFullSpeed() const
+{
+    return mDrainAtFullSpeed;
+}
+
+void TransfersProcessScheduler::passFinished(int processedTransfers, std::chrono::microseconds elapsed, bool pendingTransfers)
+{
+    mPendingTransfers = pendingTransfers;
+    mLastPassElapsed = elapsed;
+
+    if(processedTransfers > 0)
+    {
+        auto cost(static_cast<double>(elapsed.count()) / processedTransfers);
+        mCostPerTransferUs = mCostPerTransferUs < 0.0 ? cost
+                                                      : COST_SMOOTHING_FACTOR * cost + (1.0 - COST_SMOOTHING_FACTOR) * mCostPerTransferUs;
+    }
+}
+
+int TransfersProcessScheduler::nextBatchSize() const
+{
+    if(mDrainAtFullSpeed)
+    {
+        return MAX_BATCH_SIZE;
+    }
+
+    if(mCostPerTransferUs <= 0.0)
+    {
+        return DEFAULT_BATCH_SIZE;
+    }
+
+    auto budgetUs(std::chrono::duration_cast<std::chrono::microseconds>(mFrameBudget).count());
+    auto batch(static_cast<long long>(budgetUs / mCostPerTransferUs));
+    return static_cast<int>(std::min<long long>(std::max<long long>(batch, MIN_BATCH_SIZE), MAX_BATCH_SIZE));
+}
+
+std::chrono::milliseconds TransfersProcessScheduler::nextInterval() const
+{
+    if(!mPendingTransfers)
+    {
+        return IDLE_INTERVAL;
+    }
+
+    if(mDrainAtFullSpeed)
+    {
+        return MIN_INTERVAL;
+    }
+
+    // Give back to the event loop at least the time the last pass took
+    auto lastPass(std::chrono::duration_cast<std::chrono::milliseconds>(mLastPassElapsed));
+    return std::min(std::max(lastPass, MIN_INTERVAL), IDLE_INTERVAL);
+}
+
+void TransfersProcessScheduler::reset()
+{
+    mPendingTransfers = false;
+    mCostPerTransferUs = -1.0;
+    mLastPassElapsed = std::chrono::microseconds(0);
+}
@@ -0,0 +1,45 @@
+#ifndef TRANSFERSPROCESSSCHEDULER_H
+#define TRANSFERSPROCESSSCHEDULER_H
+
+#include <chrono>
+
+/// Responsability: sizes the batches of transfers processed by the TransfersModel on the GUI thread and the
+/// interval between them. It measures how long each pass takes and keeps a moving average of the cost per
+/// transfer, so the next batch fits in the frame budget. While there are transfers waiting the passes are
+/// chained faster, leaving the GUI thread at least as much idle time as the last pass took. When nobody is
+/// looking at the transfers (Transfer Manager hidden) the batches are as big as possible.
+class TransfersProcessScheduler
+{
+public:
+    static constexpr int MIN_BATCH_SIZE = 50;
+    static constexpr int MAX_BATCH_SIZE = 20000;
+    static constexpr int DEFAULT_BATCH_SIZE = 2000;
+    static constexpr std::chrono::milliseconds DEFAULT_FRAME_BUDGET{8};
+    static constexpr std::chrono::milliseconds IDLE_INTERVAL{100};
+    static constexpr std::chrono::milliseconds MIN_INTERVAL{10};
+
+    TransfersProcessScheduler();
+
+    void setFrameBudget(std::chrono::milliseconds budget);
+    std::chrono::milliseconds frameBudget() const;
+
+    void setDrainAtFullSpeed(bool state);
+    bool drainAtFullSpeed() const;
+
+    void passFinished(int processedTransfers, std::chrono::microseconds elapsed, bool pendingTransfers);
+
+    int nextBatchSize() const;
+    std::chrono::milliseconds nextInterval() const;
+
+    void reset();
+
+private:
+    std::chrono::milliseconds mFrameBudget;
+    bool mDrainAtFullSpeed;
+    bool mPendingTransfers;
+    // Moving average, negative until the first measure
+    double mCostPerTransferUs;
+    std::chrono::microseconds mLastPassElapsed;
+};
+
+#endif // TRANSFERSPROCESSSCHEDULER_H
@@ -9,6 +9,10 @@ set(DESKTOP_APP_TRANSFERS_HEADERS
     transfers/model/TransfersManagerSortFilterProxyModel.h
     transfers/model/TransfersSortFilterProxyBaseModel.h
     transfers/model/TransfersModel.h
+    transfers/model/TransferTagIndex.h
+    transfers/model/TransferColumns.h
+    transfers/model/TransfersProcessScheduler.h
+    transfers/model/TransferEventQueue.h
     transfers/model/TransferMetaData.h
     transfers/gui/SomeIssuesOccurredMessage.h
     transfers/gui/InfoDialogTransferDelegateWidget.h
@@ -29,6 +33,10 @@ set(DESKTOP_APP_TRANSFERS_HEADERS
 
 set(DESKTOP_APP_TRANSFERS_SOURCES
     transfers/model/TransfersModel.cpp
+    transfers/model/TransferTagIndex.cpp
+    transfers/model/TransferColumns.cpp
+    transfers/model/TransfersProcessScheduler.cpp
+    transfers/model/TransferEventQueue.cpp
     transfers/gui/DuplicatedNodeDialogs/DuplicatedNodeDialog.cpp
     transfers/gui/DuplicatedNodeDialogs/DuplicatedNodeInfo.cpp
     transfers/gui/DuplicatedNodeDialogs/DuplicatedNodeItem.cpp
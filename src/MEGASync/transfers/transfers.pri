@@ -4,6 +4,10 @@ INCLUDEPATH += $$PWD/model
 INCLUDEPATH += $$PWD/gui
 
 SOURCES += $$PWD/model/TransfersModel.cpp \
+           $$PWD/model/TransferTagIndex.cpp \
+           $$PWD/model/TransferColumns.cpp \
+           $$PWD/model/TransfersProcessScheduler.cpp \
+           $$PWD/model/TransferEventQueue.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeDialog.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeInfo.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeItem.cpp \
@@ -37,6 +41,10 @@ HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
            $$PWD/model/TransfersManagerSortFilterProxyModel.h \
            $$PWD/model/TransfersSortFilterProxyBaseModel.h \
            $$PWD/model/TransfersModel.h \
+           $$PWD/model/TransferTagIndex.h \
+           $$PWD/model/TransferColumns.h \
+           $$PWD/model/TransfersProcessScheduler.h \
+           $$PWD/model/TransferEventQueue.h \
            $$PWD/model/TransferMetaData.h \
            $$PWD/gui/SomeIssuesOccurredMessage.h \
            $$PWD/gui/InfoDialogTransferDelegateWidget.h \
@@ -0,0 +1,197 @@
+#include <catch.hpp>
+#include "mega_state_cache.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+class StateCache
+{
+public:
+    explicit StateCache(guint maxSize) : mCache(mega_state_cache_new(maxSize)) {}
+    ~StateCache()
+    {
+        mega_state_cache_free(mCache);
+    }
+
+    MEGAStateCache* get() const
+    {
+        return mCache;
+    }
+
+    bool lookup(const std::string& path, FileState& state)
+    {
+        return mega_state_cache_lookup(mCache, path.c_str(), &state);
+    }
+
+private:
+    MEGAStateCache* mCache;
+};
+}
+
+TEST_CASE("State cache discards the least recently used paths")
+{
+    StateCache cache(3);
+    FileState state;
+
+    mega_state_cache_insert(cache.get(), "/sync/a", RESPONSE_SYNCED);
+    mega_state_cache_insert(cache.get(), "/sync/b", RESPONSE_PENDING);
+    mega_state_cache_insert(cache.get(), "/sync/c", RESPONSE_SYNCING);
+    REQUIRE(cache.lookup("/sync/a", state));
+    REQUIRE(state == RESPONSE_SYNCED);
+
+    mega_state_cache_insert(cache.get(), "/sync/d", RESPONSE_IGNORED);
+    REQUIRE(mega_state_cache_size(cache.get()) == 3);
+    REQUIRE(!cache.lookup("/sync/b", state));
+    REQUIRE(cache.lookup("/sync/a", state));
+    REQUIRE(cache.lookup("/sync/c", state));
+    REQUIRE(cache.lookup("/sync/d", state));
+    REQUIRE(state == RESPONSE_IGNORED);
+
+    mega_state_cache_insert(cache.get(), "/sync/a", RESPONSE_PENDING);
+    REQUIRE(mega_state_cache_size(cache.get()) == 3);
+    REQUIRE(cache.lookup("/sync/a", state));
+    REQUIRE(state == RESPONSE_PENDING);
+}
+
+TEST_CASE("State cache removes folders with everything inside them")
+{
+    StateCache cache(10);
+    FileState state;
+
+    mega_state_cache_insert(cache.get(), "/sync", RESPONSE_SYNCED);
+    mega_state_cache_insert(cache.get(), "/sync/folder", RESPONSE_SYNCED);
+    mega_state_cache_insert(cache.get(), "/sync/folder/file", RESPONSE_SYNCED);
+    mega_state_cache_insert(cache.get(), "/sync/folder2", RESPONSE_SYNCED);
+
+    mega_state_cache_remove_tree(cache.get(), "/sync/folder/");
+    REQUIRE(!cache.lookup("/sync/folder", state));
+    REQUIRE(!cache.lookup("/sync/folder/file", state));
+    REQUIRE(cache.lookup("/sync", state));
+    REQUIRE(cache.lookup("/sync/folder2", state));
+
+    mega_state_cache_remove(cache.get(), "/sync");
+    REQUIRE(!cache.lookup("/sync", state));
+    REQUIRE(cache.lookup("/sync/folder2", state));
+
+    mega_state_cache_clear(cache.get());
+    REQUIRE(mega_state_cache_size(cache.get()) == 0);
+}
+
+// The server changes the states and notifies them in bursts, like the notify server does while syncing.
+// After each burst is delivered, the cache must not return any state older than the server one.
+TEST_CASE("State cache never returns stale states after a burst of notifications")
+{
+    constexpr int SYNCS{3};
+    constexpr int FOLDERS_PER_SYNC{20};
+    constexpr int FILES_PER_FOLDER{50};
+    constexpr int ROUNDS{200};
+    const std::vector<FileState> states{RESPONSE_SYNCED, RESPONSE_PENDING, RESPONSE_SYNCING, RESPONSE_IGNORED,
+                                        RESPONSE_PAUSED, RESPONSE_DEFAULT};
+
+    std::vector<std::string> syncs;
+    std::vector<std::string> paths;
+    for (int sync = 0; sync < SYNCS; ++sync)
+    {
+        syncs.push_back("/home/user/sync" + std::to_string(sync));
+        paths.push_back(syncs.back());
+        for (int folder = 0; folder < FOLDERS_PER_SYNC; ++folder)
+        {
+            auto folderPath(syncs.back() + "/folder" + std::to_string(folder));
+            paths.push_back(folderPath);
+            for (int file = 0; file < FILES_PER_FOLDER; ++file)
+            {
+                paths.push_back(folderPath + "/file" + std::to_string(file));
+            }
+        }
+    }
+
+    std::map<std::string, FileState> serverStates;
+    for (const auto& path : paths)
+    {
+        serverStates[path] = RESPONSE_SYNCED;
+    }
+
+    // Smaller than the paths, to discard some of them while the notifications are received
+    StateCache cache(static_cast<guint>(paths.size() / 2));
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> randomPath(0, paths.size() - 1);
+    std::uniform_int_distribution<size_t> randomState(0, states.size() - 1);
+    std::uniform_int_distribution<int> randomBurst(1, 500);
+
+    auto query = [&](const std::string& path)
+    {
+        FileState state;
+        if (cache.lookup(path, state))
+        {
+            return state;
+        }
+        state = serverStates[path];
+        mega_state_cache_insert(cache.get(), path.c_str(), state);
+        return state;
+    };
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        // The file manager shows some entries
+        for (int view = 0; view < 1000; ++view)
+        {
+            query(paths[randomPath(random)]);
+        }
+
+        // The server changes some states, the notifications are delivered afterwards in the same order
+        std::vector<std::pair<char, std::string>> notifications;
+        int burst(randomBurst(random));
+        for (int change = 0; change < burst; ++change)
+        {
+            const auto& path(paths[randomPath(random)]);
+            auto state(states[randomState(random)]);
+            serverStates[path] = state;
+            notifications.emplace_back('P', path);
+            // Some entries are shown before the notifications are received
+            query(paths[randomPath(random)]);
+
+            if (round % 10 == 0 && change == 0)
+            {
+                // A sync is removed and added again, every state inside it changes
+                const auto& sync(syncs[random() % syncs.size()]);
+                for (auto& pathState : serverStates)
+                {
+                    if (pathState.first.compare(0, sync.size(), sync) == 0)
+                    {
+                        pathState.second = states[randomState(random)];
+                    }
+                }
+                notifications.emplace_back('D', sync);
+                notifications.emplace_back('A', sync);
+            }
+        }
+
+        for (const auto& notification : notifications)
+        {
+            bool isSync(std::find(syncs.begin(), syncs.end(), notification.second) != syncs.end());
+            if (notification.first == 'P' && !isSync)
+            {
+                mega_state_cache_remove(cache.get(), notification.second.c_str());
+            }
+            else
+            {
+                mega_state_cache_remove_tree(cache.get(), notification.second.c_str());
+            }
+        }
+
+        for (const auto& path : paths)
+        {
+            FileState state;
+            if (cache.lookup(path, state))
+            {
+                REQUIRE(state == serverStates[path]);
+            }
+        }
+        REQUIRE(mega_state_cache_size(cache.get()) <= paths.size() / 2);
+    }
+}
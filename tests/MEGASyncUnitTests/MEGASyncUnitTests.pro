@@ -10,5 +10,36 @@ include(../3rdparty/catch/catch.pri)
 include(../3rdparty/trompeloeil/trompeloeil.pri)
 SOURCES += Utilities.test.cpp \
            control/TransferRemainingTime.Test.cpp \
+           control/MegaSyncLogger.Test.cpp \
+           control/LockFreeQueue.Test.cpp \
+           control/HTTPRequestParser.Test.cpp \
+           control/WebTransferProgressTable.Test.cpp \
+           control/ThreadPool.Test.cpp \
+           control/FolderSizeScanner.Test.cpp \
+           control/LocalAttributesScanner.Test.cpp \
+           control/DebrisCleaner.Test.cpp \
+           control/ResourceUsageSampler.Test.cpp \
+           control/EncryptedSettings.Test.cpp \
+           control/MergeMEGAFoldersPlan.Test.cpp \
+           control/UniqueNameIndex.Test.cpp \
+           control/LinkImportPlanner.Test.cpp \
+           transfers/TransferTagIndex.Test.cpp \
+           transfers/TransfersProcessScheduler.Test.cpp \
+           transfers/TransferEventQueue.Test.cpp \
+           transfers/TransferMetaData.Test.cpp \
+           transfers/TransferColumns.Test.cpp \
+           transfers/TransferData.Test.cpp \
+           stalled_issues/StalledIssuesDiff.Test.cpp \
+           syncs/MegaIgnoreRuleSet.Test.cpp \
+           platform/CoalescingShellNotifier.Test.cpp \
            ScaleFactorManager.Test.cpp \
            main.cpp
+
+unix:!macx {
+    SOURCES += platform/linux/ExtServer.Test.cpp \
+               MEGAShellExtNautilus/mega_state_cache.Test.cpp \
+               ../../src/MEGAShellExtNautilus/mega_state_cache.c
+    INCLUDEPATH += ../../src/MEGAShellExtNautilus
+    CONFIG += link_pkgconfig
+    PKGCONFIG += glib-2.0
+}
@@ -0,0 +1,174 @@
+#include <catch.hpp>
+#include "DebrisCleaner.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <algorithm>
+#include <memory>
+
+namespace
+{
+// Day folders with files, as the SDK leaves them in the debris
+void createDebris(const QString& debrisPath, const QStringList& dayFolders, int folders, int filesPerFolder)
+{
+    for (const auto& dayFolder : dayFolders)
+    {
+        for (int folder = 0; folder < folders; ++folder)
+        {
+            auto folderPath(QString::fromUtf8("%1/%2/folder%3").arg(debrisPath, dayFolder).arg(folder));
+            REQUIRE(QDir().mkpath(folderPath));
+            for (int file = 0; file < filesPerFolder; ++file)
+            {
+                QFile debrisFile(folderPath + QString::fromUtf8("/file%1").arg(file));
+                REQUIRE(debrisFile.open(QIODevice::WriteOnly));
+                debrisFile.write("debris");
+            }
+        }
+    }
+}
+
+struct CleanResult
+{
+    bool finished = false;
+    long long removedEntries = 0;
+    // Longest time the event loop did not process a 5 ms timer
+    qint64 maxEventLoopDelayMs = 0;
+    qint64 elapsedMs = 0;
+};
+
+CleanResult cleanAndWait(DebrisCleaner& cleaner, const QStringList& debrisFolders, int daysLimit)
+{
+    CleanResult result;
+    QEventLoop loop;
+    QObject::connect(&cleaner, &DebrisCleaner::finished, &loop, [&](long long removedEntries)
+    {
+        result.finished = true;
+        result.removedEntries = removedEntries;
+        loop.quit();
+    });
+
+    QElapsedTimer sinceLastTick;
+    QTimer ticks;
+    QObject::connect(&ticks, &QTimer::timeout, &loop, [&]()
+    {
+        result.maxEventLoopDelayMs = std::max(result.maxEventLoopDelayMs, sinceLastTick.restart());
+    });
+    QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    sinceLastTick.start();
+    ticks.start(5);
+    cleaner.clean(debrisFolders, daysLimit);
+    loop.exec();
+    result.elapsedMs = elapsed.elapsed();
+    return result;
+}
+}
+
+TEST_CASE("DebrisCleaner removes the debris without blocking the event loop")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QStringList debrisFolders{root.filePath(QLatin1String("sync1/.debris")),
+                                    root.filePath(QLatin1String("sync2/.debris"))};
+    for (const auto& debrisFolder : debrisFolders)
+    {
+        createDebris(debrisFolder, QStringList() << QLatin1String("2020-01-01") << QLatin1String("tmp"), 20, 100);
+    }
+
+    DebrisCleaner cleaner(0);
+    auto result(cleanAndWait(cleaner, debrisFolders, DebrisCleaner::ALL_FOLDERS));
+
+    REQUIRE(result.finished);
+    // Files and folders of both day folders
+    REQUIRE(result.removedEntries == 2 * (20 * 100 + 20 + 1));
+    REQUIRE(result.maxEventLoopDelayMs < 100);
+    REQUIRE(!cleaner.isCleaning());
+    for (const auto& debrisFolder : debrisFolders)
+    {
+        REQUIRE(QDir(debrisFolder).entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden)
+                == QStringList(QLatin1String("tmp")));
+    }
+}
+
+TEST_CASE("DebrisCleaner finishes the removals interrupted by a restart")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString debrisFolder(root.filePath(QLatin1String(".debris")));
+    createDebris(debrisFolder, QStringList() << QLatin1String(".removing-2020-01-01") << QLatin1String("2020-01-02"),
+                 2, 10);
+
+    DebrisCleaner cleaner(0);
+    auto result(cleanAndWait(cleaner, QStringList(debrisFolder), DebrisCleaner::NO_EXPIRATION));
+
+    REQUIRE(result.finished);
+    REQUIRE(result.removedEntries == 2 * 10 + 2 + 1);
+    REQUIRE(QDir(debrisFolder).entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden)
+            == QStringList(QLatin1String("2020-01-02")));
+}
+
+TEST_CASE("DebrisCleaner can be destroyed before its functors start")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    QStringList debrisFolders;
+    for (int sync = 0; sync < 8; ++sync)
+    {
+        debrisFolders.append(root.filePath(QString::fromUtf8("sync%1/.debris").arg(sync)));
+        createDebris(debrisFolders.last(), QStringList(QLatin1String("2020-01-01")), 1, 10);
+    }
+
+    // The functors queued, starting or running when the cleaner is destroyed must not touch it
+    for (int i = 0; i < 100; ++i)
+    {
+        std::unique_ptr<DebrisCleaner> cleaner(new DebrisCleaner(0));
+        cleaner->clean(debrisFolders, DebrisCleaner::NO_EXPIRATION);
+        cleaner.reset();
+    }
+
+    DebrisCleaner cleaner(0);
+    auto result(cleanAndWait(cleaner, debrisFolders, DebrisCleaner::ALL_FOLDERS));
+    REQUIRE(result.finished);
+}
+
+TEST_CASE("DebrisCleaner keeps to its operations per second")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString debrisFolder(root.filePath(QLatin1String(".debris")));
+    createDebris(debrisFolder, QStringList(QLatin1String("2020-01-01")), 1, 99);
+
+    // 99 files and 2 folders
+    DebrisCleaner cleaner(200);
+    auto result(cleanAndWait(cleaner, QStringList(debrisFolder), DebrisCleaner::ALL_FOLDERS));
+
+    REQUIRE(result.finished);
+    REQUIRE(result.removedEntries == 101);
+    REQUIRE(result.elapsedMs >= 450);
+}
+
+TEST_CASE("DebrisCleaner benchmark with a synthetic debris tree", "[.benchmark]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    QStringList debrisFolders;
+    for (int sync = 0; sync < 4; ++sync)
+    {
+        debrisFolders.append(root.filePath(QString::fromUtf8("sync%1/.debris").arg(sync)));
+        createDebris(debrisFolders.last(), QStringList(QLatin1String("2020-01-01")), 100, 250);
+    }
+
+    DebrisCleaner cleaner(0);
+    auto result(cleanAndWait(cleaner, debrisFolders, DebrisCleaner::ALL_FOLDERS));
+
+    WARN(result.removedEntries << " entries removed in " << result.elapsedMs << " ms, max event loop delay: "
+         << result.maxEventLoopDelayMs << " ms");
+    REQUIRE(result.finished);
+}
@@ -0,0 +1,95 @@
+#include <catch.hpp>
+#include "Preferences/EncryptedSettings.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace
+{
+QByteArray readFile(const QString& path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+}
+
+TEST_CASE("EncryptedSettings writes the changes when they are flushed")
+{
+    QTemporaryDir dir;
+    const QString settingsFile(dir.filePath(QString::fromUtf8("settings.cfg")));
+    {
+        EncryptedSettings settings(settingsFile);
+        settings.sync();
+        const auto initialContents(readFile(settingsFile));
+
+        int changesPending(0);
+        settings.setChangesPendingCallback([&changesPending]()
+        {
+            ++changesPending;
+        });
+        settings.setValue(QString::fromUtf8("rootKey"), QString::fromUtf8("rootValue"));
+        settings.beginGroup(QString::fromUtf8("account"));
+        for (int i = 0; i < 100; ++i)
+        {
+            settings.setValue(QString::fromUtf8("counter"), i);
+        }
+        settings.setValue(QString::fromUtf8("email"), QString::fromUtf8("test@mega.co.nz"));
+
+        // One notification until the changes are flushed
+        REQUIRE(changesPending == 1);
+        REQUIRE(settings.hasPendingChanges());
+        REQUIRE(settings.value(QString::fromUtf8("counter")).toInt() == 99);
+        REQUIRE(readFile(settingsFile) == initialContents);
+
+        settings.sync();
+        REQUIRE(!settings.hasPendingChanges());
+        REQUIRE(readFile(settingsFile) != initialContents);
+
+        // Setting the same value again is not a change
+        settings.setValue(QString::fromUtf8("counter"), 99);
+        REQUIRE(!settings.hasPendingChanges());
+
+        // The groups with pending values are visible
+        settings.endGroup();
+        settings.beginGroup(QString::fromUtf8("other"));
+        settings.setValue(QString::fromUtf8("key"), QString::fromUtf8("value"));
+        settings.endGroup();
+        REQUIRE(settings.containsGroup(QString::fromUtf8("other")));
+        REQUIRE(settings.numChildGroups() == 2);
+        REQUIRE(settings.isGroupEmpty());
+
+        settings.beginGroup(QString::fromUtf8("account"));
+        settings.setValue(QString::fromUtf8("pending"), QString::fromUtf8("pendingValue"));
+    }
+
+    // The pending values are written on destruction, encrypted with their group
+    EncryptedSettings settings(settingsFile);
+    REQUIRE(settings.value(QString::fromUtf8("rootKey")).toString() == QString::fromUtf8("rootValue"));
+    REQUIRE(settings.value(QString::fromUtf8("counter"), 5).toInt() == 5);
+    settings.beginGroup(QString::fromUtf8("account"));
+    REQUIRE(settings.value(QString::fromUtf8("counter")).toInt() == 99);
+    REQUIRE(settings.value(QString::fromUtf8("email")).toString() == QString::fromUtf8("test@mega.co.nz"));
+    REQUIRE(settings.value(QString::fromUtf8("pending")).toString() == QString::fromUtf8("pendingValue"));
+    REQUIRE(settings.value(QString::fromUtf8("missing"), QString::fromUtf8("default")).toString() == QString::fromUtf8("default"));
+}
+
+TEST_CASE("EncryptedSettings removes the pending and cached values")
+{
+    QTemporaryDir dir;
+    const QString settingsFile(dir.filePath(QString::fromUtf8("settings.cfg")));
+    EncryptedSettings settings(settingsFile);
+
+    settings.beginGroup(QString::fromUtf8("account"));
+    settings.setValue(QString::fromUtf8("stored"), QString::fromUtf8("value"));
+    settings.sync();
+    settings.setValue(QString::fromUtf8("pending"), QString::fromUtf8("value"));
+
+    settings.remove(QString::fromUtf8("stored"));
+    REQUIRE(settings.value(QString::fromUtf8("stored")).toString().isEmpty());
+
+    settings.remove(QString());
+    REQUIRE(!settings.hasPendingChanges());
+    REQUIRE(settings.value(QString::fromUtf8("pending")).toString().isEmpty());
+    settings.endGroup();
+    REQUIRE(!settings.containsGroup(QString::fromUtf8("account")));
+}
@@ -0,0 +1,189 @@
+#include <catch.hpp>
+#include "FolderSizeScanner.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <future>
+
+#ifdef Q_OS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace
+{
+void writeFile(const QString& path, int size)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(size, 'x'));
+}
+
+void appendToFile(const QString& path, int size)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::Append));
+    file.write(QByteArray(size, 'y'));
+}
+
+// QFile can not open a folder to change its modification time
+void setFolderModificationTime(const QString& path, const QDateTime& time)
+{
+#ifdef Q_OS_WINDOWS
+    HANDLE folder(CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(path).utf16()),
+                              FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr));
+    REQUIRE(folder != INVALID_HANDLE_VALUE);
+    // 100 ns intervals since 1601-01-01
+    auto intervals((time.toMSecsSinceEpoch() + 11644473600000LL) * 10000LL);
+    FILETIME fileTime{static_cast<DWORD>(intervals), static_cast<DWORD>(intervals >> 32)};
+    auto isSet(SetFileTime(folder, nullptr, nullptr, &fileTime));
+    CloseHandle(folder);
+    REQUIRE(isSet);
+#else
+    struct timeval times[2];
+    times[0].tv_sec = times[1].tv_sec = static_cast<time_t>(time.toSecsSinceEpoch());
+    times[0].tv_usec = times[1].tv_usec = 0;
+    REQUIRE(utimes(QFile::encodeName(path).constData(), times) == 0);
+#endif
+}
+
+void setFileModificationTime(const QString& path, const QDateTime& time)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadWrite));
+    REQUIRE(file.setFileTime(time, QFileDevice::FileModificationTime));
+}
+
+// The final size of a scan, or -1 if it does not finish
+long long scanFolders(const QStringList& folderPaths)
+{
+    auto result(std::make_shared<std::promise<long long>>());
+    auto token(FolderSizeScanner::instance()->scan(folderPaths, [result](long long size, bool finished)
+    {
+        if (finished)
+        {
+            result->set_value(size);
+        }
+    }));
+
+    auto future(result->get_future());
+    if (future.wait_for(10s) != std::future_status::ready)
+    {
+        token.cancel();
+        return -1;
+    }
+    return future.get();
+}
+}
+
+TEST_CASE("FolderSizeScanner adds the size of the files of every subfolder")
+{
+    QTemporaryDir first;
+    QTemporaryDir second;
+    REQUIRE(first.isValid());
+    REQUIRE(second.isValid());
+
+    QDir(first.path()).mkpath(QLatin1String("sub/deeper"));
+    QDir(first.path()).mkpath(QLatin1String("empty"));
+    writeFile(first.filePath(QLatin1String("a.bin")), 10);
+    writeFile(first.filePath(QLatin1String("sub/b.bin")), 20);
+    writeFile(first.filePath(QLatin1String("sub/deeper/c.bin")), 30);
+    writeFile(second.filePath(QLatin1String(".hidden")), 5);
+
+    const QString missing(first.filePath(QLatin1String("missing")));
+    REQUIRE(scanFolders(QStringList() << first.path() << second.path() << missing) == 65);
+    REQUIRE(scanFolders(QStringList() << missing) == 0);
+    REQUIRE(scanFolders(QStringList()) == 0);
+
+    // The folders changed since the last scan are read again
+    writeFile(first.filePath(QLatin1String("sub/deeper/d.bin")), 40);
+    QDir(first.path()).rmdir(QLatin1String("empty"));
+    QFile::remove(first.filePath(QLatin1String("a.bin")));
+    REQUIRE(scanFolders(QStringList() << first.path()) == 90);
+}
+
+TEST_CASE("FolderSizeScanner reuses the size of the folders that did not change")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    QDir(root.path()).mkpath(QLatin1String("sub"));
+    const QString rootFile(root.filePath(QLatin1String("a.bin")));
+    const QString subFolder(root.filePath(QLatin1String("sub")));
+    const QString subFile(root.filePath(QLatin1String("sub/b.bin")));
+    writeFile(rootFile, 10);
+    writeFile(subFile, 20);
+
+    // A folder changed in the last seconds is read again in every scan, so everything is backdated
+    const QDateTime past(QDateTime::currentDateTime().addDays(-1));
+    setFileModificationTime(rootFile, past);
+    setFileModificationTime(subFile, past);
+    setFolderModificationTime(subFolder, past);
+    setFolderModificationTime(root.path(), past);
+
+    REQUIRE(scanFolders(QStringList() << root.path()) == 30);
+
+    // Rewriting a file does not change its folder, so the second scan takes both sizes from the cache
+    appendToFile(rootFile, 1);
+    appendToFile(subFile, 2);
+    REQUIRE(scanFolders(QStringList() << root.path()) == 30);
+
+    // A new file changes its folder, which is read again. The root folder still comes from the cache
+    writeFile(root.filePath(QLatin1String("sub/c.bin")), 5);
+    REQUIRE(scanFolders(QStringList() << root.path()) == 37);
+}
+
+TEST_CASE("FolderSizeScanner stops a cancelled scan")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    for (int folder = 0; folder < 50; ++folder)
+    {
+        auto folderPath(root.filePath(QString::number(folder)));
+        QDir().mkpath(folderPath);
+        writeFile(folderPath + QLatin1String("/file"), 1);
+    }
+
+    auto token(FolderSizeScanner::instance()->scan(QStringList() << root.path(), [](long long, bool) {}));
+    token.cancel();
+    REQUIRE(token.isCancelled());
+
+    // A cancelled scan does not break the next ones
+    REQUIRE(scanFolders(QStringList() << root.path()) == 50);
+}
+
+TEST_CASE("FolderSizeScanner benchmark with a synthetic debris folder", "[.benchmark]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    constexpr int FOLDERS = 200;
+    constexpr int FILES_PER_FOLDER = 100;
+    for (int folder = 0; folder < FOLDERS; ++folder)
+    {
+        auto folderPath(root.filePath(QString::fromUtf8("%1/%2").arg(folder / 20).arg(folder)));
+        QDir().mkpath(folderPath);
+        for (int file = 0; file < FILES_PER_FOLDER; ++file)
+        {
+            writeFile(folderPath + QString::fromUtf8("/file%1").arg(file), file);
+        }
+    }
+
+    for (int run = 0; run < 2; ++run)
+    {
+        auto start(std::chrono::steady_clock::now());
+        auto size(scanFolders(QStringList() << root.path()));
+        auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+
+        WARN("Scan " << run << ": " << FOLDERS * FILES_PER_FOLDER << " files, " << elapsed.count() << " ms");
+        REQUIRE(size == FOLDERS * (FILES_PER_FOLDER * (FILES_PER_FOLDER - 1) / 2));
+    }
+}
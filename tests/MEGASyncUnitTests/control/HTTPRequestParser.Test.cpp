@@ -0,0 +1,67 @@
+#include <catch.hpp>
+#include "HTTPRequestParser.h"
+
+TEST_CASE("HTTP request parser waits for the whole request")
+{
+    HTTPRequestParser parser;
+    HTTPRequestParser::Request request;
+
+    parser.append("POST / HTTP/1.1\r\nOrigin: https://mega.nz\r\nContent-");
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::NEED_MORE_DATA);
+    parser.append("Length: 9\r\n\r");
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::NEED_MORE_DATA);
+    parser.append("\n{\"a\":");
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::NEED_MORE_DATA);
+    parser.append("\"v\"}");
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::REQUEST_READY);
+
+    REQUIRE(request.method == "POST");
+    REQUIRE(request.version == "HTTP/1.1");
+    REQUIRE(request.headerValue("origin") == "https://mega.nz");
+    REQUIRE(request.hasContentLength);
+    REQUIRE(request.body == "{\"a\":\"v\"}");
+    REQUIRE(request.keepAlive());
+    REQUIRE(!parser.hasPendingData());
+}
+
+TEST_CASE("HTTP request parser returns pipelined requests in order")
+{
+    HTTPRequestParser parser;
+    HTTPRequestParser::Request request;
+
+    parser.append("POST / HTTP/1.1\r\nContent-Length: 3\r\n\r\none"
+                  "POST / HTTP/1.1\r\nContent-Length: 3\r\nConnection: close\r\n\r\ntwo"
+                  "OPTIONS / HTTP/1.0\r\n");
+
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::REQUEST_READY);
+    REQUIRE(request.body == "one");
+    REQUIRE(request.keepAlive());
+
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::REQUEST_READY);
+    REQUIRE(request.body == "two");
+    REQUIRE(!request.keepAlive());
+
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::NEED_MORE_DATA);
+    parser.append("Connection: Keep-Alive\r\n\r\n");
+    REQUIRE(parser.next(request) == HTTPRequestParser::Result::REQUEST_READY);
+    REQUIRE(request.method == "OPTIONS");
+    REQUIRE(!request.hasContentLength);
+    REQUIRE(request.keepAlive());
+}
+
+TEST_CASE("HTTP request parser rejects invalid requests")
+{
+    HTTPRequestParser::Request request;
+
+    HTTPRequestParser badRequestLine;
+    badRequestLine.append("POST /\r\n\r\n");
+    REQUIRE(badRequestLine.next(request) == HTTPRequestParser::Result::BAD_REQUEST);
+
+    HTTPRequestParser badContentLength;
+    badContentLength.append("POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n");
+    REQUIRE(badContentLength.next(request) == HTTPRequestParser::Result::BAD_REQUEST);
+
+    HTTPRequestParser tooLarge;
+    tooLarge.append(QByteArray(HTTPRequestParser::MAX_HEADERS_SIZE + 1, 'a'));
+    REQUIRE(tooLarge.next(request) == HTTPRequestParser::Result::REQUEST_TOO_LARGE);
+}
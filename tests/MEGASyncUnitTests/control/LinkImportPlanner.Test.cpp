@@ -0,0 +1,32 @@
+#include <catch.hpp>
+#include "LinkImportPlanner.h"
+
+TEST_CASE("LinkImportPlanner skips the nodes with the same name and size")
+{
+    LinkImportPlanner planner(nullptr);
+    const mega::MegaHandle folder(1);
+
+    REQUIRE(planner.planImport(folder, QString::fromUtf8("video.mp4"), 100));
+    // The same link pasted twice is imported once
+    REQUIRE_FALSE(planner.planImport(folder, QString::fromUtf8("video.mp4"), 100));
+
+    // The name is case sensitive and the size has to match
+    REQUIRE(planner.planImport(folder, QString::fromUtf8("Video.mp4"), 100));
+    REQUIRE(planner.planImport(folder, QString::fromUtf8("video.mp4"), 101));
+
+    // Every import folder has its own nodes
+    REQUIRE(planner.planImport(2, QString::fromUtf8("video.mp4"), 100));
+}
+
+TEST_CASE("LinkImportPlanner plans a large batch of links")
+{
+    LinkImportPlanner planner(nullptr);
+    for (int link = 0; link < 2000; ++link)
+    {
+        REQUIRE(planner.planImport(1, QString::fromUtf8("file%1").arg(link), link));
+    }
+    for (int link = 0; link < 2000; ++link)
+    {
+        REQUIRE_FALSE(planner.planImport(1, QString::fromUtf8("file%1").arg(link), link));
+    }
+}
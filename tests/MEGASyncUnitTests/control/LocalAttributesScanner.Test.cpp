@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include "LocalAttributesScanner.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+void writeFile(const QString& path, int size, const QDateTime& modifiedTime)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadWrite));
+    file.write(QByteArray(size, 'x'));
+    REQUIRE(file.flush());
+    REQUIRE(file.setFileTime(modifiedTime, QFileDevice::FileModificationTime));
+}
+
+// The final result of a scan, with fileCount == -1 if it does not finish
+LocalAttributesScanner::Result scanFolder(const QString& folderPath)
+{
+    auto result(std::make_shared<std::promise<LocalAttributesScanner::Result>>());
+    auto token(LocalAttributesScanner::scan(folderPath, [result](const LocalAttributesScanner::Result& current, bool finished)
+    {
+        if (finished)
+        {
+            result->set_value(current);
+        }
+    }));
+
+    auto future(result->get_future());
+    if (future.wait_for(10s) != std::future_status::ready)
+    {
+        token.cancel();
+        LocalAttributesScanner::Result notFinished;
+        notFinished.fileCount = -1;
+        return notFinished;
+    }
+    return future.get();
+}
+}
+
+TEST_CASE("LocalAttributesScanner reads the size, file count and modified time in one scan")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    const QDateTime older(QDateTime::fromSecsSinceEpoch(1600000000));
+    const QDateTime newer(QDateTime::fromSecsSinceEpoch(1700000000));
+    const QDateTime newest(QDateTime::fromSecsSinceEpoch(1800000000));
+
+    QDir(root.path()).mkpath(QLatin1String("sub/deeper"));
+    QDir(root.path()).mkpath(QLatin1String(".hidden"));
+    writeFile(root.filePath(QLatin1String("a.bin")), 10, older);
+    writeFile(root.filePath(QLatin1String("sub/b.bin")), 20, newer);
+    writeFile(root.filePath(QLatin1String("sub/deeper/c.bin")), 30, older);
+    // The hidden files count for the size only
+    writeFile(root.filePath(QLatin1String(".hidden/d.bin")), 40, newest);
+    writeFile(root.filePath(QLatin1String("sub/.e.bin")), 50, newest);
+
+    auto result(scanFolder(root.path()));
+    REQUIRE(result.fileCount == 3);
+    REQUIRE(result.size == 150);
+    REQUIRE(result.lastModifiedTime == newer.toMSecsSinceEpoch());
+}
+
+TEST_CASE("LocalAttributesScanner reports an empty folder")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    QDir(root.path()).mkpath(QLatin1String("empty/subfolder"));
+
+    auto result(scanFolder(root.path()));
+    REQUIRE(result.fileCount == 0);
+    REQUIRE(result.size == 0);
+    REQUIRE(result.lastModifiedTime == -1);
+
+    result = scanFolder(root.filePath(QLatin1String("missing")));
+    REQUIRE(result.fileCount == 0);
+}
+
+TEST_CASE("LocalAttributesScanner stops a cancelled scan")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    for (int folder = 0; folder < 50; ++folder)
+    {
+        auto folderPath(root.filePath(QString::number(folder)));
+        QDir().mkpath(folderPath);
+        writeFile(folderPath + QLatin1String("/file"), 1, QDateTime::currentDateTime());
+    }
+
+    // The scan is cancelled from its first report, the one of the root folder, before its subfolders are done
+    std::mutex reportsMutex;
+    std::condition_variable cancelled;
+    int reports(0);
+    bool finishedReported(false);
+    ThreadPool::CancellationToken token;
+    {
+        std::unique_lock<std::mutex> lock(reportsMutex);
+        token = LocalAttributesScanner::scan(root.path(), [&](const LocalAttributesScanner::Result&, bool finished)
+        {
+            std::lock_guard<std::mutex> reportsLock(reportsMutex);
+            ++reports;
+            finishedReported |= finished;
+            token.cancel();
+            cancelled.notify_one();
+        });
+        REQUIRE(cancelled.wait_for(lock, 10s, [&reports]() { return reports > 0; }));
+    }
+    REQUIRE(token.isCancelled());
+
+    // Give the pending workers the time to report anything, then check that they did not
+    std::this_thread::sleep_for(500ms);
+    {
+        std::lock_guard<std::mutex> lock(reportsMutex);
+        REQUIRE(reports == 1);
+        REQUIRE_FALSE(finishedReported);
+    }
+
+    // A cancelled scan does not break the next ones
+    auto result(scanFolder(root.path()));
+    REQUIRE(result.fileCount == 50);
+    REQUIRE(result.size == 50);
+}
@@ -0,0 +1,88 @@
+#include <catch.hpp>
+#include "LockFreeQueue.h"
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("LockFreeQueue keeps the order and fails when it is full")
+{
+    LockFreeQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for(int value = 0; value < 4; ++value)
+    {
+        REQUIRE(queue.tryPush(int(value)));
+    }
+
+    // The item is not consumed when the push fails
+    int rejected(4);
+    REQUIRE_FALSE(queue.tryPush(std::move(rejected)));
+    REQUIRE(queue.sizeApprox() == 4);
+
+    int value(-1);
+    REQUIRE(queue.tryPop(value));
+    REQUIRE(value == 0);
+    REQUIRE(queue.tryPush(std::move(rejected)));
+
+    for(int expected = 1; expected <= 4; ++expected)
+    {
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(value == expected);
+    }
+    REQUIRE_FALSE(queue.tryPop(value));
+    REQUIRE(queue.sizeApprox() == 0);
+}
+
+TEST_CASE("LockFreeQueue delivers every item of concurrent producers to one consumer")
+{
+    constexpr int PRODUCERS{4};
+    constexpr int ITEMS_PER_PRODUCER{100000};
+
+    // Small, so the producers find it full many times
+    LockFreeQueue<int> queue(64);
+
+    std::vector<std::thread> producers;
+    for(int producer = 0; producer < PRODUCERS; ++producer)
+    {
+        producers.emplace_back([&queue, producer]()
+        {
+            for(int item = 0; item < ITEMS_PER_PRODUCER; ++item)
+            {
+                int value(producer * ITEMS_PER_PRODUCER + item);
+                while(!queue.tryPush(std::move(value)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer pushes its items in order, so the consumer must see them in that order
+    std::vector<int> nextItem(PRODUCERS, 0);
+    bool inOrder(true);
+    int received(0);
+    while(received < PRODUCERS * ITEMS_PER_PRODUCER)
+    {
+        int value;
+        if(queue.tryPop(value))
+        {
+            auto producer(value / ITEMS_PER_PRODUCER);
+            inOrder &= value % ITEMS_PER_PRODUCER == nextItem[producer];
+            nextItem[producer] = value % ITEMS_PER_PRODUCER + 1;
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    REQUIRE(inOrder);
+    int value;
+    REQUIRE_FALSE(queue.tryPop(value));
+}
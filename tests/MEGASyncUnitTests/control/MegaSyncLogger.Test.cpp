@@ -0,0 +1,142 @@
+#include <catch.hpp>
+#include "MegaSyncLogger.h"
+#include "MegaApplication.h"
+
+#include <zlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void logLine(const char* message)
+{
+    g_megaSyncLogger->log(nullptr, mega::MegaApi::LOG_LEVEL_DEBUG, nullptr, message
+#ifdef ENABLE_LOG_PERFORMANCE
+                          , nullptr, nullptr, 0
+#endif
+                          );
+}
+
+// Rotates the log, so the lines logged so far are in the closed MEGAsync.0.log
+bool rotateLog()
+{
+    std::promise<void> rotated;
+    auto connection(QObject::connect(g_megaSyncLogger, &MegaSyncLogger::logReadyForReporting, [&rotated]()
+    {
+        rotated.set_value();
+    }));
+    g_megaSyncLogger->prepareForReporting();
+    auto status(rotated.get_future().wait_for(std::chrono::seconds(10)));
+    QObject::disconnect(connection);
+    return status == std::future_status::ready;
+}
+
+std::vector<std::string> readRotatedLogLines(const std::string& prefix)
+{
+    std::vector<std::string> lines;
+    auto filename(MegaApplication::applicationDataPath() + QString::fromUtf8("/")
+                  + LOGS_FOLDER_LEAFNAME_QSTRING + QString::fromUtf8("/MEGAsync.0.log"));
+    gzFile_s* file(gzopen(filename.toUtf8().constData(), "rb"));
+    if (!file)
+    {
+        return lines;
+    }
+
+    char line[4096];
+    while (gzgets(file, line, sizeof(line)))
+    {
+        if (auto found = strstr(line, prefix.c_str()))
+        {
+            lines.emplace_back(found, strcspn(found, "\n"));
+        }
+    }
+    gzclose(file);
+    return lines;
+}
+}
+
+TEST_CASE("MegaSyncLogger writes the lines of all threads in the order they were logged")
+{
+    REQUIRE(g_megaSyncLogger);
+
+    constexpr int THREADS{4};
+    constexpr int LINES_PER_THREAD{500};
+    auto lostLinesBefore(g_megaSyncLogger->getLostLines());
+    auto prefix(std::string("Logger order test ")
+                + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + " line ");
+
+    // The threads take turns, so the order of the lines is known: thread 0 logs line 0, thread 1 line 1...
+    std::atomic<int> turn{0};
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < THREADS; ++thread)
+    {
+        threads.emplace_back([thread, &turn, &prefix]()
+        {
+            for(int line = thread; line < THREADS * LINES_PER_THREAD; line += THREADS)
+            {
+                while (turn.load() != line)
+                {
+                    std::this_thread::yield();
+                }
+                logLine((prefix + std::to_string(line)).c_str());
+                ++turn;
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(rotateLog());
+
+    auto lines(readRotatedLogLines(prefix));
+    REQUIRE(lines.size() == static_cast<size_t>(THREADS * LINES_PER_THREAD));
+    for(size_t line = 0; line < lines.size(); ++line)
+    {
+        REQUIRE(lines[line] == prefix + std::to_string(line));
+    }
+    REQUIRE(g_megaSyncLogger->getLostLines() == lostLinesBefore);
+}
+
+// Run with "[.benchmark]" to measure the lines per second the logger accepts from several threads
+TEST_CASE("MegaSyncLogger throughput from several threads", "[.benchmark]")
+{
+    REQUIRE(g_megaSyncLogger);
+
+    constexpr int THREADS{8};
+    constexpr int LINES_PER_THREAD{200000};
+    auto lostLinesBefore(g_megaSyncLogger->getLostLines());
+
+    auto start(std::chrono::steady_clock::now());
+
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < THREADS; ++thread)
+    {
+        threads.emplace_back([thread]()
+        {
+            for(int line = 0; line < LINES_PER_THREAD; ++line)
+            {
+                // Different lines, so the repeated lines detection does not skip them
+                auto message(std::string("Logger benchmark thread ") + std::to_string(thread) + " line " + std::to_string(line));
+                logLine(message.c_str());
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+    auto lines(static_cast<long long>(THREADS) * LINES_PER_THREAD);
+    WARN("Logged " << lines << " lines from " << THREADS << " threads in " << elapsed.count() << " ms ("
+         << (elapsed.count() ? lines * 1000 / elapsed.count() : lines) << " lines/s, "
+         << g_megaSyncLogger->getLostLines() - lostLinesBefore << " lost)");
+}
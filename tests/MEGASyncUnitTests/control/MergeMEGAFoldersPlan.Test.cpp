@@ -0,0 +1,221 @@
+#include <catch.hpp>
+#include "MergeMEGAFoldersPlan.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace
+{
+class TestMegaError : public mega::MegaError
+{
+public:
+    explicit TestMegaError(int errorCode)
+        : mega::MegaError(errorCode)
+    {}
+};
+
+// Cloud folders in memory, with the requests finished by the test
+class MockMergeApi : public MergeMEGAFoldersApi
+{
+public:
+    struct Request
+    {
+        MergeMEGAFoldersPlan::Step::Type type;
+        mega::MegaHandle node;
+        QString newName;
+        RequestFinished onFinished;
+    };
+
+    void addNode(mega::MegaHandle parent, mega::MegaHandle handle, const QString& name,
+                 bool isFile, const QString& fingerprint = QString())
+    {
+        children[parent].append(MergeMEGAFoldersNode{handle, name, isFile, fingerprint});
+    }
+
+    QList<MergeMEGAFoldersNode> getChildren(mega::MegaHandle folder) override
+    {
+        return children.value(folder);
+    }
+
+    void moveNode(mega::MegaHandle node, mega::MegaHandle, const QString& newName, RequestFinished onFinished) override
+    {
+        addRequest(Request{MergeMEGAFoldersPlan::Step::Type::Move, node, newName, onFinished});
+    }
+
+    void remove(mega::MegaHandle node, RequestFinished onFinished) override
+    {
+        addRequest(Request{MergeMEGAFoldersPlan::Step::Type::Remove, node, QString(), onFinished});
+    }
+
+    void moveToBin(mega::MegaHandle node, RequestFinished onFinished) override
+    {
+        addRequest(Request{MergeMEGAFoldersPlan::Step::Type::MoveToBin, node, QString(), onFinished});
+    }
+
+    // Finishes the first request in flight
+    Request finishRequest(std::shared_ptr<mega::MegaError> error = nullptr)
+    {
+        auto request(requests.front());
+        requests.erase(requests.begin());
+        finishedRequests.push_back(request);
+        request.onFinished(error);
+        return request;
+    }
+
+    void finishAllRequests()
+    {
+        while (!requests.empty())
+        {
+            finishRequest();
+        }
+    }
+
+    QHash<mega::MegaHandle, QList<MergeMEGAFoldersNode>> children;
+    std::vector<Request> requests;
+    std::vector<Request> finishedRequests;
+    size_t maxRequestsInFlight = 0;
+
+private:
+    void addRequest(const Request& request)
+    {
+        requests.push_back(request);
+        maxRequestsInFlight = std::max(maxRequestsInFlight, requests.size());
+    }
+};
+
+const mega::MegaHandle TARGET = 1;
+const mega::MegaHandle TO_MERGE = 2;
+
+const MergeMEGAFoldersPlan::Step& findStep(const MergeMEGAFoldersPlan& plan, mega::MegaHandle node)
+{
+    const auto& steps(plan.getSteps());
+    return *std::find_if(steps.begin(), steps.end(), [node](const MergeMEGAFoldersPlan::Step& step)
+    {
+        return step.node == node;
+    });
+}
+}
+
+TEST_CASE("MergeMEGAFoldersPlan plans the moves, renames and removals")
+{
+    MockMergeApi api;
+    api.addNode(TARGET, 10, QString::fromUtf8("notes.txt"), true, QString::fromUtf8("fp1"));
+    api.addNode(TARGET, 11, QString::fromUtf8("notes(1).txt"), true, QString::fromUtf8("fp2"));
+    api.addNode(TARGET, 12, QString::fromUtf8("photos"), false);
+    api.addNode(TARGET, 13, QString::fromUtf8("same.txt"), true, QString::fromUtf8("fp3"));
+    api.addNode(12, 14, QString::fromUtf8("a.jpg"), true, QString::fromUtf8("fp4"));
+
+    api.addNode(TO_MERGE, 20, QString::fromUtf8("notes.txt"), true, QString::fromUtf8("fp5"));
+    api.addNode(TO_MERGE, 21, QString::fromUtf8("new.txt"), true, QString::fromUtf8("fp6"));
+    api.addNode(TO_MERGE, 22, QString::fromUtf8("photos"), false);
+    api.addNode(TO_MERGE, 23, QString::fromUtf8("same.txt"), true, QString::fromUtf8("fp3"));
+    api.addNode(22, 24, QString::fromUtf8("a.jpg"), true, QString::fromUtf8("fp7"));
+    api.addNode(22, 25, QString::fromUtf8("b.jpg"), true, QString::fromUtf8("fp8"));
+
+    auto plan(MergeMEGAFoldersPlan::create(&api, TARGET, TO_MERGE, MergeMEGAFoldersPlan::IgnoreAndMoveToBin));
+
+    // The identical file is left, so the merged folder goes to the bin
+    REQUIRE(plan.count(MergeMEGAFoldersPlan::Step::Type::Move) == 4);
+    REQUIRE(plan.count(MergeMEGAFoldersPlan::Step::Type::Remove) == 1);
+    REQUIRE(plan.count(MergeMEGAFoldersPlan::Step::Type::MoveToBin) == 1);
+    REQUIRE(findStep(plan, 20).newName == QString::fromUtf8("notes(2).txt"));
+    REQUIRE(findStep(plan, 21).newName.isEmpty());
+    REQUIRE(findStep(plan, 24).newName == QString::fromUtf8("a(1).jpg"));
+    REQUIRE(findStep(plan, 25).newName.isEmpty());
+
+    // The emptied subfolder is removed once its children are moved
+    const auto& steps(plan.getSteps());
+    const auto& removeSubfolder(findStep(plan, 22));
+    REQUIRE(removeSubfolder.type == MergeMEGAFoldersPlan::Step::Type::Remove);
+    REQUIRE(removeSubfolder.dependencies == 2);
+    REQUIRE(steps.at(findStep(plan, 24).dependent).node == 22);
+
+    const auto& moveToBin(steps.back());
+    REQUIRE(moveToBin.type == MergeMEGAFoldersPlan::Step::Type::MoveToBin);
+    REQUIRE(moveToBin.node == TO_MERGE);
+    REQUIRE(moveToBin.dependencies == 3);
+}
+
+TEST_CASE("MergeMEGAFoldersExecutor keeps a window of requests in flight")
+{
+    auto api(std::make_shared<MockMergeApi>());
+    for (mega::MegaHandle handle = 100; handle < 200; ++handle)
+    {
+        api->addNode(TO_MERGE, handle, QString::fromUtf8("file%1").arg(handle), true);
+    }
+
+    MergeMEGAFoldersExecutor executor(api, MergeMEGAFoldersPlan::create(api.get(), TARGET, TO_MERGE, MergeMEGAFoldersPlan::Rename), 8);
+    int lastProgress(0);
+    int finished(0);
+    QObject::connect(&executor, &MergeMEGAFoldersExecutor::progress, [&lastProgress](int finishedSteps, int)
+    {
+        lastProgress = finishedSteps;
+    });
+    QObject::connect(&executor, &MergeMEGAFoldersExecutor::finished, [&finished]()
+    {
+        ++finished;
+    });
+
+    executor.start();
+    REQUIRE(api->requests.size() == 8);
+
+    api->finishAllRequests();
+    REQUIRE(finished == 1);
+    REQUIRE(executor.isCompleted());
+    REQUIRE(!executor.getError());
+    REQUIRE(lastProgress == 101);
+    REQUIRE(api->maxRequestsInFlight == 8);
+    REQUIRE(api->finishedRequests.size() == 101);
+
+    // The merged folder is removed after every move
+    REQUIRE(api->finishedRequests.back().type == MergeMEGAFoldersPlan::Step::Type::Remove);
+    REQUIRE(api->finishedRequests.back().node == TO_MERGE);
+}
+
+TEST_CASE("MergeMEGAFoldersExecutor resumes after a cancel or an error")
+{
+    auto api(std::make_shared<MockMergeApi>());
+    for (mega::MegaHandle handle = 100; handle < 120; ++handle)
+    {
+        api->addNode(TO_MERGE, handle, QString::fromUtf8("file%1").arg(handle), true);
+    }
+
+    MergeMEGAFoldersExecutor executor(api, MergeMEGAFoldersPlan::create(api.get(), TARGET, TO_MERGE, MergeMEGAFoldersPlan::Rename), 4);
+    int finished(0);
+    QObject::connect(&executor, &MergeMEGAFoldersExecutor::finished, [&finished]()
+    {
+        ++finished;
+    });
+
+    executor.start();
+    api->finishRequest();
+    executor.cancel();
+
+    // The requests in flight finish, no new ones are sent
+    REQUIRE(finished == 0);
+    api->finishAllRequests();
+    REQUIRE(finished == 1);
+    REQUIRE(executor.isCancelled());
+    REQUIRE(executor.getFinishedSteps() == 5);
+    REQUIRE(api->finishedRequests.size() == 5);
+
+    // A failed move stops the merge and the folder is not removed
+    executor.start();
+    REQUIRE(api->requests.size() == 4);
+    api->finishRequest(std::make_shared<TestMegaError>(mega::MegaError::API_EACCESS));
+    api->finishAllRequests();
+    REQUIRE(finished == 2);
+    REQUIRE(executor.getError());
+    REQUIRE(executor.getFinishedSteps() == 8);
+
+    // The failed move is retried
+    executor.start();
+    api->finishAllRequests();
+    REQUIRE(finished == 3);
+    REQUIRE(!executor.getError());
+    REQUIRE(executor.isCompleted());
+    REQUIRE(executor.getFinishedSteps() == 21);
+    REQUIRE(api->finishedRequests.size() == 22);
+    REQUIRE(api->finishedRequests.back().node == TO_MERGE);
+}
@@ -0,0 +1,59 @@
+#include <catch.hpp>
+#include "ResourceUsageSampler.h"
+
+#include <algorithm>
+
+TEST_CASE("ResourceUsageSampler parses the /proc files")
+{
+    ResourceUsageSample sample;
+    REQUIRE(ResourceUsageSampler::parseStatm("123456 2500 700 300 0 9000 0\n", 4096, sample));
+    REQUIRE(sample.residentBytes == 2500 * 4096);
+    REQUIRE(!ResourceUsageSampler::parseStatm("", 4096, sample));
+
+    const auto status(ResourceUsageSampler::parseKeyValues("Name:\tmegasync\n"
+                                                           "VmRSS:\t   10000 kB\n"
+                                                           "RssAnon:\t    8000 kB\n"
+                                                           "RssFile:\t    2000 kB\n"
+                                                           "Cpus_allowed_list:\t0-7\n"
+                                                           "voluntary_ctxt_switches:\t1234\n"
+                                                           "nonvoluntary_ctxt_switches:\t56\n"));
+    REQUIRE(status.value("RssAnon") == 8000 * 1024);
+    REQUIRE(status.value("RssFile") == 2000 * 1024);
+    REQUIRE(status.value("voluntary_ctxt_switches") == 1234);
+    REQUIRE(status.value("nonvoluntary_ctxt_switches") == 56);
+    REQUIRE(!status.contains("Name"));
+    REQUIRE(!status.contains("Cpus_allowed_list"));
+
+    const auto io(ResourceUsageSampler::parseKeyValues("rchar: 100\nwchar: 200\nread_bytes: 4096\nwrite_bytes: 8192\n"));
+    REQUIRE(io.value("read_bytes") == 4096);
+    REQUIRE(io.value("write_bytes") == 8192);
+}
+
+TEST_CASE("ResourceUsageSampler keeps the last samples")
+{
+    ResourceUsageSampler sampler(3);
+    REQUIRE(sampler.getSamples().isEmpty());
+
+    for (int i = 1; i <= 5; ++i)
+    {
+        ResourceUsageSample sample;
+        sample.timestamp = i;
+        sampler.addSample(sample);
+
+        const auto samples(sampler.getSamples());
+        REQUIRE(samples.size() == std::min(i, 3));
+        REQUIRE(samples.last().timestamp == i);
+        REQUIRE(samples.first().timestamp == std::max(1, i - 2));
+    }
+}
+
+#ifdef Q_OS_LINUX
+TEST_CASE("ResourceUsageSampler reads the usage of this process")
+{
+    ResourceUsageSample sample;
+    REQUIRE(ResourceUsageSampler::readProcessUsage(sample));
+    REQUIRE(sample.residentBytes > 0);
+    REQUIRE(sample.anonymousBytes > 0);
+    REQUIRE(sample.voluntaryContextSwitches >= 0);
+}
+#endif
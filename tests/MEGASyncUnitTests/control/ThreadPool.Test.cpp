@@ -0,0 +1,230 @@
+#include <catch.hpp>
+#include "ThreadPool.h"
+
+#include <atomic>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+template<typename Condition>
+bool waitFor(Condition condition)
+{
+    auto deadline(std::chrono::steady_clock::now() + 5s);
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// The stats of a functor are updated after it returns
+bool waitForIdleLane(const ThreadPool& pool, ThreadPool::Lane lane)
+{
+    return waitFor([&]()
+    {
+        auto stats(pool.getLaneStats(lane));
+        return !stats.queued && !stats.running;
+    });
+}
+}
+
+TEST_CASE("ThreadPool runs interactive functors while the background lane is busy")
+{
+    ThreadPool pool(2);
+    std::atomic<bool> released{false};
+    std::atomic<int> started{0};
+    std::atomic<int> finished{0};
+
+    // One worker is always left out of the background lane
+    for (int i = 0; i < 3; ++i)
+    {
+        pool.push([&]()
+        {
+            started++;
+            waitFor([&]()
+            {
+                return released.load();
+            });
+            finished++;
+        });
+    }
+    bool backgroundStarted(waitFor([&]()
+    {
+        return started > 0;
+    }));
+
+    std::atomic<bool> interactive{false};
+    pool.push([&]()
+    {
+        interactive = true;
+    }, ThreadPool::Lane::INTERACTIVE);
+    bool interactiveFinished(waitFor([&]()
+    {
+        return interactive.load();
+    }));
+    auto stats(pool.getLaneStats(ThreadPool::Lane::BACKGROUND));
+    auto startedBeforeRelease(started.load());
+    released = true;
+
+    REQUIRE(backgroundStarted);
+    REQUIRE(interactiveFinished);
+    REQUIRE(startedBeforeRelease == 1);
+    REQUIRE(stats.running == 1);
+    REQUIRE(stats.queued == 2);
+
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::BACKGROUND));
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::INTERACTIVE));
+    REQUIRE(finished == 3);
+    REQUIRE(pool.getLaneStats(ThreadPool::Lane::BACKGROUND).executed == 3);
+    REQUIRE(pool.getLaneStats(ThreadPool::Lane::INTERACTIVE).executed == 1);
+}
+
+TEST_CASE("ThreadPool keeps a worker for the interactive lane when the background and bulk lanes are busy")
+{
+    ThreadPool pool(5);
+    std::atomic<bool> released{false};
+    std::atomic<int> started{0};
+
+    // Alone, each lane fits in 4 workers: together they must leave the fifth one free
+    for (auto lane : {ThreadPool::Lane::BACKGROUND, ThreadPool::Lane::BULK_IO})
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            pool.push([&]()
+            {
+                started++;
+                waitFor([&]()
+                {
+                    return released.load();
+                });
+            }, lane);
+        }
+    }
+    bool lowerLanesStarted(waitFor([&]()
+    {
+        return started == 4;
+    }));
+    std::this_thread::sleep_for(50ms);
+
+    std::atomic<bool> interactive{false};
+    pool.push([&]()
+    {
+        interactive = true;
+    }, ThreadPool::Lane::INTERACTIVE);
+    bool interactiveFinished(waitFor([&]()
+    {
+        return interactive.load();
+    }));
+    auto background(pool.getLaneStats(ThreadPool::Lane::BACKGROUND));
+    auto bulk(pool.getLaneStats(ThreadPool::Lane::BULK_IO));
+    auto startedBeforeRelease(started.load());
+    released = true;
+
+    REQUIRE(lowerLanesStarted);
+    REQUIRE(interactiveFinished);
+    REQUIRE(startedBeforeRelease == 4);
+    REQUIRE(background.running + bulk.running == 4);
+
+    // The functors held back by the shared limit run once the others finish
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::BACKGROUND));
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::BULK_IO));
+    REQUIRE(started == 6);
+}
+
+TEST_CASE("ThreadPool discards the cancelled functors")
+{
+    ThreadPool pool(1);
+    std::atomic<bool> released{false};
+    std::atomic<bool> started{false};
+    pool.push([&]()
+    {
+        started = true;
+        waitFor([&]()
+        {
+            return released.load();
+        });
+    }, ThreadPool::Lane::BULK_IO);
+    bool blockerStarted(waitFor([&]()
+    {
+        return started.load();
+    }));
+
+    ThreadPool::CancellationToken token;
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 10; ++i)
+    {
+        pool.push([&]()
+        {
+            executed++;
+        }, ThreadPool::Lane::BULK_IO, token);
+    }
+    auto queued(pool.getLaneStats(ThreadPool::Lane::BULK_IO).queued);
+
+    token.cancel();
+    released = true;
+    REQUIRE(blockerStarted);
+    REQUIRE(queued == 10);
+    REQUIRE(token.isCancelled());
+
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::BULK_IO));
+    auto stats(pool.getLaneStats(ThreadPool::Lane::BULK_IO));
+    REQUIRE(executed == 0);
+    REQUIRE(stats.cancelled == 10);
+    REQUIRE(stats.executed == 1);
+}
+
+TEST_CASE("ThreadPool interrupts the running functor when its token is cancelled")
+{
+    ThreadPool pool(2);
+    ThreadPool::CancellationToken token;
+    std::atomic<bool> started{false};
+    std::atomic<bool> interrupted{false};
+
+    pool.push([&]()
+    {
+        started = true;
+        waitFor([]()
+        {
+            return ThreadPool::isThreadInterrupted();
+        });
+        interrupted = ThreadPool::isThreadInterrupted();
+    }, ThreadPool::Lane::BACKGROUND, token);
+
+    REQUIRE(waitFor([&]()
+    {
+        return started.load();
+    }));
+    REQUIRE(!ThreadPool::isThreadInterrupted());
+    token.cancel();
+    REQUIRE(waitForIdleLane(pool, ThreadPool::Lane::BACKGROUND));
+    REQUIRE(interrupted);
+}
+
+TEST_CASE("ThreadPool runs every queued functor before being destroyed")
+{
+    std::atomic<int> executed{0};
+    {
+        ThreadPool pool(4);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.push([&]()
+            {
+                // Pushed from a worker, to its own queues
+                for (int j = 0; j < 10; ++j)
+                {
+                    pool.push([&]()
+                    {
+                        executed++;
+                    });
+                }
+                executed++;
+            }, static_cast<ThreadPool::Lane>(i % ThreadPool::LANES));
+        }
+    }
+    REQUIRE(executed == 1100);
+}
@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include "UniqueNameIndex.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+TEST_CASE("UniqueNameIndex hands out the lowest free counter")
+{
+    UniqueNameIndex index;
+    index.addName(QString::fromUtf8("report.pdf"));
+    index.addName(QString::fromUtf8("Report(1).PDF"));
+    index.addName(QString::fromUtf8("report(3).pdf"));
+
+    REQUIRE(index.contains(QString::fromUtf8("REPORT.pdf")));
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("report"), QString::fromUtf8(".pdf")) == 2);
+    // Not used until it is added
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("report"), QString::fromUtf8(".pdf")) == 2);
+
+    index.addName(UniqueNameIndex::getCounterName(QString::fromUtf8("report"), 2, QString::fromUtf8(".pdf")));
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("report"), QString::fromUtf8(".pdf")) == 4);
+
+    // Every stem and suffix has its own counter
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("report"), QString::fromUtf8(".txt")) == 1);
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("other"), QString()) == 1);
+    REQUIRE(UniqueNameIndex::getCounterName(QString::fromUtf8("other"), 1, QString()) == QString::fromUtf8("other(1)"));
+}
+
+TEST_CASE("UniqueNameIndex shares a batch of renames")
+{
+    UniqueNameIndex index;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto counter(index.getFreeCounter(QString::fromUtf8("photo"), QString::fromUtf8(".jpg")));
+        REQUIRE(counter == i + 1);
+        index.addName(UniqueNameIndex::getCounterName(QString::fromUtf8("photo"), counter, QString::fromUtf8(".jpg")));
+    }
+
+    UniqueNameIndexes indexes;
+    indexes.getIndex(1).addName(QString::fromUtf8("a(1)"));
+    REQUIRE(indexes.getIndex(1).getFreeCounter(QString::fromUtf8("a"), QString()) == 2);
+    REQUIRE(indexes.getIndex(2).getFreeCounter(QString::fromUtf8("a"), QString()) == 1);
+}
+
+TEST_CASE("UniqueNameIndex reads the local folder once")
+{
+    QTemporaryDir dir;
+    for (const auto& name : {"notes(1).txt", "notes(2).txt"})
+    {
+        QFile file(QDir(dir.path()).filePath(QString::fromUtf8(name)));
+        REQUIRE(file.open(QIODevice::WriteOnly));
+    }
+
+    UniqueNameIndex index;
+    index.addLocalEntries(dir.path(), false);
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("notes"), QString::fromUtf8(".txt")) == 3);
+
+    // The files created later are not seen, the caller adds the names it uses
+    QFile file(QDir(dir.path()).filePath(QString::fromUtf8("notes(3).txt")));
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    index.addLocalEntries(dir.path(), false);
+    REQUIRE(index.getFreeCounter(QString::fromUtf8("notes"), QString::fromUtf8(".txt")) == 3);
+}
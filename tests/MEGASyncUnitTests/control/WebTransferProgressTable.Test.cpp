@@ -0,0 +1,50 @@
+#include <catch.hpp>
+#include "WebTransferProgressTable.h"
+
+using namespace mega;
+
+TEST_CASE("Web transfer progress table keeps the changed handles")
+{
+    WebTransferProgressTable table;
+    table.track(1);
+    table.track(2);
+    REQUIRE(table.takeChangedHandles().size() == 2);
+    REQUIRE(table.takeChangedHandles().isEmpty());
+
+    REQUIRE(table.update(2, MegaTransfer::STATE_ACTIVE, 10, 100, 5, QString(), 1000));
+    REQUIRE(table.update(2, MegaTransfer::STATE_ACTIVE, 20, 100, 5, QString(), 1000));
+    REQUIRE(!table.update(3, MegaTransfer::STATE_ACTIVE, 20, 100, 5, QString(), 1000));
+
+    auto changedHandles = table.takeChangedHandles();
+    REQUIRE(changedHandles.size() == 1);
+    REQUIRE(changedHandles.first() == 2);
+    REQUIRE(table.value(2)->progress == 20);
+    REQUIRE(table.value(3) == nullptr);
+}
+
+TEST_CASE("Web transfer progress table purges only the expired transfers")
+{
+    constexpr long long MAX_AGE{1800};
+    WebTransferProgressTable table;
+    table.track(1);
+    table.track(2);
+    table.track(3);
+
+    table.update(1, MegaTransfer::STATE_COMPLETED, 100, 100, 0, QString(), 1000);
+    table.update(2, MegaTransfer::STATE_FAILED, 0, 100, 0, QString(), 1500);
+    table.update(3, MegaTransfer::STATE_ACTIVE, 50, 100, 0, QString(), 1500);
+
+    table.purgeExpired(1000 + MAX_AGE, MAX_AGE);
+    REQUIRE(table.size() == 3);
+
+    table.purgeExpired(1000 + MAX_AGE + WebTransferProgressTable::EXPIRY_BUCKET_SECS, MAX_AGE);
+    REQUIRE(!table.contains(1));
+    REQUIRE(table.contains(2));
+
+    // Started again after finishing, it is not purged with its old end time
+    table.track(2);
+    table.purgeExpired(100000, MAX_AGE);
+    REQUIRE(table.size() == 2);
+    REQUIRE(table.contains(2));
+    REQUIRE(table.contains(3));
+}
@@ -0,0 +1,202 @@
+#include <catch.hpp>
+#include "CoalescingShellNotifier.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+namespace
+{
+class RecordingShellNotifier : public AbstractShellNotifier
+{
+public:
+    void notify(const QString& path) override
+    {
+        notifiedPaths.append(path);
+        if (reportsProcessed)
+        {
+            emit shellNotificationProcessed();
+        }
+    }
+
+    QStringList notifiedPaths;
+    bool reportsProcessed = true;
+};
+
+struct NotifierFixture
+{
+    explicit NotifierFixture(const CoalescingShellNotifier::Options& options)
+        : base(std::make_shared<RecordingShellNotifier>())
+        , notifier(base, options)
+    {
+        QObject::connect(&notifier, &AbstractShellNotifier::shellNotificationProcessed, &notifier, [this]()
+        {
+            ++processed;
+        });
+    }
+
+    // Runs the event loop until every notification is processed
+    void waitUntilProcessed(int notifications)
+    {
+        QEventLoop loop;
+        QTimer check;
+        QObject::connect(&check, &QTimer::timeout, &loop, [&]()
+        {
+            if (processed >= notifications)
+            {
+                loop.quit();
+            }
+        });
+        QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+        check.start(5);
+        loop.exec();
+    }
+
+    std::shared_ptr<RecordingShellNotifier> base;
+    CoalescingShellNotifier notifier;
+    int processed = 0;
+};
+
+CoalescingShellNotifier::Options getOptions()
+{
+    CoalescingShellNotifier::Options options;
+    options.windowMs = 20;
+    return options;
+}
+}
+
+TEST_CASE("CoalescingShellNotifier sends the repeated paths once")
+{
+    NotifierFixture fixture(getOptions());
+    for (int i = 0; i < 10; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/a"));
+        fixture.notifier.notify(QString::fromUtf8("/sync/b"));
+    }
+    REQUIRE(fixture.base->notifiedPaths.isEmpty());
+
+    fixture.waitUntilProcessed(20);
+    REQUIRE(fixture.processed == 20);
+    REQUIRE(fixture.base->notifiedPaths == QStringList({QString::fromUtf8("/sync/a"), QString::fromUtf8("/sync/b")}));
+
+    const auto stats(fixture.notifier.getStats());
+    REQUIRE(stats.received == 20);
+    REQUIRE(stats.notified == 2);
+    REQUIRE(stats.deduplicated == 18);
+    REQUIRE(stats.queueDepth == 0);
+    REQUIRE(stats.maxQueueDepth == 2);
+}
+
+TEST_CASE("CoalescingShellNotifier replaces the pending children by the folder")
+{
+    auto options(getOptions());
+    options.maxPendingChildren = 3;
+    NotifierFixture fixture(options);
+    for (int i = 0; i < 10; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/folder/file%1").arg(i));
+    }
+    fixture.notifier.notify(QString::fromUtf8("/sync/other"));
+
+    fixture.waitUntilProcessed(11);
+    REQUIRE(fixture.processed == 11);
+    REQUIRE(fixture.base->notifiedPaths == QStringList({QString::fromUtf8("/sync/folder"), QString::fromUtf8("/sync/other")}));
+    REQUIRE(fixture.notifier.getStats().collapsed == 9);
+}
+
+TEST_CASE("CoalescingShellNotifier drops the notifications beyond the queue limit")
+{
+    auto options(getOptions());
+    options.maxPendingPaths = 5;
+    NotifierFixture fixture(options);
+    for (int i = 0; i < 8; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/file%1").arg(i));
+    }
+    // The dropped ones are processed at once, so the pending count of the app is not left behind
+    REQUIRE(fixture.processed == 3);
+
+    fixture.waitUntilProcessed(8);
+    REQUIRE(fixture.processed == 8);
+    REQUIRE(fixture.base->notifiedPaths.size() == 5);
+    REQUIRE(fixture.notifier.getStats().dropped == 3);
+}
+
+TEST_CASE("CoalescingShellNotifier sends a pending ancestor in place of the paths beyond the queue limit")
+{
+    auto options(getOptions());
+    options.maxPendingPaths = 2;
+    options.maxPendingChildren = 100;
+    NotifierFixture fixture(options);
+    fixture.notifier.notify(QString::fromUtf8("/sync/folder"));
+    fixture.notifier.notify(QString::fromUtf8("/sync/other"));
+    fixture.notifier.notify(QString::fromUtf8("/sync/folder/sub/file"));
+
+    fixture.waitUntilProcessed(3);
+    REQUIRE(fixture.processed == 3);
+    REQUIRE(fixture.base->notifiedPaths == QStringList({QString::fromUtf8("/sync/folder"), QString::fromUtf8("/sync/other")}));
+    REQUIRE(fixture.notifier.getStats().collapsed == 1);
+    REQUIRE(fixture.notifier.getStats().dropped == 0);
+}
+
+TEST_CASE("CoalescingShellNotifier sends the root path in place of the paths beyond the queue limit")
+{
+    auto options(getOptions());
+    options.maxPendingPaths = 2;
+    options.getRootPath = [](const QString& path)
+    {
+        return path.startsWith(QLatin1String("/sync/")) ? QString::fromUtf8("/sync") : QString();
+    };
+    NotifierFixture fixture(options);
+    for (int i = 0; i < 4; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/file%1").arg(i));
+    }
+    // Nothing to refresh in its place
+    fixture.notifier.notify(QString::fromUtf8("/other/file"));
+    REQUIRE(fixture.processed == 1);
+
+    fixture.waitUntilProcessed(5);
+    REQUIRE(fixture.processed == 5);
+    REQUIRE(fixture.base->notifiedPaths == QStringList({QString::fromUtf8("/sync/file0"), QString::fromUtf8("/sync/file1"),
+                                                        QString::fromUtf8("/sync")}));
+    REQUIRE(fixture.notifier.getStats().collapsed == 2);
+    REQUIRE(fixture.notifier.getStats().dropped == 1);
+}
+
+TEST_CASE("CoalescingShellNotifier reports the processed paths when the base notifier does not")
+{
+    auto options(getOptions());
+    options.baseReportsProcessed = false;
+    NotifierFixture fixture(options);
+    fixture.base->reportsProcessed = false;
+    for (int i = 0; i < 10; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/a"));
+        fixture.notifier.notify(QString::fromUtf8("/sync/file%1").arg(i));
+    }
+
+    fixture.waitUntilProcessed(20);
+    REQUIRE(fixture.processed == 20);
+    REQUIRE(fixture.base->notifiedPaths.size() == 11);
+}
+
+TEST_CASE("CoalescingShellNotifier limits the notifications per second")
+{
+    auto options(getOptions());
+    options.maxNotificationsPerSecond = 200;
+    NotifierFixture fixture(options);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 100; ++i)
+    {
+        fixture.notifier.notify(QString::fromUtf8("/sync/file%1").arg(i));
+    }
+    fixture.waitUntilProcessed(100);
+
+    REQUIRE(fixture.processed == 100);
+    REQUIRE(fixture.base->notifiedPaths.size() == 100);
+    // 100 notifications at 200 per second, starting with an empty budget
+    REQUIRE(timer.elapsed() >= 400);
+}
@@ -0,0 +1,159 @@
+#include <catch.hpp>
+#include "linux/ExtServer.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr char ASCII_FILE_SEP{0x1C};
+const QString BENCHMARK_SOCKET_NAME{QString::fromLatin1("mega.benchmark.socket")};
+
+// The states are not the point of the benchmark, only the requests
+class BenchmarkExtServer : public ExtServer
+{
+public:
+    BenchmarkExtServer() : ExtServer(MegaSyncApp, BENCHMARK_SOCKET_NAME) {}
+
+protected:
+    int getSyncPathState(std::string&) override
+    {
+        return mega::MegaApi::STATE_SYNCED;
+    }
+};
+
+// Blocking client, like the ones of the file manager extensions
+class ExtClient
+{
+public:
+    explicit ExtClient(const std::string& socketPath)
+    {
+        mSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un remote{};
+        remote.sun_family = AF_UNIX;
+        strncpy(remote.sun_path, socketPath.c_str(), sizeof(remote.sun_path) - 1);
+        if (connect(mSocket, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == -1)
+        {
+            close(mSocket);
+            mSocket = -1;
+        }
+    }
+
+    ~ExtClient()
+    {
+        if (mSocket >= 0)
+        {
+            close(mSocket);
+        }
+    }
+
+    bool isConnected() const
+    {
+        return mSocket >= 0;
+    }
+
+    std::string request(const std::string& request)
+    {
+        size_t written = 0;
+        while (written < request.size())
+        {
+            auto result = write(mSocket, request.data() + written, request.size() - written);
+            if (result <= 0)
+            {
+                return std::string();
+            }
+            written += static_cast<size_t>(result);
+        }
+
+        std::string response;
+        char c;
+        while (read(mSocket, &c, 1) == 1 && c != '\n')
+        {
+            response.push_back(c);
+        }
+        return response;
+    }
+
+private:
+    int mSocket;
+};
+
+// Runs the client requests in another thread, while the server answers them in this one
+template<typename ClientWork>
+long long measureMs(ClientWork work)
+{
+    auto start(std::chrono::steady_clock::now());
+    auto result(std::async(std::launch::async, work));
+    while (result.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    }
+    REQUIRE(result.get());
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// Run with "[.benchmark]" to compare one request per entry against a single batched request per folder
+TEST_CASE("ExtServer path states of synthetic folders", "[.benchmark]")
+{
+    QTemporaryDir dataDir;
+    REQUIRE(dataDir.isValid());
+    Preferences::instance()->initialize(dataDir.path());
+
+    BenchmarkExtServer server;
+    const std::string socketPath((MegaApplication::applicationDataPath() + QDir::separator()
+                                  + BENCHMARK_SOCKET_NAME).toStdString());
+
+    for (int entries : {100, 1000, 20000})
+    {
+        QTemporaryDir folder;
+        REQUIRE(folder.isValid());
+        for (int entry = 0; entry < entries; ++entry)
+        {
+            QFile file(folder.filePath(QString::fromLatin1("synthetic entry %1.txt").arg(entry)));
+            REQUIRE(file.open(QIODevice::WriteOnly));
+        }
+        const std::string folderPath(folder.path().toStdString());
+        const QStringList names(QDir(folder.path()).entryList(QDir::Files));
+
+        auto singleMs = measureMs([&]()
+        {
+            ExtClient client(socketPath);
+            bool ok(client.isConnected());
+            for (const auto& name : names)
+            {
+                auto request(std::string("P:") + folderPath + "/" + name.toStdString() + ASCII_FILE_SEP + "0");
+                ok = ok && client.request(request) == "0";
+            }
+            return ok;
+        });
+
+        auto batchMs = measureMs([&]()
+        {
+            ExtClient client(socketPath);
+            auto request(std::string("B:0") + ASCII_FILE_SEP + folderPath);
+            for (const auto& name : names)
+            {
+                request += ASCII_FILE_SEP + name.toStdString();
+            }
+            request += '\n';
+
+            auto response(client.isConnected() ? client.request(request) : std::string());
+            return response.size() == static_cast<size_t>(names.size() * 2 - 1);
+        });
+
+        WARN(entries << " entries: " << singleMs << " ms with one request per entry, "
+             << batchMs << " ms with a batched request");
+    }
+}
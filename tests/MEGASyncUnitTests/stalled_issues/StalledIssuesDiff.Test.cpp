@@ -0,0 +1,247 @@
+#include <catch.hpp>
+#include "StalledIssuesDiff.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QSortFilterProxyModel>
+
+#include <chrono>
+#include <random>
+
+namespace
+{
+// One key per character
+QVector<QString> toKeys(const std::string& keys)
+{
+    QVector<QString> result;
+    for(auto key : keys)
+    {
+        result.append(QString(QLatin1Char(key)));
+    }
+    return result;
+}
+
+// Same steps as the model: removals, reorder and then insertions
+QVector<QString> applyDiff(const QVector<QString>& oldKeys, const QVector<QString>& newKeys)
+{
+    StalledIssuesDiff diff(oldKeys, newKeys);
+
+    auto keys(oldKeys);
+    for(const auto& rows : diff.removedRows())
+    {
+        keys.remove(rows.first, rows.last - rows.first + 1);
+    }
+
+    QVector<QString> reordered;
+    for(auto oldRow : diff.oldRows())
+    {
+        if(oldRow >= 0)
+        {
+            reordered.append(oldKeys.at(oldRow));
+        }
+    }
+    REQUIRE(diff.isReordered() == (reordered != keys));
+    keys = reordered;
+
+    for(const auto& rows : diff.insertedRows())
+    {
+        for(int row = rows.first; row <= rows.last; ++row)
+        {
+            keys.insert(row, newKeys.at(row));
+        }
+    }
+    return keys;
+}
+
+// Changes its rows as StalledIssuesModel::updateRows does, with a proxy on top like the stalled issues view
+class KeysModel : public QAbstractListModel
+{
+public:
+    explicit KeysModel(const QVector<QString>& keys)
+        : mKeys(keys)
+    {
+        updateOrder(0);
+    }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : mKeys.size();
+    }
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        return role == Qt::DisplayRole ? QVariant(mKeys.at(index.row())) : QVariant();
+    }
+
+    void updateRows(const StalledIssuesDiff& diff, const QVector<QString>& keys)
+    {
+        for(const auto& rows : diff.removedRows())
+        {
+            beginRemoveRows(QModelIndex(), rows.first, rows.last);
+            for(int row = rows.first; row <= rows.last; ++row)
+            {
+                mOrder.remove(mKeys.at(row));
+            }
+            mKeys.remove(rows.first, rows.last - rows.first + 1);
+            updateOrder(rows.first);
+            endRemoveRows();
+        }
+
+        for(const auto& rows : diff.insertedRows())
+        {
+            beginInsertRows(QModelIndex(), rows.first, rows.last);
+            for(int row = rows.first; row <= rows.last; ++row)
+            {
+                mKeys.insert(row, keys.at(row));
+            }
+            updateOrder(rows.first);
+            endInsertRows();
+        }
+    }
+
+    void reset(const QVector<QString>& keys)
+    {
+        beginResetModel();
+        mKeys = keys;
+        mOrder.clear();
+        updateOrder(0);
+        endResetModel();
+    }
+
+    const QVector<QString>& keys() const
+    {
+        return mKeys;
+    }
+
+private:
+    void updateOrder(int firstRow)
+    {
+        for(int row = firstRow; row < mKeys.size(); ++row)
+        {
+            mOrder.insert(mKeys.at(row), row);
+        }
+    }
+
+    QVector<QString> mKeys;
+    QHash<QString, int> mOrder;
+};
+
+QString stallKey(int id)
+{
+    // Similar to a real key: reason, side and paths
+    return QString::fromLatin1("3\x1f" "0\x1f/home/user/MEGA/folder%1/file%2.txt\x1f" "0\x1f/folder%1/file%2.txt")
+        .arg(id / 100).arg(id);
+}
+}
+
+TEST_CASE("StalledIssuesDiff finds the rows to remove and insert")
+{
+    StalledIssuesDiff diff(toKeys("abcdef"), toKeys("axbefyz"));
+
+    REQUIRE(diff.removedCount() == 2);
+    REQUIRE(diff.removedRows().size() == 1);
+    REQUIRE(diff.removedRows().first().first == 2);
+    REQUIRE(diff.removedRows().first().last == 3);
+
+    REQUIRE(diff.insertedCount() == 3);
+    REQUIRE(diff.insertedRows().size() == 2);
+    REQUIRE(diff.insertedRows().at(0).first == 1);
+    REQUIRE(diff.insertedRows().at(0).last == 1);
+    REQUIRE(diff.insertedRows().at(1).first == 5);
+    REQUIRE(diff.insertedRows().at(1).last == 6);
+
+    REQUIRE(diff.oldRows() == QVector<int>({0, -1, 1, 4, 5, -1, -1}));
+    REQUIRE(!diff.isReordered());
+}
+
+TEST_CASE("StalledIssuesDiff turns the old list into the new one")
+{
+    auto oldKeys = GENERATE(as<std::string>{}, "", "abc", "abcabc", "aaab", "abcdefgh");
+    auto newKeys = GENERATE(as<std::string>{}, "", "abc", "cba", "bcaacb", "aab", "xaybzc", "hgfedcba", "x");
+
+    CAPTURE(oldKeys, newKeys);
+    REQUIRE(applyDiff(toKeys(oldKeys), toKeys(newKeys)) == toKeys(newKeys));
+}
+
+TEST_CASE("StalledIssuesDiff is incremental while few rows change compared with the list size")
+{
+    constexpr int ISSUES = 30000;
+    QVector<QString> oldKeys;
+    for(int id = 0; id < ISSUES; ++id)
+    {
+        oldKeys.append(stallKey(id));
+    }
+
+    // 1% scattered churn
+    auto newKeys(oldKeys);
+    for(int row = 0; row < ISSUES; row += 100)
+    {
+        newKeys[row] = stallKey(ISSUES + row);
+    }
+    StalledIssuesDiff fewChanges(oldKeys, newKeys);
+    REQUIRE(fewChanges.removedRows().size() == ISSUES / 100);
+    REQUIRE(fewChanges.isIncremental());
+
+    // 20% churn
+    for(int row = 0; row < ISSUES; row += 5)
+    {
+        newKeys[row] = stallKey(ISSUES + row);
+    }
+    REQUIRE(!StalledIssuesDiff(oldKeys, newKeys).isIncremental());
+
+    // The small lists are always updated row by row
+    REQUIRE(StalledIssuesDiff(toKeys("abcdef"), toKeys("uvwxyz")).isIncremental());
+}
+
+TEST_CASE("StalledIssuesDiff benchmark with synthetic stall lists", "[.benchmark]")
+{
+    constexpr int ISSUES = 30000;
+    std::mt19937 generator(ISSUES);
+
+    QVector<QString> oldKeys;
+    for(int id = 0; id < ISSUES; ++id)
+    {
+        oldKeys.append(stallKey(id));
+    }
+
+    for(auto churn : {0, 1, 10, 50, 100})
+    {
+        // Some issues are solved and new ones appear in their place
+        auto newKeys(oldKeys);
+        std::uniform_int_distribution<int> rows(0, ISSUES - 1);
+        auto nextId(ISSUES);
+        for(int changed = 0; changed < ISSUES * churn / 100; ++changed)
+        {
+            newKeys[rows(generator)] = stallKey(nextId++);
+        }
+
+        auto start(std::chrono::steady_clock::now());
+        StalledIssuesDiff diff(oldKeys, newKeys);
+        auto elapsed(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+        REQUIRE(!diff.isReordered());
+
+        // Applying the changes row by row and reloading everything, both seen through a proxy
+        KeysModel incrementalModel(oldKeys);
+        QSortFilterProxyModel incrementalProxy;
+        incrementalProxy.setSourceModel(&incrementalModel);
+        start = std::chrono::steady_clock::now();
+        incrementalModel.updateRows(diff, newKeys);
+        auto incrementalElapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+        REQUIRE(incrementalModel.keys() == newKeys);
+
+        KeysModel resetModel(oldKeys);
+        QSortFilterProxyModel resetProxy;
+        resetProxy.setSourceModel(&resetModel);
+        start = std::chrono::steady_clock::now();
+        resetModel.reset(newKeys);
+        auto resetElapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+        REQUIRE(resetProxy.rowCount() == newKeys.size());
+
+        WARN(churn << "% churn: diff " << elapsed.count() << " us, "
+                   << diff.removedRows().size() << " removed ranges, "
+                   << diff.insertedRows().size() << " inserted ranges, "
+                   << "row by row " << incrementalElapsed.count() << " ms, "
+                   << "reset " << resetElapsed.count() << " ms, "
+                   << (diff.isIncremental() ? "row by row" : "reset") << " chosen");
+    }
+}
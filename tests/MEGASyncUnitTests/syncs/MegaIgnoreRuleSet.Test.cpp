@@ -0,0 +1,188 @@
+#include <catch.hpp>
+#include "syncs/control/MegaIgnoreManager.h"
+#include "syncs/control/MegaIgnoreRuleSet.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+// Same as MegaIgnoreManager::parseIgnoresFile
+QList<std::shared_ptr<MegaIgnoreRule>> parseRules(const QStringList& lines)
+{
+    QList<std::shared_ptr<MegaIgnoreRule>> rules;
+    for (const auto& line : lines)
+    {
+        const bool isCommented(line.startsWith(QLatin1String("#")));
+        switch (MegaIgnoreManager::getRuleType(line))
+        {
+            case MegaIgnoreRule::RuleType::SIZERULE:
+                rules.append(std::make_shared<MegaIgnoreSizeRule>(line, isCommented));
+                break;
+            case MegaIgnoreRule::RuleType::EXTENSIONRULE:
+                rules.append(std::make_shared<MegaIgnoreExtensionRule>(line, isCommented));
+                break;
+            case MegaIgnoreRule::RuleType::NAMERULE:
+                rules.append(std::make_shared<MegaIgnoreNameRule>(line, isCommented));
+                break;
+            default:
+                rules.append(std::make_shared<MegaIgnoreInvalidRule>(line, isCommented));
+                break;
+        }
+    }
+    return rules;
+}
+
+MegaIgnoreRuleSet::Entry file(const char* path, long long size = 100)
+{
+    MegaIgnoreRuleSet::Entry entry;
+    entry.path = QString::fromUtf8(path);
+    entry.size = size;
+    return entry;
+}
+
+MegaIgnoreRuleSet::Entry folder(const char* path)
+{
+    MegaIgnoreRuleSet::Entry entry;
+    entry.path = QString::fromUtf8(path);
+    entry.isFolder = true;
+    return entry;
+}
+}
+
+TEST_CASE("MegaIgnoreRuleSet tells which rule excludes a path")
+{
+    const auto rules(parseRules(QStringList()
+                                << QLatin1String("-:*.tmp")
+                                << QLatin1String("-d:node_modules")
+                                << QLatin1String("+:keep.tmp")
+                                << QLatin1String("-p:docs/private*")
+                                << QLatin1String("-N:build")
+                                << QLatin1String("-G:*.LOG")
+                                << QLatin1String("-:temp?[0-9].txt")
+                                << QLatin1String("-r:.*\\.ba[kK]")
+                                << QLatin1String("#-:*.txt")
+                                << QLatin1String("-s:*")
+                                << QLatin1String("exclude-larger:1k")
+                                << QLatin1String("exclude-smaller:10")));
+    MegaIgnoreRuleSet ruleSet(rules);
+    REQUIRE(ruleSet.compiledRulesCount() == 9);
+
+    auto excludedBy = [&](const MegaIgnoreRuleSet::Entry& entry, int ruleIndex)
+    {
+        auto match(ruleSet.match(entry));
+        return match.excluded && match.rule == rules.at(ruleIndex);
+    };
+
+    // Extension, and a later rule including it again
+    REQUIRE(excludedBy(file("a.tmp"), 0));
+    REQUIRE(excludedBy(file("folder/b.TMP"), 0));
+    REQUIRE(!ruleSet.match(file("folder/KEEP.tmp")).excluded);
+    REQUIRE(ruleSet.match(file("folder/KEEP.tmp")).rule == rules.at(2));
+
+    // Folders only, and everything inside them
+    REQUIRE(excludedBy(folder("src/node_modules"), 1));
+    REQUIRE(excludedBy(file("src/node_modules/lib/index.js"), 1));
+    REQUIRE(!ruleSet.match(file("node_modules")).excluded);
+
+    // Path
+    REQUIRE(excludedBy(file("docs/private/notes.txt"), 3));
+    REQUIRE(!ruleSet.match(file("other/docs/private/notes.txt")).excluded);
+
+    // Only in the root
+    REQUIRE(excludedBy(folder("build"), 4));
+    REQUIRE(!ruleSet.match(folder("src/build")).excluded);
+
+    // Case sensitive
+    REQUIRE(excludedBy(file("server.LOG"), 5));
+    REQUIRE(!ruleSet.match(file("server.log")).excluded);
+
+    // Glob and regular expression
+    REQUIRE(excludedBy(file("tempa1.txt"), 6));
+    REQUIRE(!ruleSet.match(file("tempa.txt")).excluded);
+    REQUIRE(excludedBy(file("data.BAK"), 7));
+
+    // Symbolic links
+    MegaIgnoreRuleSet::Entry link(file("link"));
+    link.isSymLink = true;
+    REQUIRE(excludedBy(link, 9));
+
+    // Sizes, only for files
+    REQUIRE(excludedBy(file("big.bin", 2048), 10));
+    REQUIRE(excludedBy(file("small.bin", 5), 11));
+    REQUIRE(!ruleSet.match(file("fits.bin", 1024)).excluded);
+    REQUIRE(ruleSet.match(file("fits.bin", 1024)).rule == nullptr);
+}
+
+TEST_CASE("MegaIgnoreRuleSet matches a batch as one entry at a time")
+{
+    MegaIgnoreRuleSet ruleSet(parseRules(QStringList()
+                                         << QLatin1String("-d:cache")
+                                         << QLatin1String("+:important*")
+                                         << QLatin1String("-:*.o")));
+
+    const QVector<MegaIgnoreRuleSet::Entry> entries{folder("cache"),
+                                                    file("cache/important.txt"),
+                                                    file("src/main.o"),
+                                                    file("src/important.o"),
+                                                    file("src/main.cpp")};
+    const auto matches(ruleSet.match(entries));
+    REQUIRE(matches.size() == entries.size());
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto match(ruleSet.match(entries.at(i)));
+        REQUIRE(matches.at(i).excluded == match.excluded);
+        REQUIRE(matches.at(i).rule == match.rule);
+    }
+    REQUIRE(matches.at(1).excluded);
+    REQUIRE(matches.at(2).excluded);
+    REQUIRE(matches.at(3).excluded);
+    REQUIRE(!matches.at(4).excluded);
+}
+
+TEST_CASE("MegaIgnoreRuleSet benchmark with a synthetic sync tree", "[.benchmark]")
+{
+    QStringList lines;
+    lines << QLatin1String("-:*.tmp") << QLatin1String("-:*.bak") << QLatin1String("-:*.o")
+          << QLatin1String("-:*.pyc") << QLatin1String("-:*.log") << QLatin1String("-d:node_modules")
+          << QLatin1String("-d:.git") << QLatin1String("-:Thumbs.db") << QLatin1String("-:.DS_Store")
+          << QLatin1String("-:~*") << QLatin1String("-:*cache*") << QLatin1String("-:*.sw[op]")
+          << QLatin1String("-p:build/*") << QLatin1String("-r:core\\.[0-9]+") << QLatin1String("+:keep*")
+          << QLatin1String("exclude-larger:100m");
+    MegaIgnoreRuleSet ruleSet(parseRules(lines));
+
+    constexpr int FOLDERS = 10000;
+    constexpr int FILES_PER_FOLDER = 100;
+    static const char* extensions[] = {".txt", ".tmp", ".cpp", ".o", ".jpg", ".log", ".swp", ".pdf"};
+
+    QVector<MegaIgnoreRuleSet::Entry> entries;
+    entries.reserve(FOLDERS * (FILES_PER_FOLDER + 1));
+    for (int folderIndex = 0; folderIndex < FOLDERS; ++folderIndex)
+    {
+        MegaIgnoreRuleSet::Entry folderEntry;
+        folderEntry.path = QString::fromUtf8("projects/p%1/src/module%2").arg(folderIndex / 100).arg(folderIndex % 100);
+        folderEntry.isFolder = true;
+        entries.append(folderEntry);
+
+        for (int fileIndex = 0; fileIndex < FILES_PER_FOLDER; ++fileIndex)
+        {
+            MegaIgnoreRuleSet::Entry fileEntry;
+            fileEntry.path = folderEntry.path + QString::fromUtf8("/file%1").arg(fileIndex)
+                             + QString::fromUtf8(extensions[fileIndex % 8]);
+            fileEntry.size = fileIndex * 1024;
+            entries.append(fileEntry);
+        }
+    }
+
+    auto start(std::chrono::steady_clock::now());
+    auto matches(ruleSet.match(entries));
+    auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+
+    auto excluded(std::count_if(matches.begin(), matches.end(), [](const MegaIgnoreRuleSet::Match& match)
+    {
+        return match.excluded;
+    }));
+    WARN(entries.size() << " entries, " << ruleSet.compiledRulesCount() << " rules: " << elapsed.count()
+         << " ms, " << excluded << " excluded");
+    REQUIRE(matches.size() == entries.size());
+}
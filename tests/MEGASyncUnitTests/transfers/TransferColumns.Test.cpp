@@ -0,0 +1,69 @@
+#include <catch.hpp>
+#include "TransferColumns.h"
+
+namespace
+{
+TransferData createData(bool isUpload, mega::MegaHandle nodeHandle, mega::MegaHandle parentHandle)
+{
+    TransferData data;
+    data.mType = isUpload ? TransferData::TRANSFER_UPLOAD : TransferData::TRANSFER_DOWNLOAD;
+    data.mNodeHandle = nodeHandle;
+    data.mParentHandle = parentHandle;
+    return data;
+}
+}
+
+TEST_CASE("TransferColumns finds the downloads by node handle and the uploads by parent handle")
+{
+    TransferColumns columns;
+    columns.append(createData(false, 10, 100));
+    columns.append(createData(true, 10, 100));
+    columns.append(createData(false, 20, 200));
+    columns.append(createData(false, 10, 300));
+
+    REQUIRE(columns.findDownloadByNodeHandle(10) == 0);
+    REQUIRE(columns.findDownloadByNodeHandle(10, 1) == 3);
+    REQUIRE(columns.findDownloadByNodeHandle(10, 4) == -1);
+    REQUIRE(columns.findDownloadByNodeHandle(30) == -1);
+
+    // The downloads are not found by parent handle
+    REQUIRE(columns.findUploadByParentHandle(100) == 1);
+    REQUIRE(columns.findUploadByParentHandle(200) == -1);
+    REQUIRE(columns.findUploadByParentHandle(100, -5) == 1);
+}
+
+TEST_CASE("TransferColumns keeps the rows up to date")
+{
+    TransferColumns columns;
+    for(int row = 0; row < 5; ++row)
+    {
+        columns.append(createData(false, 10 + row, 100));
+    }
+
+    columns.update(2, createData(true, 50, 500));
+    REQUIRE(columns.findDownloadByNodeHandle(12) == -1);
+    REQUIRE(columns.findUploadByParentHandle(500) == 2);
+
+    // Out of range rows are ignored
+    columns.update(5, createData(true, 60, 600));
+    REQUIRE(columns.findUploadByParentHandle(600) == -1);
+
+    columns.remove(1, 2);
+    REQUIRE(columns.findDownloadByNodeHandle(10) == 0);
+    REQUIRE(columns.findDownloadByNodeHandle(11) == -1);
+    REQUIRE(columns.findUploadByParentHandle(500) == -1);
+    REQUIRE(columns.findDownloadByNodeHandle(13) == 1);
+    REQUIRE(columns.findDownloadByNodeHandle(14) == 2);
+
+    columns.remove(2, 5);
+    REQUIRE(columns.findDownloadByNodeHandle(14) == 2);
+
+    QList<QExplicitlySharedDataPointer<TransferData>> transfers;
+    transfers.append(QExplicitlySharedDataPointer<TransferData>(new TransferData(createData(true, 70, 700))));
+    columns.reset(transfers);
+    REQUIRE(columns.findDownloadByNodeHandle(10) == -1);
+    REQUIRE(columns.findUploadByParentHandle(700) == 0);
+
+    columns.clear();
+    REQUIRE(columns.findUploadByParentHandle(700) == -1);
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+#include "TransferItem.h"
+#include "ResourceUsageSampler.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+TransferData createData(const QString& path)
+{
+    TransferData data;
+    data.mFilename = path.mid(std::max(path.lastIndexOf(QLatin1Char('/')), path.lastIndexOf(QLatin1Char('\\'))) + 1);
+    data.setPath(path);
+    return data;
+}
+}
+
+TEST_CASE("TransferData rebuilds the path from the parent folder and the leaf name")
+{
+    auto path = GENERATE(as<QString>{},
+                         QLatin1String("/home/user/MEGA/folder/file.txt"),
+                         QLatin1String("C:\\Users\\user\\MEGA\\file.txt"),
+                         QLatin1String("/home/user/MEGA/folder/"),
+                         QLatin1String("file.txt"),
+                         QLatin1String(""));
+    CAPTURE(path.toStdString());
+    REQUIRE(createData(path).path() == path);
+
+    // The leaf is not always the file name (i.e. the temporary files of a download)
+    TransferData data;
+    data.mFilename = QLatin1String("file.txt");
+    data.setPath(path + QLatin1String(".mega"));
+    REQUIRE(data.path() == path + QLatin1String(".mega"));
+}
+
+#ifdef WIN32
+TEST_CASE("TransferData removes the long path prefix")
+{
+    REQUIRE(createData(QLatin1String("\\\\?\\C:\\MEGA\\file.txt")).path() == QLatin1String("C:\\MEGA\\file.txt"));
+}
+#endif
+
+#ifdef Q_OS_LINUX
+// Run with "[.benchmark]" to compare the memory of the rows with a full path per row, as it was stored before
+TEST_CASE("TransferData memory benchmark with 500k transfers", "[.benchmark]")
+{
+    constexpr int TRANSFERS{500000};
+    constexpr int FILES_PER_FOLDER{500};
+
+    auto anonymousBytes = []()
+    {
+        ResourceUsageSample sample;
+        REQUIRE(ResourceUsageSampler::readProcessUsage(sample));
+        return sample.anonymousBytes;
+    };
+
+    auto createRows = [](bool fullPaths, std::vector<TransferData>& rows, std::vector<QString>& paths)
+    {
+        rows.reserve(TRANSFERS);
+        for(int transfer = 0; transfer < TRANSFERS; ++transfer)
+        {
+            auto filename(QString::fromLatin1("file_%1.jpg").arg(transfer));
+            // Each path is built again, as it comes from the SDK
+            auto path(QString::fromLatin1("/home/user/Pictures/Camera uploads/%1/").arg(transfer / FILES_PER_FOLDER)
+                      + filename);
+            rows.push_back(TransferData());
+            rows.back().mFilename = filename;
+            rows.back().setPath(path);
+            if(fullPaths)
+            {
+                paths.push_back(path);
+            }
+        }
+    };
+
+    // Both sets of rows are kept, so the second one does not reuse the memory freed by the first one
+    std::vector<TransferData> sharedRows;
+    std::vector<TransferData> fullPathRows;
+    std::vector<QString> paths;
+    paths.reserve(TRANSFERS);
+
+    auto before(anonymousBytes());
+    createRows(false, sharedRows, paths);
+    auto sharedBytes(anonymousBytes() - before);
+
+    before = anonymousBytes();
+    createRows(true, fullPathRows, paths);
+    auto fullPathBytes(anonymousBytes() - before);
+
+    WARN(TRANSFERS << " transfers: " << sharedBytes / TRANSFERS << " bytes per row with shared parent paths, "
+                   << fullPathBytes / TRANSFERS << " bytes per row with a full path per row ("
+                   << static_cast<double>(fullPathBytes) / sharedBytes << "x)");
+    REQUIRE(sharedBytes < fullPathBytes);
+}
+#endif
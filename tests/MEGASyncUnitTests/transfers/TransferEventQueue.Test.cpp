@@ -0,0 +1,170 @@
+#include <catch.hpp>
+#include "TransferEventQueue.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace
+{
+TransferEventQueue::Event createEvent(TransferTag tag, TransferEventQueue::Cache cache, long long notificationNumber = 0)
+{
+    TransferEventQueue::Event event;
+    event.data = QExplicitlySharedDataPointer<TransferData>(new TransferData());
+    event.data->mTag = tag;
+    event.data->mNotificationNumber = notificationNumber;
+    event.cache = cache;
+    return event;
+}
+
+struct DrainedEvent
+{
+    TransferTag tag;
+    TransferEventQueue::Cache cache;
+    long long notificationNumber;
+
+    bool operator==(const DrainedEvent& other) const
+    {
+        return tag == other.tag && cache == other.cache && notificationNumber == other.notificationNumber;
+    }
+};
+
+std::vector<DrainedEvent> drain(TransferEventQueue& queue)
+{
+    std::vector<DrainedEvent> events;
+    queue.drain([&events](const TransferEventQueue::Event& event)
+    {
+        events.push_back({event.data->mTag, event.cache, event.data->mNotificationNumber});
+    });
+    return events;
+}
+}
+
+TEST_CASE("TransferEventQueue keeps the order of the events that go through the overflow list")
+{
+    using Cache = TransferEventQueue::Cache;
+
+    TransferEventQueue queue(2);
+    for(TransferTag tag = 1; tag <= 5; ++tag)
+    {
+        queue.push(createEvent(tag, Cache::START));
+    }
+    REQUIRE(queue.hasEvents());
+
+    auto events(drain(queue));
+    REQUIRE(events.size() == 5);
+    for(TransferTag tag = 1; tag <= 5; ++tag)
+    {
+        REQUIRE(events[static_cast<size_t>(tag - 1)] == DrainedEvent{tag, Cache::START, 0});
+    }
+    REQUIRE_FALSE(queue.hasEvents());
+
+    auto stats(queue.getStats());
+    REQUIRE(stats.receivedEvents == 5);
+    REQUIRE(stats.overflowedEvents == 3);
+    REQUIRE(stats.maxOverflowEvents == 3);
+
+    // Once drained, the events go through the lock-free queue again
+    queue.push(createEvent(6, Cache::START));
+    REQUIRE(queue.getStats().overflowedEvents == 3);
+    REQUIRE(drain(queue) == std::vector<DrainedEvent>{{6, Cache::START, 0}});
+}
+
+TEST_CASE("TransferEventQueue keeps the latest update of each transfer in the overflow list")
+{
+    using Cache = TransferEventQueue::Cache;
+
+    TransferEventQueue queue(2);
+    queue.push(createEvent(1, Cache::START));
+    queue.push(createEvent(2, Cache::START));
+
+    // The queue is full from here
+    queue.push(createEvent(3, Cache::UPDATE, 1));
+    queue.push(createEvent(3, Cache::UPDATE, 3));
+    // Older than the pending one
+    queue.push(createEvent(3, Cache::UPDATE, 2));
+    queue.push(createEvent(4, Cache::START, 1));
+    queue.push(createEvent(4, Cache::UPDATE, 2));
+    queue.push(createEvent(4, Cache::FAILED, 3));
+    // A failure came after the pending update, so this one cannot replace it
+    queue.push(createEvent(4, Cache::UPDATE, 4));
+
+    std::vector<DrainedEvent> expected{{1, Cache::START, 0},
+                                       {2, Cache::START, 0},
+                                       {3, Cache::UPDATE, 3},
+                                       {4, Cache::START, 1},
+                                       {4, Cache::UPDATE, 2},
+                                       {4, Cache::FAILED, 3},
+                                       {4, Cache::UPDATE, 4}};
+    REQUIRE(drain(queue) == expected);
+
+    auto stats(queue.getStats());
+    REQUIRE(stats.receivedEvents == 9);
+    REQUIRE(stats.overflowedEvents == 7);
+    REQUIRE(stats.overflowCoalescedEvents == 2);
+    REQUIRE(stats.maxOverflowEvents == 5);
+}
+
+TEST_CASE("TransferEventQueue delivers the events of concurrent producers to one consumer")
+{
+    using Cache = TransferEventQueue::Cache;
+
+    constexpr int PRODUCERS{4};
+    constexpr int TRANSFERS_PER_PRODUCER{50};
+    constexpr int UPDATES_PER_TRANSFER{1000};
+
+    // Small, so most of the events go through the overflow list
+    TransferEventQueue queue(16);
+
+    std::atomic<int> finishedProducers{0};
+    std::vector<std::thread> producers;
+    for(int producer = 0; producer < PRODUCERS; ++producer)
+    {
+        producers.emplace_back([&queue, &finishedProducers, producer]()
+        {
+            for(int update = 1; update <= UPDATES_PER_TRANSFER; ++update)
+            {
+                for(int transfer = 0; transfer < TRANSFERS_PER_PRODUCER; ++transfer)
+                {
+                    queue.push(createEvent(producer * TRANSFERS_PER_PRODUCER + transfer, Cache::UPDATE, update));
+                }
+            }
+            ++finishedProducers;
+        });
+    }
+
+    // Updates can be merged, but a transfer never goes back to an older update
+    std::map<TransferTag, long long> latestUpdates;
+    bool inOrder(true);
+    auto onEvent = [&latestUpdates, &inOrder](const TransferEventQueue::Event& event)
+    {
+        auto& latest(latestUpdates[event.data->mTag]);
+        inOrder &= event.data->mNotificationNumber > latest;
+        latest = event.data->mNotificationNumber;
+    };
+
+    while(finishedProducers < PRODUCERS)
+    {
+        queue.drain(onEvent);
+        std::this_thread::yield();
+    }
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+    queue.drain(onEvent);
+
+    REQUIRE(inOrder);
+    REQUIRE(latestUpdates.size() == static_cast<size_t>(PRODUCERS * TRANSFERS_PER_PRODUCER));
+    for(auto& latestUpdate : latestUpdates)
+    {
+        REQUIRE(latestUpdate.second == UPDATES_PER_TRANSFER);
+    }
+    REQUIRE_FALSE(queue.hasEvents());
+
+    auto stats(queue.getStats());
+    REQUIRE(stats.receivedEvents == static_cast<uint64_t>(PRODUCERS * TRANSFERS_PER_PRODUCER * UPDATES_PER_TRANSFER));
+    // The overflow list never holds more than one update per transfer
+    REQUIRE(stats.maxOverflowEvents <= static_cast<uint64_t>(PRODUCERS * TRANSFERS_PER_PRODUCER));
+}
@@ -0,0 +1,155 @@
+#include <catch.hpp>
+#include "TransferMetaData.h"
+
+#include <megaapi.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+class TestMegaError : public mega::MegaError
+{
+public:
+    explicit TestMegaError(int errorCode)
+        : mega::MegaError(errorCode)
+    {}
+};
+
+// The fields read by TransferMetaDataContainer, set by the test
+class TestMegaTransfer : public mega::MegaTransfer
+{
+public:
+    mega::MegaTransfer* copy() override {return new TestMegaTransfer(*this);}
+
+    int getType() const override {return type;}
+    int getTag() const override {return tag;}
+    int getFolderTransferTag() const override {return folderTransferTag;}
+    bool isFolderTransfer() const override {return folderTransfer;}
+    bool isSyncTransfer() const override {return false;}
+    const char* getAppData() const override {return appData.isEmpty() ? nullptr : appData.constData();}
+    int getState() const override {return state;}
+    mega::MegaHandle getNodeHandle() const override {return mega::INVALID_HANDLE;}
+    mega::MegaHandle getParentHandle() const override {return mega::INVALID_HANDLE;}
+
+    int type = mega::MegaTransfer::TYPE_DOWNLOAD;
+    int tag = 0;
+    int folderTransferTag = 0;
+    bool folderTransfer = false;
+    QByteArray appData;
+    int state = mega::MegaTransfer::STATE_ACTIVE;
+};
+
+std::shared_ptr<DownloadTransferMetaData> startFolderDownload(unsigned long long appId, int folderTag)
+{
+    auto data = TransferMetaDataContainer::createTransferMetaDataWithappDataId<DownloadTransferMetaData>(appId, QString::fromUtf8("/tmp"));
+
+    TestMegaTransfer folder;
+    folder.tag = folderTag;
+    folder.folderTransfer = true;
+    folder.appData = QByteArray::number(appId);
+    TransferMetaDataContainer::start(&folder);
+    return data;
+}
+
+// Starts and finishes the files of a folder, as the transfers thread does
+void transferFolderFiles(int folderTag, int files, int finishedState)
+{
+    TestMegaTransfer file;
+    file.folderTransferTag = folderTag;
+    TestMegaError ok(mega::MegaError::API_OK);
+    for (int index = 1; index <= files; ++index)
+    {
+        file.tag = folderTag + index;
+        file.state = mega::MegaTransfer::STATE_ACTIVE;
+        TransferMetaDataContainer::start(&file);
+    }
+    for (int index = 1; index <= files; ++index)
+    {
+        file.tag = folderTag + index;
+        file.state = finishedState;
+        TransferMetaDataContainer::finishFromFolderTransfer(&file, &ok);
+    }
+}
+}
+
+TEST_CASE("TransferMetaDataContainer finds the data of the folder files by folder tag")
+{
+    auto first(startFolderDownload(910001, 1000));
+    auto second(startFolderDownload(910002, 2000));
+
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(1000) == first);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag<DownloadTransferMetaData>(2000) == second);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(3000) == nullptr);
+
+    transferFolderFiles(1000, 10, mega::MegaTransfer::STATE_COMPLETED);
+    REQUIRE(first->getTotalFiles() == 10);
+    REQUIRE(first->getPendingFiles() == 0);
+    REQUIRE(first->getFileTransfersOK() == 10);
+    REQUIRE(second->getTotalFiles() == 0);
+
+    TestMegaTransfer file;
+    file.tag = 2001;
+    file.folderTransferTag = 2000;
+    REQUIRE(TransferMetaDataContainer::getAppData(&file) == second);
+
+    // The folder tags of a removed data are not found anymore
+    TransferMetaDataContainer::removeAppData(910001);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(1000) == nullptr);
+    REQUIRE(TransferMetaDataContainer::getAppDataById(910001) == nullptr);
+    TransferMetaDataContainer::removeAppData(910002);
+}
+
+TEST_CASE("TransferMetaData counts the files by state")
+{
+    auto data(startFolderDownload(920001, 5000));
+
+    transferFolderFiles(5000, 4, mega::MegaTransfer::STATE_CANCELLED);
+    REQUIRE(data->getTotalFiles() == 4);
+    REQUIRE(data->getFileTransfersCancelled() == 4);
+    REQUIRE(data->getFileTransfersOK() == 0);
+    REQUIRE(data->getTransferIdsByState(TransferData::TRANSFER_CANCELLED).size() == 4);
+    REQUIRE(data->getFirstTransferIdByState(TransferData::TRANSFER_CANCELLED).tag == 5001);
+    REQUIRE(!data->getFirstTransferIdByState(TransferData::TRANSFER_COMPLETED).isValid());
+
+    TransferMetaDataContainer::removeAppData(920001);
+}
+
+// Run with "[.benchmark]" to drive the container from several transfer threads
+TEST_CASE("TransferMetaDataContainer benchmark with millions of start and finish calls", "[.benchmark]")
+{
+    constexpr int THREADS{4};
+    constexpr int FILES_PER_THREAD{250000};
+
+    std::vector<std::shared_ptr<DownloadTransferMetaData>> data;
+    for (int thread = 0; thread < THREADS; ++thread)
+    {
+        data.push_back(startFolderDownload(930000 + thread, (thread + 1) * 1000000));
+    }
+
+    auto start(std::chrono::steady_clock::now());
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < THREADS; ++thread)
+    {
+        threads.emplace_back([thread]()
+        {
+            transferFolderFiles((thread + 1) * 1000000, FILES_PER_THREAD, mega::MegaTransfer::STATE_COMPLETED);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+    WARN(THREADS * FILES_PER_THREAD * 2 << " start and finish calls in " << elapsed.count() << " ms");
+
+    for (int thread = 0; thread < THREADS; ++thread)
+    {
+        REQUIRE(data[thread]->getFileTransfersOK() == FILES_PER_THREAD);
+        REQUIRE(data[thread]->getPendingFiles() == 0);
+        TransferMetaDataContainer::removeAppData(930000 + thread);
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch.hpp>
+#include "TransferTagIndex.h"
+
+#include <chrono>
+#include <random>
+
+TEST_CASE("Transfer tag index keeps rows after removals")
+{
+    TransferTagIndex index;
+    for(TransferTag tag = 1; tag <= 10; ++tag)
+    {
+        index.append(tag);
+    }
+
+    REQUIRE(index.size() == 10);
+    REQUIRE(index.rowOf(1) == 0);
+    REQUIRE(index.rowOf(10) == 9);
+    REQUIRE(index.tagAt(4) == 5);
+
+    // Remove a range in the middle
+    for(TransferTag tag = 3; tag <= 6; ++tag)
+    {
+        REQUIRE(index.remove(tag));
+    }
+
+    REQUIRE(index.size() == 6);
+    REQUIRE(index.rowOf(4) == -1);
+    REQUIRE(index.rowOf(2) == 1);
+    REQUIRE(index.rowOf(7) == 2);
+    REQUIRE(index.rowOf(10) == 5);
+    REQUIRE(index.tagAt(2) == 7);
+    REQUIRE(index.tagAt(6) == 0);
+
+    // Appended after removals
+    index.append(11);
+    REQUIRE(index.rowOf(11) == 6);
+    REQUIRE(!index.remove(4));
+
+    index.clear();
+    REQUIRE(index.size() == 0);
+    REQUIRE(index.rowOf(1) == -1);
+}
+
+TEST_CASE("Transfer tag index matches a plain list after random operations")
+{
+    TransferTagIndex index;
+    QList<TransferTag> reference;
+    std::mt19937 generator(42);
+
+    for(TransferTag tag = 1; tag < 20000; ++tag)
+    {
+        if(generator() % 3 || reference.isEmpty())
+        {
+            index.append(tag);
+            reference.append(tag);
+        }
+        else
+        {
+            auto row(static_cast<int>(generator() % static_cast<unsigned>(reference.size())));
+            REQUIRE(index.tagAt(row) == reference.at(row));
+            index.remove(reference.takeAt(row));
+        }
+    }
+
+    REQUIRE(index.size() == reference.size());
+    for(int row = 0; row < reference.size(); ++row)
+    {
+        REQUIRE(index.rowOf(reference.at(row)) == row);
+    }
+
+    index.reset(reference.mid(0, 100));
+    REQUIRE(index.size() == 100);
+    REQUIRE(index.rowOf(reference.at(99)) == 99);
+}
+
+// Run with "[.benchmark]" to replay start/update/finish events on the tag index
+TEST_CASE("Transfer tag index replays 250k transfer events", "[.benchmark]")
+{
+    constexpr int EVENTS{250000};
+    TransferTagIndex index;
+    std::mt19937 generator(7);
+
+    auto start(std::chrono::steady_clock::now());
+
+    TransferTag nextTag(1);
+    TransferTag firstAlive(1);
+    long long rowsChecked(0);
+    for(int event = 0; event < EVENTS; ++event)
+    {
+        switch(generator() % 3)
+        {
+            case 0:
+                index.append(nextTag++);
+                break;
+            case 1:
+                // Update: the model looks for the row of the tag
+                rowsChecked += index.rowOf(firstAlive + static_cast<TransferTag>(generator() % 1000));
+                break;
+            default:
+                // Finish: completed transfers are cleared from the top of the list
+                if(firstAlive < nextTag)
+                {
+                    index.remove(firstAlive++);
+                }
+                break;
+        }
+    }
+
+    auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+    WARN("Replayed " << EVENTS << " events in " << elapsed.count() << " ms (" << rowsChecked << ")");
+    REQUIRE(index.size() >= 0);
+}
@@ -0,0 +1,45 @@
+#include <catch.hpp>
+#include "TransfersProcessScheduler.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Transfers process scheduler sizes the batch to the frame budget")
+{
+    TransfersProcessScheduler scheduler;
+    scheduler.setFrameBudget(8ms);
+
+    // No measures yet
+    REQUIRE(scheduler.nextBatchSize() == TransfersProcessScheduler::DEFAULT_BATCH_SIZE);
+    REQUIRE(scheduler.nextInterval() == TransfersProcessScheduler::IDLE_INTERVAL);
+
+    // 1000 transfers in 16 ms: 16 us per transfer, so 500 fit in 8 ms
+    scheduler.passFinished(1000, 16000us, true);
+    REQUIRE(scheduler.nextBatchSize() == 500);
+    // There are transfers waiting: the next pass comes after giving back the time spent
+    REQUIRE(scheduler.nextInterval() == 16ms);
+
+    // Very expensive transfers never go below the minimum batch
+    scheduler.passFinished(10, 1000000us, true);
+    REQUIRE(scheduler.nextBatchSize() == TransfersProcessScheduler::MIN_BATCH_SIZE);
+    REQUIRE(scheduler.nextInterval() == TransfersProcessScheduler::IDLE_INTERVAL);
+
+    // Nothing pending
+    scheduler.passFinished(0, 10us, false);
+    REQUIRE(scheduler.nextInterval() == TransfersProcessScheduler::IDLE_INTERVAL);
+}
+
+TEST_CASE("Transfers process scheduler drains at full speed when nobody is looking")
+{
+    TransfersProcessScheduler scheduler;
+    scheduler.passFinished(1000, 16000us, true);
+
+    scheduler.setDrainAtFullSpeed(true);
+    REQUIRE(scheduler.nextBatchSize() == TransfersProcessScheduler::MAX_BATCH_SIZE);
+    REQUIRE(scheduler.nextInterval() == TransfersProcessScheduler::MIN_INTERVAL);
+
+    scheduler.setDrainAtFullSpeed(false);
+    REQUIRE(scheduler.nextBatchSize() == 500);
+
+    scheduler.reset();
+    REQUIRE(scheduler.nextBatchSize() == TransfersProcessScheduler::DEFAULT_BATCH_SIZE);
+}